@@ -12,6 +12,8 @@ void arch_disable_interrupts();
 
 void arch_enable_interrupts();
 
+bool arch_interrupts_enabled();
+
 void arch_halt();
 
 void arch_yield();
@@ -22,10 +24,40 @@ void arch_load_context(Task *task);
 
 void arch_task_go(Task *task);
 
+void arch_task_destroy(Task *task);
+
 size_t arch_debug_write(const void *buffer, size_t size);
 
 TimeStamp arch_get_time();
 
+// A monotonic clock with a high resolution, counting since the machine
+// started. Reading it is cheap, converting its ticks is not.
+uint64_t arch_get_clock();
+
+uint64_t arch_clock_to_nanoseconds(uint64_t ticks);
+
+// Raises the timer interrupt once, this long from now. The timer may not
+// count that far, then it comes earlier.
+void arch_timer_oneshot(uint64_t nanoseconds);
+
+// Starts the processors other than the one we booted on.
+void arch_start_cpus();
+
+// The index of the processor running this, for cpu_get(). Unless
+// interrupts are disabled, the task may be on another one right after.
+int arch_current_cpu();
+
+// Spinning with interrupts disabled, what the other processors asked this
+// one to do with an interprocessor interrupt is done meanwhile.
+void arch_pause();
+
+// Makes another processor call schedule(), it has something to run.
+void arch_reschedule(int cpu);
+
+// What a PCI device writes, and where, to raise this interrupt. False if
+// the processor can't receive message signaled interrupts.
+bool arch_msi_message(int irq, uint64_t *address, uint32_t *data);
+
 NO_RETURN void arch_reboot();
 
 NO_RETURN void arch_shutdown();
@@ -42,6 +74,9 @@ void arch_virtual_initialize();
 
 void arch_virtual_memory_enable();
 
+// On the other processors, started with the kernel address space loaded.
+void arch_virtual_memory_enable_ap();
+
 bool arch_virtual_present(void *address_space, uintptr_t virtual_address);
 
 uintptr_t arch_virtual_to_physical(void *address_space, uintptr_t virtual_address);
@@ -52,6 +87,12 @@ MemoryRange arch_virtual_alloc(void *address_space, MemoryRange physical_range,
 
 void arch_virtual_free(void *address_space, MemoryRange virtual_range);
 
+// Where the mappings of userspace go, the kernel is below.
+MemoryRange arch_virtual_user_range();
+
+// The alignment which lets a mapping of this size use large pages.
+size_t arch_virtual_alignment(size_t size);
+
 void *arch_address_space_create();
 
 void arch_address_space_destroy(void *address_space);
@@ -1,10 +1,12 @@
 #include <libsystem/Logger.h>
 
-#include "archs/x86_32/ACPI.h"
-#include "archs/x86_32/IOAPIC.h"
-#include "archs/x86_32/LAPIC.h"
+#include "archs/x86/ACPI.h"
+#include "archs/x86/HPET.h"
+#include "archs/x86/IOAPIC.h"
+#include "archs/x86/LAPIC.h"
 
 #include "kernel/firmware/ACPI.h"
+#include "kernel/scheduling/Cpu.h"
 
 void acpi_madt_initialize(MADT *madt)
 {
@@ -12,13 +14,22 @@ void acpi_madt_initialize(MADT *madt)
 
     lapic_found(madt->local_apic);
 
-    madt->foreach_record([](auto record) {
+    // We are running on the boot processor, its registers are still at their
+    // physical address.
+    int boot_apic_id = lapic_id();
+
+    madt->foreach_record([&](auto record) {
         switch (record->type)
         {
         case MADTRecordType::LAPIC:
         {
             auto local_apic = reinterpret_cast<MADTLocalApicRecord *>(record);
             logger_info("Local APIC (cpu_id=%d, apic_id=%d, flags=%08x)", local_apic->processor_id, local_apic->apic_id, local_apic->flags);
+
+            if (local_apic->flags & MADT_LAPIC_ENABLED)
+            {
+                cpu_found(local_apic->apic_id, local_apic->apic_id == boot_apic_id);
+            }
         }
         break;
 
@@ -60,9 +71,16 @@ void acpi_initialize(Handover *handover)
 
     RSDP *rsdp = (RSDP *)(handover->acpi_rsdp_address);
 
-    RSDT *rsdt = (RSDT *)(rsdp->rsdt_address);
+    RSDT *rsdt = (RSDT *)(uintptr_t)(rsdp->rsdt_address);
 
     MADT *madt = (MADT *)rsdt->child("APIC");
 
     acpi_madt_initialize(madt);
+
+    HPET *hpet = (HPET *)rsdt->child("HPET");
+
+    if (hpet)
+    {
+        hpet_found(hpet->address);
+    }
 }
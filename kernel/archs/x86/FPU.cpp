@@ -1,44 +1,234 @@
+#include <libsystem/Logger.h>
+#include <libsystem/Macros.h>
 #include <string.h>
 
+#include "archs/x86/CPUID.h"
 #include "archs/x86/FPU.h"
+#include "archs/x86/x86.h"
 
-char fpu_initial_context[512] ALIGNED(16);
-char fpu_registers[512] ALIGNED(16);
+#include "kernel/scheduling/Scheduler.h"
+
+#define CR0_MONITOR_COPROCESSOR (1 << 1)
+#define CR0_TASK_SWITCHED (1 << 3)
+#define CR0_EMULATION (1 << 2)
+#define CR0_NUMERIC_ERROR (1 << 5)
+
+#define CR4_OSFXSR (1 << 9)
+#define CR4_OSXMMEXCPT (1 << 10)
+#define CR4_OSXSAVE (1 << 18)
+
+#define XCR0_X87 (1 << 0)
+#define XCR0_SSE (1 << 1)
+#define XCR0_AVX (1 << 2)
+
+#define FPU_CONTEXT_ALIGN 64
+#define FPU_CONTEXT_SIZE (sizeof(Task::fpu_registers) - FPU_CONTEXT_ALIGN)
+
+enum FPUSaveMethod
+{
+    FPU_FXSAVE,
+    FPU_XSAVE,
+    FPU_XSAVEOPT,
+};
+
+static FPUSaveMethod _method = FPU_FXSAVE;
+static uint64_t _features = XCR0_X87 | XCR0_SSE;
+
+static char _initial_context[FPU_CONTEXT_SIZE] ALIGNED(FPU_CONTEXT_ALIGN) = {};
+
+// The task whose state is in the FPU registers, of each processor.
+static Task *_owner[CPU_MAX] = {};
+
+static void cpuid_leaf(uint32_t leaf, uint32_t subleaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+    asm volatile("cpuid"
+                 : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                 : "a"(leaf), "c"(subleaf));
+}
+
+static void xsetbv(uint32_t reg, uint64_t value)
+{
+    asm volatile("xsetbv" ::"c"(reg), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+static void *fpu_area(Task *task)
+{
+    return reinterpret_cast<void *>(ALIGN_UP((uintptr_t)task->fpu_registers, FPU_CONTEXT_ALIGN));
+}
+
+static void fpu_save(void *area)
+{
+    uint32_t low = _features;
+    uint32_t high = _features >> 32;
+
+    switch (_method)
+    {
+    case FPU_XSAVEOPT:
+        asm volatile("xsaveopt (%0)" ::"r"(area), "a"(low), "d"(high)
+                     : "memory");
+        break;
+
+    case FPU_XSAVE:
+        asm volatile("xsave (%0)" ::"r"(area), "a"(low), "d"(high)
+                     : "memory");
+        break;
+
+    default:
+        asm volatile("fxsave (%0)" ::"r"(area)
+                     : "memory");
+        break;
+    }
+}
+
+static void fpu_restore(void *area)
+{
+    uint32_t low = _features;
+    uint32_t high = _features >> 32;
+
+    if (_method == FPU_FXSAVE)
+    {
+        asm volatile("fxrstor (%0)" ::"r"(area)
+                     : "memory");
+    }
+    else
+    {
+        asm volatile("xrstor (%0)" ::"r"(area), "a"(low), "d"(high)
+                     : "memory");
+    }
+}
+
+static void fpu_enable_xsave()
+{
+    uint32_t features = cpuid_get_feature_ECX();
+
+    if (!(features & CPUID_FEAT_ECX_XSAVE))
+    {
+        return;
+    }
+
+    asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_OSXSAVE));
+
+    uint64_t enabled = XCR0_X87 | XCR0_SSE;
+
+    if (features & CPUID_FEAT_ECX_AVX)
+    {
+        enabled |= XCR0_AVX;
+    }
+
+    xsetbv(0, enabled);
+
+    // The size of the area for the features we just enabled.
+    uint32_t eax, ebx, ecx, edx;
+    cpuid_leaf(0xD, 0, &eax, &ebx, &ecx, &edx);
+
+    if (ebx > FPU_CONTEXT_SIZE)
+    {
+        logger_warn("The XSAVE area takes %d bytes, using FXSAVE", ebx);
+        xsetbv(0, XCR0_X87 | XCR0_SSE);
+        return;
+    }
+
+    _features = enabled;
+
+    // Skips the parts which are unchanged since they were restored.
+    cpuid_leaf(0xD, 1, &eax, &ebx, &ecx, &edx);
+    _method = (eax & 1) ? FPU_XSAVEOPT : FPU_XSAVE;
+}
 
 void fpu_initialize()
 {
-    asm volatile("clts");
-    size_t t;
-    asm volatile("mov %%cr0, %0"
-                 : "=r"(t));
-    t &= ~(1 << 2);
-    t |= (1 << 1);
-    t |= (1 << 5);
-    asm volatile("mov %0, %%cr0" ::"r"(t));
-
-    asm volatile("mov %%cr4, %0"
-                 : "=r"(t));
-    t |= 3 << 9;
-    asm volatile("mov %0, %%cr4" ::"r"(t));
+    fpu_enable();
 
     // Initialize the FPU
     asm volatile("fninit");
-    asm volatile("fxsave (%0)" ::"r"(fpu_initial_context));
+    fpu_save(_initial_context);
+
+    logger_info("Saving the FPU state with %s (features=%x)",
+                _method == FPU_XSAVEOPT ? "XSAVEOPT" : (_method == FPU_XSAVE ? "XSAVE" : "FXSAVE"),
+                (uint32_t)_features);
+}
+
+void fpu_enable()
+{
+    asm volatile("clts");
+
+    CRRegister cr0 = CR0();
+    cr0 &= ~CR0_EMULATION;
+    cr0 |= CR0_MONITOR_COPROCESSOR | CR0_NUMERIC_ERROR;
+    asm volatile("mov %0, %%cr0" ::"r"(cr0));
+
+    asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_OSFXSR | CR4_OSXMMEXCPT));
+
+    fpu_enable_xsave();
+
+    asm volatile("fninit");
+}
+
+// The registers of no processor hold the state of the task anymore.
+static void fpu_forget(Task *task)
+{
+    for (int i = 0; i < CPU_MAX; i++)
+    {
+        Task *expected = task;
+        __atomic_compare_exchange_n(&_owner[i], &expected, nullptr, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    }
 }
 
 void fpu_init_context(Task *task)
 {
-    memcpy(&task->fpu_registers, &fpu_initial_context, 512);
+    fpu_forget(task);
+
+    memcpy(fpu_area(task), _initial_context, FPU_CONTEXT_SIZE);
 }
 
 void fpu_save_context(Task *task)
 {
-    asm volatile("fxsave (%0)" ::"r"(fpu_registers));
-    memcpy(&task->fpu_registers, &fpu_registers, 512);
+    if (cpu_count() > 1 && _owner[arch_current_cpu()] == task)
+    {
+        asm volatile("clts");
+        fpu_save(fpu_area(task));
+    }
+}
+
+void fpu_switch_context(Task *task)
+{
+    if (task == _owner[arch_current_cpu()])
+    {
+        asm volatile("clts");
+    }
+    else
+    {
+        asm volatile("mov %0, %%cr0" ::"r"(CR0() | CR0_TASK_SWITCHED));
+    }
+}
+
+// The running task used the FPU while it held someone else's state, called
+// with interrupts disabled.
+void fpu_handle_unavailable()
+{
+    asm volatile("clts");
+
+    Task *running = scheduler_running();
+    Task *&owner = _owner[arch_current_cpu()];
+
+    if (owner == running)
+    {
+        return;
+    }
+
+    if (owner)
+    {
+        fpu_save(fpu_area(owner));
+    }
+
+    // The state was saved when the task left the processor it ran on.
+    fpu_forget(running);
+
+    fpu_restore(fpu_area(running));
+    owner = running;
 }
 
-void fpu_load_context(Task *task)
+void fpu_release_context(Task *task)
 {
-    memcpy(&fpu_registers, &task->fpu_registers, 512);
-    asm volatile("fxrstor (%0)" ::"r"(fpu_registers));
+    fpu_forget(task);
 }
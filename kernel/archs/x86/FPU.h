@@ -4,8 +4,20 @@
 
 void fpu_initialize();
 
+// The registers of the processor, the others are started after the first
+// one measured what they can save.
+void fpu_enable();
+
+void fpu_init_context(Task *task);
+
+// The state is only saved and restored once another task uses the FPU, the
+// switch only makes the next use trap if the FPU holds someone else's state.
+void fpu_switch_context(Task *task);
+
+// Another processor may run the task next, so with more than one the state
+// it left in the registers is saved when it is switched out.
 void fpu_save_context(Task *task);
 
-void fpu_load_context(Task *task);
+void fpu_handle_unavailable();
 
-void fpu_init_context(Task *task);
\ No newline at end of file
+void fpu_release_context(Task *task);
@@ -0,0 +1,59 @@
+#include <libsystem/Logger.h>
+
+#include "archs/x86/HPET.h"
+
+constexpr int HPET_CAPABILITIES_PERIOD = 0x004;
+constexpr int HPET_CONFIGURATION = 0x010;
+constexpr int HPET_MAIN_COUNTER = 0x0F0;
+
+constexpr uint32_t HPET_ENABLE = 1 << 0;
+
+// The specification doesn't allow a slower counter, 10MHz.
+constexpr uint32_t HPET_MAX_PERIOD = 100000000;
+
+static volatile uint8_t *_hpet = nullptr;
+
+// In femtoseconds.
+static uint32_t _period = 0;
+
+static uint32_t hpet_read(int offset)
+{
+    return *reinterpret_cast<volatile uint32_t *>(_hpet + offset);
+}
+
+static void hpet_write(int offset, uint32_t value)
+{
+    *reinterpret_cast<volatile uint32_t *>(_hpet + offset) = value;
+}
+
+void hpet_found(uintptr_t address)
+{
+    _hpet = reinterpret_cast<volatile uint8_t *>(address);
+    _period = hpet_read(HPET_CAPABILITIES_PERIOD);
+
+    if (_period == 0 || _period > HPET_MAX_PERIOD)
+    {
+        logger_warn("HPET at %08x has a bogus period of %ufs", address, _period);
+        _hpet = nullptr;
+        return;
+    }
+
+    hpet_write(HPET_CONFIGURATION, hpet_read(HPET_CONFIGURATION) | HPET_ENABLE);
+
+    logger_info("HPET found at %08x, running at %uKHz", address, (uint32_t)hpet_ticks_per_millisecond());
+}
+
+bool hpet_available()
+{
+    return _hpet != nullptr;
+}
+
+uint64_t hpet_ticks_per_millisecond()
+{
+    return 1000000000000ull / _period;
+}
+
+uint32_t hpet_counter()
+{
+    return hpet_read(HPET_MAIN_COUNTER);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+// The registers are only reachable at their physical address, the HPET is
+// used before paging is enabled to calibrate the TSC.
+void hpet_found(uintptr_t address);
+
+bool hpet_available();
+
+uint64_t hpet_ticks_per_millisecond();
+
+// The low half of the main counter, it wraps around.
+uint32_t hpet_counter();
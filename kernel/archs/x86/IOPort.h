@@ -49,3 +49,20 @@ static inline void out32(uint16_t port, uint32_t data)
                  :
                  : "a"(data), "d"(port));
 }
+
+// count words at once, through the same port.
+static inline void in16_repeat(uint16_t port, uint16_t *buffer, size_t count)
+{
+    asm volatile("rep insw"
+                 : "+D"(buffer), "+c"(count)
+                 : "d"(port)
+                 : "memory");
+}
+
+static inline void out16_repeat(uint16_t port, const uint16_t *buffer, size_t count)
+{
+    asm volatile("rep outsw"
+                 : "+S"(buffer), "+c"(count)
+                 : "d"(port)
+                 : "memory");
+}
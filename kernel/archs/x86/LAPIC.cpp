@@ -0,0 +1,162 @@
+#include <libmath/MinMax.h>
+#include <libsystem/Logger.h>
+
+#include "archs/Arch.h"
+#include "archs/x86/LAPIC.h"
+#include "archs/x86/PIC.h"
+#include "archs/x86/TSC.h"
+
+#include "kernel/interrupts/Interupts.h"
+
+constexpr int LAPIC_ID = 0x0020;
+constexpr int LAPIC_EOI = 0x00B0;
+constexpr int LAPIC_SPURIOUS = 0x00F0;
+constexpr int LAPIC_ICR_LOW = 0x0300;
+constexpr int LAPIC_ICR_HIGH = 0x0310;
+constexpr int LAPIC_TIMER = 0x0320;
+constexpr int LAPIC_TIMER_INITIAL = 0x0380;
+constexpr int LAPIC_TIMER_CURRENT = 0x0390;
+constexpr int LAPIC_TIMER_DIVIDE = 0x03E0;
+
+constexpr uint32_t LAPIC_SOFTWARE_ENABLE = 0x100;
+
+constexpr uint32_t ICR_INIT = 0x500;
+constexpr uint32_t ICR_STARTUP = 0x600;
+constexpr uint32_t ICR_PENDING = 0x1000;
+constexpr uint32_t ICR_ASSERT = 0x4000;
+
+constexpr uint32_t TIMER_MASKED = 0x10000;
+constexpr uint32_t TIMER_DIVIDE_BY_16 = 0x3;
+
+static uintptr_t lapic_physical = 0;
+static volatile uint32_t *lapic = nullptr;
+static bool lapic_mapped = false;
+
+// In ticks per second, the same on every processor.
+static uint64_t lapic_timer_frequency = 0;
+
+void lapic_found(uintptr_t address)
+{
+    lapic_physical = address;
+    lapic = reinterpret_cast<uint32_t *>(address);
+    logger_info("LAPIC found at %08x", lapic);
+}
+
+void lapic_map()
+{
+    InterruptsRetainer retainer;
+
+    if (!lapic_physical || lapic_mapped)
+    {
+        return;
+    }
+
+    lapic_mapped = true;
+
+    MemoryRange range{lapic_physical, ARCH_PAGE_SIZE};
+    lapic = reinterpret_cast<uint32_t *>(arch_virtual_alloc(arch_kernel_address_space(), range, MEMORY_NONE).base());
+}
+
+bool lapic_available()
+{
+    return lapic != nullptr;
+}
+
+// The registers are 16 bytes apart, reg is their offset in bytes.
+uint32_t lapic_read(uint32_t reg)
+{
+    return lapic[reg / sizeof(uint32_t)];
+}
+
+void lapic_write(uint32_t reg, uint32_t data)
+{
+    lapic[reg / sizeof(uint32_t)] = data;
+}
+
+void lapic_ack()
+{
+    lapic_write(LAPIC_EOI, 0);
+}
+
+void lapic_initialize()
+{
+    pic_disable();
+
+    lapic_enable();
+}
+
+void lapic_enable()
+{
+    lapic_write(LAPIC_SPURIOUS, lapic_read(LAPIC_SPURIOUS) | LAPIC_SOFTWARE_ENABLE);
+}
+
+int lapic_id()
+{
+    return lapic_read(LAPIC_ID) >> 24;
+}
+
+static void lapic_send_ipi(int apic_id, uint32_t command)
+{
+    // An interrupt sending one too would change the destination under us.
+    InterruptsRetainer retainer;
+
+    lapic_write(LAPIC_ICR_HIGH, apic_id << 24);
+    lapic_write(LAPIC_ICR_LOW, command);
+
+    while (lapic_read(LAPIC_ICR_LOW) & ICR_PENDING)
+    {
+        asm volatile("pause");
+    }
+}
+
+void lapic_send_init(int apic_id)
+{
+    lapic_send_ipi(apic_id, ICR_INIT | ICR_ASSERT);
+}
+
+// The processor starts in real mode at the page entry, which has to be
+// below the first megabyte.
+void lapic_send_startup(int apic_id, uintptr_t entry)
+{
+    lapic_send_ipi(apic_id, ICR_STARTUP | ICR_ASSERT | (entry / ARCH_PAGE_SIZE));
+}
+
+void lapic_send_interrupt(int apic_id, int vector)
+{
+    lapic_send_ipi(apic_id, ICR_ASSERT | vector);
+}
+
+void lapic_timer_calibrate()
+{
+    lapic_write(LAPIC_TIMER_DIVIDE, TIMER_DIVIDE_BY_16);
+    lapic_write(LAPIC_TIMER, TIMER_MASKED);
+    lapic_write(LAPIC_TIMER_INITIAL, 0xFFFFFFFF);
+
+    tsc_delay(10000);
+
+    uint32_t elapsed = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CURRENT);
+    lapic_write(LAPIC_TIMER_INITIAL, 0);
+
+    lapic_timer_frequency = elapsed * 100ull;
+    logger_info("The local APIC timer runs at %dkHz", (int)(lapic_timer_frequency / 1000));
+}
+
+void lapic_timer_initialize()
+{
+    lapic_write(LAPIC_TIMER_DIVIDE, TIMER_DIVIDE_BY_16);
+
+    // One-shot, it stays stopped until it is given a count.
+    lapic_write(LAPIC_TIMER, LAPIC_TIMER_VECTOR);
+}
+
+void lapic_timer_oneshot(uint64_t nanoseconds)
+{
+    uint64_t longest = 0xFFFFFFFFull * 1000000000ull / lapic_timer_frequency;
+    nanoseconds = MIN(nanoseconds, longest);
+
+    // Rounded up, the interrupt never comes before the deadline.
+    uint64_t count = (nanoseconds * lapic_timer_frequency + 999999999) / 1000000000;
+    count = MAX(count, (uint64_t)1);
+
+    lapic_write(LAPIC_TIMER_INITIAL, count);
+}
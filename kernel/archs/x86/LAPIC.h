@@ -0,0 +1,42 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+// Where PCI devices write their message signaled interrupts.
+#define LAPIC_MSI_ADDRESS 0xFEE00000
+
+// Raised by the timer of the processors other than the first one, which
+// uses the PIT.
+#define LAPIC_TIMER_VECTOR 124
+
+void lapic_found(uintptr_t address);
+
+// The registers are only reachable at their physical address until paging
+// is enabled, then they have to be mapped.
+void lapic_map();
+
+bool lapic_available();
+
+void lapic_initialize();
+
+void lapic_enable();
+
+int lapic_id();
+
+void lapic_send_init(int apic_id);
+
+void lapic_send_startup(int apic_id, uintptr_t entry);
+
+void lapic_send_interrupt(int apic_id, int vector);
+
+// Measures the timer against the TSC, it runs at the same rate on every
+// processor.
+void lapic_timer_calibrate();
+
+// The timer of the processor it is called on, it only interrupts once it
+// is given a deadline.
+void lapic_timer_initialize();
+
+void lapic_timer_oneshot(uint64_t nanoseconds);
+
+void lapic_ack();
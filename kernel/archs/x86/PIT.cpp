@@ -1,11 +1,23 @@
-#include "archs/x86/PIT.h"
+#include <libmath/MinMax.h>
+
 #include "archs/x86/IOPort.h"
+#include "archs/x86/PIT.h"
 
-void pit_initialize(int frequency)
+void pit_initialize()
 {
-    uint16_t divisor = 1193182 / frequency;
+    pit_oneshot(PIT_ONESHOT_MAX);
+}
+
+void pit_oneshot(uint64_t nanoseconds)
+{
+    nanoseconds = MIN(nanoseconds, (uint64_t)PIT_ONESHOT_MAX);
+
+    // Rounded up, the interrupt never comes before the deadline.
+    uint64_t count = (nanoseconds * PIT_FREQUENCY + 999999999) / 1000000000;
+    count = MAX(count, (uint64_t)1);
 
-    out8(0x43, 0x36);
-    out8(0x40, divisor & 0xFF);
-    out8(0x40, (divisor >> 8) & 0xFF);
+    // The first channel, interrupt on terminal count.
+    out8(0x43, 0x30);
+    out8(0x40, count & 0xFF);
+    out8(0x40, (count >> 8) & 0xFF);
 }
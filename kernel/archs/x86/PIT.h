@@ -2,4 +2,14 @@
 
 #include <libsystem/Common.h>
 
-void pit_initialize(int frequency);
+#define PIT_FREQUENCY 1193182
+
+// The longest the first channel counts down for, in nanoseconds.
+#define PIT_ONESHOT_MAX 50000000
+
+// Starts the first countdown, the scheduler arms the next ones.
+void pit_initialize();
+
+// Raises IRQ 0 once, this long from now. Longer than PIT_ONESHOT_MAX is
+// cut short.
+void pit_oneshot(uint64_t nanoseconds);
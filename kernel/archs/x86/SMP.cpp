@@ -0,0 +1,245 @@
+#include <abi/Process.h>
+#include <libsystem/Logger.h>
+#include <string.h>
+
+#include "archs/Arch.h"
+#include "archs/x86/FPU.h"
+#include "archs/x86/LAPIC.h"
+#include "archs/x86/SMP.h"
+#include "archs/x86/TLB.h"
+#include "archs/x86/TSC.h"
+#include "archs/x86/x86.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/Memory.h"
+#include "kernel/memory/Physical.h"
+#include "kernel/scheduling/Cpu.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/System.h"
+#include "kernel/tasking/Tasking.h"
+
+extern "C" char smp_trampoline_start[];
+extern "C" char smp_trampoline_end[];
+
+// Read by the trampoline, processors are started one at a time.
+extern "C" uintptr_t smp_ap_page_directory;
+extern "C" uintptr_t smp_ap_stack;
+
+uintptr_t smp_ap_page_directory = 0;
+uintptr_t smp_ap_stack = 0;
+
+// Until the local APIC is mapped, only the boot processor is running.
+static bool _started = false;
+static int _cpu_by_apic_id[256] = {};
+
+// The processors which have to flush their TLB, a bit each.
+static uint32_t _tlb_flush_pending = 0;
+
+int smp_current_cpu()
+{
+    if (!_started)
+    {
+        return 0;
+    }
+
+    return _cpu_by_apic_id[lapic_id()];
+}
+
+// Started on the stack of its idle task, which it becomes.
+extern "C" void smp_ap_main()
+{
+    Cpu *cpu = cpu_current();
+
+    smp_ap_initialize(cpu);
+    arch_virtual_memory_enable_ap();
+    fpu_enable();
+    lapic_enable();
+
+    // Until it can retain interrupts, it takes the kernel lock itself.
+    interrupts_lock();
+
+    scheduler_did_start_cpu(cpu);
+    arch_load_context(cpu->idle);
+
+    interrupts_unlock();
+
+    lapic_timer_initialize();
+
+    __atomic_store_n(&cpu->online, true, __ATOMIC_SEQ_CST);
+
+    // The kernel mappings may have changed before it was asked to flush.
+    tlb_flush();
+
+    interrupts_enable_holding();
+    lapic_timer_oneshot(SCHEDULER_SLICE);
+    sti();
+
+    system_hang();
+}
+
+void smp_reschedule(int cpu)
+{
+    lapic_send_interrupt(cpu_get(cpu)->apic_id, SMP_RESCHEDULE_VECTOR);
+}
+
+void smp_tlb_shootdown()
+{
+    if (!_started)
+    {
+        return;
+    }
+
+    int current = arch_current_cpu();
+    uint32_t targets = 0;
+
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        if (i != current && __atomic_load_n(&cpu_get(i)->online, __ATOMIC_ACQUIRE))
+        {
+            targets |= 1u << i;
+        }
+    }
+
+    if (!targets)
+    {
+        return;
+    }
+
+    __atomic_or_fetch(&_tlb_flush_pending, targets, __ATOMIC_SEQ_CST);
+
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        if (targets & (1u << i))
+        {
+            lapic_send_interrupt(cpu_get(i)->apic_id, SMP_TLB_SHOOTDOWN_VECTOR);
+        }
+    }
+
+    while (__atomic_load_n(&_tlb_flush_pending, __ATOMIC_SEQ_CST) & targets)
+    {
+        arch_pause();
+    }
+}
+
+void smp_handle_requests()
+{
+    if (!_started)
+    {
+        return;
+    }
+
+    uint32_t self = 1u << arch_current_cpu();
+
+    if (__atomic_load_n(&_tlb_flush_pending, __ATOMIC_SEQ_CST) & self)
+    {
+        tlb_flush();
+        __atomic_and_fetch(&_tlb_flush_pending, ~self, __ATOMIC_SEQ_CST);
+    }
+}
+
+static bool smp_wait_online(Cpu *cpu, uint64_t microseconds)
+{
+    for (uint64_t i = 0; i < microseconds / 10; i++)
+    {
+        if (__atomic_load_n(&cpu->online, __ATOMIC_SEQ_CST))
+        {
+            return true;
+        }
+
+        tsc_delay(10);
+    }
+
+    return __atomic_load_n(&cpu->online, __ATOMIC_SEQ_CST);
+}
+
+// INIT, then up to two STARTUP, as the MultiProcessor Specification says.
+static bool smp_start_cpu(Cpu *cpu)
+{
+    lapic_send_init(cpu->apic_id);
+    tsc_delay(10000);
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        lapic_send_startup(cpu->apic_id, SMP_TRAMPOLINE);
+
+        if (smp_wait_online(cpu, attempt == 0 ? 1000 : 100000))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static Result smp_install_trampoline()
+{
+    MemoryRange trampoline{SMP_TRAMPOLINE, ARCH_PAGE_SIZE};
+
+    {
+        InterruptsRetainer retainer;
+
+        if (physical_is_used(trampoline))
+        {
+            return ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    TRY(memory_map_identity(arch_kernel_address_space(), trampoline, MEMORY_NONE));
+
+    memcpy((void *)SMP_TRAMPOLINE, smp_trampoline_start, smp_trampoline_end - smp_trampoline_start);
+
+    return SUCCESS;
+}
+
+void smp_initialize()
+{
+    if (cpu_count() == 1 || !lapic_available())
+    {
+        return;
+    }
+
+    if constexpr (!__CONFIG_SMP__)
+    {
+        logger_info("Only using the boot processor of %d", cpu_count());
+        return;
+    }
+
+    if (smp_install_trampoline() != SUCCESS)
+    {
+        logger_warn("The page of the trampoline is used, only using the boot processor");
+        return;
+    }
+
+    lapic_map();
+    lapic_timer_calibrate();
+
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        _cpu_by_apic_id[cpu_get(i)->apic_id] = i;
+    }
+
+    _started = true;
+
+    smp_ap_page_directory = (uintptr_t)arch_kernel_address_space();
+
+    int online = 1;
+
+    for (int i = 1; i < cpu_count(); i++)
+    {
+        Cpu *cpu = cpu_get(i);
+
+        tasking_create_idle_task(cpu);
+        smp_ap_stack = (uintptr_t)cpu->idle->kernel_stack + PROCESS_STACK_SIZE;
+
+        // A late processor would share the stack of the next one.
+        if (!smp_start_cpu(cpu))
+        {
+            logger_warn("The processor %d didn't start", cpu_get(i)->apic_id);
+            break;
+        }
+
+        online++;
+    }
+
+    logger_info("%d of %d processors are online", online, cpu_count());
+}
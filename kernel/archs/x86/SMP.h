@@ -0,0 +1,30 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+#include "kernel/scheduling/Cpu.h"
+
+// Where the startup code of the other processors is copied, the page has to
+// be below the first megabyte.
+#define SMP_TRAMPOLINE 0x8000
+
+// What the processors ask each other.
+#define SMP_RESCHEDULE_VECTOR 125
+#define SMP_TLB_SHOOTDOWN_VECTOR 126
+
+void smp_initialize();
+
+int smp_current_cpu();
+
+// Loads the tables and sets up the registers each processor has its own of,
+// done by each architecture.
+void smp_ap_initialize(Cpu *cpu);
+
+void smp_reschedule(int cpu);
+
+// The other processors flush their whole TLB, this waits until they did.
+void smp_tlb_shootdown();
+
+// What the other processors asked this one to do, called from the handler
+// of their interrupt and while spinning with interrupts disabled.
+void smp_handle_requests();
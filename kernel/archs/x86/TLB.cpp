@@ -0,0 +1,75 @@
+#include <libsystem/Logger.h>
+
+#include "archs/x86/CPUID.h"
+#include "archs/x86/TLB.h"
+#include "archs/x86/x86.h"
+
+#define CR4_PAGE_GLOBAL_ENABLE (1 << 7)
+
+static bool _global_pages = false;
+
+void tlb_initialize()
+{
+    if (!(cpuid_get_feature_EDX() & CPUID_FEAT_EDX_PGE))
+    {
+        logger_warn("The processor doesn't have global pages");
+        return;
+    }
+
+    asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_PAGE_GLOBAL_ENABLE));
+
+    _global_pages = true;
+}
+
+bool tlb_global_pages()
+{
+    return _global_pages;
+}
+
+static void tlb_flush_all()
+{
+    CRRegister cr4 = CR4();
+
+    // Toggling global pages flushes everything, even the global entries.
+    asm volatile("mov %0, %%cr4" ::"r"(cr4 & ~CR4_PAGE_GLOBAL_ENABLE)
+                 : "memory");
+    asm volatile("mov %0, %%cr4" ::"r"(cr4)
+                 : "memory");
+}
+
+static void tlb_flush_local()
+{
+    asm volatile("mov %0, %%cr3" ::"r"(CR3())
+                 : "memory");
+}
+
+void tlb_flush()
+{
+    if (_global_pages)
+    {
+        tlb_flush_all();
+    }
+    else
+    {
+        tlb_flush_local();
+    }
+}
+
+void tlb_invalidate(MemoryRange range, bool global)
+{
+    if (range.page_count() <= TLB_INVALIDATE_THRESHOLD)
+    {
+        for (size_t i = 0; i < range.page_count(); i++)
+        {
+            invlpg(range.base() + i * ARCH_PAGE_SIZE);
+        }
+    }
+    else if (global && _global_pages)
+    {
+        tlb_flush_all();
+    }
+    else
+    {
+        tlb_flush_local();
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+#include "kernel/memory/MemoryRange.h"
+
+// Past this many pages, flushing the whole TLB is cheaper than invalidating
+// each page.
+#define TLB_INVALIDATE_THRESHOLD 32
+
+static inline void invlpg(uintptr_t address)
+{
+    asm volatile("invlpg (%0)" ::"r"(address)
+                 : "memory");
+}
+
+// Makes the kernel mappings global if the processor supports it, they stay
+// in the TLB when the address space changes.
+void tlb_initialize();
+
+bool tlb_global_pages();
+
+// Everything, the kernel mappings too.
+void tlb_flush();
+
+// Invalidates the translations of a range of the address space which is
+// loaded, or of the kernel mappings when the range is global.
+void tlb_invalidate(MemoryRange range, bool global);
@@ -0,0 +1,92 @@
+#include <libsystem/Logger.h>
+
+#include "archs/x86/HPET.h"
+#include "archs/x86/IOPort.h"
+#include "archs/x86/PIT.h"
+#include "archs/x86/TSC.h"
+
+#define CALIBRATION_MILLISECONDS 10
+
+static uint64_t _ticks_per_millisecond = 0;
+
+// The second channel of the PIT is counted down once, the speaker is kept
+// off and its output is polled until it reaches zero.
+static uint64_t tsc_measure_ticks_per_millisecond()
+{
+    uint16_t count = PIT_FREQUENCY * CALIBRATION_MILLISECONDS / 1000;
+
+    out8(0x61, (in8(0x61) & ~0x02) | 0x01);
+
+    out8(0x43, 0xB0);
+    out8(0x42, count & 0xFF);
+    out8(0x42, (count >> 8) & 0xFF);
+
+    // The count starts on the rising edge of the gate.
+    uint8_t gate = in8(0x61);
+    out8(0x61, gate & ~0x01);
+    out8(0x61, gate | 0x01);
+
+    uint64_t start = rdtsc();
+
+    while ((in8(0x61) & 0x20) == 0)
+    {
+    }
+
+    return (rdtsc() - start) / CALIBRATION_MILLISECONDS;
+}
+
+// More precise than the PIT, and not reached through slow port accesses.
+static uint64_t tsc_measure_ticks_per_millisecond_against_hpet()
+{
+    uint32_t count = hpet_ticks_per_millisecond() * CALIBRATION_MILLISECONDS;
+    uint32_t start = hpet_counter();
+
+    uint64_t start_tsc = rdtsc();
+
+    while (hpet_counter() - start < count)
+    {
+        asm volatile("pause");
+    }
+
+    return (rdtsc() - start_tsc) / CALIBRATION_MILLISECONDS;
+}
+
+void tsc_initialize()
+{
+    // The shortest of a few runs, the others were stretched by the host.
+    for (size_t i = 0; i < 3; i++)
+    {
+        uint64_t measured = hpet_available()
+                                ? tsc_measure_ticks_per_millisecond_against_hpet()
+                                : tsc_measure_ticks_per_millisecond();
+
+        if (_ticks_per_millisecond == 0 || measured < _ticks_per_millisecond)
+        {
+            _ticks_per_millisecond = measured;
+        }
+    }
+
+    logger_info("TSC running at %uMHz, measured against the %s", (uint32_t)(_ticks_per_millisecond / 1000), hpet_available() ? "HPET" : "PIT");
+}
+
+uint64_t tsc_to_nanoseconds(uint64_t ticks)
+{
+    if (_ticks_per_millisecond == 0)
+    {
+        return 0;
+    }
+
+    // In two parts, ticks * 1000000 would overflow after a few hours.
+    return ticks / _ticks_per_millisecond * 1000000 +
+           ticks % _ticks_per_millisecond * 1000000 / _ticks_per_millisecond;
+}
+
+void tsc_delay(uint64_t microseconds)
+{
+    uint64_t end = rdtsc() + _ticks_per_millisecond * microseconds / 1000;
+
+    while (rdtsc() < end)
+    {
+        asm volatile("pause");
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+static inline uint64_t rdtsc()
+{
+    uint32_t low;
+    uint32_t high;
+
+    asm volatile("rdtsc"
+                 : "=a"(low), "=d"(high));
+
+    return ((uint64_t)high << 32) | low;
+}
+
+// Measures the frequency of the TSC against the HPET if it was found, or
+// the PIT. The TSC can be read before that but its ticks can't be
+// converted to a duration.
+void tsc_initialize();
+
+uint64_t tsc_to_nanoseconds(uint64_t ticks);
+
+// Spins for at least this long, for hardware which wants to be given time.
+void tsc_delay(uint64_t microseconds);
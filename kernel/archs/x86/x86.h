@@ -53,3 +53,30 @@ static inline void cli() { asm volatile("cli"); }
 static inline void sti() { asm volatile("sti"); }
 
 static inline void hlt() { asm volatile("hlt"); }
+
+static inline void pause() { asm volatile("pause"); }
+
+#define EFLAGS_INTERRUPT_ENABLE (1 << 9)
+
+static inline bool interrupts_enabled()
+{
+    uintptr_t flags;
+    asm volatile("pushf\n"
+                 "pop %0"
+                 : "=r"(flags));
+    return flags & EFLAGS_INTERRUPT_ENABLE;
+}
+
+static inline void rdmsr(uint32_t msr, uint32_t *lo, uint32_t *hi)
+{
+    asm volatile("rdmsr"
+                 : "=a"(*lo), "=d"(*hi)
+                 : "c"(msr));
+}
+
+static inline void wrmsr(uint32_t msr, uint32_t lo, uint32_t hi)
+{
+    asm volatile("wrmsr"
+                 :
+                 : "a"(lo), "d"(hi), "c"(msr));
+}
@@ -3,7 +3,13 @@
 #include <libsystem/Common.h>
 #include <libsystem/Logger.h>
 
-#define GDT_ENTRY_COUNT 6
+#include "kernel/scheduling/Cpu.h"
+
+// The code and data segments, then the task state segment of each processor.
+#define GDT_SEGMENT_COUNT 5
+#define GDT_ENTRY_COUNT (GDT_SEGMENT_COUNT + CPU_MAX)
+
+#define GDT_TSS_SELECTOR(__cpu) ((GDT_SEGMENT_COUNT + (__cpu)) * sizeof(GDTEntry))
 
 #define GDT_PRESENT 0b10010000     // Present bit. This must be 1 for all valid selectors.
 #define GDT_TSS_PRESENT 0b10000000 // Present bit. This must be 1 for all valid selectors.
@@ -99,6 +105,9 @@ struct PACKED GDTEntry
 
 void gdt_initialize();
 
+// Loads the table on another processor, with its own task state segment.
+void gdt_load(int cpu);
+
 extern "C" void gdt_flush(uint32_t);
 
 extern "C" void tss_flush(uint32_t);
@@ -20,13 +20,18 @@ void idt_initialize()
     idt[3] = IDT_ENTRY(__interrupt_vector[3], 0x08, TRAPGATE);
     idt[4] = IDT_ENTRY(__interrupt_vector[4], 0x08, TRAPGATE);
 
-    for (int i = 5; i < 48; i++)
+    for (int i = 5; i < 64; i++)
     {
         idt[i] = IDT_ENTRY(__interrupt_vector[i], 0x08, INTGATE);
     }
 
-    idt[127] = IDT_ENTRY(__interrupt_vector[48], 0x08, INTGATE);
-    idt[128] = IDT_ENTRY(__interrupt_vector[49], 0x08, INTGATE | IDT_USER);
+    for (int i = 124; i < 127; i++)
+    {
+        idt[i] = IDT_ENTRY(__interrupt_vector[64 + i - 124], 0x08, INTGATE);
+    }
+
+    idt[127] = IDT_ENTRY(__interrupt_vector[67], 0x08, INTGATE);
+    idt[128] = IDT_ENTRY(__interrupt_vector[68], 0x08, INTGATE | IDT_USER);
 
     idt_flush((uint32_t)&idt_descriptor);
 }
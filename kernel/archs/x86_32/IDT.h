@@ -34,6 +34,8 @@ struct PACKED IDTEntry
         .offset16_31 = (uint16_t)(((__offset) >> 16) & 0xffff), \
     }
 
+extern IDTDescriptor idt_descriptor;
+
 extern "C" void idt_flush(uint32_t);
 
 void idt_initialize();
@@ -7,8 +7,12 @@
 #include "kernel/system/System.h"
 #include "kernel/tasking/Syscalls.h"
 
+#include "archs/x86/FPU.h"
+#include "archs/x86/LAPIC.h"
 #include "archs/x86/PIC.h"
+#include "archs/x86/SMP.h"
 #include "archs/x86_32/Interrupts.h"
+#include "archs/x86_32/Syscall.h"
 #include "archs/x86_32/x86_32.h"
 
 static const char *_exception_messages[32] = {
@@ -50,7 +54,12 @@ extern "C" uint32_t interrupts_handler(uintptr_t esp, InterruptStackFrame stackf
 {
     ASSERT_INTERRUPTS_NOT_RETAINED();
 
-    if (stackframe.intno < 32)
+    if (stackframe.intno == 7)
+    {
+        // The task used the FPU since it was switched to.
+        fpu_handle_unavailable();
+    }
+    else if (stackframe.intno < 32)
     {
         if (stackframe.cs == 0x1B)
         {
@@ -80,70 +89,82 @@ extern "C" uint32_t interrupts_handler(uintptr_t esp, InterruptStackFrame stackf
                 stackframe.err);
         }
     }
-    else if (stackframe.intno < 48)
+    else if (stackframe.intno < 32 + DISPATCHER_IRQ_COUNT)
     {
         interrupts_disable_holding();
+        interrupts_lock();
 
         int irq = stackframe.intno - 32;
 
         if (irq == 0)
         {
-            system_tick();
             esp = schedule(esp);
         }
-        else
+        else if (dispatcher_dispatch(irq))
         {
-            dispatcher_dispatch(irq);
+            // The worker handles it now, not at the next tick.
+            esp = schedule(esp);
         }
 
+        interrupts_unlock();
         interrupts_enable_holding();
     }
-    else if (stackframe.intno == 127)
+    else if (stackframe.intno == SMP_TLB_SHOOTDOWN_VECTOR)
+    {
+        // The processor which asked holds the kernel lock while it waits.
+        smp_handle_requests();
+    }
+    else if (stackframe.intno == LAPIC_TIMER_VECTOR ||
+             stackframe.intno == SMP_RESCHEDULE_VECTOR ||
+             stackframe.intno == 127)
     {
         interrupts_disable_holding();
+        interrupts_lock();
 
         esp = schedule(esp);
 
+        interrupts_unlock();
         interrupts_enable_holding();
     }
     else if (stackframe.intno == 128)
     {
         sti();
 
-        Syscall syscall = (Syscall)stackframe.eax;
-
-        if (syscall == HJ_PROCESS_CLONE)
-        {
-            InterruptsRetainer retainer;
-
-            auto usf = ((UserInterruptStackFrame *)&stackframe);
-
-            *((int *)stackframe.ebx) = 0;
-
-            auto child = task_clone(scheduler_running(), usf->user_esp, usf->eip, usf->ecx | TASK_USER);
-
-            *((int *)stackframe.ebx) = child->id;
+        auto usf = ((UserInterruptStackFrame *)&stackframe);
 
-            stackframe.eax = SUCCESS;
-        }
-        else
-        {
-            stackframe.eax = task_do_syscall((Syscall)stackframe.eax, stackframe.ebx, stackframe.ecx, stackframe.edx, stackframe.esi, stackframe.edi);
-        }
+        uint32_t user_esp = usf->user_esp;
+        uint32_t user_eip = usf->eip;
 
-        if (stackframe.eax == SUCCESS && syscall == HJ_PROCESS_EXEC)
-        {
-            Task *running_task = scheduler_running();
+        stackframe.eax = syscall_dispatch(
+            (Syscall)stackframe.eax,
+            stackframe.ebx,
+            stackframe.ecx,
+            stackframe.edx,
+            stackframe.esi,
+            stackframe.edi,
+            user_esp,
+            user_eip);
 
-            auto usf = ((UserInterruptStackFrame *)&stackframe);
-            usf->user_esp = running_task->user_stack_pointer;
-            usf->eip = (uintptr_t)running_task->entry_point;
-        }
+        usf->user_esp = user_esp;
+        usf->eip = user_eip;
 
         cli();
     }
 
-    pic_ack(stackframe.intno);
+    if (stackframe.intno >= 32 + DISPATCHER_MSI_FIRST && stackframe.intno < 32 + DISPATCHER_IRQ_COUNT)
+    {
+        lapic_ack();
+    }
+    else if (stackframe.intno >= LAPIC_TIMER_VECTOR && stackframe.intno <= SMP_TLB_SHOOTDOWN_VECTOR)
+    {
+        lapic_ack();
+    }
+    else if (stackframe.intno >= 32 && stackframe.intno < 32 + DISPATCHER_MSI_FIRST)
+    {
+        // Not for the other interrupts, a processor would acknowledge the
+        // one the first processor is handling.
+        pic_ack(stackframe.intno);
+    }
 
     return esp;
 }
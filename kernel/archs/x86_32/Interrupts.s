@@ -23,6 +23,7 @@ __interrupt%1:
 %endmacro
 
 extern interrupts_handler
+extern scheduler_did_switch
 
 __interrupt_common:
     cld
@@ -41,11 +42,20 @@ __interrupt_common:
     mov fs, ax
     mov gs, ax
 
+    mov ebx, esp
     push esp
 
     call interrupts_handler
 
+    ; The stack is another one if we switched to another task, the one we
+    ; left can run on another processor once we are off its stack.
+    cmp eax, ebx
     mov esp, eax
+    je .same_task
+
+    call scheduler_did_switch
+
+.same_task:
 
     pop gs
     pop fs
@@ -108,6 +118,29 @@ INTERRUPT_NOERR 45
 INTERRUPT_NOERR 46
 INTERRUPT_NOERR 47
 
+; The MSIs of PCI devices
+INTERRUPT_NOERR 48
+INTERRUPT_NOERR 49
+INTERRUPT_NOERR 50
+INTERRUPT_NOERR 51
+INTERRUPT_NOERR 52
+INTERRUPT_NOERR 53
+INTERRUPT_NOERR 54
+INTERRUPT_NOERR 55
+INTERRUPT_NOERR 56
+INTERRUPT_NOERR 57
+INTERRUPT_NOERR 58
+INTERRUPT_NOERR 59
+INTERRUPT_NOERR 60
+INTERRUPT_NOERR 61
+INTERRUPT_NOERR 62
+INTERRUPT_NOERR 63
+
+; The timer of the other processors and what they ask each other
+INTERRUPT_NOERR 124
+INTERRUPT_NOERR 125
+INTERRUPT_NOERR 126
+
 INTERRUPT_NOERR 127
 INTERRUPT_SYSCALL 128
 
@@ -164,5 +197,26 @@ __interrupt_vector:
     INTERRUPT_NAME 46
     INTERRUPT_NAME 47
 
+    INTERRUPT_NAME 48
+    INTERRUPT_NAME 49
+    INTERRUPT_NAME 50
+    INTERRUPT_NAME 51
+    INTERRUPT_NAME 52
+    INTERRUPT_NAME 53
+    INTERRUPT_NAME 54
+    INTERRUPT_NAME 55
+    INTERRUPT_NAME 56
+    INTERRUPT_NAME 57
+    INTERRUPT_NAME 58
+    INTERRUPT_NAME 59
+    INTERRUPT_NAME 60
+    INTERRUPT_NAME 61
+    INTERRUPT_NAME 62
+    INTERRUPT_NAME 63
+
+    INTERRUPT_NAME 124
+    INTERRUPT_NAME 125
+    INTERRUPT_NAME 126
+
     INTERRUPT_NAME 127
     INTERRUPT_NAME 128
@@ -7,6 +7,13 @@
 #define PAGE_DIRECTORY_INDEX(vaddr) ((vaddr) >> 22)
 #define PAGE_TABLE_INDEX(vaddr) (((vaddr) >> 12) & 0x03ff)
 
+// The first gigabyte is the kernel's, its page tables are shared by every
+// address space.
+#define KERNEL_VIRTUAL_END (0x40000000)
+
+// With CR4.PSE, a page directory entry can map one.
+#define LARGE_PAGE_SIZE (4 * 1024 * 1024)
+
 #define PAGE_TABLE_ENTRY_COUNT 1024
 #define PAGE_DIRECTORY_ENTRY_COUNT 1024
 
@@ -22,7 +29,8 @@ union PACKED PageTableEntry
         bool Accessed : 1;
         bool Dirty : 1;
         bool Pat : 1;
-        uint32_t Ignored : 4;
+        bool Global : 1;
+        uint32_t Ignored : 3;
         uint32_t PageFrameNumber : 20;
     };
 
@@ -62,5 +70,3 @@ extern "C" void paging_enable();
 extern "C" void paging_disable();
 
 extern "C" void paging_load_directory(uintptr_t directory);
-
-extern "C" void paging_invalidate_tlb();
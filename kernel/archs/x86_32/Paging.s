@@ -19,9 +19,3 @@ paging_load_directory:
     mov eax, [esp + 4]
     mov cr3, eax
     ret
-
-global paging_invalidate_tlb
-paging_invalidate_tlb:
-    mov eax, cr3
-    mov cr3, eax
-    ret
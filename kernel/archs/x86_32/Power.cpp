@@ -2,9 +2,9 @@
 
 #include "archs/Arch.h"
 
+#include "archs/x86/ACPI.h"
 #include "archs/x86/IOPort.h"
 #include "archs/x86/x86.h"
-#include "archs/x86_32/ACPI.h"
 #include "archs/x86_32/Power.h"
 
 namespace x86
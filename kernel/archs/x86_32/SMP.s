@@ -0,0 +1,70 @@
+;; --- Processors startup --------------------------------------------------- ;;
+
+; Copied below the first megabyte, where the startup IPI starts the other
+; processors in real mode. It switches to protected mode with its own table,
+; enables paging with the kernel address space and jumps into the kernel.
+
+SMP_TRAMPOLINE equ 0x8000
+
+%define TRAMPOLINE(__label) (__label - smp_trampoline_start + SMP_TRAMPOLINE)
+
+extern smp_ap_main
+extern smp_ap_page_directory
+extern smp_ap_stack
+
+section .text
+
+bits 16
+global smp_trampoline_start
+smp_trampoline_start:
+    cli
+    cld
+
+    xor ax, ax
+    mov ds, ax
+
+    lgdt [TRAMPOLINE(smp_trampoline_gdt_descriptor)]
+
+    mov eax, cr0
+    or eax, 1
+    mov cr0, eax
+
+    jmp dword 0x08:TRAMPOLINE(smp_trampoline_protected_mode)
+
+bits 32
+smp_trampoline_protected_mode:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    mov eax, [smp_ap_page_directory]
+    mov cr3, eax
+
+    mov eax, cr0
+    or eax, 0x80000000
+    mov cr0, eax
+
+    mov esp, [smp_ap_stack]
+
+    mov eax, smp_ap_main
+    call eax
+
+.hang:
+    cli
+    hlt
+    jmp .hang
+
+smp_trampoline_gdt:
+    dq 0x0000000000000000
+    dq 0x00CF9A000000FFFF
+    dq 0x00CF92000000FFFF
+
+smp_trampoline_gdt_descriptor:
+    dw smp_trampoline_gdt_descriptor - smp_trampoline_gdt - 1
+    dd TRAMPOLINE(smp_trampoline_gdt)
+
+global smp_trampoline_end
+smp_trampoline_end:
@@ -0,0 +1,90 @@
+#include <libsystem/Logger.h>
+
+#include "archs/x86/CPUID.h"
+#include "archs/x86/x86.h"
+#include "archs/x86_32/Syscall.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/tasking/Syscalls.h"
+
+#define MSR_SYSENTER_CS 0x174
+#define MSR_SYSENTER_ESP 0x175
+#define MSR_SYSENTER_EIP 0x176
+
+extern "C" void syscall_entry();
+
+static bool _sysenter = false;
+
+void syscall_initialize()
+{
+    if (!cpuid().SEP)
+    {
+        logger_info("SYSENTER is not supported, using int $0x80");
+        return;
+    }
+
+    // SYSEXIT returns to the segments 16 and 24 bytes after this one.
+    wrmsr(MSR_SYSENTER_CS, 0x08, 0);
+    wrmsr(MSR_SYSENTER_EIP, (uintptr_t)syscall_entry, 0);
+
+    _sysenter = true;
+}
+
+void syscall_set_kernel_stack(uint32_t stack)
+{
+    if (_sysenter)
+    {
+        wrmsr(MSR_SYSENTER_ESP, stack, 0);
+    }
+}
+
+uint32_t syscall_dispatch(Syscall syscall, uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4, uint32_t p5, uint32_t &user_esp, uint32_t &user_eip)
+{
+    if (syscall == HJ_PROCESS_CLONE)
+    {
+        if (!syscall_validate_ptr(p1, sizeof(int)))
+        {
+            return ERR_BAD_ADDRESS;
+        }
+
+        InterruptsRetainer retainer;
+
+        // The child starts where the parent returns, with a zero pid.
+        *((int *)p1) = 0;
+
+        auto child = task_clone(scheduler_running(), user_esp, user_eip, p2 | TASK_USER);
+
+        *((int *)p1) = child->id;
+
+        return SUCCESS;
+    }
+
+    uint32_t result = task_do_syscall(syscall, p1, p2, p3, p4, p5);
+
+    if (result == SUCCESS && syscall == HJ_PROCESS_EXEC)
+    {
+        Task *running_task = scheduler_running();
+
+        user_esp = running_task->user_stack_pointer;
+        user_eip = (uintptr_t)running_task->entry_point;
+    }
+
+    return result;
+}
+
+extern "C" void syscall_handler(SyscallFrame *frame)
+{
+    sti();
+
+    uint32_t p3 = 0;
+
+    if (syscall_validate_ptr(frame->esp, sizeof(uint32_t)))
+    {
+        p3 = *reinterpret_cast<uint32_t *>(frame->esp);
+    }
+
+    frame->eax = syscall_dispatch((Syscall)frame->eax, frame->ebx, frame->ebp, p3, frame->esi, frame->edi, frame->esp, frame->eip);
+
+    cli();
+}
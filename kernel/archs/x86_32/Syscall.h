@@ -0,0 +1,26 @@
+#pragma once
+
+#include <abi/Syscalls.h>
+
+// What the SYSENTER entry leaves on the kernel stack. The userspace stub
+// passes the second argument in EBP and pushes the third one on its stack,
+// ECX and EDX hold where SYSEXIT returns to.
+struct SyscallFrame
+{
+    uint32_t eax;
+    uint32_t ebx;
+    uint32_t esi;
+    uint32_t edi;
+    uint32_t ebp;
+    uint32_t eip;
+    uint32_t esp;
+};
+
+void syscall_initialize();
+
+// SYSENTER doesn't go through the TSS, the stack is set for each task.
+void syscall_set_kernel_stack(uint32_t stack);
+
+// Shared by "int $0x80" and SYSENTER, cloning and exec need where the
+// task returns to in userspace.
+uint32_t syscall_dispatch(Syscall syscall, uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4, uint32_t p5, uint32_t &user_esp, uint32_t &user_eip);
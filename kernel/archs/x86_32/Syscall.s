@@ -0,0 +1,42 @@
+;; --- SYSENTER ------------------------------------------------------------- ;;
+
+; Interrupts are disabled and we are on the kernel stack of the task, see
+; SyscallFrame for the registers we get from userspace.
+
+extern syscall_handler
+
+global syscall_entry
+syscall_entry:
+    cld
+
+    push ecx ; where SYSEXIT returns to
+    push edx
+    push ebp ; the arguments
+    push edi
+    push esi
+    push ebx
+    push eax
+
+    mov cx, 0x10
+    mov ds, cx
+    mov es, cx
+
+    push esp
+    call syscall_handler
+    add esp, 4
+
+    mov cx, 0x23
+    mov ds, cx
+    mov es, cx
+
+    pop eax
+    pop ebx
+    pop esi
+    pop edi
+    pop ebp
+    pop edx
+    pop ecx
+
+    ; Interrupts are enabled after the next instruction.
+    sti
+    sysexit
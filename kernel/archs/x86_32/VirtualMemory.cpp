@@ -4,16 +4,44 @@
 #include <libutils/ResultOr.h>
 
 #include "archs/Arch.h"
+#include "archs/x86/CPUID.h"
+#include "archs/x86/SMP.h"
+#include "archs/x86/TLB.h"
+#include "archs/x86/x86.h"
 #include "archs/x86_32/Paging.h"
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/memory/Memory.h"
 #include "kernel/memory/Physical.h"
+#include "kernel/scheduling/Cpu.h"
 #include "kernel/system/System.h"
 
 PageDirectory _kernel_page_directory ALIGNED(ARCH_PAGE_SIZE) = {};
 PageTable _kernel_page_tables[256] ALIGNED(ARCH_PAGE_SIZE) = {};
 
+#define CR4_PAGE_SIZE_EXTENSION (1 << 4)
+
+// The one each processor has loaded.
+static void *_loaded_address_space[CPU_MAX] = {};
+
+// The page directory entries of the kernel are copied in every address
+// space, so large pages are only used above it.
+static bool _large_pages = false;
+
+static void virtual_invalidate(void *address_space, MemoryRange range)
+{
+    bool global = range.base() < KERNEL_VIRTUAL_END;
+
+    // The other address spaces are flushed when they are loaded.
+    if (global || address_space == _loaded_address_space[arch_current_cpu()])
+    {
+        tlb_invalidate(range, global);
+    }
+
+    // Another processor may have it loaded.
+    smp_tlb_shootdown();
+}
+
 void arch_virtual_initialize()
 {
     // Setup the kernel pagedirectory.
@@ -30,6 +58,25 @@ void arch_virtual_initialize()
 void arch_virtual_memory_enable()
 {
     paging_enable();
+    tlb_initialize();
+
+    if (cpuid_get_feature_EDX() & CPUID_FEAT_EDX_PSE)
+    {
+        asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_PAGE_SIZE_EXTENSION));
+        _large_pages = true;
+    }
+}
+
+void arch_virtual_memory_enable_ap()
+{
+    tlb_initialize();
+
+    if (_large_pages)
+    {
+        asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_PAGE_SIZE_EXTENSION));
+    }
+
+    _loaded_address_space[arch_current_cpu()] = arch_kernel_address_space();
 }
 
 void *arch_kernel_address_space()
@@ -46,9 +93,9 @@ bool arch_virtual_present(void *address_space, uintptr_t virtual_address)
     int page_directory_index = PAGE_DIRECTORY_INDEX(virtual_address);
     PageDirectoryEntry &page_directory_entry = page_directory->entries[page_directory_index];
 
-    if (!page_directory_entry.Present)
+    if (!page_directory_entry.Present || page_directory_entry.LargePage)
     {
-        return false;
+        return page_directory_entry.Present;
     }
 
     PageTable &page_table = *reinterpret_cast<PageTable *>(page_directory_entry.PageFrameNumber * ARCH_PAGE_SIZE);
@@ -73,6 +120,11 @@ uintptr_t arch_virtual_to_physical(void *address_space, uintptr_t virtual_addres
         return 0;
     }
 
+    if (page_directory_entry.LargePage)
+    {
+        return (page_directory_entry.PageFrameNumber * ARCH_PAGE_SIZE) + (virtual_address % LARGE_PAGE_SIZE);
+    }
+
     PageTable &page_table = *reinterpret_cast<PageTable *>(page_directory_entry.PageFrameNumber * ARCH_PAGE_SIZE);
 
     int page_table_index = PAGE_TABLE_INDEX(virtual_address);
@@ -86,18 +138,101 @@ uintptr_t arch_virtual_to_physical(void *address_space, uintptr_t virtual_addres
     return (page_table_entry.PageFrameNumber * ARCH_PAGE_SIZE) + (virtual_address & 0xfff);
 }
 
+// Breaks a large page into small ones, so part of it can be changed.
+static Result split_large_page(PageDirectory *page_directory, PageDirectoryEntry &page_directory_entry)
+{
+    PageTable *page_table;
+    TRY(memory_alloc_identity(page_directory, MEMORY_CLEAR, (uintptr_t *)&page_table));
+
+    for (size_t i = 0; i < PAGE_TABLE_ENTRY_COUNT; i++)
+    {
+        PageTableEntry &page_table_entry = page_table->entries[i];
+
+        page_table_entry.Present = 1;
+        page_table_entry.Write = page_directory_entry.Write;
+        page_table_entry.User = page_directory_entry.User;
+        page_table_entry.PageFrameNumber = page_directory_entry.PageFrameNumber + i;
+    }
+
+    page_directory_entry.as_uint = 0;
+    page_directory_entry.Present = 1;
+    page_directory_entry.Write = 1;
+    page_directory_entry.User = 1;
+    page_directory_entry.PageFrameNumber = (uint32_t)(page_table) >> 12;
+
+    return SUCCESS;
+}
+
+// The small pages of a page directory entry are replaced by a large one,
+// their table can go once nothing uses it anymore.
+static void free_small_pages(void *address_space, uintptr_t address, PageDirectoryEntry &page_directory_entry)
+{
+    bool had_table = page_directory_entry.Present && !page_directory_entry.LargePage;
+    auto page_table = reinterpret_cast<PageTable *>(page_directory_entry.PageFrameNumber * ARCH_PAGE_SIZE);
+
+    page_directory_entry.as_uint = 0;
+
+    if (!had_table)
+    {
+        return;
+    }
+
+    bool had_pages = false;
+
+    for (size_t i = 0; i < PAGE_TABLE_ENTRY_COUNT; i++)
+    {
+        had_pages |= page_table->entries[i].Present;
+    }
+
+    // Without pages only the table can be cached, a single invlpg drops
+    // every cached table.
+    size_t size = had_pages ? LARGE_PAGE_SIZE : ARCH_PAGE_SIZE;
+    virtual_invalidate(address_space, {address, size});
+    memory_free(arch_kernel_address_space(), {(uintptr_t)page_table, sizeof(PageTable)});
+}
+
 Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr_t virtual_address, MemoryFlags flags)
 {
     ASSERT_INTERRUPTS_RETAINED();
 
     auto page_directory = reinterpret_cast<PageDirectory *>(address_space);
 
-    for (size_t i = 0; i < physical_range.size() / ARCH_PAGE_SIZE; i++)
+    bool remapped = false;
+
+    size_t offset = 0;
+
+    while (offset < physical_range.size())
     {
-        size_t offset = i * ARCH_PAGE_SIZE;
+        uintptr_t address = virtual_address + offset;
+        uintptr_t physical_address = physical_range.base() + offset;
 
-        int page_directory_index = PAGE_DIRECTORY_INDEX(virtual_address + offset);
+        int page_directory_index = PAGE_DIRECTORY_INDEX(address);
         PageDirectoryEntry &page_directory_entry = page_directory->entries[page_directory_index];
+
+        if (_large_pages &&
+            address >= KERNEL_VIRTUAL_END &&
+            address % LARGE_PAGE_SIZE == 0 &&
+            physical_address % LARGE_PAGE_SIZE == 0 &&
+            physical_range.size() - offset >= LARGE_PAGE_SIZE)
+        {
+            remapped |= page_directory_entry.Present && page_directory_entry.LargePage;
+            free_small_pages(address_space, address, page_directory_entry);
+
+            page_directory_entry.Present = 1;
+            page_directory_entry.Write = 1;
+            page_directory_entry.User = flags & MEMORY_USER;
+            page_directory_entry.LargePage = 1;
+            page_directory_entry.PageFrameNumber = physical_address >> 12;
+
+            offset += LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        if (page_directory_entry.Present && page_directory_entry.LargePage)
+        {
+            TRY(split_large_page(page_directory, page_directory_entry));
+        }
+
         PageTable *page_table = reinterpret_cast<PageTable *>(page_directory_entry.PageFrameNumber * ARCH_PAGE_SIZE);
 
         if (!page_directory_entry.Present)
@@ -110,16 +245,25 @@ Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr
             page_directory_entry.PageFrameNumber = (uint32_t)(page_table) >> 12;
         }
 
-        int page_table_index = PAGE_TABLE_INDEX(virtual_address + offset);
+        int page_table_index = PAGE_TABLE_INDEX(address);
         PageTableEntry &page_table_entry = page_table->entries[page_table_index];
 
+        // Pages which were not present can't be in the TLB.
+        remapped |= page_table_entry.Present;
+
         page_table_entry.Present = 1;
         page_table_entry.Write = 1;
         page_table_entry.User = flags & MEMORY_USER;
-        page_table_entry.PageFrameNumber = (physical_range.base() + offset) >> 12;
+        page_table_entry.Global = address < KERNEL_VIRTUAL_END;
+        page_table_entry.PageFrameNumber = physical_address >> 12;
+
+        offset += ARCH_PAGE_SIZE;
     }
 
-    paging_invalidate_tlb();
+    if (remapped)
+    {
+        virtual_invalidate(address_space, (MemoryRange){virtual_address, physical_range.size()});
+    }
 
     return SUCCESS;
 }
@@ -169,11 +313,11 @@ void arch_virtual_free(void *address_space, MemoryRange virtual_range)
 
     auto page_directory = reinterpret_cast<PageDirectory *>(address_space);
 
-    for (size_t i = 0; i < virtual_range.size() / ARCH_PAGE_SIZE; i++)
+    for (size_t offset = 0; offset < virtual_range.size(); offset += ARCH_PAGE_SIZE)
     {
-        size_t offset = i * ARCH_PAGE_SIZE;
+        uintptr_t address = virtual_range.base() + offset;
 
-        size_t page_directory_index = PAGE_DIRECTORY_INDEX(virtual_range.base() + offset);
+        size_t page_directory_index = PAGE_DIRECTORY_INDEX(address);
         PageDirectoryEntry *page_directory_entry = &page_directory->entries[page_directory_index];
 
         if (!page_directory_entry->Present)
@@ -181,9 +325,25 @@ void arch_virtual_free(void *address_space, MemoryRange virtual_range)
             continue;
         }
 
+        if (page_directory_entry->LargePage)
+        {
+            if (address % LARGE_PAGE_SIZE == 0 && virtual_range.size() - offset >= LARGE_PAGE_SIZE)
+            {
+                page_directory_entry->as_uint = 0;
+                offset += LARGE_PAGE_SIZE - ARCH_PAGE_SIZE;
+                continue;
+            }
+
+            if (split_large_page(page_directory, *page_directory_entry) != SUCCESS)
+            {
+                logger_error("Failed to unmap part of a large page at %p", address);
+                continue;
+            }
+        }
+
         PageTable *page_table = (PageTable *)(page_directory_entry->PageFrameNumber * ARCH_PAGE_SIZE);
 
-        size_t page_table_index = PAGE_TABLE_INDEX(virtual_range.base() + offset);
+        size_t page_table_index = PAGE_TABLE_INDEX(address);
         PageTableEntry *page_table_entry = &page_table->entries[page_table_index];
 
         if (page_table_entry->Present)
@@ -192,7 +352,18 @@ void arch_virtual_free(void *address_space, MemoryRange virtual_range)
         }
     }
 
-    paging_invalidate_tlb();
+    virtual_invalidate(address_space, virtual_range);
+}
+
+MemoryRange arch_virtual_user_range()
+{
+    // Up to the last page, so the end doesn't overflow.
+    return {KERNEL_VIRTUAL_END, 0xfffff000 - KERNEL_VIRTUAL_END};
+}
+
+size_t arch_virtual_alignment(size_t size)
+{
+    return _large_pages && size >= LARGE_PAGE_SIZE ? LARGE_PAGE_SIZE : ARCH_PAGE_SIZE;
 }
 
 void *arch_address_space_create()
@@ -230,13 +401,23 @@ void arch_address_space_destroy(void *address_space)
 
     assert(address_space != arch_kernel_address_space());
 
+    // Its translations would be left in the TLB for the next one at this address.
+    if (address_space == _loaded_address_space[arch_current_cpu()])
+    {
+        arch_address_space_switch(arch_kernel_address_space());
+    }
+
     auto page_directory = reinterpret_cast<PageDirectory *>(address_space);
 
     for (size_t i = 256; i < 1024; i++)
     {
         PageDirectoryEntry *page_directory_entry = &page_directory->entries[i];
 
-        if (page_directory_entry->Present)
+        if (page_directory_entry->Present && page_directory_entry->LargePage)
+        {
+            physical_free({(uintptr_t)page_directory_entry->PageFrameNumber * ARCH_PAGE_SIZE, LARGE_PAGE_SIZE});
+        }
+        else if (page_directory_entry->Present)
         {
             PageTable *page_table = (PageTable *)(page_directory_entry->PageFrameNumber * ARCH_PAGE_SIZE);
 
@@ -264,5 +445,13 @@ void arch_address_space_destroy(void *address_space)
 void arch_address_space_switch(void *address_space)
 {
     InterruptsRetainer retainer;
+
+    // Loading CR3 flushes the TLB, the threads of a process share theirs.
+    if (address_space == _loaded_address_space[arch_current_cpu()])
+    {
+        return;
+    }
+
+    _loaded_address_space[arch_current_cpu()] = address_space;
     paging_load_directory(arch_virtual_to_physical(arch_kernel_address_space(), (uintptr_t)address_space));
 }
@@ -2,18 +2,21 @@
 #include <libsystem/core/Plugs.h>
 
 #include "archs/Arch.h"
+#include "archs/x86/ACPI.h"
 #include "archs/x86/COM.h"
 #include "archs/x86/CPUID.h"
 #include "archs/x86/FPU.h"
+#include "archs/x86/LAPIC.h"
 #include "archs/x86/PIC.h"
 #include "archs/x86/PIT.h"
 #include "archs/x86/RTC.h"
-#include "archs/x86_32/ACPI.h"
+#include "archs/x86/SMP.h"
+#include "archs/x86/TSC.h"
 #include "archs/x86_32/GDT.h"
 #include "archs/x86_32/IDT.h"
 #include "archs/x86_32/Interrupts.h"
-#include "archs/x86_32/LAPIC.h"
 #include "archs/x86_32/Power.h"
+#include "archs/x86_32/Syscall.h"
 #include "archs/x86_32/x86_32.h"
 
 #include "kernel/firmware/SMBIOS.h"
@@ -25,6 +28,8 @@ void arch_disable_interrupts() { cli(); }
 
 void arch_enable_interrupts() { sti(); }
 
+bool arch_interrupts_enabled() { return interrupts_enabled(); }
+
 void arch_halt() { hlt(); }
 
 void arch_yield() { asm("int $127"); }
@@ -36,8 +41,9 @@ void arch_save_context(Task *task)
 
 void arch_load_context(Task *task)
 {
-    fpu_load_context(task);
+    fpu_switch_context(task);
     set_kernel_stack((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
+    syscall_set_kernel_stack((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
 }
 
 void arch_task_go(Task *task)
@@ -81,10 +87,69 @@ void arch_task_go(Task *task)
     }
 }
 
+void arch_task_destroy(Task *task)
+{
+    fpu_release_context(task);
+}
+
 size_t arch_debug_write(const void *buffer, size_t size) { return com_write(COM1, buffer, size); }
 
 TimeStamp arch_get_time() { return rtc_now(); }
 
+uint64_t arch_get_clock() { return rdtsc(); }
+
+uint64_t arch_clock_to_nanoseconds(uint64_t ticks) { return tsc_to_nanoseconds(ticks); }
+
+void arch_timer_oneshot(uint64_t nanoseconds)
+{
+    // The interrupts of the PIT only go to the first processor.
+    if (arch_current_cpu() == 0)
+    {
+        pit_oneshot(nanoseconds);
+    }
+    else
+    {
+        lapic_timer_oneshot(nanoseconds);
+    }
+}
+
+void arch_start_cpus() { smp_initialize(); }
+
+void smp_ap_initialize(Cpu *cpu)
+{
+    gdt_load(cpu->id);
+    idt_flush((uint32_t)&idt_descriptor);
+    syscall_initialize();
+}
+
+int arch_current_cpu() { return smp_current_cpu(); }
+
+void arch_pause()
+{
+    pause();
+    smp_handle_requests();
+}
+
+void arch_reschedule(int cpu) { smp_reschedule(cpu); }
+
+bool arch_msi_message(int irq, uint64_t *address, uint32_t *data)
+{
+    if (!lapic_available())
+    {
+        return false;
+    }
+
+    // Messages are only accepted once the local APIC is enabled.
+    lapic_map();
+    lapic_enable();
+
+    // To the boot processor, which handles the interrupts, edge triggered.
+    *address = LAPIC_MSI_ADDRESS | (lapic_id() << 12);
+    *data = 32 + irq;
+
+    return true;
+}
+
 extern "C" void arch_main(void *info, uint32_t magic)
 {
     __plug_initialize();
@@ -105,11 +170,14 @@ extern "C" void arch_main(void *info, uint32_t magic)
 
     gdt_initialize();
     idt_initialize();
+    syscall_initialize();
     pic_initialize();
     fpu_initialize();
-    pit_initialize(1000);
+    pit_initialize();
 
+    // The TSC is calibrated against the HPET, if ACPI tells us about one.
     acpi_initialize(handover);
+    tsc_initialize();
     //lapic_initialize();
     // smbios::EntryPoint *smbios_entrypoint = smbios::find({0xF0000, 65536});
     //
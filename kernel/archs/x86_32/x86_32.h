@@ -20,17 +20,3 @@ static inline uint32_t ESP()
                  : "=r"(r));
     return r;
 }
-
-static inline void rdmsr(uint32_t msr, uint32_t *lo, uint32_t *hi)
-{
-    asm volatile("rdmsr"
-                 : "=a"(*lo), "=d"(*hi)
-                 : "c"(msr));
-}
-
-static inline void wrmsr(uint32_t msr, uint32_t lo, uint32_t hi)
-{
-    asm volatile("wrmsr"
-                 :
-                 : "a"(lo), "d"(hi), "c"(msr));
-}
@@ -1,15 +1,11 @@
+#include "archs/Arch.h"
 #include "archs/x86_64/GDT.h"
 
-static TSS64 tss = {
-    .reserved = 0,
-    .rsp = {},
-    .reserved0 = 0,
-    .ist = {},
-    .reserved1 = 0,
-    .reserved2 = 0,
-    .reserved3 = 0,
-    .iopb_offset = 0,
-};
+static TSS64 tss[CPU_MAX] = {};
+
+static uint8_t nmi_stacks[CPU_MAX][IST_STACK_SIZE] ALIGNED(16) = {};
+static uint8_t double_fault_stacks[CPU_MAX][IST_STACK_SIZE] ALIGNED(16) = {};
+static uint8_t machine_check_stacks[CPU_MAX][IST_STACK_SIZE] ALIGNED(16) = {};
 
 static GDT64 gdt = {};
 
@@ -24,16 +20,32 @@ void gdt_initialize()
     gdt.entries[1] = {GDT_PRESENT | GDT_SEGMENT | GDT_READWRITE | GDT_EXECUTABLE, GDT_LONG_MODE_GRANULARITY};
     gdt.entries[2] = {GDT_PRESENT | GDT_SEGMENT | GDT_READWRITE, 0};
 
-    gdt.entries[3] = {GDT_PRESENT | GDT_SEGMENT | GDT_READWRITE | GDT_EXECUTABLE | GDT_USER, GDT_LONG_MODE_GRANULARITY};
-    gdt.entries[4] = {GDT_PRESENT | GDT_SEGMENT | GDT_READWRITE | GDT_USER, 0};
+    // SYSRET wants the user data segment right before the user code one.
+    gdt.entries[3] = {GDT_PRESENT | GDT_SEGMENT | GDT_READWRITE | GDT_USER, 0};
+    gdt.entries[4] = {GDT_PRESENT | GDT_SEGMENT | GDT_READWRITE | GDT_EXECUTABLE | GDT_USER, GDT_LONG_MODE_GRANULARITY};
 
-    gdt.tss = {(uintptr_t)&tss};
+    for (size_t i = 0; i < CPU_MAX; i++)
+    {
+        gdt.tss[i] = {(uintptr_t)&tss[i]};
 
+        tss[i].ist[IST_NMI - 1] = (uint64_t)&nmi_stacks[i][IST_STACK_SIZE];
+        tss[i].ist[IST_DOUBLE_FAULT - 1] = (uint64_t)&double_fault_stacks[i][IST_STACK_SIZE];
+        tss[i].ist[IST_MACHINE_CHECK - 1] = (uint64_t)&machine_check_stacks[i][IST_STACK_SIZE];
+    }
+
+    gdt_load(0);
+}
+
+void gdt_load(int cpu)
+{
     gdt_flush((uint64_t)&gdt_descriptor);
+    tss_flush(GDT_TSS_SELECTOR(cpu));
 }
 
 void set_kernel_stack(uint64_t stack)
 {
-    tss.rsp[0] = stack;
-    tss.ist[0] = stack;
+    TSS64 &current = tss[arch_current_cpu()];
+
+    current.rsp[0] = stack;
+    current.ist[0] = stack;
 }
@@ -3,8 +3,13 @@
 #include <libsystem/Common.h>
 #include <libsystem/Logger.h>
 
+#include "kernel/scheduling/Cpu.h"
+
 #define GDT_ENTRY_COUNT 5
 
+// A TSS for each processor after the segments, they take two entries.
+#define GDT_TSS_SELECTOR(__cpu) ((GDT_ENTRY_COUNT + (__cpu) * 2) * 8)
+
 #define GDT_SEGMENT (0b00010000)
 #define GDT_PRESENT (0b10000000)
 #define GDT_USER (0b01100000)
@@ -15,6 +20,19 @@
 
 #define GDT_FLAGS 0b1100
 
+#define GDT_USER_CODE_SELECTOR 0x23
+#define GDT_USER_DATA_SELECTOR 0x1B
+
+// Interrupts which can come while the stack can't be trusted get their own,
+// the numbers go in the IDT and start at 1. An NMI or a machine check can
+// come right after SYSCALL, still on the user stack, and a double fault
+// often comes from a kernel stack overflow.
+#define IST_NMI 2
+#define IST_DOUBLE_FAULT 3
+#define IST_MACHINE_CHECK 4
+
+#define IST_STACK_SIZE (4096 * 4)
+
 struct PACKED TSS64
 {
     uint32_t reserved;
@@ -107,6 +125,11 @@ struct PACKED GDTTSSEntry64
         base_upper32 = (addr >> 32) & 0xffffffff;
     }
 
+    constexpr GDTTSSEntry64()
+        : GDTTSSEntry64(0)
+    {
+    }
+
     constexpr GDTTSSEntry64(uintptr_t tss_address)
         : length(sizeof(TSS64)),
           base_low16(tss_address & 0xffff),
@@ -123,11 +146,14 @@ struct PACKED GDTTSSEntry64
 struct PACKED GDT64
 {
     GDTEntry64 entries[GDT_ENTRY_COUNT] = {};
-    GDTTSSEntry64 tss = {0};
+    GDTTSSEntry64 tss[CPU_MAX] = {};
 };
 
 void gdt_initialize();
 
+// Loads the table and the TSS of this processor.
+void gdt_load(int cpu);
+
 extern "C" void gdt_flush(uint64_t);
 
 extern "C" void tss_flush(uint64_t);
@@ -1,4 +1,5 @@
 
+#include "archs/x86_64/GDT.h"
 #include "archs/x86_64/IDT.h"
 
 extern uintptr_t __interrupt_vector[];
@@ -12,13 +13,22 @@ IDT64Descriptor idt_descriptor = {
 
 void idt_initialize()
 {
-    for (int i = 0; i < 48; i++)
+    for (int i = 0; i < 64; i++)
     {
         idt[i] = IDT64Entry(__interrupt_vector[i], 0, INTGATE);
     }
 
-    idt[127] = IDT64Entry(__interrupt_vector[48], 0, INTGATE);
-    idt[128] = IDT64Entry(__interrupt_vector[49], 0, INTGATE | IDT_USER);
+    idt[2] = IDT64Entry(__interrupt_vector[2], IST_NMI, INTGATE);
+    idt[8] = IDT64Entry(__interrupt_vector[8], IST_DOUBLE_FAULT, INTGATE);
+    idt[18] = IDT64Entry(__interrupt_vector[18], IST_MACHINE_CHECK, INTGATE);
+
+    for (int i = 124; i < 127; i++)
+    {
+        idt[i] = IDT64Entry(__interrupt_vector[64 + i - 124], 0, INTGATE);
+    }
+
+    idt[127] = IDT64Entry(__interrupt_vector[67], 0, INTGATE);
+    idt[128] = IDT64Entry(__interrupt_vector[68], 0, INTGATE | IDT_USER);
 
     idt_flush((uint64_t)&idt_descriptor);
 }
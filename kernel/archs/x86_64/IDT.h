@@ -40,6 +40,8 @@ struct PACKED IDT64Entry
     }
 };
 
+extern IDT64Descriptor idt_descriptor;
+
 extern "C" void idt_flush(uint64_t);
 
 void idt_initialize();
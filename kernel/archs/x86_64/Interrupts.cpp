@@ -6,8 +6,12 @@
 #include "kernel/system/System.h"
 #include "kernel/tasking/Syscalls.h"
 
+#include "archs/x86/FPU.h"
+#include "archs/x86/LAPIC.h"
 #include "archs/x86/PIC.h"
+#include "archs/x86/SMP.h"
 
+#include "archs/x86_64/GDT.h"
 #include "archs/x86_64/Interrupts.h"
 #include "archs/x86_64/x86_64.h"
 
@@ -50,9 +54,14 @@ extern "C" uint64_t interrupts_handler(uintptr_t rsp)
 {
     InterruptStackFrame *stackframe = reinterpret_cast<InterruptStackFrame *>(rsp);
 
-    if (stackframe->intno < 32)
+    if (stackframe->intno == 7)
     {
-        if (stackframe->cs == 0x1B)
+        // The task used the FPU since it was switched to.
+        fpu_handle_unavailable();
+    }
+    else if (stackframe->intno < 32)
+    {
+        if (stackframe->cs == GDT_USER_CODE_SELECTOR)
         {
             logger_error("Task %s(%d) triggered an exception: '%s' %x.%x (IP=%08x CR2=%08x)",
                          scheduler_running()->name,
@@ -79,30 +88,41 @@ extern "C" uint64_t interrupts_handler(uintptr_t rsp)
                 stackframe->err);
         }
     }
-    else if (stackframe->intno < 48)
+    else if (stackframe->intno < 32 + DISPATCHER_IRQ_COUNT)
     {
         interrupts_disable_holding();
+        interrupts_lock();
 
         int irq = stackframe->intno - 32;
 
         if (irq == 0)
         {
-            system_tick();
             rsp = schedule(rsp);
         }
-        else
+        else if (dispatcher_dispatch(irq))
         {
-            dispatcher_dispatch(irq);
+            // The worker handles it now, not at the next tick.
+            rsp = schedule(rsp);
         }
 
+        interrupts_unlock();
         interrupts_enable_holding();
     }
-    else if (stackframe->intno == 127)
+    else if (stackframe->intno == SMP_TLB_SHOOTDOWN_VECTOR)
+    {
+        // The processor which asked holds the kernel lock while it waits.
+        smp_handle_requests();
+    }
+    else if (stackframe->intno == LAPIC_TIMER_VECTOR ||
+             stackframe->intno == SMP_RESCHEDULE_VECTOR ||
+             stackframe->intno == 127)
     {
         interrupts_disable_holding();
+        interrupts_lock();
 
         rsp = schedule(rsp);
 
+        interrupts_unlock();
         interrupts_enable_holding();
     }
     else if (stackframe->intno == 128)
@@ -120,7 +140,20 @@ extern "C" uint64_t interrupts_handler(uintptr_t rsp)
         cli();
     }
 
-    pic_ack(stackframe->intno);
+    if (stackframe->intno >= 32 + DISPATCHER_MSI_FIRST && stackframe->intno < 32 + DISPATCHER_IRQ_COUNT)
+    {
+        lapic_ack();
+    }
+    else if (stackframe->intno >= LAPIC_TIMER_VECTOR && stackframe->intno <= SMP_TLB_SHOOTDOWN_VECTOR)
+    {
+        lapic_ack();
+    }
+    else if (stackframe->intno >= 32 && stackframe->intno < 32 + DISPATCHER_MSI_FIRST)
+    {
+        // Not for the other interrupts, a processor would acknowledge the
+        // one the first processor is handling.
+        pic_ack(stackframe->intno);
+    }
 
     return rsp;
 }
@@ -2,6 +2,13 @@
 
 #include <libsystem/Common.h>
 
+// The first gigabyte is the kernel's, its page tables are shared by every
+// address space.
+#define KERNEL_VIRTUAL_END (0x40000000)
+
+// Mapped by a single level 2 entry.
+#define LARGE_PAGE_SIZE (2 * 1024 * 1024)
+
 struct PACKED PageMappingLevel4Entry
 {
     bool present : 1;               // Must be 1 to reference a PML-1
@@ -67,8 +74,9 @@ struct PACKED PageMappingLevel2Entry
     bool cache : 1;                 // Page-level cache disable
     bool accessed : 1;              // Indicates whether this entry has been used
     int zero0 : 1;                  // Ignored
-    int size : 1;                   // Must be 0 otherwise, this entry maps a 2-MByte page.
-    int zero1 : 4;                  // Ignored
+    bool size : 1;                  // Must be 0 otherwise, this entry maps a 2-MByte page.
+    bool global : 1;                // Of a 2-MByte page, ignored otherwise.
+    int zero1 : 3;                  // Ignored
     uint64_t physical_address : 36; // Physical address of a 4-KByte aligned PLM-1
     int zero2 : 15;                 // Ignored
     bool execute_disabled : 1;      // If IA32_EFER.NXE = 1, Execute-disable
@@ -76,7 +84,7 @@ struct PACKED PageMappingLevel2Entry
 
 struct PACKED PageMappingLevel2
 {
-    PageMappingLevel3Entry entries[512];
+    PageMappingLevel2Entry entries[512];
 };
 
 static inline size_t pml2_index(uintptr_t address)
@@ -107,7 +115,7 @@ struct PACKED PageMappingLevel1Entry
 
 struct PACKED PageMappingLevel1
 {
-    PageMappingLevel3Entry entries[512];
+    PageMappingLevel1Entry entries[512];
 };
 
 static inline size_t pml1_index(uintptr_t address)
@@ -119,5 +127,3 @@ static_assert(sizeof(PageMappingLevel1Entry) == sizeof(uint64_t));
 static_assert(sizeof(PageMappingLevel1) == 4096);
 
 extern "C" void paging_load_directory(uintptr_t directory);
-
-extern "C" void paging_invalidate_tlb();
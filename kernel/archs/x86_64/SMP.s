@@ -0,0 +1,98 @@
+;; --- Processors startup --------------------------------------------------- ;;
+
+; Copied below the first megabyte, where the startup IPI starts the other
+; processors in real mode. It goes through protected mode with its own table
+; to long mode, with the kernel address space, and jumps into the kernel.
+
+SMP_TRAMPOLINE equ 0x8000
+
+%define TRAMPOLINE(__label) (__label - smp_trampoline_start + SMP_TRAMPOLINE)
+
+CR4_PAE equ (1 << 5)
+MSR_EFER equ 0xC0000080
+EFER_LONG_MODE_ENABLE equ (1 << 8)
+
+extern smp_ap_main
+extern smp_ap_page_directory
+extern smp_ap_stack
+
+section .text
+
+bits 16
+global smp_trampoline_start
+smp_trampoline_start:
+    cli
+    cld
+
+    xor ax, ax
+    mov ds, ax
+
+    lgdt [TRAMPOLINE(smp_trampoline_gdt_descriptor)]
+
+    mov eax, cr0
+    or eax, 1
+    mov cr0, eax
+
+    jmp dword 0x08:TRAMPOLINE(smp_trampoline_protected_mode)
+
+bits 32
+smp_trampoline_protected_mode:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    mov eax, cr4
+    or eax, CR4_PAE
+    mov cr4, eax
+
+    ; The kernel is below the first gigabyte, so are its tables.
+    mov eax, [smp_ap_page_directory]
+    mov cr3, eax
+
+    mov ecx, MSR_EFER
+    rdmsr
+    or eax, EFER_LONG_MODE_ENABLE
+    wrmsr
+
+    mov eax, cr0
+    or eax, 0x80000000
+    mov cr0, eax
+
+    jmp dword 0x18:TRAMPOLINE(smp_trampoline_long_mode)
+
+bits 64
+smp_trampoline_long_mode:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    ; Copied somewhere else, nothing can be relative to the instruction.
+    mov rax, smp_ap_stack
+    mov rsp, [rax]
+
+    mov rax, smp_ap_main
+    call rax
+
+.hang:
+    cli
+    hlt
+    jmp .hang
+
+smp_trampoline_gdt:
+    dq 0x0000000000000000
+    dq 0x00CF9A000000FFFF
+    dq 0x00CF92000000FFFF
+    dq 0x00209A0000000000
+
+smp_trampoline_gdt_descriptor:
+    dw smp_trampoline_gdt_descriptor - smp_trampoline_gdt - 1
+    dd TRAMPOLINE(smp_trampoline_gdt)
+
+global smp_trampoline_end
+smp_trampoline_end:
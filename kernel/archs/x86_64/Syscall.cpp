@@ -0,0 +1,63 @@
+#include "archs/x86/x86.h"
+#include "archs/x86_64/Syscall.h"
+
+#include "kernel/scheduling/Cpu.h"
+#include "kernel/tasking/Syscalls.h"
+
+#define MSR_EFER 0xC0000080
+#define MSR_STAR 0xC0000081
+#define MSR_LSTAR 0xC0000082
+#define MSR_FMASK 0xC0000084
+
+#define EFER_SYSCALL_ENABLE (1 << 0)
+
+// Cleared on entry: interrupts, direction and trap.
+#define SYSCALL_FLAGS_MASK 0x700
+
+// The entry of each processor, and the stacks it uses.
+extern "C" uintptr_t syscall_entries[CPU_MAX];
+
+struct SyscallStacks
+{
+    uint64_t kernel;
+    uint64_t user;
+};
+
+static_assert(sizeof(SyscallStacks) == 16, "The entries expect 16 bytes per processor");
+
+extern "C" SyscallStacks syscall_stacks[CPU_MAX];
+
+SyscallStacks syscall_stacks[CPU_MAX] = {};
+
+void syscall_initialize()
+{
+    uint32_t efer_low;
+    uint32_t efer_high;
+    rdmsr(MSR_EFER, &efer_low, &efer_high);
+    wrmsr(MSR_EFER, efer_low | EFER_SYSCALL_ENABLE, efer_high);
+
+    // SYSCALL loads the kernel code segment and the one after it. SYSRET
+    // loads the user segments 8 and 16 bytes after the second selector.
+    wrmsr(MSR_STAR, 0, (0x10 << 16) | 0x08);
+
+    uint64_t entry = syscall_entries[arch_current_cpu()];
+    wrmsr(MSR_LSTAR, entry & 0xffffffff, entry >> 32);
+
+    wrmsr(MSR_FMASK, SYSCALL_FLAGS_MASK, 0);
+}
+
+void syscall_set_kernel_stack(uint64_t stack)
+{
+    syscall_stacks[arch_current_cpu()].kernel = stack;
+}
+
+extern "C" uint64_t syscall_handler(Syscall syscall, uint64_t p1, uint64_t p2, uint64_t p3, uint64_t p4, uint64_t p5)
+{
+    sti();
+
+    uint64_t result = task_do_syscall(syscall, p1, p2, p3, p4, p5);
+
+    cli();
+
+    return result;
+}
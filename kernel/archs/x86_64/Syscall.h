@@ -0,0 +1,8 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+void syscall_initialize();
+
+// SYSCALL doesn't switch stacks, the entry loads this one for each task.
+void syscall_set_kernel_stack(uint64_t stack);
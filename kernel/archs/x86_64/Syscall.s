@@ -0,0 +1,101 @@
+;; --- SYSCALL -------------------------------------------------------------- ;;
+
+; Interrupts are masked and we are still on the user stack. RCX and R11 hold
+; where SYSRET returns to, the userspace stub passes the second argument in
+; R10 since RCX is taken.
+
+; SYSCALL doesn't tell which processor we are on, so each one has its own
+; entry, which knows where its stacks are: the kernel one of the running
+; task, then room for the user one.
+
+CPU_MAX equ 32 ; as in kernel/scheduling/Cpu.h
+
+GDT_USER_CODE_SELECTOR equ 0x23 ; as in archs/x86_64/GDT.h
+GDT_USER_DATA_SELECTOR equ 0x1B
+
+extern syscall_handler
+extern syscall_stacks
+
+%assign cpu 0
+%rep CPU_MAX
+syscall_entry %+ cpu:
+    mov [rel syscall_stacks + cpu * 16 + 8], rsp
+    mov rsp, [rel syscall_stacks + cpu * 16]
+
+    push qword [rel syscall_stacks + cpu * 16 + 8]
+    jmp syscall_common
+%assign cpu cpu + 1
+%endrep
+
+global syscall_entries
+syscall_entries:
+%assign cpu 0
+%rep CPU_MAX
+    dq syscall_entry %+ cpu
+%assign cpu cpu + 1
+%endrep
+
+syscall_common:
+    push rcx
+    push r11
+
+    push rdi
+    push rsi
+    push rdx
+    push r8
+    push r9
+    push r10
+
+    sub rsp, 8 ; keep the stack aligned for the call
+
+    ; syscall_handler(syscall, p1, p2, p3, p4, p5)
+    mov r9, rdi
+    mov r8, rsi
+    mov rcx, rdx
+    mov rdx, r10
+    mov rsi, rbx
+    mov rdi, rax
+    call syscall_handler
+
+    add rsp, 8
+
+    ; SYSRET to a non-canonical address faults on Intel processors in ring 0,
+    ; with the user stack. IRETQ faults on the kernel stack. RCX and R11 are
+    ; still free, they are restored from the stack below.
+    mov rcx, [rsp + 7 * 8]
+    shr rcx, 47
+    jnz .iret
+
+    pop r10
+    pop r9
+    pop r8
+    pop rdx
+    pop rsi
+    pop rdi
+
+    pop r11
+    pop rcx
+
+    ; syscall_handler() disabled interrupts again, nothing can use the user
+    ; stack before SYSRET.
+    pop rsp
+    o64 sysret
+
+.iret:
+    pop r10
+    pop r9
+    pop r8
+    pop rdx
+    pop rsi
+    pop rdi
+
+    pop r11
+    pop rcx
+
+    ; Only the user stack is left, turn it into the frame of IRETQ.
+    push qword [rsp]
+    mov qword [rsp + 8], GDT_USER_DATA_SELECTOR ; ss
+    push r11 ; rflags
+    push qword GDT_USER_CODE_SELECTOR ; cs
+    push rcx ; rip
+    iretq
@@ -3,9 +3,14 @@
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/memory/Memory.h"
+#include "kernel/memory/Physical.h"
+#include "kernel/scheduling/Cpu.h"
 #include "kernel/system/System.h"
 
 #include "archs/Arch.h"
+#include "archs/x86/CPUID.h"
+#include "archs/x86/SMP.h"
+#include "archs/x86/TLB.h"
 #include "archs/x86_64/Paging.h"
 #include "archs/x86_64/x86_64.h"
 
@@ -15,6 +20,82 @@ PageMappingLevel3 kpml3 ALIGNED(ARCH_PAGE_SIZE) = {};
 PageMappingLevel2 kpml2 ALIGNED(ARCH_PAGE_SIZE) = {};
 PageMappingLevel1 kpml1[512] ALIGNED(ARCH_PAGE_SIZE) = {};
 
+#define CR3_NO_FLUSH (1ull << 63)
+#define CR4_PCID_ENABLE (1 << 17)
+
+// Address spaces are tagged with a PCID, so their translations survive
+// switching to another one. There are 4096 of them, a few are enough for
+// the processes which run in turn.
+#define PCID_COUNT 64
+
+struct PCID
+{
+    void *address_space;
+
+    // Translations were changed while it wasn't loaded.
+    bool stale;
+};
+
+static bool _pcid_enabled = false;
+
+// The TLB of each processor has its own, and so has its own tags.
+static PCID _pcids[CPU_MAX][PCID_COUNT] = {};
+static size_t _pcid_next[CPU_MAX] = {};
+
+// The one each processor has loaded.
+static void *_loaded_address_space[CPU_MAX] = {};
+
+static size_t pcid_get(void *address_space)
+{
+    auto &pcids = _pcids[arch_current_cpu()];
+    auto &next = _pcid_next[arch_current_cpu()];
+
+    for (size_t i = 0; i < PCID_COUNT; i++)
+    {
+        if (pcids[i].address_space == address_space)
+        {
+            return i;
+        }
+    }
+
+    // The translations left with this PCID are from someone else, they have
+    // to be flushed. The first one is the kernel's.
+    size_t pcid = next % (PCID_COUNT - 1) + 1;
+    next = pcid;
+
+    pcids[pcid] = {address_space, true};
+
+    return pcid;
+}
+
+static void pcid_invalidate(int cpu, void *address_space)
+{
+    for (size_t i = 0; i < PCID_COUNT; i++)
+    {
+        if (_pcids[cpu][i].address_space == address_space)
+        {
+            _pcids[cpu][i].stale = true;
+        }
+    }
+}
+
+static void virtual_invalidate(void *address_space, MemoryRange range)
+{
+    bool global = range.base() < KERNEL_VIRTUAL_END;
+
+    if (global || address_space == _loaded_address_space[arch_current_cpu()])
+    {
+        tlb_invalidate(range, global);
+    }
+    else if (_pcid_enabled)
+    {
+        pcid_invalidate(arch_current_cpu(), address_space);
+    }
+
+    // Another processor may have it loaded, or its translations tagged.
+    smp_tlb_shootdown();
+}
+
 void *arch_kernel_address_space()
 {
     return &kpml4;
@@ -47,6 +128,34 @@ void arch_virtual_initialize()
 void arch_virtual_memory_enable()
 {
     arch_address_space_switch(arch_kernel_address_space());
+
+    tlb_initialize();
+
+    // The kernel mappings have to be global, invalidating them would only
+    // reach the PCID which is loaded otherwise.
+    if (tlb_global_pages() && (cpuid_get_feature_ECX() & CPUID_FEAT_ECX_PCIDE))
+    {
+        asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_PCID_ENABLE));
+
+        for (int i = 0; i < CPU_MAX; i++)
+        {
+            _pcids[i][0] = {arch_kernel_address_space(), false};
+        }
+
+        _pcid_enabled = true;
+    }
+}
+
+void arch_virtual_memory_enable_ap()
+{
+    tlb_initialize();
+
+    if (_pcid_enabled)
+    {
+        asm volatile("mov %0, %%cr4" ::"r"(CR4() | CR4_PCID_ENABLE));
+    }
+
+    _loaded_address_space[arch_current_cpu()] = arch_kernel_address_space();
 }
 
 bool arch_virtual_present(void *address_space, uintptr_t virtual_address)
@@ -72,9 +181,9 @@ bool arch_virtual_present(void *address_space, uintptr_t virtual_address)
     auto pml2 = reinterpret_cast<PageMappingLevel2 *>(pml3_entry.physical_address * ARCH_PAGE_SIZE);
     auto &pml2_entry = pml2->entries[pml2_index(virtual_address)];
 
-    if (!pml2_entry.present)
+    if (!pml2_entry.present || pml2_entry.size)
     {
-        return false;
+        return pml2_entry.present;
     }
 
     auto pml1 = reinterpret_cast<PageMappingLevel1 *>(pml2_entry.physical_address * ARCH_PAGE_SIZE);
@@ -111,6 +220,11 @@ uintptr_t arch_virtual_to_physical(void *address_space, uintptr_t virtual_addres
         return 0;
     }
 
+    if (pml2_entry.size)
+    {
+        return (pml2_entry.physical_address * ARCH_PAGE_SIZE) + (virtual_address % LARGE_PAGE_SIZE);
+    }
+
     auto pml1 = reinterpret_cast<PageMappingLevel1 *>(pml2_entry.physical_address * ARCH_PAGE_SIZE);
     auto &pml1_entry = pml1->entries[pml1_index(virtual_address)];
 
@@ -122,15 +236,108 @@ uintptr_t arch_virtual_to_physical(void *address_space, uintptr_t virtual_addres
     return (pml1_entry.physical_address * ARCH_PAGE_SIZE) + (virtual_address & 0xfff);
 }
 
+// The level 1 tables of the kernel's gigabyte are static, a large page
+// there leaves its table unused until it is gone.
+static PageMappingLevel1 *kernel_table(uintptr_t address)
+{
+    return address < KERNEL_VIRTUAL_END ? &kpml1[pml2_index(address)] : nullptr;
+}
+
+static void clear_large_page(uintptr_t address, PageMappingLevel2Entry *pml2_entry)
+{
+    *pml2_entry = {};
+
+    auto pml1 = kernel_table(address);
+
+    if (pml1)
+    {
+        pml2_entry->present = 1;
+        pml2_entry->writable = 1;
+        pml2_entry->physical_address = (uint64_t)pml1 / ARCH_PAGE_SIZE;
+    }
+}
+
+// Breaks a large page into small ones, so part of it can be changed.
+static Result split_large_page(void *address_space, uintptr_t address, PageMappingLevel2Entry *pml2_entry)
+{
+    auto pml1 = kernel_table(address);
+
+    if (!pml1)
+    {
+        TRY(memory_alloc_identity(address_space, MEMORY_CLEAR, (uintptr_t *)&pml1));
+    }
+
+    for (size_t i = 0; i < 512; i++)
+    {
+        auto &pml1_entry = pml1->entries[i];
+
+        pml1_entry = {};
+        pml1_entry.present = 1;
+        pml1_entry.writable = pml2_entry->writable;
+        pml1_entry.user = pml2_entry->user;
+        pml1_entry.global = pml2_entry->global;
+        pml1_entry.physical_address = pml2_entry->physical_address + i;
+    }
+
+    pml2_entry->writable = 1;
+    pml2_entry->user = !kernel_table(address);
+    pml2_entry->size = 0;
+    pml2_entry->global = 0;
+    pml2_entry->physical_address = (uint64_t)pml1 / ARCH_PAGE_SIZE;
+
+    return SUCCESS;
+}
+
+// The small pages of a level 2 entry are replaced by a large one, their
+// table can go once nothing uses it anymore.
+static void free_small_pages(void *address_space, uintptr_t address, PageMappingLevel2Entry *pml2_entry)
+{
+    bool had_table = pml2_entry->present && !pml2_entry->size;
+    auto table = reinterpret_cast<PageMappingLevel1 *>(pml2_entry->physical_address * ARCH_PAGE_SIZE);
+
+    *pml2_entry = {};
+
+    if (!had_table)
+    {
+        return;
+    }
+
+    bool had_pages = false;
+
+    for (size_t i = 0; i < 512; i++)
+    {
+        had_pages |= table->entries[i].present;
+    }
+
+    // Without pages only the table can be cached, a single invlpg drops
+    // every cached table.
+    size_t size = had_pages ? LARGE_PAGE_SIZE : ARCH_PAGE_SIZE;
+    virtual_invalidate(address_space, {address, size});
+
+    if (table == kernel_table(address))
+    {
+        *table = {};
+    }
+    else
+    {
+        memory_free(arch_kernel_address_space(), {(uintptr_t)table, ARCH_PAGE_SIZE});
+    }
+}
+
 Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr_t virtual_address, MemoryFlags flags)
 {
     ASSERT_INTERRUPTS_RETAINED();
 
     auto plm4 = reinterpret_cast<PageMappingLevel4 *>(address_space);
 
-    for (size_t i = 0; i < physical_range.page_count(); i++)
+    bool remapped = false;
+
+    size_t offset = 0;
+
+    while (offset < physical_range.size())
     {
-        uint64_t address = virtual_address + i * ARCH_PAGE_SIZE;
+        uint64_t address = virtual_address + offset;
+        uint64_t physical_address = physical_range.base() + offset;
 
         auto pml4_entry = &plm4->entries[pml4_index(address)];
         auto pml3 = reinterpret_cast<PageMappingLevel3 *>(pml4_entry->physical_address * ARCH_PAGE_SIZE);
@@ -159,6 +366,30 @@ Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr
         }
 
         auto pml2_entry = &pml2->entries[pml2_index(address)];
+
+        if (address % LARGE_PAGE_SIZE == 0 &&
+            physical_address % LARGE_PAGE_SIZE == 0 &&
+            physical_range.size() - offset >= LARGE_PAGE_SIZE)
+        {
+            remapped |= pml2_entry->present && pml2_entry->size;
+            free_small_pages(address_space, address, pml2_entry);
+
+            pml2_entry->present = 1;
+            pml2_entry->writable = 1;
+            pml2_entry->user = flags & MEMORY_USER;
+            pml2_entry->size = 1;
+            pml2_entry->global = address < KERNEL_VIRTUAL_END;
+            pml2_entry->physical_address = physical_address / ARCH_PAGE_SIZE;
+
+            offset += LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        if (pml2_entry->present && pml2_entry->size)
+        {
+            TRY(split_large_page(address_space, address, pml2_entry));
+        }
+
         auto pml1 = reinterpret_cast<PageMappingLevel1 *>(pml2_entry->physical_address * ARCH_PAGE_SIZE);
 
         if (!pml2_entry->present)
@@ -173,23 +404,28 @@ Result arch_virtual_map(void *address_space, MemoryRange physical_range, uintptr
 
         auto pml1_entry = &pml1->entries[pml1_index(address)];
 
+        // Pages which were not present can't be in the TLB.
+        remapped |= pml1_entry->present;
+
         pml1_entry->present = 1;
         pml1_entry->writable = 1;
         pml1_entry->user = flags & MEMORY_USER;
-        pml1_entry->physical_address = (physical_range.base() + i * ARCH_PAGE_SIZE) / ARCH_PAGE_SIZE;
+        pml1_entry->global = address < KERNEL_VIRTUAL_END;
+        pml1_entry->physical_address = physical_address / ARCH_PAGE_SIZE;
+
+        offset += ARCH_PAGE_SIZE;
     }
 
-    paging_invalidate_tlb();
+    if (remapped)
+    {
+        virtual_invalidate(address_space, MemoryRange{virtual_address, physical_range.size()});
+    }
 
     return SUCCESS;
 }
 
-MemoryRange arch_virtual_alloc(void *address_space, MemoryRange physical_range, MemoryFlags flags)
+static uintptr_t virtual_find_free(void *address_space, size_t size, size_t alignment, bool is_user_memory)
 {
-    ASSERT_INTERRUPTS_RETAINED();
-
-    bool is_user_memory = flags & MEMORY_USER;
-
     uintptr_t virtual_address = 0;
     size_t current_size = 0;
 
@@ -198,6 +434,11 @@ MemoryRange arch_virtual_alloc(void *address_space, MemoryRange physical_range,
     {
         uintptr_t current_address = i * ARCH_PAGE_SIZE;
 
+        if (current_size == 0 && current_address % alignment != 0)
+        {
+            continue;
+        }
+
         if (!arch_virtual_present(address_space, current_address))
         {
             if (current_size == 0)
@@ -207,11 +448,9 @@ MemoryRange arch_virtual_alloc(void *address_space, MemoryRange physical_range,
 
             current_size += ARCH_PAGE_SIZE;
 
-            if (current_size == physical_range.size())
+            if (current_size == size)
             {
-                assert(SUCCESS == arch_virtual_map(address_space, physical_range, virtual_address, flags));
-
-                return (MemoryRange){virtual_address, current_size};
+                return virtual_address;
             }
         }
         else
@@ -220,16 +459,45 @@ MemoryRange arch_virtual_alloc(void *address_space, MemoryRange physical_range,
         }
     }
 
-    logger_fatal("Out of virtual memory!");
+    return 0;
+}
+
+MemoryRange arch_virtual_alloc(void *address_space, MemoryRange physical_range, MemoryFlags flags)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    bool is_user_memory = flags & MEMORY_USER;
+
+    uintptr_t virtual_address = 0;
+
+    // Like the framebuffer, which can then be mapped with large pages.
+    if (physical_range.base() % LARGE_PAGE_SIZE == 0 && physical_range.size() >= LARGE_PAGE_SIZE)
+    {
+        virtual_address = virtual_find_free(address_space, physical_range.size(), LARGE_PAGE_SIZE, is_user_memory);
+    }
+
+    if (virtual_address == 0)
+    {
+        virtual_address = virtual_find_free(address_space, physical_range.size(), ARCH_PAGE_SIZE, is_user_memory);
+    }
+
+    if (virtual_address == 0)
+    {
+        logger_fatal("Out of virtual memory!");
+    }
+
+    assert(SUCCESS == arch_virtual_map(address_space, physical_range, virtual_address, flags));
+
+    return (MemoryRange){virtual_address, physical_range.size()};
 }
 
 void arch_virtual_free(void *address_space, MemoryRange virtual_range)
 {
     ASSERT_INTERRUPTS_RETAINED();
 
-    for (size_t i = 0; i < virtual_range.page_count(); i++)
+    for (size_t offset = 0; offset < virtual_range.size(); offset += ARCH_PAGE_SIZE)
     {
-        uint64_t address = virtual_range.base() + i * ARCH_PAGE_SIZE;
+        uint64_t address = virtual_range.base() + offset;
 
         auto plm4 = reinterpret_cast<PageMappingLevel4 *>(address_space);
         auto pml4_entry = &plm4->entries[pml4_index(address)];
@@ -255,13 +523,41 @@ void arch_virtual_free(void *address_space, MemoryRange virtual_range)
             continue;
         }
 
+        if (pml2_entry->size)
+        {
+            if (address % LARGE_PAGE_SIZE == 0 && virtual_range.size() - offset >= LARGE_PAGE_SIZE)
+            {
+                clear_large_page(address, pml2_entry);
+                offset += LARGE_PAGE_SIZE - ARCH_PAGE_SIZE;
+                continue;
+            }
+
+            if (split_large_page(address_space, address, pml2_entry) != SUCCESS)
+            {
+                logger_error("Failed to unmap part of a large page at %p", address);
+                continue;
+            }
+        }
+
         auto pml1 = reinterpret_cast<PageMappingLevel1 *>(pml2_entry->physical_address * ARCH_PAGE_SIZE);
         auto pml1_entry = &pml1->entries[pml1_index(address)];
 
         *pml1_entry = {};
     }
 
-    paging_invalidate_tlb();
+    virtual_invalidate(address_space, virtual_range);
+}
+
+MemoryRange arch_virtual_user_range()
+{
+    // The lower half of the 48 bits address space, without its last page: a
+    // SYSCALL at the end of it would return to a non-canonical address.
+    return {KERNEL_VIRTUAL_END, 0x800000000000 - ARCH_PAGE_SIZE - KERNEL_VIRTUAL_END};
+}
+
+size_t arch_virtual_alignment(size_t size)
+{
+    return size >= LARGE_PAGE_SIZE ? LARGE_PAGE_SIZE : ARCH_PAGE_SIZE;
 }
 
 void *arch_address_space_create()
@@ -278,37 +574,144 @@ void *arch_address_space_create()
     pml4_entry.present = 1;
     pml4_entry.physical_address = (uint64_t)pml3 / ARCH_PAGE_SIZE;
 
-    PageMappingLevel2 *pml2;
-    memory_alloc_identity(arch_kernel_address_space(), MEMORY_CLEAR, (uintptr_t *)&pml2);
-
+    // The kernel's gigabyte, shared down from its level 2 so its large
+    // pages are everywhere.
     auto &pml3_entry = pml3->entries[0];
     pml3_entry.user = 1;
     pml3_entry.writable = 1;
     pml3_entry.present = 1;
-    pml3_entry.physical_address = (uint64_t)pml2 / ARCH_PAGE_SIZE;
+    pml3_entry.physical_address = (uint64_t)&kpml2 / ARCH_PAGE_SIZE;
 
+    // A previous address space may have been at the same place.
+    for (int i = 0; i < CPU_MAX; i++)
+    {
+        pcid_invalidate(i, pml4);
+    }
+
+    return pml4;
+}
+
+static void free_table(void *table)
+{
+    memory_free(arch_kernel_address_space(), {(uintptr_t)table, ARCH_PAGE_SIZE});
+}
+
+static void free_pml2(PageMappingLevel2 *pml2)
+{
     for (size_t i = 0; i < 512; i++)
     {
         auto &pml2_entry = pml2->entries[i];
-        pml2_entry.user = 1;
-        pml2_entry.writable = 1;
-        pml2_entry.present = 1;
-        pml2_entry.physical_address = (uint64_t)&kpml1[i] / ARCH_PAGE_SIZE;
+
+        if (!pml2_entry.present)
+        {
+            continue;
+        }
+
+        if (pml2_entry.size)
+        {
+            physical_free({pml2_entry.physical_address * ARCH_PAGE_SIZE, LARGE_PAGE_SIZE});
+            continue;
+        }
+
+        auto pml1 = reinterpret_cast<PageMappingLevel1 *>(pml2_entry.physical_address * ARCH_PAGE_SIZE);
+
+        for (size_t j = 0; j < 512; j++)
+        {
+            if (pml1->entries[j].present)
+            {
+                physical_free({pml1->entries[j].physical_address * ARCH_PAGE_SIZE, ARCH_PAGE_SIZE});
+            }
+        }
+
+        free_table(pml1);
     }
 
-    return pml4;
+    free_table(pml2);
 }
 
 void arch_address_space_destroy(void *address_space)
 {
-    ASSERT_INTERRUPTS_RETAINED();
+    InterruptsRetainer retainer;
+
+    assert(address_space != arch_kernel_address_space());
+
+    // Its translations would be left in the TLB for the next one at this address.
+    if (address_space == _loaded_address_space[arch_current_cpu()])
+    {
+        arch_address_space_switch(arch_kernel_address_space());
+    }
+
+    for (int i = 0; i < CPU_MAX; i++)
+    {
+        pcid_invalidate(i, address_space);
+    }
+
+    auto pml4 = reinterpret_cast<PageMappingLevel4 *>(address_space);
+
+    for (size_t i = 0; i < 512; i++)
+    {
+        auto &pml4_entry = pml4->entries[i];
+
+        if (!pml4_entry.present)
+        {
+            continue;
+        }
+
+        auto pml3 = reinterpret_cast<PageMappingLevel3 *>(pml4_entry.physical_address * ARCH_PAGE_SIZE);
 
-    UNUSED(address_space);
+        for (size_t j = 0; j < 512; j++)
+        {
+            auto &pml3_entry = pml3->entries[j];
+
+            if (!pml3_entry.present)
+            {
+                continue;
+            }
+
+            // The kernel's gigabyte, its tables are shared.
+            if (i == 0 && j == 0)
+            {
+                continue;
+            }
+
+            free_pml2(reinterpret_cast<PageMappingLevel2 *>(pml3_entry.physical_address * ARCH_PAGE_SIZE));
+        }
+
+        free_table(pml3);
+    }
 
-    ASSERT_NOT_REACHED();
+    free_table(pml4);
 }
 
 void arch_address_space_switch(void *address_space)
 {
-    paging_load_directory((uintptr_t)address_space);
+    InterruptsRetainer retainer;
+
+    // Loading CR3 flushes the TLB, the threads of a process share theirs.
+    if (address_space == _loaded_address_space[arch_current_cpu()])
+    {
+        return;
+    }
+
+    _loaded_address_space[arch_current_cpu()] = address_space;
+
+    if (!_pcid_enabled)
+    {
+        paging_load_directory((uintptr_t)address_space);
+        return;
+    }
+
+    size_t pcid = pcid_get(address_space);
+    uintptr_t cr3 = (uintptr_t)address_space | pcid;
+
+    PCID &tag = _pcids[arch_current_cpu()][pcid];
+
+    if (!tag.stale)
+    {
+        cr3 |= CR3_NO_FLUSH;
+    }
+
+    tag.stale = false;
+
+    paging_load_directory(cr3);
 }
@@ -23,9 +23,12 @@ gdt_flush:
     mov gs, ax
     mov ss, ax
 
-    mov ax, 0x28
-    ltr ax
+    ret
 
+global tss_flush
+tss_flush:
+    mov ax, di
+    ltr ax
     ret
 
 global idt_flush
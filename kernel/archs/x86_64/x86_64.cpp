@@ -9,17 +9,22 @@
 #include "kernel/system/System.h"
 #include "kernel/tasking/Task.h"
 
+#include "archs/x86/ACPI.h"
 #include "archs/x86/COM.h"
 #include "archs/x86/CPUID.h"
 #include "archs/x86/FPU.h"
 #include "archs/x86/IOPort.h"
+#include "archs/x86/LAPIC.h"
 #include "archs/x86/PIC.h"
 #include "archs/x86/PIT.h"
 #include "archs/x86/RTC.h"
+#include "archs/x86/SMP.h"
+#include "archs/x86/TSC.h"
 
 #include "archs/x86_64/GDT.h"
 #include "archs/x86_64/IDT.h"
 #include "archs/x86_64/Interrupts.h"
+#include "archs/x86_64/Syscall.h"
 #include "archs/x86_64/x86_64.h"
 
 extern "C" void arch_main(void *info, uint32_t magic)
@@ -42,9 +47,14 @@ extern "C" void arch_main(void *info, uint32_t magic)
 
     gdt_initialize();
     idt_initialize();
+    syscall_initialize();
     pic_initialize();
     fpu_initialize();
-    pit_initialize(1000);
+    pit_initialize();
+
+    // The TSC is calibrated against the HPET, if ACPI tells us about one.
+    acpi_initialize(handover);
+    tsc_initialize();
 
     system_main(handover);
 
@@ -55,6 +65,8 @@ void arch_disable_interrupts() { cli(); }
 
 void arch_enable_interrupts() { sti(); }
 
+bool arch_interrupts_enabled() { return interrupts_enabled(); }
+
 void arch_halt()
 {
     hlt();
@@ -72,12 +84,15 @@ void arch_save_context(Task *task)
 
 void arch_load_context(Task *task)
 {
-    fpu_load_context(task);
+    fpu_switch_context(task);
     set_kernel_stack((uint64_t)task->kernel_stack + PROCESS_STACK_SIZE);
+    syscall_set_kernel_stack((uint64_t)task->kernel_stack + PROCESS_STACK_SIZE);
 }
 
 void arch_task_go(Task *task)
 {
+    fpu_init_context(task);
+
     if (task->_flags & TASK_USER)
     {
         InterruptStackFrame stackframe = {};
@@ -88,8 +103,8 @@ void arch_task_go(Task *task)
         stackframe.rip = (uintptr_t)task->entry_point;
         stackframe.rbp = (uintptr_t)stackframe.rsp;
 
-        stackframe.cs = 0x1b;
-        stackframe.ss = 0x23;
+        stackframe.cs = GDT_USER_CODE_SELECTOR;
+        stackframe.ss = GDT_USER_DATA_SELECTOR;
 
         task_kernel_stack_push(task, &stackframe, sizeof(InterruptStackFrame));
     }
@@ -110,6 +125,11 @@ void arch_task_go(Task *task)
     }
 }
 
+void arch_task_destroy(Task *task)
+{
+    fpu_release_context(task);
+}
+
 size_t arch_debug_write(const void *buffer, size_t size)
 {
     return com_write(COM1, buffer, size);
@@ -120,6 +140,75 @@ TimeStamp arch_get_time()
     return rtc_now();
 }
 
+uint64_t arch_get_clock()
+{
+    return rdtsc();
+}
+
+uint64_t arch_clock_to_nanoseconds(uint64_t ticks)
+{
+    return tsc_to_nanoseconds(ticks);
+}
+
+void arch_timer_oneshot(uint64_t nanoseconds)
+{
+    // The interrupts of the PIT only go to the first processor.
+    if (arch_current_cpu() == 0)
+    {
+        pit_oneshot(nanoseconds);
+    }
+    else
+    {
+        lapic_timer_oneshot(nanoseconds);
+    }
+}
+
+void arch_start_cpus()
+{
+    smp_initialize();
+}
+
+void smp_ap_initialize(Cpu *cpu)
+{
+    gdt_load(cpu->id);
+    idt_flush((uint64_t)&idt_descriptor);
+    syscall_initialize();
+}
+
+int arch_current_cpu()
+{
+    return smp_current_cpu();
+}
+
+void arch_pause()
+{
+    pause();
+    smp_handle_requests();
+}
+
+void arch_reschedule(int cpu)
+{
+    smp_reschedule(cpu);
+}
+
+bool arch_msi_message(int irq, uint64_t *address, uint32_t *data)
+{
+    if (!lapic_available())
+    {
+        return false;
+    }
+
+    // Messages are only accepted once the local APIC is enabled.
+    lapic_map();
+    lapic_enable();
+
+    // To the boot processor, which handles the interrupts, edge triggered.
+    *address = LAPIC_MSI_ADDRESS | (lapic_id() << 12);
+    *data = 32 + irq;
+
+    return true;
+}
+
 NO_RETURN void arch_reboot()
 {
     logger_warn("STUB %s", __func__);
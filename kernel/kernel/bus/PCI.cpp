@@ -195,6 +195,64 @@ int pci_get_interrupt(PCIAddress address)
     }
 }
 
+int pci_find_capability(PCIAddress address, uint8_t id)
+{
+    if (!(address.read16(PCI_STATUS) & PCI_STATUS_CAPABILITIES))
+    {
+        return 0;
+    }
+
+    int offset = address.read8(PCI_CAPABILITIES) & 0xFC;
+
+    // The list could loop, there is room for 48 capabilities at most.
+    for (int i = 0; offset != 0 && i < 48; i++)
+    {
+        if (address.read8(offset) == id)
+        {
+            return offset;
+        }
+
+        offset = address.read8(offset + 1) & 0xFC;
+    }
+
+    return 0;
+}
+
+// The configuration space is written 32 bits at a time, narrower writes
+// would go to the wrong offset.
+void pci_enable_msi(PCIAddress address, int capability, uint64_t message_address, uint32_t message_data)
+{
+    uint32_t header = address.read32(capability);
+    uint16_t control = header >> 16;
+
+    address.write32(capability + 4, message_address & 0xFFFFFFFF);
+
+    if (control & PCI_MSI_64BIT)
+    {
+        address.write32(capability + 8, message_address >> 32);
+        address.write32(capability + 12, message_data & 0xFFFF);
+    }
+    else
+    {
+        address.write32(capability + 8, message_data & 0xFFFF);
+    }
+
+    // A single message, the others are left disabled.
+    control = (control & ~0x70) | PCI_MSI_ENABLE;
+    address.write32(capability, (header & 0xFFFF) | (control << 16));
+
+    // The status bits are cleared by writing ones, they are left alone.
+    uint32_t command = address.read32(PCI_COMMAND) & 0xFFFF;
+    address.write32(PCI_COMMAND, command | PCI_COMMAND_INTERRUPT_DISABLE);
+}
+
+void pci_enable_bus_mastering(PCIAddress address)
+{
+    // The status is in the upper half, writing ones to it clears them.
+    uint32_t command = address.read32(PCI_COMMAND) & 0xFFFF;
+    address.write32(PCI_COMMAND, command | PCI_COMMAND_BUS_MASTER);
+}
+
 void pci_initialize()
 {
     pci_initialize_isa_bridge();
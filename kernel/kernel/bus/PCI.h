@@ -8,4 +8,15 @@ void pci_initialize();
 
 int pci_get_interrupt(PCIAddress address);
 
+// The offset of a capability in the configuration space, 0 if the device
+// doesn't have it.
+int pci_find_capability(PCIAddress address, uint8_t id);
+
+// The device then raises its interrupt by writing data at address, not
+// through its interrupt pin.
+void pci_enable_msi(PCIAddress address, int capability, uint64_t message_address, uint32_t message_data);
+
+// The device can then read and write memory on its own.
+void pci_enable_bus_mastering(PCIAddress address);
+
 Iteration pci_scan(IterationCallback<PCIAddress> callback);
@@ -24,9 +24,19 @@
 #define PCI_BAR4 0x20
 #define PCI_BAR5 0x24
 
+#define PCI_CAPABILITIES 0x34
 #define PCI_INTERRUPT_LINE 0x3C
 #define PCI_INTERRUPT_PIN 0x3D
 
+#define PCI_COMMAND_BUS_MASTER (1 << 2)
+#define PCI_COMMAND_INTERRUPT_DISABLE (1 << 10)
+#define PCI_STATUS_CAPABILITIES (1 << 4)
+
+#define PCI_CAPABILITY_MSI 0x05
+
+#define PCI_MSI_ENABLE (1 << 0)
+#define PCI_MSI_64BIT (1 << 7)
+
 #define PCI_SECONDARY_BUS 0x19
 
 #define PCI_HEADER_TYPE_DEVICE 0
@@ -34,6 +44,7 @@
 #define PCI_HEADER_TYPE_CARDBUS 2
 
 #define PCI_TYPE_BRIDGE 0x0604
+#define PCI_TYPE_IDE 0x0101
 #define PCI_TYPE_SATA 0x0106
 
 #define PCI_ADDRESS_PORT 0xCF8
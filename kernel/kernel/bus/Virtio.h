@@ -19,3 +19,44 @@
 #define VIRTIO_REGISTER_QUEUE_NOTIFY (0x10)
 #define VIRTIO_REGISTER_DEVICE_STATUS (0x12)
 #define VIRTIO_REGISTER_ISR_STATUS (0x13)
+
+// Without MSI-X, the configuration of the device follows the registers.
+#define VIRTIO_REGISTER_DEVICE_CONFIG (0x14)
+
+// The queue is given to a legacy device as the number of its first page.
+#define VIRTIO_QUEUE_ALIGNMENT (4096)
+
+// 2.6 Split Virtqueues
+
+#define VIRTIO_DESCRIPTOR_NEXT (1)
+#define VIRTIO_DESCRIPTOR_WRITE (2)
+
+#define VIRTIO_USED_NO_NOTIFY (1)
+
+struct PACKED VirtioDescriptor
+{
+    uint64_t address;
+    uint32_t length;
+    uint16_t flags;
+    uint16_t next;
+};
+
+struct PACKED VirtioAvailable
+{
+    uint16_t flags;
+    uint16_t index;
+    uint16_t ring[];
+};
+
+struct PACKED VirtioUsedElement
+{
+    uint32_t id;
+    uint32_t length;
+};
+
+struct PACKED VirtioUsed
+{
+    uint16_t flags;
+    uint16_t index;
+    VirtioUsedElement ring[];
+};
@@ -10,6 +10,8 @@
 #include "kernel/bus/UNIX.h"
 #include "kernel/devices/Devices.h"
 #include "kernel/devices/Driver.h"
+#include "kernel/interrupts/Dispatcher.h"
+#include "kernel/system/Trace.h"
 
 static Vector<RefPtr<Device>> *_devices = nullptr;
 
@@ -77,33 +79,12 @@ void device_iterate(IterationCallback<RefPtr<Device>> callback)
     }
 }
 
-void devices_acknowledge_interrupt(int interrupt)
-{
-    device_iterate([&](auto device) {
-        if (device->interrupt() == interrupt)
-        {
-            device->acknowledge_interrupt();
-        }
-
-        return Iteration::CONTINUE;
-    });
-}
-
-void devices_handle_interrupt(int interrupt)
-{
-    device_iterate([&](auto device) {
-        if (device->interrupt() == interrupt)
-        {
-            device->handle_interrupt();
-        }
-
-        return Iteration::CONTINUE;
-    });
-}
-
 void device_initialize()
 {
-    pci_initialize();
+    {
+        TraceSpan span{"pci"};
+        pci_initialize();
+    }
 
     logger_info("Initializing devices...");
 
@@ -123,6 +104,8 @@ void device_initialize()
 
         logger_info("Found a driver: %s", driver->name());
 
+        TraceSpan span{driver->name()};
+
         auto device = driver->instance(address);
         if (!device->did_fail())
         {
@@ -131,4 +114,9 @@ void device_initialize()
 
         return Iteration::CONTINUE;
     });
+
+    device_iterate([&](RefPtr<Device> device) {
+        dispatcher_register(device);
+        return Iteration::CONTINUE;
+    });
 }
@@ -15,8 +15,4 @@ String device_claim_name(DeviceClass klass);
 
 void device_initialize();
 
-void devices_acknowledge_interrupt(int interrupt);
-
-void devices_handle_interrupt(int interrupt);
-
 void device_mount(RefPtr<Device> device);
@@ -32,11 +32,11 @@ public:
 
         case LEGACY_ATA0:
         case LEGACY_ATA1:
-            return 5;
+            return 14;
 
         case LEGACY_ATA2:
         case LEGACY_ATA3:
-            return 6;
+            return 15;
 
         case LEGACY_MOUSE:
             return 12;
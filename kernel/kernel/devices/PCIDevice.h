@@ -2,6 +2,7 @@
 
 #include "kernel/bus/PCI.h"
 #include "kernel/devices/Driver.h"
+#include "kernel/interrupts/Dispatcher.h"
 #include "kernel/memory/MemoryRange.h"
 
 enum class PCIBarType
@@ -79,6 +80,39 @@ public:
         _interrupt = pci_get_interrupt(pci_address());
     }
 
+    // The interrupt is then the device's own, not shared through a pin.
+    // Has to be called before the device is registered, the legacy
+    // interrupt is kept if it fails.
+    bool enable_msi()
+    {
+        int capability = pci_find_capability(pci_address(), PCI_CAPABILITY_MSI);
+
+        if (capability == 0)
+        {
+            return false;
+        }
+
+        uint64_t message_address = 0;
+        uint32_t message_data = 0;
+        int irq = dispatcher_allocate_msi(&message_address, &message_data);
+
+        if (irq < 0)
+        {
+            return false;
+        }
+
+        pci_enable_msi(pci_address(), capability, message_address, message_data);
+        _interrupt = irq;
+
+        return true;
+    }
+
+    // Lets the device read and write memory by itself, for DMA.
+    void enable_bus_mastering()
+    {
+        pci_enable_bus_mastering(pci_address());
+    }
+
     PCIBar bar(int index)
     {
         assert(index >= 0 && index <= 5);
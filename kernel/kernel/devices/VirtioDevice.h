@@ -1,19 +1,110 @@
 #pragma once
 
+#include <libutils/OwnPtr.h>
+
 #include "kernel/bus/Virtio.h"
 #include "kernel/devices/PCIDevice.h"
+#include "kernel/devices/VirtioQueue.h"
 
+// Through the legacy interface, in the first BAR. Devices which only have
+// the modern one have no I/O ports there.
 class VirtioDevice : public PCIDevice
 {
 private:
+    uint16_t _io_base = 0;
+
+    void status(uint8_t status)
+    {
+        out8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS, status);
+    }
+
+    uint8_t status()
+    {
+        return in8(_io_base + VIRTIO_REGISTER_DEVICE_STATUS);
+    }
+
 public:
+    bool legacy() { return _io_base != 0; }
+
     VirtioDevice(DeviceAddress address, DeviceClass klass) : PCIDevice(address, klass)
     {
+        auto bar0 = bar(0);
+
+        if (bar0.type() == PCIBarType::PIO)
+        {
+            _io_base = bar0.base();
+        }
     }
 
     ~VirtioDevice()
     {
     }
+
+    // 3.1.1 Driver Requirements: Device Initialization, the device is
+    // reset and the features we want and it has are accepted.
+    uint32_t negotiate(uint32_t features)
+    {
+        status(0);
+        status(VIRTIO_STATUS_ACKNOWLEDGE);
+        status(VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+
+        uint32_t accepted = in32(_io_base + VIRTIO_REGISTER_DEVICE_FEATURES) & features;
+        out32(_io_base + VIRTIO_REGISTER_GUEST_FEATURES, accepted);
+
+        return accepted;
+    }
+
+    // Null if the device doesn't have this queue.
+    OwnPtr<VirtioQueue> setup_queue(int index)
+    {
+        out16(_io_base + VIRTIO_REGISTER_QUEUE_SELECT, index);
+
+        uint16_t size = in16(_io_base + VIRTIO_REGISTER_QUEUE_SIZE);
+
+        if (size == 0)
+        {
+            return nullptr;
+        }
+
+        auto queue = own<VirtioQueue>(index, size);
+        out32(_io_base + VIRTIO_REGISTER_QUEUE_ADDRESS, queue->physical_base() / VIRTIO_QUEUE_ALIGNMENT);
+
+        return queue;
+    }
+
+    void ready()
+    {
+        status(status() | VIRTIO_STATUS_DRIVER_OK);
+    }
+
+    void failed()
+    {
+        status(status() | VIRTIO_STATUS_FAILED);
+    }
+
+    void notify(VirtioQueue &queue)
+    {
+        if (queue.should_notify())
+        {
+            out16(_io_base + VIRTIO_REGISTER_QUEUE_NOTIFY, queue.index());
+        }
+    }
+
+    // Reading it also lowers the interrupt line.
+    uint8_t interrupt_status()
+    {
+        return in8(_io_base + VIRTIO_REGISTER_ISR_STATUS);
+    }
+
+    uint32_t read_config32(size_t offset)
+    {
+        return in32(_io_base + VIRTIO_REGISTER_DEVICE_CONFIG + offset);
+    }
+
+    uint64_t read_config64(size_t offset)
+    {
+        return read_config32(offset) | ((uint64_t)read_config32(offset + 4) << 32);
+    }
 };
 
 template <typename VirtioDeviceType>
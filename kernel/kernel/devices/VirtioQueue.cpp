@@ -0,0 +1,119 @@
+#include <assert.h>
+#include <string.h>
+
+#include "kernel/devices/VirtioQueue.h"
+
+// The used ring starts on the next page. The rings end with an event
+// index, which we don't use.
+static size_t used_offset(uint16_t size)
+{
+    size_t available_end = sizeof(VirtioDescriptor) * size +
+                           sizeof(VirtioAvailable) + sizeof(uint16_t) * (size + 1);
+
+    return ALIGN_UP(available_end, VIRTIO_QUEUE_ALIGNMENT);
+}
+
+size_t VirtioQueue::memory_size(uint16_t size)
+{
+    size_t used_size = sizeof(VirtioUsed) + sizeof(VirtioUsedElement) * size + sizeof(uint16_t);
+
+    return used_offset(size) + ALIGN_UP(used_size, VIRTIO_QUEUE_ALIGNMENT);
+}
+
+VirtioQueue::VirtioQueue(int index, uint16_t size)
+    : _index{index}, _size{size}
+{
+    _memory = make<MMIORange>(memory_size(size));
+    memset(reinterpret_cast<void *>(_memory->base()), 0, _memory->size());
+
+    _descriptors = reinterpret_cast<VirtioDescriptor *>(_memory->base());
+    _available = reinterpret_cast<VirtioAvailable *>(_memory->base() + sizeof(VirtioDescriptor) * size);
+    _used = reinterpret_cast<VirtioUsed *>(_memory->base() + used_offset(size));
+
+    for (uint16_t i = 0; i < size; i++)
+    {
+        _descriptors[i].next = i + 1;
+    }
+
+    _free_head = 0;
+    _free_count = size;
+}
+
+int VirtioQueue::submit(VirtioBuffer *buffers, size_t count)
+{
+    assert(count > 0);
+
+    if (count > _free_count)
+    {
+        return -1;
+    }
+
+    uint16_t head = _free_head;
+    uint16_t index = head;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto &descriptor = _descriptors[index];
+
+        descriptor.address = buffers[i].physical;
+        descriptor.length = buffers[i].size;
+        descriptor.flags = buffers[i].writable ? VIRTIO_DESCRIPTOR_WRITE : 0;
+
+        // The free descriptors are already chained, the last one keeps its
+        // link to the rest of them.
+        if (i + 1 < count)
+        {
+            descriptor.flags |= VIRTIO_DESCRIPTOR_NEXT;
+        }
+
+        index = descriptor.next;
+    }
+
+    _free_head = index;
+    _free_count -= count;
+
+    uint16_t available = _available->index;
+    _available->ring[available % _size] = head;
+
+    // The device must see the chain before the index which publishes it.
+    __atomic_store_n(&_available->index, (uint16_t)(available + 1), __ATOMIC_RELEASE);
+
+    return head;
+}
+
+bool VirtioQueue::collect(uint16_t *head, uint32_t *length)
+{
+    if (_last_used == __atomic_load_n(&_used->index, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    auto &element = _used->ring[_last_used % _size];
+    _last_used++;
+
+    *head = element.id;
+    *length = element.length;
+
+    uint16_t last = element.id;
+    uint16_t count = 1;
+
+    while (_descriptors[last].flags & VIRTIO_DESCRIPTOR_NEXT)
+    {
+        last = _descriptors[last].next;
+        count++;
+    }
+
+    _descriptors[last].next = _free_head;
+    _free_head = element.id;
+    _free_count += count;
+
+    return true;
+}
+
+bool VirtioQueue::should_notify()
+{
+    // Our index has to be out before the device's flags are looked at.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return !(__atomic_load_n(&_used->flags, __ATOMIC_ACQUIRE) & VIRTIO_USED_NO_NOTIFY);
+}
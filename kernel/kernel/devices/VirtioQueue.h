@@ -0,0 +1,65 @@
+#pragma once
+
+#include <libutils/RefPtr.h>
+
+#include "kernel/bus/Virtio.h"
+#include "kernel/memory/MMIO.h"
+
+struct VirtioBuffer
+{
+    uintptr_t physical;
+    size_t size;
+
+    // Written by the device, read by us.
+    bool writable;
+};
+
+// The descriptors, the available ring and the used ring of a queue, laid
+// out in one physical range like legacy devices want them. Not safe to be
+// used by more than one task at once.
+class VirtioQueue
+{
+private:
+    int _index;
+    uint16_t _size;
+
+    RefPtr<MMIORange> _memory;
+
+    VirtioDescriptor *_descriptors;
+    VirtioAvailable *_available;
+    VirtioUsed *_used;
+
+    // The unused descriptors are chained through their next field.
+    uint16_t _free_head = 0;
+    uint16_t _free_count = 0;
+
+    uint16_t _last_used = 0;
+
+    NONCOPYABLE(VirtioQueue);
+    NONMOVABLE(VirtioQueue);
+
+public:
+    static size_t memory_size(uint16_t size);
+
+    int index() { return _index; }
+
+    uint16_t size() { return _size; }
+
+    uint16_t free_count() { return _free_count; }
+
+    uintptr_t physical_base() { return _memory->physical_base(); }
+
+    VirtioQueue(int index, uint16_t size);
+
+    // Chains the buffers and makes them available to the device. Returns
+    // the head of the chain, the device hands it back once it is done, or
+    // -1 if there aren't enough free descriptors.
+    int submit(VirtioBuffer *buffers, size_t count);
+
+    // Takes back a chain the device is done with, false if there is none.
+    bool collect(uint16_t *head, uint32_t *length);
+
+    // The device may ask not to be notified while it is still going
+    // through the available ring.
+    bool should_notify();
+};
@@ -203,6 +203,8 @@ E1000::E1000(DeviceAddress address) : PCIDevice(address, DeviceClass::NETWORK)
 
     initialize_rx();
     initialize_tx();
+
+    enable_msi();
     enable_interrupt();
 }
 
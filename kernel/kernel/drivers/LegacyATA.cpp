@@ -1,6 +1,12 @@
 #include <libsystem/Logger.h>
+#include <skift/Lock.h>
+#include <string.h>
 
+#include "archs/Arch.h"
+
+#include "kernel/bus/PCI.h"
 #include "kernel/drivers/LegacyATA.h"
+#include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/tasking/Task.h"
 
@@ -22,31 +28,37 @@
 #define ATA_SR_IDX 0x02
 #define ATA_SR_ERR 0x01
 
-// Identify
+// Identify, in words
 #define ATA_IDENT_DEVICETYPE 0
-#define ATA_IDENT_CYLINDERS 2
-#define ATA_IDENT_HEADS 6
-#define ATA_IDENT_SECTORS 12
-#define ATA_IDENT_SERIAL 20
-#define ATA_IDENT_MODEL 54
-#define ATA_IDENT_NUM_BLOCKS0 60
-#define ATA_IDENT_NUM_BLOCKS1 61
+#define ATA_IDENT_CYLINDERS 1
+#define ATA_IDENT_HEADS 3
+#define ATA_IDENT_SECTORS 6
+#define ATA_IDENT_SERIAL 10
+#define ATA_IDENT_MODEL 27
+#define ATA_IDENT_MULTIPLE 47
+#define ATA_IDENT_CAPABILITIES 49
+#define ATA_IDENT_FIELDVALID 53
+#define ATA_IDENT_MAX_LBA 60
+#define ATA_IDENT_COMMANDSETS 82
 #define ATA_IDENT_LBA 83
-#define ATA_IDENT_CAPABILITIES 98
-#define ATA_IDENT_FIELDVALID 106
-#define ATA_IDENT_MAX_LBA 120
-#define ATA_IDENT_COMMANDSETS 164
-#define ATA_IDENT_MAX_LBA_EXT 200
+#define ATA_IDENT_MAX_LBA_EXT 100
+
+#define ATA_CAPABILITY_DMA (1 << 8)
 
 // Commands
 #define ATA_CMD_READ_PIO 0x20
 #define ATA_CMD_READ_PIO_EXT 0x24
+#define ATA_CMD_READ_MULTIPLE 0xC4
+#define ATA_CMD_READ_MULTIPLE_EXT 0x29
 #define ATA_CMD_READ_DMA 0xC8
 #define ATA_CMD_READ_DMA_EXT 0x25
 #define ATA_CMD_WRITE_PIO 0x30
 #define ATA_CMD_WRITE_PIO_EXT 0x34
+#define ATA_CMD_WRITE_MULTIPLE 0xC5
+#define ATA_CMD_WRITE_MULTIPLE_EXT 0x39
 #define ATA_CMD_WRITE_DMA 0xCA
 #define ATA_CMD_WRITE_DMA_EXT 0x35
+#define ATA_CMD_SET_MULTIPLE 0xC6
 #define ATA_CMD_CACHE_FLUSH 0xE7
 #define ATA_CMD_CACHE_FLUSH_EXT 0xEA
 #define ATA_CMD_PACKET 0xA0
@@ -64,23 +76,128 @@
 #define ATA_REG_HDDEVSEL 0x06
 #define ATA_REG_COMMAND 0x07
 #define ATA_REG_STATUS 0x07
-#define ATA_REG_SECCOUNT1 0x08
-#define ATA_REG_LBA3 0x09
-#define ATA_REG_LBA4 0x0A
-#define ATA_REG_LBA5 0x0B
-#define ATA_REG_CONTROL 0x0C
-#define ATA_REG_ALTSTATUS 0x0C
-#define ATA_REG_DEVADDRESS 0x0D
+
+// Device control, the same port gives the status without lowering the
+// interrupt.
+#define ATA_CONTROL_RESET 0x04
+
+// Bus master registers, the ones of the secondary channel come after the
+// ones of the primary.
+#define ATA_BM_COMMAND 0x00
+#define ATA_BM_STATUS 0x02
+#define ATA_BM_REGIONS 0x04
+#define ATA_BM_SECONDARY 0x08
+
+#define ATA_BM_COMMAND_START 0x01
+#define ATA_BM_COMMAND_READ 0x08
+
+#define ATA_BM_STATUS_ACTIVE 0x01
+#define ATA_BM_STATUS_ERROR 0x02
+#define ATA_BM_STATUS_INTERRUPT 0x04
+
+#define ATA_REGION_BOUNDARY 0x10000
+#define ATA_REGION_END 0x8000
 
 // IO Ports
 #define ATA_PRIMARY_IO 0x1F0
 #define ATA_SECONDARY_IO 0x170
+#define ATA_PRIMARY_CONTROL 0x3F6
+#define ATA_SECONDARY_CONTROL 0x376
 
 // LBA modes
 #define ATA_28LBA_MAX 0x0FFFFFFF
 #define ATA_48LBA_MAX 0xFFFFFFFFFFFF
 #define ATA_SECTOR_SIZE 512
 
+// Milliseconds a DMA transfer may take before the channel is reset.
+#define ATA_DMA_TIMEOUT 5000
+
+// Both drives of a channel share its registers, one command at a time.
+struct ATAChannel
+{
+    uint16_t io;
+    uint16_t control;
+
+    // 0 without a PCI IDE controller to be the bus master.
+    uint16_t bus_master;
+
+    Lock lock;
+};
+
+static ATAChannel _channels[2] = {
+    {ATA_PRIMARY_IO, ATA_PRIMARY_CONTROL, 0, {"ata-primary"}},
+    {ATA_SECONDARY_IO, ATA_SECONDARY_CONTROL, 0, {"ata-secondary"}},
+};
+
+static bool _bus_master_probed = false;
+
+// Only the channels in compatibility mode are at the legacy ports.
+static void ata_probe_bus_master()
+{
+    if (_bus_master_probed)
+    {
+        return;
+    }
+
+    _bus_master_probed = true;
+
+    pci_scan([](PCIAddress address) {
+        if (address.read_class_sub_class() != PCI_TYPE_IDE)
+        {
+            return Iteration::CONTINUE;
+        }
+
+        uint8_t interface = address.read8(PCI_PROG_IF);
+        uint32_t bar4 = address.read32(PCI_BAR4);
+
+        if (!(interface & 0x80) || !(bar4 & 1))
+        {
+            return Iteration::STOP;
+        }
+
+        uint16_t base = bar4 & 0xFFFC;
+
+        if (!(interface & 0x01))
+        {
+            _channels[ATA_PRIMARY].bus_master = base;
+        }
+
+        if (!(interface & 0x04))
+        {
+            _channels[ATA_SECONDARY].bus_master = base + ATA_BM_SECONDARY;
+        }
+
+        pci_enable_bus_mastering(address);
+
+        logger_info("IDE bus master at %04x on PCI:%02x:%02x.%x", base, address.bus(), address.slot(), address.func());
+
+        return Iteration::STOP;
+    });
+}
+
+static bool ata_dma_done(uint16_t bus_master)
+{
+    return in8(bus_master + ATA_BM_STATUS) & (ATA_BM_STATUS_INTERRUPT | ATA_BM_STATUS_ERROR);
+}
+
+// The interrupt of the drive wakes up the dispatcher, which has the blocked
+// tasks checked right after.
+class BlockerATATransfer : public Blocker
+{
+private:
+    uint16_t _bus_master;
+
+public:
+    BlockerATATransfer(uint16_t bus_master) : _bus_master{bus_master}
+    {
+    }
+
+    bool can_unblock(Task &) override
+    {
+        return ata_dma_done(_bus_master);
+    }
+};
+
 LegacyATA::LegacyATA(DeviceAddress address) : LegacyDevice(address, DeviceClass::DISK)
 {
     switch (address.legacy())
@@ -107,12 +224,49 @@ LegacyATA::LegacyATA(DeviceAddress address) : LegacyDevice(address, DeviceClass:
     }
 
     identify();
+
+    if (!_exists)
+    {
+        return;
+    }
+
+    auto &channel = _channels[_bus];
+
+    // The interrupts of the drive are let through.
+    out8(channel.control, 0);
+
+    if (_multiple > 0)
+    {
+        select();
+        out8(channel.io + ATA_REG_SECCOUNT0, _multiple);
+        out8(channel.io + ATA_REG_COMMAND, ATA_CMD_SET_MULTIPLE);
+
+        if (wait(false) != SUCCESS)
+        {
+            _multiple = 0;
+        }
+    }
+
+    _buffer = make<MMIORange>(ATA_TRANSFER_SECTORS * ATA_SECTOR_SIZE);
+    _regions = make<MMIORange>(ARCH_PAGE_SIZE);
+
+    ata_probe_bus_master();
+
+    // The addresses in the table are 32 bits.
+    _supports_dma = channel.bus_master != 0 &&
+                    (_ide_buffer[ATA_IDENT_CAPABILITIES] & ATA_CAPABILITY_DMA) &&
+                    _buffer->physical_end() <= 0xFFFFFFFF &&
+                    _regions->physical_end() <= 0xFFFFFFFF;
+
+    _use_dma = _supports_dma;
+
+    logger_info("%u sectors per interrupt, DMA: %i", MAX(_multiple, 1), _supports_dma);
 }
 
 void LegacyATA::select()
 {
-    const uint16_t io_port = _bus == ATA_PRIMARY ? ATA_PRIMARY_IO : ATA_SECONDARY_IO;
-    out8(io_port + ATA_REG_HDDEVSEL, _drive == ATA_MASTER ? 0xA0 : 0xB0);
+    out8(_channels[_bus].io + ATA_REG_HDDEVSEL, _drive == ATA_MASTER ? 0xA0 : 0xB0);
+    delay();
 }
 
 size_t LegacyATA::size()
@@ -123,7 +277,7 @@ size_t LegacyATA::size()
 void LegacyATA::identify()
 {
     select();
-    const uint16_t io_port = _bus == ATA_PRIMARY ? ATA_PRIMARY_IO : ATA_SECONDARY_IO;
+    const uint16_t io_port = _channels[_bus].io;
 
     /* ATA specs say these values must be zero before sending IDENTIFY */
     out8(io_port + ATA_REG_SECCOUNT0, 0);
@@ -159,10 +313,7 @@ void LegacyATA::identify()
         logger_info("%s%s is online.", _bus == ATA_PRIMARY ? "Primary" : "Secondary", _drive == ATA_PRIMARY ? " master" : " slave");
 
         // Read back the data
-        for (size_t i = 0; i < _ide_buffer.count(); i++)
-        {
-            _ide_buffer[i] = in16(io_port + ATA_REG_DATA);
-        }
+        in16_repeat(io_port + ATA_REG_DATA, _ide_buffer.raw_storage(), _ide_buffer.count());
 
         _exists = true;
 
@@ -177,9 +328,23 @@ void LegacyATA::identify()
         _model = String(model_buf.raw_storage(), model_buf.count());
         _supports_48lba = (_ide_buffer[ATA_IDENT_LBA] >> 10) & 0x1;
 
-        _num_blocks = _ide_buffer[ATA_IDENT_NUM_BLOCKS1] << 16 | _ide_buffer[ATA_IDENT_NUM_BLOCKS0];
+        if (_supports_48lba)
+        {
+            _num_blocks = 0;
+
+            for (int i = 3; i >= 0; i--)
+            {
+                _num_blocks = (_num_blocks << 16) | _ide_buffer[ATA_IDENT_MAX_LBA_EXT + i];
+            }
+        }
+        else
+        {
+            _num_blocks = _ide_buffer[ATA_IDENT_MAX_LBA + 1] << 16 | _ide_buffer[ATA_IDENT_MAX_LBA];
+        }
+
+        _multiple = _ide_buffer[ATA_IDENT_MULTIPLE] & 0xFF;
 
-        logger_info("IDENITY: Modelname: %s LBA48: %i NB: %i", _model.cstring(), _supports_48lba, _num_blocks);
+        logger_info("IDENITY: Modelname: %s LBA48: %i NB: %u", _model.cstring(), _supports_48lba, (uint32_t)_num_blocks);
     }
     else
     {
@@ -188,134 +353,295 @@ void LegacyATA::identify()
     }
 }
 
-void LegacyATA::delay(uint16_t io_port)
+void LegacyATA::delay()
 {
     // exactly 400ns
     for (int i = 0; i < 4; i++)
-        in8(io_port + ATA_REG_ALTSTATUS);
+        in8(_channels[_bus].control);
 }
 
-void LegacyATA::poll(uint16_t io_port)
+// Until the drive is no longer busy, and has data to move if it should.
+Result LegacyATA::wait(bool data)
 {
-    delay(io_port);
+    delay();
 
-    /* Now, poll untill BSY is clear. */
-    while ((in8(io_port + ATA_REG_STATUS) & ATA_SR_BSY) != 0)
-        task_sleep(scheduler_running(), 10);
+    uint8_t status;
 
-    uint8_t status = 0;
+    while ((status = in8(_channels[_bus].control)) & ATA_SR_BSY)
+    {
+        asm volatile("pause");
+    }
 
-    do
+    if ((status & (ATA_SR_ERR | ATA_SR_DF)) || (data && !(status & ATA_SR_DRQ)))
     {
-        status = in8(io_port + ATA_REG_STATUS);
+        logger_error("%s%s failed with status %02x.", _bus == ATA_PRIMARY ? "Primary" : "Secondary",
+                     _drive == ATA_PRIMARY ? " master" : " slave", status);
 
-        if (status & ATA_SR_ERR)
-        {
-            logger_error("%s%s has ERR set. Disabled.", _bus == ATA_PRIMARY ? "Primary" : "Secondary",
-                         _drive == ATA_PRIMARY ? " master" : " slave");
+        return ERR_INPUT_OUTPUT;
+    }
 
-            return;
-        }
-    } while (!(status & ATA_SR_DRQ));
-    return;
+    return SUCCESS;
 }
 
-void LegacyATA::write_lba(uint16_t io_port, uint32_t lba)
+// A count of 256 is written as 0 by LBA28 commands, LBA48 ones take the
+// high bytes first through the same registers.
+void LegacyATA::write_lba(uint64_t lba, size_t count)
 {
-    const uint8_t cmd = (_drive == ATA_MASTER ? 0xE0 : 0xF0);
-
-    // Write LBA address
-    out8(io_port + 1, 0x00);                                                 // Null byte to first port
-    out8(io_port + ATA_REG_LBA0, (uint8_t)(lba));                            // First byte of LBA
-    out8(io_port + ATA_REG_LBA1, (uint8_t)(lba));                            // Second byte of LBA
-    out8(io_port + ATA_REG_LBA2, (uint8_t)(lba));                            // Third byte of LBA
-    out8(io_port + ATA_REG_HDDEVSEL, (cmd | (uint8_t)((lba >> 24 & 0x0F)))); // High 4-bits of LBA
+    const uint16_t io_port = _channels[_bus].io;
+
+    if (_supports_48lba)
+    {
+        out8(io_port + ATA_REG_HDDEVSEL, _drive == ATA_MASTER ? 0x40 : 0x50);
+
+        out8(io_port + ATA_REG_SECCOUNT0, (count >> 8) & 0xFF);
+        out8(io_port + ATA_REG_LBA0, (lba >> 24) & 0xFF);
+        out8(io_port + ATA_REG_LBA1, (lba >> 32) & 0xFF);
+        out8(io_port + ATA_REG_LBA2, (lba >> 40) & 0xFF);
+    }
+    else
+    {
+        const uint8_t cmd = (_drive == ATA_MASTER ? 0xE0 : 0xF0);
+        out8(io_port + ATA_REG_HDDEVSEL, cmd | ((lba >> 24) & 0x0F));
+    }
+
+    out8(io_port + ATA_REG_SECCOUNT0, count & 0xFF);
+    out8(io_port + ATA_REG_LBA0, lba & 0xFF);
+    out8(io_port + ATA_REG_LBA1, (lba >> 8) & 0xFF);
+    out8(io_port + ATA_REG_LBA2, (lba >> 16) & 0xFF);
 }
 
-uint8_t LegacyATA::read_block(uint8_t *buf, uint32_t lba, size_t size)
+// The drive is polled before each block, they are small enough for it to
+// be ready most of the time.
+Result LegacyATA::transfer_pio(bool write, uint64_t lba, size_t count)
 {
-    assert(size <= ATA_SECTOR_SIZE);
-    const uint16_t io_port = _bus == ATA_PRIMARY ? ATA_PRIMARY_IO : ATA_SECONDARY_IO;
-    write_lba(io_port, lba);
-
-    // Issue Read command
-    out8(io_port + ATA_REG_COMMAND, ATA_CMD_READ_PIO);
+    const uint16_t io_port = _channels[_bus].io;
 
-    // Poll
-    poll(io_port);
+    uint8_t command;
 
-    for (unsigned int i = 0; i < (size / 2); i++)
+    if (_multiple > 0)
     {
-        uint16_t data = in16(io_port + ATA_REG_DATA);
-        *(uint16_t *)(buf + i * 2) = data;
+        command = write ? (_supports_48lba ? ATA_CMD_WRITE_MULTIPLE_EXT : ATA_CMD_WRITE_MULTIPLE)
+                        : (_supports_48lba ? ATA_CMD_READ_MULTIPLE_EXT : ATA_CMD_READ_MULTIPLE);
     }
+    else
+    {
+        command = write ? (_supports_48lba ? ATA_CMD_WRITE_PIO_EXT : ATA_CMD_WRITE_PIO)
+                        : (_supports_48lba ? ATA_CMD_READ_PIO_EXT : ATA_CMD_READ_PIO);
+    }
+
+    size_t block = MAX(_multiple, 1);
+
+    write_lba(lba, count);
+    TRY(wait(false));
+
+    out8(io_port + ATA_REG_COMMAND, command);
 
-    delay(io_port);
+    auto data = reinterpret_cast<uint16_t *>(_buffer->base());
 
-    return 1;
+    for (size_t done = 0; done < count; done += block)
+    {
+        TRY(wait(true));
+
+        size_t words = MIN(count - done, block) * ATA_SECTOR_SIZE / 2;
+
+        if (write)
+        {
+            out16_repeat(io_port + ATA_REG_DATA, data + done * ATA_SECTOR_SIZE / 2, words);
+        }
+        else
+        {
+            in16_repeat(io_port + ATA_REG_DATA, data + done * ATA_SECTOR_SIZE / 2, words);
+        }
+    }
+
+    // The last block is written once the drive is no longer busy.
+    return wait(false);
 }
 
-uint8_t LegacyATA::write_block(uint8_t *buf, uint32_t lba, size_t size)
+Result LegacyATA::transfer_dma(bool write, uint64_t lba, size_t count)
 {
-    assert(size <= ATA_SECTOR_SIZE);
-    const uint16_t io_port = _bus == ATA_PRIMARY ? ATA_PRIMARY_IO : ATA_SECONDARY_IO;
-    write_lba(io_port, lba);
+    auto &channel = _channels[_bus];
+    const uint16_t bus_master = channel.bus_master;
+
+    auto regions = reinterpret_cast<ATAPhysicalRegion *>(_regions->base());
+    uintptr_t physical = _buffer->physical_base();
+    size_t remaining = count * ATA_SECTOR_SIZE;
+    size_t index = 0;
 
-    // Issue Write command
-    out8(io_port + ATA_REG_COMMAND, ATA_CMD_WRITE_PIO);
+    while (remaining > 0)
+    {
+        size_t size = MIN(remaining, ATA_REGION_BOUNDARY - physical % ATA_REGION_BOUNDARY);
+
+        regions[index++] = {(uint32_t)physical, (uint16_t)(size & 0xFFFF), 0};
+
+        physical += size;
+        remaining -= size;
+    }
+
+    regions[index - 1].flags = ATA_REGION_END;
+
+    // The bits which say the drives can do DMA are kept, the other ones are
+    // cleared by writing ones.
+    out8(bus_master + ATA_BM_COMMAND, 0);
+    out32(bus_master + ATA_BM_REGIONS, _regions->physical_base());
+    out8(bus_master + ATA_BM_STATUS, (in8(bus_master + ATA_BM_STATUS) & 0x60) | ATA_BM_STATUS_ERROR | ATA_BM_STATUS_INTERRUPT);
 
-    // Poll
-    poll(io_port);
+    write_lba(lba, count);
+    TRY(wait(false));
 
-    for (unsigned int i = 0; i < (size / 2); i++)
+    out8(channel.io + ATA_REG_COMMAND, write ? (_supports_48lba ? ATA_CMD_WRITE_DMA_EXT : ATA_CMD_WRITE_DMA)
+                                             : (_supports_48lba ? ATA_CMD_READ_DMA_EXT : ATA_CMD_READ_DMA));
+
+    // Reading from the disk is writing to memory.
+    out8(bus_master + ATA_BM_COMMAND, (write ? 0 : ATA_BM_COMMAND_READ) | ATA_BM_COMMAND_START);
+
+    // The buffer is written by the drive, it isn't given up on until it
+    // stops.
+    while (!ata_dma_done(bus_master))
     {
-        uint16_t tmp = (buf[i * 2 + 1] << 8) | buf[i * 2];
-        out16(io_port, tmp);
+        BlockerATATransfer blocker{bus_master};
+
+        if (task_block(scheduler_running(), blocker, ATA_DMA_TIMEOUT) == TIMEOUT)
+        {
+            logger_error("DMA transfer timed out, resetting the channel");
+
+            out8(bus_master + ATA_BM_COMMAND, 0);
+            out8(channel.control, ATA_CONTROL_RESET);
+            delay();
+            out8(channel.control, 0);
+
+            return ERR_INPUT_OUTPUT;
+        }
     }
 
-    delay(io_port);
+    out8(bus_master + ATA_BM_COMMAND, 0);
+
+    uint8_t bus_master_status = in8(bus_master + ATA_BM_STATUS);
+    out8(bus_master + ATA_BM_STATUS, (bus_master_status & 0x60) | ATA_BM_STATUS_ERROR | ATA_BM_STATUS_INTERRUPT);
+
+    if (bus_master_status & ATA_BM_STATUS_ERROR)
+    {
+        logger_error("The bus master failed with status %02x", bus_master_status);
+        return ERR_INPUT_OUTPUT;
+    }
 
-    return 1;
+    return wait(false);
+}
+
+Result LegacyATA::transfer(bool write, uint64_t lba, size_t count)
+{
+    assert(count > 0 && count <= ATA_TRANSFER_SECTORS);
+
+    if (_use_dma)
+    {
+        return transfer_dma(write, lba, count);
+    }
+    else
+    {
+        return transfer_pio(write, lba, count);
+    }
+}
+
+void LegacyATA::acknowledge_interrupt()
+{
+    // Lowers the interrupt of the drive, the bus master keeps its status
+    // until the transfer is done with.
+    in8(_channels[_bus].io + ATA_REG_STATUS);
 }
 
 ResultOr<size_t> LegacyATA::read(size64_t offset, void *buffer, size_t size)
 {
-    LockHolder holder(_buffer_lock);
+    if (offset >= this->size())
+    {
+        return 0;
+    }
+
+    size = MIN(size, this->size() - offset);
 
-    uint32_t start_lba = offset / ATA_SECTOR_SIZE;
-    uint32_t num_blocks = (size / ATA_SECTOR_SIZE) + 1;
-    uint8_t *byte_buffer = (uint8_t *)buffer;
-    size_t rem_size = size;
+    LockHolder holder(_channels[_bus].lock);
 
-    // Read *size* at maximum
-    for (unsigned int i = 0; i < num_blocks; i++)
+    auto sectors = reinterpret_cast<uint8_t *>(_buffer->base());
+    size_t done = 0;
+
+    while (done < size)
     {
-        size_t read_size = MIN(ATA_SECTOR_SIZE, rem_size);
-        read_block(byte_buffer, start_lba + i, read_size);
-        byte_buffer += ATA_SECTOR_SIZE;
-        rem_size -= read_size;
+        size64_t position = offset + done;
+        size_t skip = position % ATA_SECTOR_SIZE;
+        size_t chunk = MIN(size - done, ATA_TRANSFER_SECTORS * ATA_SECTOR_SIZE - skip);
+        size_t count = ALIGN_UP(skip + chunk, ATA_SECTOR_SIZE) / ATA_SECTOR_SIZE;
+
+        TRY(transfer(false, position / ATA_SECTOR_SIZE, count));
+
+        memcpy((uint8_t *)buffer + done, sectors + skip, chunk);
+
+        done += chunk;
     }
 
     return size;
 }
 
+// The sectors only partially written are read first.
 ResultOr<size_t> LegacyATA::write(size64_t offset, const void *buffer, size_t size)
 {
-    LockHolder holder(_buffer_lock);
+    if (offset >= this->size())
+    {
+        return 0;
+    }
+
+    size = MIN(size, this->size() - offset);
+
+    LockHolder holder(_channels[_bus].lock);
 
-    uint32_t start_lba = offset / ATA_SECTOR_SIZE;
-    uint32_t num_blocks = (size / ATA_SECTOR_SIZE) + 1;
-    uint8_t *byte_buffer = (uint8_t *)buffer;
-    size_t rem_size = size;
+    auto sectors = reinterpret_cast<uint8_t *>(_buffer->base());
+    size_t done = 0;
 
-    // Write *size* at maximum
-    for (unsigned int i = 0; i < num_blocks; i++)
+    while (done < size)
     {
-        size_t write_size = MIN(ATA_SECTOR_SIZE, rem_size);
-        write_block(byte_buffer, start_lba + i, write_size);
-        byte_buffer += ATA_SECTOR_SIZE;
-        rem_size -= write_size;
+        size64_t position = offset + done;
+        size_t skip = position % ATA_SECTOR_SIZE;
+        size_t chunk = MIN(size - done, ATA_TRANSFER_SECTORS * ATA_SECTOR_SIZE - skip);
+        size_t count = ALIGN_UP(skip + chunk, ATA_SECTOR_SIZE) / ATA_SECTOR_SIZE;
+
+        if (skip != 0 || (skip + chunk) % ATA_SECTOR_SIZE != 0)
+        {
+            TRY(transfer(false, position / ATA_SECTOR_SIZE, count));
+        }
+
+        memcpy(sectors + skip, (const uint8_t *)buffer + done, chunk);
+
+        TRY(transfer(true, position / ATA_SECTOR_SIZE, count));
+
+        done += chunk;
     }
 
     return size;
 }
+
+Result LegacyATA::call(IOCall request, void *args)
+{
+    if (request == IOCALL_DISK_GET_TRANSFER_MODE)
+    {
+        auto mode = (IOCallDiskTransferModeArgs *)args;
+        mode->dma = _use_dma;
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_DISK_SET_TRANSFER_MODE)
+    {
+        auto mode = (IOCallDiskTransferModeArgs *)args;
+
+        if (mode->dma && !_supports_dma)
+        {
+            return ERR_OPERATION_NOT_SUPPORTED;
+        }
+
+        LockHolder holder(_channels[_bus].lock);
+        _use_dma = mode->dma;
+
+        return SUCCESS;
+    }
+    else
+    {
+        return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+    }
+}
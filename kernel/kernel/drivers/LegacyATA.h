@@ -1,43 +1,72 @@
 #pragma once
 
 #include <libutils/Array.h>
-#include <skift/Lock.h>
 
 #include "kernel/devices/LegacyDevice.h"
+#include "kernel/memory/MMIO.h"
+
+// The most a command moves at once, the sector count of LBA28 commands
+// can't say more.
+#define ATA_TRANSFER_SECTORS 256
+
+// An entry of the table the bus master goes through, the region can't
+// cross a 64KiB boundary.
+struct PACKED ATAPhysicalRegion
+{
+    uint32_t address;
+
+    // 0 means 64KiB.
+    uint16_t size;
+
+    uint16_t flags;
+};
 
 class LegacyATA : public LegacyDevice
 {
 private:
-    Lock _buffer_lock{"legacy-ata"};
-
     void identify();
     void select();
-    void has_failed(uint8_t status);
 
-    void delay(uint16_t io_port);
-    void poll(uint16_t io_port);
+    void delay();
+    Result wait(bool data);
 
-    // TODO: will have to be uint64_t for LBA48
-    void write_lba(uint16_t io_port, uint32_t lba);
-    uint8_t read_block(uint8_t *buf, uint32_t lba, size_t size);
-    uint8_t write_block(uint8_t *buf, uint32_t lba, size_t size);
+    void write_lba(uint64_t lba, size_t count);
+
+    Result transfer_pio(bool write, uint64_t lba, size_t count);
+    Result transfer_dma(bool write, uint64_t lba, size_t count);
+    Result transfer(bool write, uint64_t lba, size_t count);
 
     int _bus;
     int _drive;
     Array<uint16_t, 256> _ide_buffer;
     bool _exists = false;
     String _model;
-    bool _supports_48lba;
-    size_t _num_blocks;
+    bool _supports_48lba = false;
+    uint64_t _num_blocks = 0;
+
+    // Sectors moved between two interrupts by READ/WRITE MULTIPLE, 0 if the
+    // drive doesn't have these commands.
+    int _multiple = 0;
+
+    bool _supports_dma = false;
+    bool _use_dma = false;
+
+    // Whole sectors, every transfer goes through it.
+    RefPtr<MMIORange> _buffer;
+    RefPtr<MMIORange> _regions;
 
 public:
     LegacyATA(DeviceAddress address);
 
     size_t size() override;
 
+    void acknowledge_interrupt() override;
+
     ResultOr<size_t> read(size64_t offset, void *buffer, size_t size) override;
 
     ResultOr<size_t> write(size64_t offset, const void *buffer, size_t size) override;
 
+    Result call(IOCall request, void *args) override;
+
     virtual bool did_fail() override { return !_exists; }
 };
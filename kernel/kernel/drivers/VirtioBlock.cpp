@@ -1 +1,455 @@
+#include <libsystem/Logger.h>
+#include <string.h>
+
+#include "archs/Arch.h"
+
 #include "kernel/drivers/VirtioBlock.h"
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/MemoryObject.h"
+#include "kernel/scheduling/Blocker.h"
+#include "kernel/scheduling/Scheduler.h"
+
+// Completions are also collected while the blocked tasks are checked, a
+// lost interrupt only delays them.
+class BlockerVirtioBlockRoom : public Blocker
+{
+private:
+    VirtioBlock &_device;
+    size_t _segments;
+
+public:
+    BlockerVirtioBlockRoom(VirtioBlock &device, size_t segments)
+        : _device{device}, _segments{segments}
+    {
+    }
+
+    bool can_unblock(Task &) override
+    {
+        _device.collect_completions();
+        return _device.can_submit(_segments);
+    }
+};
+
+class BlockerVirtioBlockTransfer : public Blocker
+{
+private:
+    VirtioBlock &_device;
+    VirtioBlockTransfer &_transfer;
+
+public:
+    BlockerVirtioBlockTransfer(VirtioBlock &device, VirtioBlockTransfer &transfer)
+        : _device{device}, _transfer{transfer}
+    {
+    }
+
+    bool can_unblock(Task &) override
+    {
+        _device.collect_completions();
+        return _transfer.pending == 0;
+    }
+};
+
+VirtioBlock::VirtioBlock(DeviceAddress address) : VirtioDevice(address, DeviceClass::DISK)
+{
+    if (!legacy())
+    {
+        logger_warn("Only the legacy interface of virtio is supported");
+        _failed = true;
+        return;
+    }
+
+    uint32_t features = negotiate(VIRTIO_BLOCK_FEATURE_SIZE_MAX |
+                                  VIRTIO_BLOCK_FEATURE_SEG_MAX |
+                                  VIRTIO_BLOCK_FEATURE_READ_ONLY);
+
+    _queue = setup_queue(0);
+
+    if (!_queue)
+    {
+        logger_error("The device has no request queue");
+        failed();
+        _failed = true;
+        return;
+    }
+
+    _capacity = read_config64(VIRTIO_BLOCK_CONFIG_CAPACITY);
+    _read_only = features & VIRTIO_BLOCK_FEATURE_READ_ONLY;
+
+    // Segments are whole sectors, a request never ends inside of one.
+    _segment_size_max = (size_t)-1;
+
+    if (features & VIRTIO_BLOCK_FEATURE_SIZE_MAX)
+    {
+        size_t size_max = ALIGN_DOWN(read_config32(VIRTIO_BLOCK_CONFIG_SIZE_MAX), VIRTIO_BLOCK_SECTOR_SIZE);
+        _segment_size_max = MAX(size_max, (size_t)VIRTIO_BLOCK_SECTOR_SIZE);
+    }
+
+    // The header and the status take a descriptor each.
+    _segments_max = MIN((size_t)VIRTIO_BLOCK_SEGMENTS, (size_t)_queue->size() - 2);
+
+    if (features & VIRTIO_BLOCK_FEATURE_SEG_MAX)
+    {
+        _segments_max = MIN(_segments_max, (size_t)MAX(read_config32(VIRTIO_BLOCK_CONFIG_SEG_MAX), 1u));
+    }
+    else
+    {
+        _segments_max = 1;
+    }
+
+    _requests_range = make<MMIORange>(sizeof(VirtioBlockRequest) * VIRTIO_BLOCK_REQUESTS);
+    _requests = reinterpret_cast<VirtioBlockRequest *>(_requests_range->base());
+
+    for (size_t i = 0; i < _queue->size(); i++)
+    {
+        _request_of_head.push_back(-1);
+    }
+
+    enable_bus_mastering();
+    ready();
+
+    logger_info("Virtio block device with %u sectors, %u segments per request", (uint32_t)_capacity, _segments_max);
+}
+
+bool VirtioBlock::can_submit(size_t segments)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    if (_queue->free_count() < segments + 2)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < VIRTIO_BLOCK_REQUESTS; i++)
+    {
+        if (_transfers[i] == nullptr)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void VirtioBlock::collect_completions()
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    uint16_t head;
+    uint32_t length;
+
+    while (_queue->collect(&head, &length))
+    {
+        int request = _request_of_head[head];
+        _request_of_head[head] = -1;
+
+        auto *transfer = _transfers[request];
+        _transfers[request] = nullptr;
+
+        if (_requests[request].status != VIRTIO_BLOCK_STATUS_OK)
+        {
+            transfer->failed = true;
+        }
+
+        transfer->pending--;
+    }
+}
+
+void VirtioBlock::acknowledge_interrupt()
+{
+    interrupt_status();
+}
+
+void VirtioBlock::handle_interrupt()
+{
+    InterruptsRetainer retainer;
+
+    collect_completions();
+}
+
+// The buffers start with room for the header, and end with room for the
+// status.
+bool VirtioBlock::submit(VirtioBlockTransfer &transfer, uint32_t type, uint64_t sector, VirtioBuffer *buffers, size_t count)
+{
+    InterruptsRetainer retainer;
+
+    collect_completions();
+
+    if (!can_submit(count - 2))
+    {
+        return false;
+    }
+
+    int request = 0;
+
+    while (_transfers[request] != nullptr)
+    {
+        request++;
+    }
+
+    auto &header = _requests[request];
+    header.type = type;
+    header.reserved = 0;
+    header.sector = sector;
+    header.status = 0xFF;
+
+    uintptr_t header_physical = _requests_range->physical_base() + request * sizeof(VirtioBlockRequest);
+
+    buffers[0] = {header_physical, offsetof(VirtioBlockRequest, status), false};
+    buffers[count - 1] = {header_physical + offsetof(VirtioBlockRequest, status), 1, true};
+
+    int head = _queue->submit(buffers, count);
+    assert(head >= 0);
+
+    _request_of_head[head] = request;
+    _transfers[request] = &transfer;
+    transfer.pending++;
+
+    notify(*_queue);
+
+    return true;
+}
+
+static void unpin(Vector<VirtioBlockPin> &pinned)
+{
+    for (size_t i = 0; i < pinned.count(); i++)
+    {
+        memory_object_deref(pinned[i].object);
+    }
+
+    pinned.clear();
+}
+
+// The task may unmap its memory while it waits for the device, which would
+// then write to pages given to someone else. The memory objects behind a
+// user buffer are kept until the transfer is done.
+static Result pin(uintptr_t address, size_t size, Vector<VirtioBlockPin> &pinned)
+{
+    InterruptsRetainer retainer;
+
+    Task *task = scheduler_running();
+    auto user_range = arch_virtual_user_range();
+
+    if (address + size < address)
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    // The buffers of the kernel aren't freed under the driver.
+    if (address + size <= user_range.base())
+    {
+        for (uintptr_t page = ALIGN_DOWN(address, ARCH_PAGE_SIZE); page < address + size; page += ARCH_PAGE_SIZE)
+        {
+            if (!arch_virtual_present(task->address_space, page))
+            {
+                return ERR_BAD_ADDRESS;
+            }
+        }
+
+        return SUCCESS;
+    }
+
+    if (address < user_range.base())
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    uintptr_t end = address + size;
+
+    while (address < end)
+    {
+        auto mapping = task->memory_mappings.containing(address);
+
+        if (!mapping)
+        {
+            unpin(pinned);
+            return ERR_BAD_ADDRESS;
+        }
+
+        pinned.push_back({mapping->address, mapping->size, memory_object_ref(mapping->object)});
+        address = mapping->address + mapping->size;
+    }
+
+    return SUCCESS;
+}
+
+// A pinned buffer is found through its memory object, the task may have
+// unmapped it already.
+static uintptr_t physical_of(Vector<VirtioBlockPin> &pinned, uintptr_t address)
+{
+    for (size_t i = 0; i < pinned.count(); i++)
+    {
+        auto &pin = pinned[i];
+
+        if (address >= pin.address && address < pin.address + pin.size)
+        {
+            return pin.object->range().base() + (address - pin.address);
+        }
+    }
+
+    return arch_virtual_to_physical(scheduler_running()->address_space, address);
+}
+
+// Split in requests, as big as the device takes them, which are all sent
+// before waiting for any of them.
+Result VirtioBlock::transfer(uint32_t type, uint64_t sector, uintptr_t address, size_t size)
+{
+    Vector<VirtioBlockPin> pinned;
+    TRY(pin(address, size, pinned));
+
+    VirtioBlockTransfer transfer{};
+
+    while (size > 0)
+    {
+        VirtioBuffer buffers[VIRTIO_BLOCK_SEGMENTS + 2];
+        size_t count = 1;
+        size_t request_size = 0;
+
+        while (size > 0)
+        {
+            size_t chunk = MIN(size, ARCH_PAGE_SIZE - address % ARCH_PAGE_SIZE);
+            chunk = MIN(chunk, _segment_size_max);
+
+            uintptr_t physical = physical_of(pinned, address);
+            auto &last = buffers[count - 1];
+
+            // Pages which follow each other in physical memory are one
+            // segment.
+            if (count > 1 &&
+                last.physical + last.size == physical &&
+                last.size + chunk <= _segment_size_max)
+            {
+                last.size += chunk;
+            }
+            else if (count - 1 < _segments_max)
+            {
+                buffers[count++] = {physical, chunk, type == VIRTIO_BLOCK_REQUEST_IN};
+            }
+            else
+            {
+                break;
+            }
+
+            address += chunk;
+            size -= chunk;
+            request_size += chunk;
+        }
+
+        // Room for the status.
+        count++;
+
+        while (!submit(transfer, type, sector, buffers, count))
+        {
+            BlockerVirtioBlockRoom blocker{*this, count - 2};
+            task_block(scheduler_running(), blocker, -1);
+        }
+
+        sector += request_size / VIRTIO_BLOCK_SECTOR_SIZE;
+    }
+
+    // The device writes to the transfer, it can't be given up on.
+    while (transfer.pending > 0)
+    {
+        BlockerVirtioBlockTransfer blocker{*this, transfer};
+        task_block(scheduler_running(), blocker, -1);
+    }
+
+    unpin(pinned);
+
+    return transfer.failed ? ERR_INPUT_OUTPUT : SUCCESS;
+}
+
+// Through a buffer of whole sectors, the ones partially written are read
+// first.
+Result VirtioBlock::transfer_unaligned(uint32_t type, size64_t offset, uint8_t *buffer, size_t size)
+{
+    auto bounce = make<MMIORange>(VIRTIO_BLOCK_BOUNCE_SIZE);
+    auto bounce_buffer = reinterpret_cast<uint8_t *>(bounce->base());
+
+    size_t done = 0;
+
+    while (done < size)
+    {
+        size64_t position = offset + done;
+        size64_t first = ALIGN_DOWN(position, (size64_t)VIRTIO_BLOCK_SECTOR_SIZE);
+
+        size_t skip = position - first;
+        size_t chunk = MIN(size - done, VIRTIO_BLOCK_BOUNCE_SIZE - skip);
+        size_t covered = ALIGN_UP(skip + chunk, VIRTIO_BLOCK_SECTOR_SIZE);
+
+        uint64_t sector = first / VIRTIO_BLOCK_SECTOR_SIZE;
+
+        if (type == VIRTIO_BLOCK_REQUEST_IN || skip != 0 || covered != chunk)
+        {
+            TRY(transfer(VIRTIO_BLOCK_REQUEST_IN, sector, bounce->base(), covered));
+        }
+
+        if (type == VIRTIO_BLOCK_REQUEST_IN)
+        {
+            memcpy(buffer + done, bounce_buffer + skip, chunk);
+        }
+        else
+        {
+            memcpy(bounce_buffer + skip, buffer + done, chunk);
+            TRY(transfer(VIRTIO_BLOCK_REQUEST_OUT, sector, bounce->base(), covered));
+        }
+
+        done += chunk;
+    }
+
+    return SUCCESS;
+}
+
+static bool is_sector_aligned(size64_t offset, const void *buffer, size_t size)
+{
+    return offset % VIRTIO_BLOCK_SECTOR_SIZE == 0 &&
+           (uintptr_t)buffer % VIRTIO_BLOCK_SECTOR_SIZE == 0 &&
+           size % VIRTIO_BLOCK_SECTOR_SIZE == 0;
+}
+
+ResultOr<size_t> VirtioBlock::read(size64_t offset, void *buffer, size_t size)
+{
+    if (offset >= this->size())
+    {
+        return 0;
+    }
+
+    size = MIN(size, this->size() - offset);
+
+    // Straight to the buffer, page by page.
+    if (is_sector_aligned(offset, buffer, size))
+    {
+        TRY(transfer(VIRTIO_BLOCK_REQUEST_IN, offset / VIRTIO_BLOCK_SECTOR_SIZE, (uintptr_t)buffer, size));
+    }
+    else
+    {
+        TRY(transfer_unaligned(VIRTIO_BLOCK_REQUEST_IN, offset, (uint8_t *)buffer, size));
+    }
+
+    return size;
+}
+
+ResultOr<size_t> VirtioBlock::write(size64_t offset, const void *buffer, size_t size)
+{
+    if (_read_only)
+    {
+        return ERR_READ_ONLY_STREAM;
+    }
+
+    if (offset >= this->size())
+    {
+        return 0;
+    }
+
+    size = MIN(size, this->size() - offset);
+
+    if (is_sector_aligned(offset, buffer, size))
+    {
+        TRY(transfer(VIRTIO_BLOCK_REQUEST_OUT, offset / VIRTIO_BLOCK_SECTOR_SIZE, (uintptr_t)buffer, size));
+    }
+    else
+    {
+        TRY(transfer_unaligned(VIRTIO_BLOCK_REQUEST_OUT, offset, (uint8_t *)buffer, size));
+    }
+
+    return size;
+}
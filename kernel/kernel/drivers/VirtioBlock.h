@@ -1,16 +1,107 @@
 #pragma once
 
+#include <libutils/Vector.h>
+
 #include "kernel/devices/VirtioDevice.h"
 
+struct MemoryObject;
+
+#define VIRTIO_BLOCK_SECTOR_SIZE 512
+
+// In flight at once, over all the tasks using the device.
+#define VIRTIO_BLOCK_REQUESTS 32
+
+// Data segments of a request, if the device takes that many.
+#define VIRTIO_BLOCK_SEGMENTS 32
+
+// Unaligned transfers are split in chunks of this size.
+#define VIRTIO_BLOCK_BOUNCE_SIZE (64 * 1024)
+
+#define VIRTIO_BLOCK_FEATURE_SIZE_MAX (1 << 1)
+#define VIRTIO_BLOCK_FEATURE_SEG_MAX (1 << 2)
+#define VIRTIO_BLOCK_FEATURE_READ_ONLY (1 << 5)
+
+#define VIRTIO_BLOCK_CONFIG_CAPACITY 0x00
+#define VIRTIO_BLOCK_CONFIG_SIZE_MAX 0x08
+#define VIRTIO_BLOCK_CONFIG_SEG_MAX 0x0C
+
+#define VIRTIO_BLOCK_REQUEST_IN 0
+#define VIRTIO_BLOCK_REQUEST_OUT 1
+
+#define VIRTIO_BLOCK_STATUS_OK 0
+
+struct PACKED VirtioBlockRequest
+{
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+
+    // Written by the device once it is done.
+    uint8_t status;
+};
+
+// The requests a read or a write was split in.
+struct VirtioBlockTransfer
+{
+    int pending;
+    bool failed;
+};
+
+// A memory object of the task, kept alive while the device uses it.
+struct VirtioBlockPin
+{
+    uintptr_t address;
+    size_t size;
+    MemoryObject *object;
+};
+
 class VirtioBlock : public VirtioDevice
 {
 private:
+    OwnPtr<VirtioQueue> _queue;
+
+    bool _failed = false;
+    bool _read_only = false;
+
+    uint64_t _capacity = 0;
+    size_t _segment_size_max = 0;
+    size_t _segments_max = 1;
+
+    // The headers and statuses of the requests, read and written by the
+    // device, and the transfer each of them belongs to while in flight.
+    RefPtr<MMIORange> _requests_range;
+    VirtioBlockRequest *_requests = nullptr;
+    VirtioBlockTransfer *_transfers[VIRTIO_BLOCK_REQUESTS] = {};
+
+    // The request at the head of each chain of descriptors.
+    Vector<int> _request_of_head;
+
+    bool submit(VirtioBlockTransfer &transfer, uint32_t type, uint64_t sector, VirtioBuffer *buffers, size_t count);
+
+    Result transfer(uint32_t type, uint64_t sector, uintptr_t address, size_t size);
+
+    Result transfer_unaligned(uint32_t type, size64_t offset, uint8_t *buffer, size_t size);
+
 public:
-    VirtioBlock(DeviceAddress address) : VirtioDevice(address, DeviceClass::DISK)
-    {
-    }
+    VirtioBlock(DeviceAddress address);
 
     ~VirtioBlock()
     {
     }
+
+    bool can_submit(size_t segments);
+
+    void collect_completions();
+
+    bool did_fail() override { return _failed; }
+
+    size_t size() override { return _capacity * VIRTIO_BLOCK_SECTOR_SIZE; }
+
+    void acknowledge_interrupt() override;
+
+    void handle_interrupt() override;
+
+    ResultOr<size_t> read(size64_t offset, void *buffer, size_t size) override;
+
+    ResultOr<size_t> write(size64_t offset, const void *buffer, size_t size) override;
 };
@@ -63,6 +63,25 @@ struct PACKED RSDT
     }
 };
 
+/* --- HPET ----------------------------------------------------------------- */
+
+struct PACKED HPET
+{
+    SDTH header;
+
+    uint32_t event_timer_block_id;
+
+    uint8_t address_space;
+    uint8_t register_bit_width;
+    uint8_t register_bit_offset;
+    uint8_t reserved;
+    uint64_t address;
+
+    uint8_t number;
+    uint16_t minimum_tick;
+    uint8_t page_protection;
+};
+
 /* --- MADT ----------------------------------------------------------------- */
 
 enum class MADTRecordType : uint8_t
@@ -80,6 +99,8 @@ struct PACKED MADTRecord
     uint8_t lenght;
 };
 
+#define MADT_LAPIC_ENABLED (1 << 0)
+
 struct PACKED MADTLocalApicRecord
 {
     MADTRecord header;
@@ -1,48 +1,97 @@
 #include <assert.h>
 #include <libsystem/Logger.h>
+#include <string.h>
+
+#include "archs/Arch.h"
 
-#include "kernel/devices/Devices.h"
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
 
-static bool _pending_interrupts[256] = {};
+static_assert(DISPATCHER_IRQ_COUNT <= 32, "The pending interrupts are a 32 bits mask");
+
+static Vector<RefPtr<Device>> *_handlers[DISPATCHER_IRQ_COUNT] = {};
+static DispatcherStatistics _statistics[DISPATCHER_IRQ_COUNT] = {};
+
+static int _msi_next = DISPATCHER_MSI_FIRST;
+
+// The interrupts raised since the worker last looked, how many times each
+// and when the first of them was.
+static uint32_t _pending = 0;
+static int _pending_count[DISPATCHER_IRQ_COUNT] = {};
+static uint64_t _pending_since[DISPATCHER_IRQ_COUNT] = {};
+
+static Task *_worker = nullptr;
 
 void dispatcher_initialize()
 {
-    Task *task = task_spawn(nullptr, "interrupts-dispatcher", dispatcher_service, nullptr, false);
-    task_go(task);
+    _worker = task_spawn(nullptr, "interrupts-dispatcher", dispatcher_service, nullptr, false);
+    task_go(_worker);
 }
 
-void dispatcher_dispatch(int interrupt)
+void dispatcher_register(RefPtr<Device> device)
 {
-    _pending_interrupts[interrupt] = true;
-    devices_acknowledge_interrupt(interrupt);
+    int irq = device->interrupt();
+
+    if (irq < 0)
+    {
+        return;
+    }
+
+    if (irq >= DISPATCHER_IRQ_COUNT)
+    {
+        logger_warn("%s uses the interrupt %d, which is never raised", device->name().cstring(), irq);
+        return;
+    }
+
+    InterruptsRetainer retainer;
+
+    if (!_handlers[irq])
+    {
+        _handlers[irq] = new Vector<RefPtr<Device>>();
+    }
+
+    _handlers[irq]->push_back(device);
 }
 
-static bool dispatcher_has_interrupt()
+int dispatcher_allocate_msi(uint64_t *address, uint32_t *data)
 {
     InterruptsRetainer retainer;
 
-    int result = 0;
-
-    for (size_t i = 0; i < 256; i++)
+    if (_msi_next >= DISPATCHER_IRQ_COUNT || !arch_msi_message(_msi_next, address, data))
     {
-        if (_pending_interrupts[i])
-        {
-            result++;
-        }
+        return -1;
     }
 
-    return result > 0;
+    return _msi_next++;
 }
 
-static void dispatcher_snapshot(bool *destination)
+bool dispatcher_dispatch(int irq)
 {
-    InterruptsRetainer retainer;
-    memcpy(destination, _pending_interrupts, sizeof(_pending_interrupts));
-    memset(_pending_interrupts, 0, sizeof(_pending_interrupts));
+    ASSERT_INTERRUPTS_RETAINED();
+
+    assert(irq >= 0 && irq < DISPATCHER_IRQ_COUNT);
+
+    _statistics[irq].count++;
+
+    if (_pending_count[irq] == 0)
+    {
+        _pending_since[irq] = arch_get_clock();
+    }
+
+    _pending_count[irq]++;
+    _pending |= 1u << irq;
+
+    if (_handlers[irq])
+    {
+        _handlers[irq]->foreach([](auto &device) {
+            device->acknowledge_interrupt();
+            return Iteration::CONTINUE;
+        });
+    }
+
+    return _worker && _worker->state() == TASK_STATE_BLOCKED;
 }
 
 class BlockerDispatcher : public Blocker
@@ -50,10 +99,56 @@ class BlockerDispatcher : public Blocker
 public:
     bool can_unblock(Task &) override
     {
-        return dispatcher_has_interrupt();
+        return _pending != 0;
     }
 };
 
+// The handlers are registered while the worker may be running.
+static RefPtr<Device> dispatcher_handler(int irq, size_t index)
+{
+    InterruptsRetainer retainer;
+
+    if (!_handlers[irq] || index >= _handlers[irq]->count())
+    {
+        return nullptr;
+    }
+
+    return (*_handlers[irq])[index];
+}
+
+static void dispatcher_handle(int irq, int count, uint64_t since)
+{
+    // Each of them is handled, they don't collapse into one.
+    for (int i = 0; i < count; i++)
+    {
+        for (size_t index = 0;; index++)
+        {
+            auto device = dispatcher_handler(irq, index);
+
+            if (!device)
+            {
+                break;
+            }
+
+            device->handle_interrupt();
+        }
+    }
+
+    uint64_t latency = arch_get_clock() - since;
+
+    InterruptsRetainer retainer;
+
+    auto &statistics = _statistics[irq];
+
+    statistics.handled += count;
+    statistics.latency_total += latency;
+
+    if (latency > statistics.latency_max)
+    {
+        statistics.latency_max = latency;
+    }
+}
+
 void dispatcher_service()
 {
     while (true)
@@ -61,18 +156,55 @@ void dispatcher_service()
         BlockerDispatcher blocker{};
         assert(task_block(scheduler_running(), blocker, -1) == SUCCESS);
 
-        while (dispatcher_has_interrupt())
+        while (true)
         {
-            bool snapshot[256];
-            dispatcher_snapshot(snapshot);
+            uint32_t pending;
+            int counts[DISPATCHER_IRQ_COUNT];
+            uint64_t since[DISPATCHER_IRQ_COUNT];
 
-            for (size_t i = 0; i < 256; i++)
             {
-                if (snapshot[i])
+                InterruptsRetainer retainer;
+
+                pending = _pending;
+                memcpy(counts, _pending_count, sizeof(_pending_count));
+                memcpy(since, _pending_since, sizeof(_pending_since));
+
+                _pending = 0;
+                memset(_pending_count, 0, sizeof(_pending_count));
+            }
+
+            if (pending == 0)
+            {
+                break;
+            }
+
+            for (int irq = 0; irq < DISPATCHER_IRQ_COUNT; irq++)
+            {
+                if (pending & (1u << irq))
                 {
-                    devices_handle_interrupt(i);
+                    dispatcher_handle(irq, counts[irq], since[irq]);
                 }
             }
         }
     }
 }
+
+DispatcherStatistics dispatcher_statistics(int irq)
+{
+    InterruptsRetainer retainer;
+
+    return _statistics[irq];
+}
+
+void dispatcher_iterate_handlers(int irq, IterationCallback<RefPtr<Device>> callback)
+{
+    for (size_t index = 0;; index++)
+    {
+        auto device = dispatcher_handler(irq, index);
+
+        if (!device || callback(device) == Iteration::STOP)
+        {
+            return;
+        }
+    }
+}
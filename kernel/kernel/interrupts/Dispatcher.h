@@ -1,11 +1,41 @@
 #pragma once
 
-#include "kernel/node/Node.h"
+#include <libutils/Callback.h>
+#include <libutils/RefPtr.h>
 
-typedef void (*DispatcherInteruptHandler)();
+#include "kernel/devices/Device.h"
+
+// The 16 of the PIC, then the ones given to PCI devices for their MSIs.
+#define DISPATCHER_IRQ_COUNT 32
+#define DISPATCHER_MSI_FIRST 16
+
+struct DispatcherStatistics
+{
+    // How many times the interrupt was raised.
+    uint64_t count;
+
+    // How many times its handlers ran, and how long after the interrupt, in
+    // ticks of the clock.
+    uint64_t handled;
+    uint64_t latency_total;
+    uint64_t latency_max;
+};
 
 void dispatcher_initialize();
 
-void dispatcher_dispatch(int interrupt);
+// Interrupts only go to the devices registered for them.
+void dispatcher_register(RefPtr<Device> device);
+
+// An interrupt for the MSIs of a PCI device and the message which raises
+// it, -1 if there is none left or the processor can't receive them.
+int dispatcher_allocate_msi(uint64_t *address, uint32_t *data);
+
+// From the interrupt handler, returns whether the worker was woken up and
+// has to be scheduled.
+bool dispatcher_dispatch(int irq);
 
 void dispatcher_service();
+
+DispatcherStatistics dispatcher_statistics(int irq);
+
+void dispatcher_iterate_handlers(int irq, IterationCallback<RefPtr<Device>> callback);
@@ -4,9 +4,14 @@
 
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Cpu.h"
 
-static bool _can_be_holded = false;
-static int _depth = 0;
+static bool _can_be_holded[CPU_MAX] = {};
+static int _depth[CPU_MAX] = {};
+
+// The processor holding the kernel lock, and how many times it took it.
+static int _lock_owner = -1;
+static int _lock_count = 0;
 
 void interrupts_initialize()
 {
@@ -20,37 +25,90 @@ void interrupts_initialize()
 
 bool interrupts_retained()
 {
-    return !_can_be_holded || _depth > 0;
+    // Nothing can be retained while interrupts are coming, and otherwise we
+    // can't be moved to another processor.
+    if (arch_interrupts_enabled())
+    {
+        return false;
+    }
+
+    int cpu = arch_current_cpu();
+
+    return !_can_be_holded[cpu] || _depth[cpu] > 0;
 }
 
 void interrupts_enable_holding()
 {
-    _can_be_holded = true;
+    _can_be_holded[arch_current_cpu()] = true;
 }
 
 void interrupts_disable_holding()
 {
-    _can_be_holded = false;
+    _can_be_holded[arch_current_cpu()] = false;
+}
+
+void interrupts_lock()
+{
+    int cpu = arch_current_cpu();
+
+    if (__atomic_load_n(&_lock_owner, __ATOMIC_RELAXED) == cpu)
+    {
+        _lock_count++;
+        return;
+    }
+
+    int expected = -1;
+
+    while (!__atomic_compare_exchange_n(&_lock_owner, &expected, cpu, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        expected = -1;
+        arch_pause();
+    }
+
+    _lock_count = 1;
+}
+
+void interrupts_unlock()
+{
+    assert(_lock_owner == arch_current_cpu());
+
+    _lock_count--;
+
+    if (_lock_count == 0)
+    {
+        __atomic_store_n(&_lock_owner, -1, __ATOMIC_RELEASE);
+    }
 }
 
 void interrupts_retain()
 {
-    if (_can_be_holded)
+    arch_disable_interrupts();
+
+    int cpu = arch_current_cpu();
+
+    if (_can_be_holded[cpu])
     {
-        arch_disable_interrupts();
-        _depth++;
+        if (_depth[cpu] == 0)
+        {
+            interrupts_lock();
+        }
+
+        _depth[cpu]++;
     }
 }
 
 void interrupts_release()
 {
-    if (_can_be_holded)
+    int cpu = arch_current_cpu();
+
+    if (_can_be_holded[cpu])
     {
-        assert(_depth > 0);
-        _depth--;
+        assert(_depth[cpu] > 0);
+        _depth[cpu]--;
 
-        if (_depth == 0)
+        if (_depth[cpu] == 0)
         {
+            interrupts_unlock();
             arch_enable_interrupts();
         }
     }
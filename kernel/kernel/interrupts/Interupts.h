@@ -14,6 +14,13 @@ void interrupts_enable_holding();
 
 void interrupts_disable_holding();
 
+// Every processor runs the kernel with interrupts disabled under this lock,
+// retaining interrupts takes it and so do the interrupts which schedule. A
+// processor can take it again while holding it.
+void interrupts_lock();
+
+void interrupts_unlock();
+
 void interrupts_retain();
 
 void interrupts_release();
@@ -14,10 +14,13 @@
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/modules/Modules.h"
 #include "kernel/node/DevicesInfo.h"
+#include "kernel/node/InterruptsInfo.h"
 #include "kernel/node/ProcessInfo.h"
+#include "kernel/node/TraceInfo.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/storage/Partitions.h"
 #include "kernel/system/System.h"
+#include "kernel/system/Trace.h"
 #include "kernel/tasking/Tasking.h"
 #include "kernel/tasking/Userspace.h"
 
@@ -35,22 +38,36 @@ static void splash_screen()
     stream_format(log_stream, "\n");
 }
 
+template <typename TCallback>
+static void boot_step(const char *name, TCallback callback)
+{
+    TraceSpan span{name};
+    callback();
+}
+
 void system_main(Handover *handover)
 {
     splash_screen();
-    system_initialize();
-    memory_initialize(handover);
-    scheduler_initialize();
-    tasking_initialize();
-    interrupts_initialize();
-    modules_initialize(handover);
-    driver_initialize();
-    device_initialize();
-    partitions_initialize();
+
+    boot_step("system", [&]() { system_initialize(); });
+    boot_step("memory", [&]() { memory_initialize(handover); });
+    boot_step("scheduler", [&]() { scheduler_initialize(); });
+    boot_step("tasking", [&]() { tasking_initialize(); });
+    boot_step("interrupts", [&]() { interrupts_initialize(); });
+    boot_step("cpus", [&]() { arch_start_cpus(); });
+    boot_step("modules", [&]() { modules_initialize(handover); });
+    boot_step("drivers", [&]() { driver_initialize(); });
+    boot_step("devices", [&]() { device_initialize(); });
+    boot_step("partitions", [&]() { partitions_initialize(); });
+
     process_info_initialize();
     device_info_initialize();
-    devices_filesystem_initialize();
-    graphic_initialize(handover);
+    trace_info_initialize();
+    interrupts_info_initialize();
+
+    boot_step("devices filesystem", [&]() { devices_filesystem_initialize(); });
+    boot_step("graphics", [&]() { graphic_initialize(handover); });
+
     userspace_initialize();
 
     ASSERT_NOT_REACHED();
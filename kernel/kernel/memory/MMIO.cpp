@@ -17,7 +17,7 @@ MMIORange::MMIORange(size_t size)
     InterruptsRetainer retainer;
 
     _own_physical_range = true;
-    _physical_range = {physical_alloc(size)};
+    _physical_range = {physical_alloc_large(size)};
     _virtual_range = {arch_virtual_alloc(arch_kernel_address_space(), _physical_range, MEMORY_NONE)};
 }
 
@@ -1,5 +1,6 @@
 
 #include <assert.h>
+#include <libmath/MinMax.h>
 #include <libsystem/Logger.h>
 #include <libsystem/io/Stream.h>
 #include <string.h>
@@ -14,6 +15,10 @@
 
 static bool _memory_initialized = false;
 
+// A page of the kernel address space where memory_copy_to() maps the pages
+// it copies to.
+static uintptr_t _copy_window = 0;
+
 extern int __start;
 extern int __end;
 
@@ -240,3 +245,45 @@ Result memory_free(void *address_space, MemoryRange virtual_range)
 
     return SUCCESS;
 }
+
+Result memory_copy_to(void *address_space, uintptr_t address, const void *buffer, size_t size)
+{
+    size_t copied = 0;
+
+    while (copied < size)
+    {
+        InterruptsRetainer retainer;
+
+        uintptr_t current = address + copied;
+
+        if (!arch_virtual_present(address_space, current))
+        {
+            return ERR_BAD_ADDRESS;
+        }
+
+        size_t offset = current % ARCH_PAGE_SIZE;
+        size_t chunk = MIN(ARCH_PAGE_SIZE - offset, size - copied);
+
+        MemoryRange page{arch_virtual_to_physical(address_space, current) - offset, ARCH_PAGE_SIZE};
+
+        if (!_copy_window)
+        {
+            _copy_window = arch_virtual_alloc(arch_kernel_address_space(), page, MEMORY_NONE).base();
+        }
+        else
+        {
+            Result virtual_map_result = arch_virtual_map(arch_kernel_address_space(), page, _copy_window, MEMORY_NONE);
+
+            if (virtual_map_result != SUCCESS)
+            {
+                return virtual_map_result;
+            }
+        }
+
+        memcpy((void *)(_copy_window + offset), (const char *)buffer + copied, chunk);
+
+        copied += chunk;
+    }
+
+    return SUCCESS;
+}
@@ -23,3 +23,7 @@ Result memory_alloc(void *address_space, size_t size, MemoryFlags flags, uintptr
 Result memory_alloc_identity(void *address_space, MemoryFlags flags, uintptr_t *out_address);
 
 Result memory_free(void *address_space, MemoryRange range);
+
+// Copy to memory of another address space, through a temporary mapping in
+// the kernel's.
+Result memory_copy_to(void *address_space, uintptr_t address, const void *buffer, size_t size);
@@ -23,7 +23,7 @@ MemoryObject *memory_object_create(size_t size)
 
     memory_object->id = _memory_object_id++;
     memory_object->refcount = 1;
-    memory_object->_range = physical_alloc(size);
+    memory_object->_range = physical_alloc_large(size);
 
     list_pushback(_memory_objects, memory_object);
 
@@ -1,5 +1,6 @@
 #include <libsystem/Logger.h>
 
+#include "archs/Arch.h"
 #include "archs/Memory.h"
 
 #include "kernel/interrupts/Interupts.h"
@@ -43,13 +44,21 @@ void physical_page_set_free(uintptr_t address)
     MEMORY[page / 8] &= ~(1 << (page % 8));
 }
 
-MemoryRange physical_alloc(size_t size)
+MemoryRange physical_try_alloc(size_t size, size_t alignment)
 {
     ASSERT_INTERRUPTS_RETAINED();
 
     assert(IS_PAGE_ALIGN(size));
+    assert(IS_PAGE_ALIGN(alignment));
 
-    for (size_t i = best_bet; i < ((TOTAL_MEMORY - size) / ARCH_PAGE_SIZE); i++)
+    if (size > TOTAL_MEMORY)
+    {
+        return {};
+    }
+
+    size_t step = alignment / ARCH_PAGE_SIZE;
+
+    for (size_t i = ALIGN_UP(best_bet, step); i < ((TOTAL_MEMORY - size) / ARCH_PAGE_SIZE); i += step)
     {
         MemoryRange range(i * ARCH_PAGE_SIZE, size);
 
@@ -60,9 +69,42 @@ MemoryRange physical_alloc(size_t size)
         }
     }
 
+    return {};
+}
+
+MemoryRange physical_alloc(size_t size)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    MemoryRange range = physical_try_alloc(size, ARCH_PAGE_SIZE);
+
+    if (!range.empty())
+    {
+        return range;
+    }
+
     logger_fatal("Out of physical memory!\tTrying to allocat %dkio but free memory is %dkio !", size / 1024, (TOTAL_MEMORY - USED_MEMORY) / 1024);
 }
 
+MemoryRange physical_alloc_large(size_t size)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    size_t alignment = arch_virtual_alignment(size);
+
+    if (alignment > ARCH_PAGE_SIZE)
+    {
+        MemoryRange range = physical_try_alloc(size, alignment);
+
+        if (!range.empty())
+        {
+            return range;
+        }
+    }
+
+    return physical_alloc(size);
+}
+
 void physical_free(MemoryRange range)
 {
     ASSERT_INTERRUPTS_RETAINED();
@@ -10,6 +10,12 @@ extern uint8_t MEMORY[1024 * 1024 / 8];
 
 MemoryRange physical_alloc(size_t size);
 
+// An empty range if no free range has this alignment.
+MemoryRange physical_try_alloc(size_t size, size_t alignment);
+
+// Aligned for large pages if possible, any range will do otherwise.
+MemoryRange physical_alloc_large(size_t size);
+
 void physical_free(MemoryRange range);
 
 bool physical_is_used(MemoryRange range);
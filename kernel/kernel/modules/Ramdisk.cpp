@@ -1,4 +1,3 @@
-
 #include <libfile/TARArchive.h>
 #include <libsystem/Logger.h>
 #include <libsystem/Result.h>
@@ -7,12 +6,31 @@
 
 #include "kernel/memory/Memory.h"
 #include "kernel/modules/Modules.h"
+#include "kernel/node/File.h"
 #include "kernel/scheduling/Scheduler.h"
 
+// The memory of the module, kept while a file of the ramdisk still reads
+// from it.
+struct RamdiskImage : public AnyRef
+{
+    MemoryRange range;
+
+    RamdiskImage(MemoryRange range) : range{range} {}
+
+    ~RamdiskImage() override
+    {
+        memory_free(arch_kernel_address_space(), range);
+    }
+};
+
 void ramdisk_load(Module *module)
 {
+    auto image = make<RamdiskImage>(module->range);
+
+    TARIterator archive{(void *)module->range.base(), module->range.size()};
     TARBlock block;
-    for (size_t i = 0; tar_read((void *)module->range.base(), &block, i); i++)
+
+    while (archive.next(&block))
     {
         auto file_path = Path::parse(block.name);
 
@@ -27,26 +45,16 @@ void ramdisk_load(Module *module)
         }
         else if ((block.typeflag & 8) == 0 || (block.typeflag & 8) == 5)
         {
-            auto result_or_handle = scheduler_running()->domain().open(file_path, OPEN_WRITE | OPEN_CREATE);
-
-            if (!result_or_handle.success())
-            {
-                logger_warn("Failed to open file %s! %s", block.name, result_to_string(result_or_handle.result()));
-                continue;
-            }
+            auto file = make<FsFile>(image, block.data, block.size);
 
-            auto handle = result_or_handle.unwrap();
+            Result result = scheduler_running()->domain().link(file_path, file);
 
-            auto result_or_written = handle->write(block.data, block.size);
-
-            if (!result_or_written.success())
+            if (result != SUCCESS)
             {
-                logger_error("Failed to write file: %s", result_to_string(result_or_written.result()));
+                logger_warn("Failed to create file %s: %s", block.name, result_to_string(result));
             }
         }
     }
 
-    memory_free(arch_kernel_address_space(), module->range);
-
     logger_info("Loading ramdisk succeeded.");
 }
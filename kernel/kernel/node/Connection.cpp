@@ -8,9 +8,29 @@
 
 FsConnection::FsConnection() : FsNode(FILE_TYPE_CONNECTION) {}
 
+// What's buffered has to be read first, the waiting reader only gets the
+// data when there is none.
+static size_t give_or_buffer(RingBuffer<char> &data, HandoffSlot &handoff, const void *buffer, size_t size)
+{
+    if (data.empty())
+    {
+        size_t given = handoff.give(buffer, size);
+
+        if (given > 0)
+        {
+            return given;
+        }
+    }
+
+    return data.write((const char *)buffer, size);
+}
+
 void FsConnection::accepted()
 {
     _accepted = true;
+
+    // The server only holds the lock of its socket.
+    changed();
 }
 
 bool FsConnection::is_accepted()
@@ -74,7 +94,7 @@ ResultOr<size_t> FsConnection::write(FsHandle &handle, const void *buffer, size_
     {
         if (server())
         {
-            return _data_to_server.write((const char *)buffer, size);
+            return give_or_buffer(_data_to_server, _handoff_to_server, buffer, size);
         }
         else
         {
@@ -85,7 +105,7 @@ ResultOr<size_t> FsConnection::write(FsHandle &handle, const void *buffer, size_
     {
         if (clients())
         {
-            return _data_to_client.write((const char *)buffer, size);
+            return give_or_buffer(_data_to_client, _handoff_to_client, buffer, size);
         }
         else
         {
@@ -93,3 +113,27 @@ ResultOr<size_t> FsConnection::write(FsHandle &handle, const void *buffer, size_
         }
     }
 }
+
+bool FsConnection::wait_handoff(FsHandle &handle, Handoff &handoff)
+{
+    if (handle.has_flag(OPEN_CLIENT))
+    {
+        return _data_to_client.empty() && server() && _handoff_to_client.wait(handoff);
+    }
+    else
+    {
+        return _data_to_server.empty() && clients() && _handoff_to_server.wait(handoff);
+    }
+}
+
+void FsConnection::cancel_handoff(FsHandle &handle, Handoff &handoff)
+{
+    if (handle.has_flag(OPEN_CLIENT))
+    {
+        _handoff_to_client.cancel(handoff);
+    }
+    else
+    {
+        _handoff_to_server.cancel(handoff);
+    }
+}
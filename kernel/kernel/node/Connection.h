@@ -14,6 +14,9 @@ private:
     RingBuffer<char> _data_to_server{BUFFER_SIZE};
     RingBuffer<char> _data_to_client{BUFFER_SIZE};
 
+    HandoffSlot _handoff_to_server;
+    HandoffSlot _handoff_to_client;
+
 public:
     FsConnection();
 
@@ -28,4 +31,8 @@ public:
     ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
 
     ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
+
+    bool wait_handoff(FsHandle &handle, Handoff &handoff) override;
+
+    void cancel_handoff(FsHandle &handle, Handoff &handoff) override;
 };
@@ -0,0 +1,175 @@
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/EventQueue.h"
+#include "kernel/node/Handle.h"
+
+FsEventQueue::FsEventQueue() : FsNode(FILE_TYPE_EVENT_QUEUE)
+{
+}
+
+FsEventQueue::~FsEventQueue()
+{
+    for (size_t i = 0; i < _watched.count(); i++)
+    {
+        _watched[i].handle->node()->unwatched_by(this);
+    }
+}
+
+void FsEventQueue::invalidate(Watched &entry)
+{
+    if (entry.stale)
+    {
+        return;
+    }
+
+    if (entry.ready)
+    {
+        _ready--;
+    }
+
+    entry.stale = true;
+    _stale++;
+}
+
+void FsEventQueue::forget(size_t index)
+{
+    auto &entry = _watched[index];
+
+    if (entry.stale)
+    {
+        _stale--;
+    }
+    else if (entry.ready)
+    {
+        _ready--;
+    }
+
+    entry.handle->node()->unwatched_by(this);
+    _watched.remove_index(index);
+}
+
+Result FsEventQueue::watch(int handle_index, RefPtr<FsHandle> handle, PollEvent events)
+{
+    // A queue holding a reference on itself would never be freed.
+    if (events != 0 && handle->node() == this)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    // Closing the handle takes the lock of its node, it has to happen once
+    // interrupts aren't retained anymore.
+    RefPtr<FsHandle> unwatched;
+
+    InterruptsRetainer retainer;
+
+    for (size_t i = 0; i < _watched.count(); i++)
+    {
+        if (_watched[i].handle_index != handle_index)
+        {
+            continue;
+        }
+
+        unwatched = _watched[i].handle;
+        forget(i);
+        break;
+    }
+
+    if (events == 0)
+    {
+        return SUCCESS;
+    }
+
+    auto type = handle->node()->type();
+    bool polled = type == FILE_TYPE_DEVICE || type == FILE_TYPE_EVENT_QUEUE;
+
+    _watched.push_back({handle_index, handle, events, 0, true, polled});
+    _stale++;
+
+    handle->node()->watched_by(this);
+
+    return SUCCESS;
+}
+
+void FsEventQueue::node_changed(FsNode *node)
+{
+    InterruptsRetainer retainer;
+
+    for (size_t i = 0; i < _watched.count(); i++)
+    {
+        if (_watched[i].handle->node() == node)
+        {
+            invalidate(_watched[i]);
+        }
+    }
+}
+
+// Polls the stale entries, true if any entry is ready.
+bool FsEventQueue::refresh()
+{
+    bool any = _ready > 0;
+
+    for (size_t i = 0; i < _watched.count() && _stale > 0; i++)
+    {
+        auto &entry = _watched[i];
+
+        if (!entry.stale)
+        {
+            continue;
+        }
+
+        entry.ready = entry.handle->poll(entry.events);
+        any = any || entry.ready;
+
+        if (!entry.polled)
+        {
+            entry.stale = false;
+            _stale--;
+
+            if (entry.ready)
+            {
+                _ready++;
+            }
+        }
+    }
+
+    return any;
+}
+
+bool FsEventQueue::any_ready()
+{
+    InterruptsRetainer retainer;
+
+    if (_ready > 0)
+    {
+        return true;
+    }
+
+    return _stale > 0 && refresh();
+}
+
+size_t FsEventQueue::collect(HandlePoll *ready, size_t count)
+{
+    InterruptsRetainer retainer;
+
+    refresh();
+
+    size_t collected = 0;
+    size_t watched = _watched.count();
+
+    for (size_t i = 0; i < watched && collected < count; i++)
+    {
+        auto &entry = _watched[(_next + i) % watched];
+
+        if (entry.ready)
+        {
+            ready[collected] = {entry.handle_index, entry.events, entry.ready};
+            collected++;
+        }
+    }
+
+    if (watched)
+    {
+        _next = (_next + 1) % watched;
+    }
+
+    return collected;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <libutils/Vector.h>
+
+#include "kernel/node/Node.h"
+
+// The set of handles a process waits on, kept in the kernel so it doesn't
+// have to be sent and resolved again on every wait. The watched handles stay
+// alive until they are unwatched.
+//
+// What each handle is ready for is remembered until its node tells it may
+// have changed, so a wait with nothing happening doesn't poll them all.
+class FsEventQueue : public FsNode
+{
+private:
+    struct Watched
+    {
+        int handle_index;
+        RefPtr<FsHandle> handle;
+        PollEvent events;
+
+        // What poll() returned, until the node changes.
+        PollEvent ready;
+        bool stale;
+
+        // Devices change from their interrupts without telling, and a queue
+        // from the nodes it watches, they are polled every time.
+        bool polled;
+    };
+
+    Vector<Watched> _watched;
+
+    // Where the next collect starts, so a handle that is always ready
+    // can't hide the ones after it when the caller's buffer is small.
+    size_t _next = 0;
+
+    // The entries known to be ready, and the ones to poll again before
+    // knowing.
+    size_t _ready = 0;
+    size_t _stale = 0;
+
+    void invalidate(Watched &entry);
+
+    void forget(size_t index);
+
+    bool refresh();
+
+public:
+    FsEventQueue();
+
+    ~FsEventQueue();
+
+    // With no events the entry is removed, the handle may be closed already.
+    Result watch(int handle_index, RefPtr<FsHandle> handle, PollEvent events);
+
+    void node_changed(FsNode *node);
+
+    bool any_ready();
+
+    size_t collect(HandlePoll *ready, size_t count);
+
+    bool can_read(FsHandle &) override { return any_ready(); }
+};
@@ -12,16 +12,44 @@ FsFile::FsFile() : FsNode(FILE_TYPE_REGULAR)
     _buffer_size = 0;
 }
 
+FsFile::FsFile(RefPtr<AnyRef> owner, const char *data, size_t size) : FsNode(FILE_TYPE_REGULAR)
+{
+    _buffer = const_cast<char *>(data);
+    _buffer_allocated = 0;
+    _buffer_size = size;
+    _borrowed_from = owner;
+}
+
 FsFile::~FsFile()
 {
-    free(_buffer);
+    if (!_borrowed_from)
+    {
+        free(_buffer);
+    }
+}
+
+void FsFile::own_buffer(size_t size)
+{
+    size_t allocated = MAX(size, MAX(_buffer_size, 512));
+
+    char *buffer = (char *)malloc(allocated);
+    memcpy(buffer, _buffer, _buffer_size);
+
+    _buffer = buffer;
+    _buffer_allocated = allocated;
+    _borrowed_from = nullptr;
 }
 
 Result FsFile::open(FsHandle &handle)
 {
     if (handle.has_flag(OPEN_TRUNC))
     {
-        free(_buffer);
+        if (!_borrowed_from)
+        {
+            free(_buffer);
+        }
+
+        _borrowed_from = nullptr;
         _buffer = (char *)malloc(512);
         _buffer_allocated = 512;
         _buffer_size = 0;
@@ -50,6 +78,11 @@ ResultOr<size_t> FsFile::read(FsHandle &handle, void *buffer, size_t size)
 
 ResultOr<size_t> FsFile::write(FsHandle &handle, const void *buffer, size_t size)
 {
+    if (_borrowed_from)
+    {
+        own_buffer(handle.offset() + size);
+    }
+
     if ((handle.offset() + size) > _buffer_allocated)
     {
         _buffer = (char *)realloc(_buffer, handle.offset() + size);
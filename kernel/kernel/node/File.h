@@ -9,9 +9,17 @@ private:
     size_t _buffer_allocated;
     size_t _buffer_size;
 
+    // While set, the content is borrowed from memory it keeps alive. It is
+    // read-only and copied to the heap on the first write.
+    RefPtr<AnyRef> _borrowed_from;
+
+    void own_buffer(size_t size);
+
 public:
     FsFile();
 
+    FsFile(RefPtr<AnyRef> owner, const char *data, size_t size);
+
     ~FsFile() override;
 
     Result open(FsHandle &handle) override;
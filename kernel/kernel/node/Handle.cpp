@@ -7,6 +7,7 @@
 
 #include "kernel/node/Connection.h"
 #include "kernel/node/Handle.h"
+#include "kernel/node/Handoff.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
 
@@ -96,9 +97,50 @@ ResultOr<size_t> FsHandle::read(void *buffer, size_t size)
         return ERR_WRITE_ONLY_STREAM;
     }
 
-    BlockerRead blocker{*this};
+    // Nothing to read yet, wait with the buffer on nodes which let the
+    // writer copy into it directly.
+    Handoff handoff{scheduler_running(), buffer, size};
+    bool waiting = false;
 
-    TRY(task_block(scheduler_running(), blocker, -1));
+    if (!_node->can_read(*this))
+    {
+        _node->acquire(scheduler_running_id());
+        waiting = !_node->can_read(*this) && _node->wait_handoff(*this, handoff);
+        _node->release(scheduler_running_id());
+    }
+
+    BlockerRead blocker{*this, waiting ? &handoff : nullptr};
+
+    Result block_result = task_block(scheduler_running(), blocker, -1);
+
+    if (waiting && !handoff.completed)
+    {
+        // Unless we were interrupted, the blocker acquired the node.
+        if (block_result != SUCCESS)
+        {
+            _node->acquire(scheduler_running_id());
+        }
+
+        _node->cancel_handoff(*this, handoff);
+
+        // A writer may have handed the data between the interruption and
+        // the acquire.
+        if (block_result != SUCCESS)
+        {
+            _node->release(scheduler_running_id());
+        }
+    }
+
+    if (handoff.completed)
+    {
+        _offset += handoff.transferred;
+        return handoff.transferred;
+    }
+
+    if (block_result != SUCCESS)
+    {
+        return block_result;
+    }
 
     auto read_result = _node->read(*this, buffer, size);
 
@@ -162,6 +204,52 @@ ResultOr<size_t> FsHandle::write(const void *buffer, size_t size)
     return written;
 }
 
+ResultOr<size_t> FsHandle::readv(const IOVec *vectors, size_t count)
+{
+    size_t read = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        // Only the first buffer is allowed to wait for data, the following
+        // ones take what is already there.
+        if (i > 0 && !poll(POLL_READ))
+        {
+            break;
+        }
+
+        size_t vector_read = TRY(this->read(vectors[i].buffer, vectors[i].size));
+
+        read += vector_read;
+
+        if (vector_read < vectors[i].size)
+        {
+            break;
+        }
+    }
+
+    return read;
+}
+
+ResultOr<size_t> FsHandle::writev(const IOVec *vectors, size_t count)
+{
+    size_t written = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t vector_written = TRY(write(vectors[i].buffer, vectors[i].size));
+
+        written += vector_written;
+
+        // The next buffers would land after a gap.
+        if (vector_written < vectors[i].size)
+        {
+            break;
+        }
+    }
+
+    return written;
+}
+
 ResultOr<ssize64_t> FsHandle::seek(IO::SeekFrom from)
 {
     _node->acquire(scheduler_running_id());
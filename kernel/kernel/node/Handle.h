@@ -43,6 +43,10 @@ public:
 
     ResultOr<size_t> write(const void *buffer, size_t size);
 
+    ResultOr<size_t> readv(const IOVec *vectors, size_t count);
+
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count);
+
     ResultOr<ssize64_t> seek(IO::SeekFrom from);
 
     Result call(IOCall request, void *args);
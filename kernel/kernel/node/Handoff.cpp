@@ -0,0 +1,57 @@
+#include <libmath/MinMax.h>
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/Memory.h"
+#include "kernel/node/Handoff.h"
+#include "kernel/tasking/Task.h"
+
+bool HandoffSlot::wait(Handoff &handoff)
+{
+    if (_waiting || handoff.size == 0)
+    {
+        return false;
+    }
+
+    _waiting = &handoff;
+
+    return true;
+}
+
+void HandoffSlot::cancel(Handoff &handoff)
+{
+    if (_waiting == &handoff)
+    {
+        _waiting = nullptr;
+    }
+}
+
+size_t HandoffSlot::give(const void *buffer, size_t size)
+{
+    if (!_waiting || size == 0)
+    {
+        return 0;
+    }
+
+    auto &handoff = *_waiting;
+    size_t transferred = MIN(size, handoff.size);
+
+    if (memory_copy_to(handoff.task->address_space, (uintptr_t)handoff.buffer, buffer, transferred) != SUCCESS)
+    {
+        return 0;
+    }
+
+    _waiting = nullptr;
+
+    InterruptsRetainer retainer;
+
+    handoff.transferred = transferred;
+    handoff.completed = true;
+
+    // Don't let the reader wait for the scheduler to look at it again.
+    if (handoff.task->state() == TASK_STATE_BLOCKED)
+    {
+        handoff.task->try_unblock();
+    }
+
+    return transferred;
+}
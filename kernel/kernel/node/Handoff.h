@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+
+struct Task;
+
+// A reader blocked on an empty stream, with the buffer its read returns.
+struct Handoff
+{
+    Task *task;
+    void *buffer;
+    size_t size;
+
+    size_t transferred = 0;
+    bool completed = false;
+};
+
+// Where the reader of one direction of a pipe or a connection waits, so a
+// writer can copy straight into its buffer instead of going through the
+// ring buffer of the node. Only used with the node acquired.
+class HandoffSlot
+{
+private:
+    Handoff *_waiting = nullptr;
+
+public:
+    bool wait(Handoff &handoff);
+
+    void cancel(Handoff &handoff);
+
+    // Returns how much was given to the waiting reader, zero if there is
+    // none and the data should be buffered.
+    size_t give(const void *buffer, size_t size);
+};
@@ -0,0 +1,86 @@
+#include <string.h>
+
+#include <libmath/MinMax.h>
+#include <libsystem/Result.h>
+#include <libutils/json/Json.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/interrupts/Dispatcher.h"
+#include "kernel/node/Handle.h"
+#include "kernel/node/InterruptsInfo.h"
+#include "kernel/scheduling/Scheduler.h"
+
+FsInterruptsInfo::FsInterruptsInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+Result FsInterruptsInfo::open(FsHandle &handle)
+{
+    Json::Value::Array root{};
+
+    for (int irq = 0; irq < DISPATCHER_IRQ_COUNT; irq++)
+    {
+        Json::Value::Array devices{};
+
+        dispatcher_iterate_handlers(irq, [&](RefPtr<Device> device) {
+            devices.push_back(device->name().cstring());
+            return Iteration::CONTINUE;
+        });
+
+        auto statistics = dispatcher_statistics(irq);
+
+        if (statistics.count == 0 && devices.empty())
+        {
+            continue;
+        }
+
+        Json::Value::Object irq_object{};
+
+        irq_object["irq"] = (int64_t)irq;
+        irq_object["devices"] = move(devices);
+        irq_object["count"] = (int64_t)statistics.count;
+        irq_object["handled"] = (int64_t)statistics.handled;
+
+        // In nanoseconds, from the interrupt to the end of its handlers.
+        if (statistics.handled > 0)
+        {
+            irq_object["latency_average"] = (int64_t)arch_clock_to_nanoseconds(statistics.latency_total / statistics.handled);
+        }
+
+        irq_object["latency_max"] = (int64_t)arch_clock_to_nanoseconds(statistics.latency_max);
+
+        root.push_back(move(irq_object));
+    }
+
+    Prettifier pretty{};
+    Json::prettify(pretty, root);
+
+    handle.attached = pretty.finalize().storage().give_ref();
+    handle.attached_size = reinterpret_cast<StringStorage *>(handle.attached)->size();
+
+    return SUCCESS;
+}
+
+void FsInterruptsInfo::close(FsHandle &handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle.attached));
+}
+
+ResultOr<size_t> FsInterruptsInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+void interrupts_info_initialize()
+{
+    scheduler_running()->domain().link(Path::parse("/System/interrupts"), make<FsInterruptsInfo>());
+}
@@ -1,5 +1,7 @@
 #include <string.h>
 
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/EventQueue.h"
 #include "kernel/node/Handle.h"
 #include "kernel/node/Node.h"
 
@@ -52,6 +54,39 @@ void FsNode::deref_handle(FsHandle &handle)
     {
         __atomic_sub_fetch(&_server, 1, __ATOMIC_SEQ_CST);
     }
+
+    // The other end may see the end of the stream or a hangup.
+    changed();
+}
+
+void FsNode::watched_by(FsEventQueue *queue)
+{
+    InterruptsRetainer retainer;
+
+    _watchers.push_back(queue);
+}
+
+void FsNode::unwatched_by(FsEventQueue *queue)
+{
+    InterruptsRetainer retainer;
+
+    _watchers.remove_value(queue);
+}
+
+void FsNode::changed()
+{
+    // A queue starting to watch the node polls it anyway.
+    if (_watchers.empty())
+    {
+        return;
+    }
+
+    InterruptsRetainer retainer;
+
+    for (size_t i = 0; i < _watchers.count(); i++)
+    {
+        _watchers[i]->node_changed(this);
+    }
 }
 
 bool FsNode::is_acquire()
@@ -67,4 +102,7 @@ void FsNode::acquire(int who_acquire)
 void FsNode::release(int who_release)
 {
     _lock.release_for(who_release);
+
+    // Reads, writes and connections change the node while it is acquired.
+    changed();
 }
@@ -7,10 +7,14 @@
 #include <libutils/RefPtr.h>
 #include <libutils/ResultOr.h>
 #include <libutils/String.h>
+#include <libutils/Vector.h>
 #include <skift/Lock.h>
 
+#include "kernel/node/Handoff.h"
+
 struct FsNode;
 struct FsHandle;
+class FsEventQueue;
 
 struct FsNode : public RefCounted<FsNode>
 {
@@ -23,6 +27,9 @@ private:
     unsigned int _clients = 0;
     unsigned int _server = 0;
 
+    // The event queues watching a handle on this node.
+    Vector<FsEventQueue *> _watchers;
+
 public:
     FileType type() { return _type; }
 
@@ -44,6 +51,14 @@ public:
 
     void deref_handle(FsHandle &handle);
 
+    void watched_by(FsEventQueue *queue);
+
+    void unwatched_by(FsEventQueue *queue);
+
+    // What poll() returns may be different now, the queues watching the
+    // node have to look again.
+    void changed();
+
     virtual Result open(FsHandle &) { return SUCCESS; }
 
     virtual void close(FsHandle &) {}
@@ -81,6 +96,12 @@ public:
         return ERR_NOT_WRITABLE;
     }
 
+    // Let a reader with nothing to read wait with its buffer, so the next
+    // write can be copied straight into it.
+    virtual bool wait_handoff(FsHandle &, Handoff &) { return false; }
+
+    virtual void cancel_handoff(FsHandle &, Handoff &) {}
+
     virtual RefPtr<FsNode> find(String name)
     {
         UNUSED(name);
@@ -41,5 +41,26 @@ ResultOr<size_t> FsPipe::write(FsHandle &handle, const void *buffer, size_t size
         return ERR_STREAM_CLOSED;
     }
 
+    // What's buffered has to be read first.
+    if (_buffer.empty())
+    {
+        size_t given = _handoff.give(buffer, size);
+
+        if (given > 0)
+        {
+            return given;
+        }
+    }
+
     return _buffer.write((const char *)buffer, size);
 }
+
+bool FsPipe::wait_handoff(FsHandle &, Handoff &handoff)
+{
+    return _buffer.empty() && writers() && _handoff.wait(handoff);
+}
+
+void FsPipe::cancel_handoff(FsHandle &, Handoff &handoff)
+{
+    _handoff.cancel(handoff);
+}
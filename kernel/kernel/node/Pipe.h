@@ -10,6 +10,7 @@ private:
     static constexpr int BUFFER_SIZE = 4096;
 
     RingBuffer<char> _buffer{BUFFER_SIZE};
+    HandoffSlot _handoff;
 
 public:
     FsPipe();
@@ -21,4 +22,8 @@ public:
     ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
 
     ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
+
+    bool wait_handoff(FsHandle &handle, Handoff &handoff) override;
+
+    void cancel_handoff(FsHandle &handle, Handoff &handoff) override;
 };
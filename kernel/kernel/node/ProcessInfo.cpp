@@ -27,6 +27,7 @@ static Iteration serialize_task(Json::Value::Array *list, Task *task)
     task_object["name"] = task->name;
     task_object["state"] = task_state_string(task->state());
     task_object["cpu"] = (int64_t)scheduler_get_usage(task->id);
+    task_object["cpu_time"] = (int64_t)scheduler_get_cpu_time(task);
     task_object["ram"] = (int64_t)task_memory_usage(task);
     task_object["user"] = (task->_flags & TASK_USER) == TASK_USER;
 
@@ -0,0 +1,81 @@
+#include <string.h>
+
+#include <libmath/MinMax.h>
+#include <libsystem/Result.h>
+#include <libutils/json/Json.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/node/Handle.h"
+#include "kernel/node/TraceInfo.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Trace.h"
+
+FsTraceInfo::FsTraceInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+static const char *trace_phase_string(TracePhase phase)
+{
+    switch (phase)
+    {
+    case TRACE_BEGIN:
+        return "begin";
+
+    case TRACE_END:
+        return "end";
+
+    default:
+        return "instant";
+    }
+}
+
+Result FsTraceInfo::open(FsHandle &handle)
+{
+    Json::Value::Array list{};
+
+    trace_iterate([&](const TraceEvent &event) {
+        Json::Value::Object event_object{};
+
+        event_object["name"] = event.name;
+        event_object["process"] = event.process;
+        event_object["pid"] = (int64_t)event.pid;
+        event_object["phase"] = trace_phase_string(event.phase);
+        event_object["timestamp"] = (int64_t)arch_clock_to_nanoseconds(event.clock);
+
+        list.push_back(move(event_object));
+
+        return Iteration::CONTINUE;
+    });
+
+    Prettifier pretty{};
+    Json::prettify(pretty, list);
+
+    handle.attached = pretty.finalize().storage().give_ref();
+    handle.attached_size = reinterpret_cast<StringStorage *>(handle.attached)->size();
+
+    return SUCCESS;
+}
+
+void FsTraceInfo::close(FsHandle &handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle.attached));
+}
+
+ResultOr<size_t> FsTraceInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+void trace_info_initialize()
+{
+    scheduler_running()->domain().link(Path::parse("/System/trace"), make<FsTraceInfo>());
+}
@@ -24,11 +24,18 @@ bool BlockerConnect::can_unblock(Task &)
 
 bool BlockerRead::can_unblock(Task &)
 {
-    return !_handle.node()->is_acquire() && _handle.node()->can_read(_handle);
+    return handed_off() ||
+           (!_handle.node()->is_acquire() && _handle.node()->can_read(_handle));
 }
 
 void BlockerRead::on_unblock(Task &task)
 {
+    // The writer already copied the data into the reader's buffer.
+    if (handed_off())
+    {
+        return;
+    }
+
     _handle.node()->acquire(task.id);
 }
 
@@ -53,6 +60,18 @@ bool BlockerSelect::can_unblock(Task &)
     return should_be_unblock;
 }
 
+/* --- BlockerEventQueue ---------------------------------------------------- */
+
+bool BlockerEventQueue::can_unblock(Task &)
+{
+    return !_queue.is_acquire() && _queue.any_ready();
+}
+
+void BlockerEventQueue::on_unblock(Task &task)
+{
+    _queue.acquire(task.id);
+}
+
 /* --- BlockerWait ---------------------------------------------------------- */
 
 bool BlockerWait::can_unblock(Task &)
@@ -4,6 +4,7 @@
 
 #include <libutils/Vector.h>
 
+#include "kernel/node/EventQueue.h"
 #include "kernel/node/Handle.h"
 #include "kernel/system/System.h"
 
@@ -21,6 +22,8 @@ public:
 
     void timeout(TimeStamp ts) { _timeout = ts; }
 
+    TimeStamp deadline() { return _timeout; }
+
     virtual ~Blocker() {}
 
     void unblock(Task &task)
@@ -94,10 +97,13 @@ class BlockerRead : public Blocker
 {
 private:
     FsHandle &_handle;
+    Handoff *_handoff;
+
+    bool handed_off() { return _handoff && _handoff->completed; }
 
 public:
-    BlockerRead(FsHandle &handle)
-        : _handle{handle}
+    BlockerRead(FsHandle &handle, Handoff *handoff = nullptr)
+        : _handle{handle}, _handoff{handoff}
     {
     }
 
@@ -128,6 +134,22 @@ public:
     bool can_unblock(Task &task) override;
 };
 
+class BlockerEventQueue : public Blocker
+{
+private:
+    FsEventQueue &_queue;
+
+public:
+    BlockerEventQueue(FsEventQueue &queue)
+        : _queue{queue}
+    {
+    }
+
+    bool can_unblock(Task &task) override;
+
+    void on_unblock(Task &task) override;
+};
+
 class BlockerTime : public Blocker
 {
 public:
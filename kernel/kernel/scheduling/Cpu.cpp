@@ -0,0 +1,64 @@
+#include <libsystem/Logger.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/scheduling/Cpu.h"
+
+// Filled while parsing the firmware tables, before there is a heap.
+static Cpu _cpus[CPU_MAX] = {
+    {
+        .id = 0,
+        .apic_id = 0,
+        .online = true,
+        .running = nullptr,
+        .switched_from = nullptr,
+        .switched_at = 0,
+        .idle = nullptr,
+        .tasks = nullptr,
+    },
+};
+
+static int _cpu_count = 1;
+
+void cpu_found(int apic_id, bool boot)
+{
+    if (boot)
+    {
+        _cpus[0].apic_id = apic_id;
+        return;
+    }
+
+    if (_cpu_count == CPU_MAX)
+    {
+        logger_warn("Ignoring the processor %d, only %d are supported", apic_id, CPU_MAX);
+        return;
+    }
+
+    _cpus[_cpu_count] = {
+        .id = _cpu_count,
+        .apic_id = apic_id,
+        .online = false,
+        .running = nullptr,
+        .switched_from = nullptr,
+        .switched_at = 0,
+        .idle = nullptr,
+        .tasks = nullptr,
+    };
+
+    _cpu_count++;
+}
+
+int cpu_count()
+{
+    return _cpu_count;
+}
+
+Cpu *cpu_get(int id)
+{
+    return &_cpus[id];
+}
+
+Cpu *cpu_current()
+{
+    return &_cpus[arch_current_cpu()];
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <libsystem/utils/List.h>
+
+struct Task;
+
+#define CPU_MAX 32
+
+struct Cpu
+{
+    int id;
+    int apic_id;
+
+    // Set by the processor itself once it is up.
+    bool online;
+
+    Task *running;
+
+    // The task it switched away from, until it is off its stack.
+    Task *switched_from;
+
+    // When the running task got the processor, in ticks of the clock.
+    uint64_t switched_at;
+
+    // Only processors with an idle task take tasks from the scheduler.
+    Task *idle;
+
+    // The runnable tasks waiting for this processor.
+    List *tasks;
+};
+
+// The boot processor is always the first one.
+void cpu_found(int apic_id, bool boot);
+
+int cpu_count();
+
+Cpu *cpu_get(int id);
+
+Cpu *cpu_current();
@@ -1,33 +1,141 @@
 
+#include <libmath/MinMax.h>
+
 #include "archs/Arch.h"
 
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Cpu.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/system/System.h"
 
-static bool scheduler_context_switch = false;
-static int scheduler_record[SCHEDULER_RECORD_COUNT] = {};
-
-static Task *running = nullptr;
-static Task *idle = nullptr;
+static bool scheduler_context_switch[CPU_MAX] = {};
+static uint32_t scheduler_balanced_at = 0;
 
 static List *blocked_tasks;
-static List *running_tasks;
 
 void scheduler_initialize()
 {
     blocked_tasks = list_create();
-    running_tasks = list_create();
+
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        cpu_get(i)->tasks = list_create();
+    }
 }
 
-void scheduler_did_create_idle_task(Task *task)
+void scheduler_did_create_idle_task(Cpu *cpu, Task *task)
 {
-    idle = task;
+    cpu->idle = task;
+    task->cpu = cpu;
 }
 
 void scheduler_did_create_running_task(Task *task)
 {
-    running = task;
+    Cpu *cpu = cpu_current();
+
+    cpu->running = task;
+    cpu->switched_at = arch_get_clock();
+    task->cpu = cpu;
+    task->on_cpu = true;
+}
+
+void scheduler_did_start_cpu(Cpu *cpu)
+{
+    cpu->running = cpu->idle;
+    cpu->switched_at = arch_get_clock();
+    cpu->idle->on_cpu = true;
+}
+
+static bool is_scheduling(Cpu *cpu)
+{
+    return cpu->online && cpu->idle != nullptr;
+}
+
+// The current processor wins ties, the task may still be in its cache.
+static Cpu *least_loaded_cpu()
+{
+    Cpu *least = cpu_current();
+
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        Cpu *cpu = cpu_get(i);
+
+        if (is_scheduling(cpu) && cpu->tasks->count() < least->tasks->count())
+        {
+            least = cpu;
+        }
+    }
+
+    return least;
+}
+
+static Cpu *most_loaded_cpu()
+{
+    Cpu *most = cpu_current();
+
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        Cpu *cpu = cpu_get(i);
+
+        if (is_scheduling(cpu) && cpu->tasks->count() > most->tasks->count())
+        {
+            most = cpu;
+        }
+    }
+
+    return most;
+}
+
+// An idle processor sleeps until a blocked task times out, it has to be
+// woken up when it is given a task.
+static void wake_up(Cpu *cpu)
+{
+    if (cpu != cpu_current() && cpu->running == cpu->idle)
+    {
+        arch_reschedule(cpu->id);
+    }
+}
+
+// Moves a task waiting on one processor to the queue of another, the tasks
+// which are still on a processor stay where they are.
+static bool migrate_one_task(Cpu *from, Cpu *to)
+{
+    list_foreach(Task, task, from->tasks)
+    {
+        if (!__atomic_load_n(&task->on_cpu, __ATOMIC_ACQUIRE))
+        {
+            list_remove(from->tasks, task);
+            list_push(to->tasks, task);
+            task->cpu = to;
+
+            wake_up(to);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void balance()
+{
+    Cpu *most = most_loaded_cpu();
+    Cpu *least = least_loaded_cpu();
+
+    if (most->tasks->count() > least->tasks->count() + 1)
+    {
+        migrate_one_task(most, least);
+    }
+}
+
+static void steal(Cpu *cpu)
+{
+    Cpu *most = most_loaded_cpu();
+
+    if (most != cpu)
+    {
+        migrate_one_task(most, cpu);
+    }
 }
 
 void scheduler_did_change_task_state(Task *task, TaskState oldstate, TaskState newstate)
@@ -38,7 +146,7 @@ void scheduler_did_change_task_state(Task *task, TaskState oldstate, TaskState n
     {
         if (oldstate == TASK_STATE_RUNNING)
         {
-            list_remove(running_tasks, task);
+            list_remove(task->cpu->tasks, task);
         }
 
         if (oldstate == TASK_STATE_BLOCKED)
@@ -53,23 +161,42 @@ void scheduler_did_change_task_state(Task *task, TaskState oldstate, TaskState n
 
         if (newstate == TASK_STATE_RUNNING)
         {
-            list_push(running_tasks, task);
+            task->cpu = least_loaded_cpu();
+            list_push(task->cpu->tasks, task);
+
+            wake_up(task->cpu);
         }
     }
 }
 
 bool scheduler_is_context_switch()
 {
-    return scheduler_context_switch;
+    InterruptsRetainer retainer;
+
+    return scheduler_context_switch[arch_current_cpu()];
 }
 
 Task *scheduler_running()
 {
+    // Without interrupts, the task can't be moved to another processor
+    // between finding the processor and reading what it runs.
+    bool enabled = arch_interrupts_enabled();
+    arch_disable_interrupts();
+
+    Task *running = cpu_current()->running;
+
+    if (enabled)
+    {
+        arch_enable_interrupts();
+    }
+
     return running;
 }
 
 int scheduler_running_id()
 {
+    Task *running = scheduler_running();
+
     if (running == nullptr)
     {
         return -1;
@@ -85,21 +212,56 @@ void scheduler_yield()
     ASSERT_INTERRUPTS_NOT_RETAINED();
 }
 
+// Including the time since it last got the processor, if it is running.
+static uint64_t cpu_time(Task *task, uint64_t now)
+{
+    // task->cpu is the queue the task is on, another processor may have
+    // taken it from there.
+    for (int i = 0; i < cpu_count(); i++)
+    {
+        Cpu *cpu = cpu_get(i);
+
+        if (cpu->running == task)
+        {
+            return task->cpu_time + (now - cpu->switched_at);
+        }
+    }
+
+    return task->cpu_time;
+}
+
 int scheduler_get_usage(int task_id)
 {
     InterruptsRetainer retainer;
 
-    int count = 0;
+    Task *task = task_by_id(task_id);
 
-    for (int i = 0; i < SCHEDULER_RECORD_COUNT; i++)
+    if (!task)
     {
-        if (scheduler_record[i] == task_id)
-        {
-            count++;
-        }
+        return 0;
+    }
+
+    uint64_t now = arch_get_clock();
+    uint64_t elapsed = now - task->usage_clock;
+
+    // Over a shorter window, the usage is mostly noise.
+    if (arch_clock_to_nanoseconds(elapsed) >= SCHEDULER_USAGE_WINDOW)
+    {
+        uint64_t used = cpu_time(task, now) - task->usage_cpu_time;
+
+        task->usage = used * 100 / elapsed;
+        task->usage_clock = now;
+        task->usage_cpu_time += used;
     }
 
-    return (count * 100) / SCHEDULER_RECORD_COUNT;
+    return task->usage;
+}
+
+uint64_t scheduler_get_cpu_time(Task *task)
+{
+    InterruptsRetainer retainer;
+
+    return arch_clock_to_nanoseconds(cpu_time(task, arch_get_clock()));
 }
 
 static Iteration wakeup_task_if_unblocked(void *, Task *task)
@@ -109,28 +271,112 @@ static Iteration wakeup_task_if_unblocked(void *, Task *task)
     return Iteration::CONTINUE;
 }
 
+// Until the first of the blocked tasks times out, they may also be woken
+// up by an interrupt before that.
+static uint64_t until_next_timeout()
+{
+    uint64_t now = system_get_nanoseconds();
+    uint64_t until = (uint64_t)-1;
+
+    list_foreach(Task, task, blocked_tasks)
+    {
+        TimeStamp deadline = task->_blocker->deadline();
+
+        if (deadline == (TimeStamp)-1)
+        {
+            continue;
+        }
+
+        uint64_t at = deadline * 1000000ull;
+        until = MIN(until, at > now ? at - now : 0);
+    }
+
+    return until;
+}
+
+// The first runnable task of the queue, which goes to the back. A task may
+// be runnable while another processor is still leaving it, it is skipped.
+static Task *pick(Cpu *cpu, bool *skipped)
+{
+    list_foreach(Task, task, cpu->tasks)
+    {
+        if (task == cpu->running || !__atomic_load_n(&task->on_cpu, __ATOMIC_ACQUIRE))
+        {
+            list_remove(cpu->tasks, task);
+            list_pushback(cpu->tasks, task);
+
+            return task;
+        }
+
+        *skipped = true;
+    }
+
+    return nullptr;
+}
+
+void scheduler_did_switch()
+{
+    Cpu *cpu = cpu_current();
+
+    __atomic_store_n(&cpu->switched_from->on_cpu, false, __ATOMIC_RELEASE);
+    cpu->switched_from = nullptr;
+}
+
 uintptr_t schedule(uintptr_t current_stack_pointer)
 {
-    scheduler_context_switch = true;
+    Cpu *cpu = cpu_current();
+    Task *running = cpu->running;
+
+    scheduler_context_switch[cpu->id] = true;
 
     running->kernel_stack_pointer = current_stack_pointer;
     arch_save_context(running);
 
-    scheduler_record[system_get_tick() % SCHEDULER_RECORD_COUNT] = running->id;
+    uint64_t now = arch_get_clock();
+    running->cpu_time += now - cpu->switched_at;
+    cpu->switched_at = now;
 
     list_iterate(blocked_tasks, nullptr, (ListIterationCallback)wakeup_task_if_unblocked);
 
-    // Get the next task
-    if (!list_peek_and_pushback(running_tasks, (void **)&running))
+    if (system_get_tick() - scheduler_balanced_at >= SCHEDULER_BALANCE_INTERVAL)
+    {
+        scheduler_balanced_at = system_get_tick();
+        balance();
+    }
+
+    if (cpu->tasks->empty())
+    {
+        steal(cpu);
+    }
+
+    Task *previous = running;
+    bool skipped = false;
+
+    // Get the next task, or the idle task if there are no running tasks.
+    running = pick(cpu, &skipped);
+
+    if (running == nullptr)
+    {
+        running = cpu->idle;
+    }
+
+    if (running != previous)
     {
-        // Or the idle task if there are no running tasks.
-        running = idle;
+        running->on_cpu = true;
+        cpu->switched_from = previous;
     }
 
+    cpu->running = running;
+
+    // An idle processor sleeps until a blocked task times out, instead of
+    // waking up every slice to find nothing to do. Unless a task it skipped
+    // becomes runnable in a moment.
+    arch_timer_oneshot(running == cpu->idle && !skipped ? until_next_timeout() : SCHEDULER_SLICE);
+
     arch_address_space_switch(running->address_space);
     arch_load_context(running);
 
-    scheduler_context_switch = false;
+    scheduler_context_switch[cpu->id] = false;
 
     return running->kernel_stack_pointer;
 }
@@ -2,20 +2,36 @@
 
 #include "kernel/tasking/Task.h"
 
-#define SCHEDULER_RECORD_COUNT 1000
+// In nanoseconds, how long a task runs before the next one. Blocked tasks
+// are checked that often too, unless the processor is idle.
+#define SCHEDULER_SLICE 1000000
+
+// In ticks, how often tasks are moved from the busiest processor to the
+// least busy one.
+#define SCHEDULER_BALANCE_INTERVAL 100
+
+// In nanoseconds, how long the usage of a task is measured over.
+#define SCHEDULER_USAGE_WINDOW 1000000000
 
 void scheduler_initialize();
 
-void scheduler_did_create_idle_task(Task *task);
+void scheduler_did_create_idle_task(Cpu *cpu, Task *task);
 
 void scheduler_did_create_running_task(Task *task);
 
+// The processor runs its idle task, until it is given something else.
+void scheduler_did_start_cpu(Cpu *cpu);
+
 void scheduler_did_change_task_state(Task *task, TaskState oldstate, TaskState newstate);
 
 bool scheduler_is_context_switch();
 
+// In percents of a processor.
 int scheduler_get_usage(int task_id);
 
+// In nanoseconds, how long the task has been running for.
+uint64_t scheduler_get_cpu_time(Task *task);
+
 Task *scheduler_running();
 
 int scheduler_running_id();
@@ -23,3 +39,7 @@ int scheduler_running_id();
 void scheduler_yield();
 
 uintptr_t schedule(uintptr_t current_stack_pointer);
+
+// Called by the interrupt handler once it left the stack of the task it was
+// on, which another processor can pick up from now on.
+extern "C" void scheduler_did_switch();
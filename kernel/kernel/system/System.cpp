@@ -25,21 +25,14 @@ void system_stop()
     }
 }
 
-static uint32_t _system_tick;
-
-void system_tick()
+uint64_t system_get_nanoseconds()
 {
-    if (_system_tick + 1 < _system_tick)
-    {
-        logger_fatal("System tick overflow!");
-    }
-
-    _system_tick++;
+    return arch_clock_to_nanoseconds(arch_get_clock());
 }
 
 uint32_t system_get_tick()
 {
-    return _system_tick;
+    return system_get_nanoseconds() / 1000000;
 }
 
 static TimeStamp _system_boot_timestamp = 0;
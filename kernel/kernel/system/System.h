@@ -15,8 +15,10 @@ void NO_RETURN system_hang();
 
 void NO_RETURN system_stop();
 
-void system_tick();
+// Since the machine started.
+uint64_t system_get_nanoseconds();
 
+// In milliseconds, timeouts are counted in those.
 uint32_t system_get_tick();
 
 ElapsedTime system_get_uptime();
@@ -0,0 +1,68 @@
+#include <libmath/MinMax.h>
+#include <string.h>
+
+#include "archs/Arch.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Trace.h"
+
+static TraceEvent _events[TRACE_EVENT_COUNT];
+static size_t _count = 0;
+
+void trace_record(const char *name, size_t size, TracePhase phase)
+{
+    // Read first, so the time spent recording is not part of a span.
+    uint64_t clock = arch_get_clock();
+
+    InterruptsRetainer retainer;
+
+    if (_count == TRACE_EVENT_COUNT)
+    {
+        return;
+    }
+
+    auto &event = _events[_count];
+
+    size = MIN(size, TRACE_NAME_SIZE - 1);
+    memcpy(event.name, name, size);
+    event.name[size] = '\0';
+
+    // Tasks are not there yet early in the boot.
+    Task *task = scheduler_running();
+
+    if (task)
+    {
+        strlcpy(event.process, task->name, TRACE_PROCESS_SIZE);
+        event.pid = task->id;
+    }
+    else
+    {
+        strlcpy(event.process, "kernel", TRACE_PROCESS_SIZE);
+        event.pid = 0;
+    }
+
+    event.phase = phase;
+    event.clock = clock;
+
+    _count++;
+}
+
+void trace_iterate(Callback<Iteration(const TraceEvent &)> callback)
+{
+    size_t count = 0;
+
+    {
+        InterruptsRetainer retainer;
+        count = _count;
+    }
+
+    // Events are never changed once recorded.
+    for (size_t i = 0; i < count; i++)
+    {
+        if (callback(_events[i]) == Iteration::STOP)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <abi/System.h>
+#include <libutils/Callback.h>
+#include <string.h>
+
+#define TRACE_PROCESS_SIZE 32
+
+// Events are kept from the start of the kernel until the buffer is full,
+// which is meant to cover the boot up to the desktop.
+#define TRACE_EVENT_COUNT 2048
+
+struct TraceEvent
+{
+    char name[TRACE_NAME_SIZE];
+    char process[TRACE_PROCESS_SIZE];
+    int pid;
+    TracePhase phase;
+    uint64_t clock;
+};
+
+void trace_record(const char *name, size_t size, TracePhase phase);
+
+void trace_iterate(Callback<Iteration(const TraceEvent &)> callback);
+
+// Records the time spent in a scope, for the kernel itself.
+class TraceSpan
+{
+private:
+    const char *_name;
+
+    NONCOPYABLE(TraceSpan);
+    NONMOVABLE(TraceSpan);
+
+public:
+    TraceSpan(const char *name) : _name{name}
+    {
+        trace_record(_name, strlen(_name), TRACE_BEGIN);
+    }
+
+    ~TraceSpan()
+    {
+        trace_record(_name, strlen(_name), TRACE_END);
+    }
+};
@@ -15,12 +15,22 @@ void finalize_task(Task *task)
     list_pushback(_task_to_finalize, task);
 }
 
+// A task which was just canceled may still be on the stack of the processor
+// which ran it, it waits for the next round then.
 Task *finalizer_pop_task()
 {
     InterruptsRetainer retainer;
-    Task *task = nullptr;
-    list_pop(_task_to_finalize, (void **)&task);
-    return task;
+
+    list_foreach(Task, task, _task_to_finalize)
+    {
+        if (!__atomic_load_n(&task->on_cpu, __ATOMIC_ACQUIRE))
+        {
+            list_remove(_task_to_finalize, task);
+            return task;
+        }
+    }
+
+    return nullptr;
 }
 
 void finalizer_task()
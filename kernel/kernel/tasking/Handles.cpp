@@ -1,6 +1,9 @@
+#include <stdlib.h>
 
+#include <libmath/MinMax.h>
 #include <libsystem/Logger.h>
 
+#include "kernel/node/EventQueue.h"
 #include "kernel/node/Pipe.h"
 #include "kernel/node/Terminal.h"
 #include "kernel/scheduling/Blocker.h"
@@ -188,6 +191,84 @@ Result Handles::poll(HandlePoll *handles, size_t count, Timeout timeout)
     return SUCCESS;
 }
 
+Result Handles::watch(int queue_index, int handle_index, PollEvent events)
+{
+    RefPtr<FsHandle> watched;
+
+    // The handle may be closed already when it stops being watched.
+    if (events != 0)
+    {
+        LockHolder holder(_lock);
+
+        if (!is_valid_handle(handle_index))
+        {
+            return ERR_BAD_HANDLE;
+        }
+
+        watched = _handles[handle_index];
+    }
+
+    auto handle = acquire(queue_index);
+
+    if (!handle)
+    {
+        return ERR_BAD_HANDLE;
+    }
+
+    Result result = ERR_INVALID_ARGUMENT;
+    auto node = handle->node();
+
+    if (node->type() == FILE_TYPE_EVENT_QUEUE)
+    {
+        RefPtr<FsEventQueue> queue{node};
+
+        queue->acquire(scheduler_running_id());
+        result = queue->watch(handle_index, watched, events);
+        queue->release(scheduler_running_id());
+    }
+
+    release(queue_index);
+
+    return result;
+}
+
+ResultOr<size_t> Handles::wait(int queue_index, HandlePoll *ready, size_t count, Timeout timeout)
+{
+    auto handle = acquire(queue_index);
+
+    if (!handle)
+    {
+        return ERR_BAD_HANDLE;
+    }
+
+    auto node = handle->node();
+
+    if (node->type() != FILE_TYPE_EVENT_QUEUE)
+    {
+        release(queue_index);
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    RefPtr<FsEventQueue> queue{node};
+
+    BlockerEventQueue blocker{*queue};
+    Result block_result = task_block(scheduler_running(), blocker, timeout);
+
+    if (block_result != SUCCESS)
+    {
+        release(queue_index);
+        return block_result;
+    }
+
+    // The blocker acquired the queue when it unblocked us.
+    size_t collected = queue->collect(ready, count);
+    queue->release(scheduler_running_id());
+
+    release(queue_index);
+
+    return collected;
+}
+
 ResultOr<size_t> Handles::read(int handle_index, void *buffer, size_t size)
 {
     auto handle = acquire(handle_index);
@@ -220,6 +301,129 @@ ResultOr<size_t> Handles::write(int handle_index, const void *buffer, size_t siz
     return result_or_written;
 }
 
+ResultOr<size_t> Handles::readv(int handle_index, const IOVec *vectors, size_t count)
+{
+    auto handle = acquire(handle_index);
+
+    if (!handle)
+    {
+        return ERR_BAD_HANDLE;
+    }
+
+    auto result_or_read = handle->readv(vectors, count);
+
+    release(handle_index);
+
+    return result_or_read;
+}
+
+ResultOr<size_t> Handles::writev(int handle_index, const IOVec *vectors, size_t count)
+{
+    auto handle = acquire(handle_index);
+
+    if (!handle)
+    {
+        return ERR_BAD_HANDLE;
+    }
+
+    auto result_or_written = handle->writev(vectors, count);
+
+    release(handle_index);
+
+    return result_or_written;
+}
+
+ResultOr<size_t> Handles::splice(int source, int destination, size_t size)
+{
+    if (source == destination)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    auto source_handle = acquire(source);
+
+    if (!source_handle)
+    {
+        return ERR_BAD_HANDLE;
+    }
+
+    auto destination_handle = acquire(destination);
+
+    if (!destination_handle)
+    {
+        release(source);
+        return ERR_BAD_HANDLE;
+    }
+
+    // The data goes through a kernel buffer and never reaches userspace, a
+    // whole file is copied by a single syscall.
+    auto buffer = (uint8_t *)malloc(SPLICE_CHUNK_SIZE);
+
+    if (!buffer)
+    {
+        release(destination);
+        release(source);
+
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    Result result = SUCCESS;
+    size_t spliced = 0;
+
+    while (spliced < size)
+    {
+        // Like readv, only the first chunk may wait for the source.
+        if (spliced > 0 && !source_handle->poll(POLL_READ))
+        {
+            break;
+        }
+
+        auto result_or_read = source_handle->read(buffer, MIN(SPLICE_CHUNK_SIZE, size - spliced));
+
+        if (!result_or_read.success())
+        {
+            result = result_or_read.result();
+            break;
+        }
+
+        size_t read = result_or_read.unwrap();
+
+        if (read == 0)
+        {
+            break;
+        }
+
+        auto result_or_written = destination_handle->write(buffer, read);
+
+        if (!result_or_written.success())
+        {
+            result = result_or_written.result();
+            break;
+        }
+
+        size_t written = result_or_written.unwrap();
+
+        spliced += written;
+
+        if (written < read)
+        {
+            break;
+        }
+    }
+
+    free(buffer);
+
+    release(destination);
+    release(source);
+
+    if (result != SUCCESS && spliced == 0)
+    {
+        return result;
+    }
+
+    return spliced;
+}
+
 ResultOr<ssize64_t> Handles::seek(int handle_index, IO::SeekFrom from)
 {
     auto handle = acquire(handle_index);
@@ -368,6 +572,13 @@ Result Handles::pipe(int *reader, int *writer)
         OPEN_WRITE);
 }
 
+ResultOr<int> Handles::event_queue()
+{
+    auto queue = make<FsEventQueue>();
+
+    return add(make<FsHandle>(queue, OPEN_READ));
+}
+
 Result Handles::pass(Handles &handles, int source, int destination)
 {
     {
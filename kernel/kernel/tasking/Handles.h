@@ -7,6 +7,8 @@
 class Handles
 {
 private:
+    static constexpr size_t SPLICE_CHUNK_SIZE = 16 * 1024;
+
     Lock _lock{"handles-lock"};
 
     RefPtr<FsHandle> _handles[PROCESS_HANDLE_COUNT];
@@ -42,10 +44,20 @@ public:
 
     Result poll(HandlePoll *handles, size_t count, Timeout timeout);
 
+    Result watch(int queue_index, int handle_index, PollEvent events);
+
+    ResultOr<size_t> wait(int queue_index, HandlePoll *ready, size_t count, Timeout timeout);
+
     ResultOr<size_t> read(int handle_index, void *buffer, size_t size);
 
     ResultOr<size_t> write(int handle_index, const void *buffer, size_t size);
 
+    ResultOr<size_t> readv(int handle_index, const IOVec *vectors, size_t count);
+
+    ResultOr<size_t> writev(int handle_index, const IOVec *vectors, size_t count);
+
+    ResultOr<size_t> splice(int source, int destination, size_t size);
+
     ResultOr<ssize64_t> seek(int handle_index, IO::SeekFrom from);
 
     Result call(int handle_index, IOCall request, void *args);
@@ -63,5 +75,7 @@ public:
 
     Result pipe(int *reader, int *writer);
 
+    ResultOr<int> event_queue();
+
     Result pass(Handles &handles, int source, int destination);
 };
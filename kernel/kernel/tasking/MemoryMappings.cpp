@@ -0,0 +1,295 @@
+#include <assert.h>
+#include <libmath/MinMax.h>
+
+#include "kernel/tasking/MemoryMappings.h"
+
+static uintptr_t end_of(MemoryMapping *mapping)
+{
+    return mapping->address + mapping->size;
+}
+
+static int height(MemoryMapping *node)
+{
+    return node ? node->height : 0;
+}
+
+static void update(MemoryMapping *node)
+{
+    node->height = MAX(height(node->left), height(node->right)) + 1;
+
+    node->subtree_begin = node->left ? node->left->subtree_begin : node->address;
+    node->subtree_end = node->right ? node->right->subtree_end : end_of(node);
+
+    size_t hole = 0;
+
+    if (node->left)
+    {
+        hole = MAX(node->left->subtree_hole, node->address - node->left->subtree_end);
+    }
+
+    if (node->right)
+    {
+        hole = MAX(hole, node->right->subtree_hole);
+        hole = MAX(hole, node->right->subtree_begin - end_of(node));
+    }
+
+    node->subtree_hole = hole;
+}
+
+static MemoryMapping *rotate_left(MemoryMapping *node)
+{
+    auto right = node->right;
+
+    node->right = right->left;
+    right->left = node;
+
+    update(node);
+    update(right);
+
+    return right;
+}
+
+static MemoryMapping *rotate_right(MemoryMapping *node)
+{
+    auto left = node->left;
+
+    node->left = left->right;
+    left->right = node;
+
+    update(node);
+    update(left);
+
+    return left;
+}
+
+static MemoryMapping *balance(MemoryMapping *node)
+{
+    update(node);
+
+    int factor = height(node->left) - height(node->right);
+
+    if (factor > 1)
+    {
+        if (height(node->left->left) < height(node->left->right))
+        {
+            node->left = rotate_left(node->left);
+        }
+
+        return rotate_right(node);
+    }
+
+    if (factor < -1)
+    {
+        if (height(node->right->right) < height(node->right->left))
+        {
+            node->right = rotate_right(node->right);
+        }
+
+        return rotate_left(node);
+    }
+
+    return node;
+}
+
+static MemoryMapping *tree_insert(MemoryMapping *node, MemoryMapping *mapping)
+{
+    if (!node)
+    {
+        mapping->left = nullptr;
+        mapping->right = nullptr;
+        update(mapping);
+
+        return mapping;
+    }
+
+    if (mapping->address < node->address)
+    {
+        node->left = tree_insert(node->left, mapping);
+    }
+    else
+    {
+        node->right = tree_insert(node->right, mapping);
+    }
+
+    return balance(node);
+}
+
+static MemoryMapping *tree_remove_first(MemoryMapping *node, MemoryMapping **first)
+{
+    if (!node->left)
+    {
+        *first = node;
+        return node->right;
+    }
+
+    node->left = tree_remove_first(node->left, first);
+
+    return balance(node);
+}
+
+static MemoryMapping *tree_remove(MemoryMapping *node, MemoryMapping *mapping)
+{
+    assert(node);
+
+    if (mapping->address < node->address)
+    {
+        node->left = tree_remove(node->left, mapping);
+    }
+    else if (mapping->address > node->address)
+    {
+        node->right = tree_remove(node->right, mapping);
+    }
+    else
+    {
+        if (!node->right)
+        {
+            return node->left;
+        }
+
+        MemoryMapping *successor = nullptr;
+        auto right = tree_remove_first(node->right, &successor);
+
+        successor->left = node->left;
+        successor->right = right;
+
+        return balance(successor);
+    }
+
+    return balance(node);
+}
+
+// Only holes which have room for any alignment are looked into, so a
+// subtree which is entered always has a fit and the search never goes
+// back up.
+static bool tree_find_free(MemoryMapping *node, uintptr_t from, uintptr_t to, size_t needed, size_t align, uintptr_t *address)
+{
+    if (from >= to)
+    {
+        return false;
+    }
+
+    if (!node)
+    {
+        if (to - from < needed)
+        {
+            return false;
+        }
+
+        *address = ALIGN_UP(from, align);
+        return true;
+    }
+
+    size_t room = node->subtree_hole;
+    room = MAX(room, node->subtree_begin > from ? node->subtree_begin - from : 0);
+    room = MAX(room, to > node->subtree_end ? to - node->subtree_end : 0);
+
+    if (room < needed)
+    {
+        return false;
+    }
+
+    if (tree_find_free(node->left, from, MIN(node->address, to), needed, align, address))
+    {
+        return true;
+    }
+
+    return tree_find_free(node->right, MAX(end_of(node), from), to, needed, align, address);
+}
+
+MemoryMapping *MemoryMappings::first()
+{
+    auto node = _root;
+
+    while (node && node->left)
+    {
+        node = node->left;
+    }
+
+    return node;
+}
+
+MemoryMapping *MemoryMappings::by_address(uintptr_t address)
+{
+    auto node = _root;
+
+    while (node && node->address != address)
+    {
+        node = address < node->address ? node->left : node->right;
+    }
+
+    return node;
+}
+
+MemoryMapping *MemoryMappings::containing(uintptr_t address)
+{
+    auto node = _root;
+
+    while (node)
+    {
+        if (address < node->address)
+        {
+            node = node->left;
+        }
+        else if (address >= end_of(node))
+        {
+            node = node->right;
+        }
+        else
+        {
+            return node;
+        }
+    }
+
+    return nullptr;
+}
+
+bool MemoryMappings::collides(MemoryRange range)
+{
+    auto node = _root;
+
+    while (node)
+    {
+        if (range.base() + range.size() <= node->address)
+        {
+            node = node->left;
+        }
+        else if (range.base() >= end_of(node))
+        {
+            node = node->right;
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uintptr_t MemoryMappings::find_free(MemoryRange within, size_t size, size_t align)
+{
+    uintptr_t address = 0;
+
+    size_t needed = size + align - ARCH_PAGE_SIZE;
+
+    if (!tree_find_free(_root, within.base(), within.base() + within.size(), needed, align, &address))
+    {
+        return 0;
+    }
+
+    return address;
+}
+
+void MemoryMappings::insert(MemoryMapping *mapping)
+{
+    assert(mapping->size > 0);
+
+    _root = tree_insert(_root, mapping);
+    _size += mapping->size;
+}
+
+void MemoryMappings::remove(MemoryMapping *mapping)
+{
+    _root = tree_remove(_root, mapping);
+    _size -= mapping->size;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <libutils/Iteration.h>
+
+#include "kernel/memory/MemoryRange.h"
+
+struct MemoryObject;
+
+struct MemoryMapping
+{
+    MemoryObject *object;
+
+    uintptr_t address;
+    size_t size;
+
+    MemoryRange range() { return {address, size}; }
+
+    MemoryMapping *left;
+    MemoryMapping *right;
+    int height;
+
+    // The lowest address, the highest end and the largest hole between the
+    // mappings of the subtree.
+    uintptr_t subtree_begin;
+    uintptr_t subtree_end;
+    size_t subtree_hole;
+};
+
+// The mappings of a task sorted by address, in an AVL tree. Each node knows
+// the largest hole below it, so finding room for a new mapping is a single
+// descent instead of probing the page tables page by page.
+class MemoryMappings
+{
+private:
+    MemoryMapping *_root = nullptr;
+    size_t _size = 0;
+
+    template <typename TCallback>
+    static Iteration foreach(MemoryMapping *node, TCallback &callback)
+    {
+        if (!node)
+        {
+            return Iteration::CONTINUE;
+        }
+
+        if (foreach(node->left, callback) == Iteration::STOP ||
+            callback(node) == Iteration::STOP)
+        {
+            return Iteration::STOP;
+        }
+
+        return foreach(node->right, callback);
+    }
+
+public:
+    bool empty() { return _root == nullptr; }
+
+    // The memory used by all the mappings.
+    size_t size() { return _size; }
+
+    MemoryMapping *first();
+
+    MemoryMapping *by_address(uintptr_t address);
+
+    // The mapping this address is in, not only at its start.
+    MemoryMapping *containing(uintptr_t address);
+
+    bool collides(MemoryRange range);
+
+    // The lowest address of the range where there is room for this many
+    // bytes, aligned. Returns 0 if it is full.
+    uintptr_t find_free(MemoryRange within, size_t size, size_t align);
+
+    void insert(MemoryMapping *mapping);
+
+    void remove(MemoryMapping *mapping);
+
+    // In address order. The callback may not change the tree.
+    template <typename TCallback>
+    Iteration foreach(TCallback callback)
+    {
+        return foreach(_root, callback);
+    }
+};
@@ -10,6 +10,7 @@
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/system/System.h"
+#include "kernel/system/Trace.h"
 #include "kernel/tasking/Syscalls.h"
 #include "kernel/tasking/Task-Launchpad.h"
 #include "kernel/tasking/Task-Memory.h"
@@ -372,6 +373,17 @@ Result hj_system_get_ticks(uint32_t *tick)
     return SUCCESS;
 }
 
+Result hj_system_clock(uint64_t *nanoseconds)
+{
+    if (!syscall_validate_ptr((uintptr_t)nanoseconds, sizeof(uint64_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    *nanoseconds = system_get_nanoseconds();
+    return SUCCESS;
+}
+
 Result hj_system_reboot()
 {
     arch_reboot();
@@ -384,6 +396,23 @@ Result hj_system_shutdown()
     ASSERT_NOT_REACHED();
 }
 
+Result hj_system_trace(const char *name, size_t size, TracePhase phase)
+{
+    if (!syscall_validate_ptr((uintptr_t)name, size))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    if (phase != TRACE_BEGIN && phase != TRACE_END && phase != TRACE_INSTANT)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    trace_record(name, size, phase);
+
+    return SUCCESS;
+}
+
 /* --- Create --------------------------------------------------------------- */
 
 Result hj_create_pipe(int *reader_handle, int *writer_handle)
@@ -410,6 +439,51 @@ Result hj_create_term(int *server_handle, int *client_handle)
     return handles.term(server_handle, client_handle);
 }
 
+Result hj_create_event_queue(int *queue_handle)
+{
+    if (!syscall_validate_ptr((uintptr_t)queue_handle, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto &handles = scheduler_running()->handles();
+
+    auto result_or_queue = handles.event_queue();
+
+    *queue_handle = result_or_queue.unwrap_or(HANDLE_INVALID_ID);
+
+    return result_or_queue.result();
+}
+
+Result hj_event_queue_watch(int queue_handle, int handle, PollEvent events)
+{
+    auto &handles = scheduler_running()->handles();
+
+    return handles.watch(queue_handle, handle, events);
+}
+
+Result hj_event_queue_wait(int queue_handle, HandlePoll *ready, size_t count, Timeout timeout, size_t *ready_count)
+{
+    if (count > PROCESS_HANDLE_COUNT)
+    {
+        return ERR_TOO_MANY_HANDLE;
+    }
+
+    if (!syscall_validate_ptr((uintptr_t)ready, sizeof(HandlePoll) * count) ||
+        !syscall_validate_ptr((uintptr_t)ready_count, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto &handles = scheduler_running()->handles();
+
+    auto result_or_ready = handles.wait(queue_handle, ready, count, timeout);
+
+    *ready_count = result_or_ready.unwrap_or(0);
+
+    return result_or_ready.result();
+}
+
 /* --- Handles -------------------------------------------------------------- */
 
 Result hj_handle_open(int *handle,
@@ -634,6 +708,75 @@ Result hj_handle_accept(int handle, int *connection_handle)
     }
 }
 
+static bool syscall_validate_vectors(const IOVec *vectors, size_t count)
+{
+    if (count > IOVEC_MAX_COUNT ||
+        !syscall_validate_ptr((uintptr_t)vectors, sizeof(IOVec) * count))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!syscall_validate_ptr((uintptr_t)vectors[i].buffer, vectors[i].size))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Result hj_handle_readv(int handle, const IOVec *vectors, size_t count, size_t *read)
+{
+    if (!syscall_validate_vectors(vectors, count) ||
+        !syscall_validate_ptr((uintptr_t)read, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto &handles = scheduler_running()->handles();
+
+    auto result_or_read = handles.readv(handle, vectors, count);
+
+    *read = result_or_read.unwrap_or(0);
+
+    return result_or_read.result();
+}
+
+Result hj_handle_writev(int handle, const IOVec *vectors, size_t count, size_t *written)
+{
+    if (!syscall_validate_vectors(vectors, count) ||
+        !syscall_validate_ptr((uintptr_t)written, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto &handles = scheduler_running()->handles();
+
+    auto result_or_written = handles.writev(handle, vectors, count);
+
+    *written = result_or_written.unwrap_or(0);
+
+    return result_or_written.result();
+}
+
+Result hj_handle_splice(int source, int destination, size_t size, size_t *spliced)
+{
+    if (!syscall_validate_ptr((uintptr_t)spliced, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto &handles = scheduler_running()->handles();
+
+    auto result_or_spliced = handles.splice(source, destination, size);
+
+    *spliced = result_or_spliced.unwrap_or(0);
+
+    return result_or_spliced.result();
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-function-type"
 
@@ -661,8 +804,10 @@ static SyscallHandler syscalls[__SYSCALL_COUNT] = {
     [HJ_SYSTEM_STATUS] = reinterpret_cast<SyscallHandler>(hj_system_status),
     [HJ_SYSTEM_TIME] = reinterpret_cast<SyscallHandler>(hj_system_get_time),
     [HJ_SYSTEM_TICKS] = reinterpret_cast<SyscallHandler>(hj_system_get_ticks),
+    [HJ_SYSTEM_CLOCK] = reinterpret_cast<SyscallHandler>(hj_system_clock),
     [HJ_SYSTEM_REBOOT] = reinterpret_cast<SyscallHandler>(hj_system_reboot),
     [HJ_SYSTEM_SHUTDOWN] = reinterpret_cast<SyscallHandler>(hj_system_shutdown),
+    [HJ_SYSTEM_TRACE] = reinterpret_cast<SyscallHandler>(hj_system_trace),
     [HJ_HANDLE_OPEN] = reinterpret_cast<SyscallHandler>(hj_handle_open),
     [HJ_HANDLE_CLOSE] = reinterpret_cast<SyscallHandler>(hj_handle_close),
     [HJ_HANDLE_REOPEN] = reinterpret_cast<SyscallHandler>(hj_handle_reopen),
@@ -675,8 +820,14 @@ static SyscallHandler syscalls[__SYSCALL_COUNT] = {
     [HJ_HANDLE_STAT] = reinterpret_cast<SyscallHandler>(hj_handle_stat),
     [HJ_HANDLE_CONNECT] = reinterpret_cast<SyscallHandler>(hj_handle_connect),
     [HJ_HANDLE_ACCEPT] = reinterpret_cast<SyscallHandler>(hj_handle_accept),
+    [HJ_HANDLE_READV] = reinterpret_cast<SyscallHandler>(hj_handle_readv),
+    [HJ_HANDLE_WRITEV] = reinterpret_cast<SyscallHandler>(hj_handle_writev),
+    [HJ_HANDLE_SPLICE] = reinterpret_cast<SyscallHandler>(hj_handle_splice),
     [HJ_CREATE_PIPE] = reinterpret_cast<SyscallHandler>(hj_create_pipe),
     [HJ_CREATE_TERM] = reinterpret_cast<SyscallHandler>(hj_create_term),
+    [HJ_CREATE_EVENT_QUEUE] = reinterpret_cast<SyscallHandler>(hj_create_event_queue),
+    [HJ_EVENT_QUEUE_WATCH] = reinterpret_cast<SyscallHandler>(hj_event_queue_watch),
+    [HJ_EVENT_QUEUE_WAIT] = reinterpret_cast<SyscallHandler>(hj_event_queue_wait),
 };
 
 #pragma GCC diagnostic pop
@@ -111,7 +111,7 @@ void task_pass_argc_argv_env(Task *task, Launchpad *launchpad)
 
 void task_pass_handles(Task *parent_task, Task *child_task, Launchpad *launchpad)
 {
-    for (int i = 0; i < PROCESS_HANDLE_COUNT; i++)
+    for (int i = 0; i < LAUNCHPAD_HANDLE_COUNT; i++)
     {
         int child_handle_id = i;
         int parent_handle_id = launchpad->handles[i];
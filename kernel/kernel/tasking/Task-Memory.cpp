@@ -28,36 +28,41 @@ static void kill_me_if_too_greedy(Task *task, size_t size)
     }
 }
 
-MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object)
+MemoryMapping *task_memory_mapping_create_at(Task *task, MemoryObject *memory_object, uintptr_t address)
 {
     InterruptsRetainer retainer;
 
+    if (memory_object->range().empty())
+    {
+        return nullptr;
+    }
+
     auto memory_mapping = CREATE(MemoryMapping);
 
     memory_mapping->object = memory_object_ref(memory_object);
-    memory_mapping->address = arch_virtual_alloc(task->address_space, memory_object->range(), MEMORY_USER).base();
+    memory_mapping->address = address;
     memory_mapping->size = memory_object->range().size();
 
-    list_pushback(task->memory_mapping, memory_mapping);
+    assert(SUCCESS == arch_virtual_map(task->address_space, memory_object->range(), address, MEMORY_USER));
+
+    task->memory_mappings.insert(memory_mapping);
 
     return memory_mapping;
 }
 
-MemoryMapping *task_memory_mapping_create_at(Task *task, MemoryObject *memory_object, uintptr_t address)
+MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object)
 {
     InterruptsRetainer retainer;
 
-    auto memory_mapping = CREATE(MemoryMapping);
+    size_t size = memory_object->range().size();
+    uintptr_t address = task->memory_mappings.find_free(arch_virtual_user_range(), size, arch_virtual_alignment(size));
 
-    memory_mapping->object = memory_object_ref(memory_object);
-    memory_mapping->address = address;
-    memory_mapping->size = memory_object->range().size();
-
-    assert(SUCCESS == arch_virtual_map(task->address_space, memory_object->range(), address, MEMORY_USER));
-
-    list_pushback(task->memory_mapping, memory_mapping);
+    if (!address)
+    {
+        return nullptr;
+    }
 
-    return memory_mapping;
+    return task_memory_mapping_create_at(task, memory_object, address);
 }
 
 void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping)
@@ -67,35 +72,27 @@ void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping)
     arch_virtual_free(task->address_space, (MemoryRange){memory_mapping->address, memory_mapping->size});
     memory_object_deref(memory_mapping->object);
 
-    list_remove(task->memory_mapping, memory_mapping);
+    task->memory_mappings.remove(memory_mapping);
     free(memory_mapping);
 }
 
 MemoryMapping *task_memory_mapping_by_address(Task *task, uintptr_t address)
 {
-    list_foreach(MemoryMapping, memory_mapping, task->memory_mapping)
-    {
-        if (memory_mapping->address == address)
-        {
-            return memory_mapping;
-        }
-    }
-
-    return nullptr;
+    return task->memory_mappings.by_address(address);
 }
 
 bool task_memory_mapping_colides(Task *task, uintptr_t address, size_t size)
 {
-    list_foreach(MemoryMapping, memory_mapping, task->memory_mapping)
+    auto user_range = arch_virtual_user_range();
+
+    if (address < user_range.base() ||
+        address + size < address ||
+        address + size > user_range.base() + user_range.size())
     {
-        if (address < memory_mapping->address + memory_mapping->size &&
-            address + size > memory_mapping->address)
-        {
-            return true;
-        }
+        return true;
     }
 
-    return false;
+    return task->memory_mappings.collides({address, size});
 }
 
 /* --- User facing API ------------------------------------------------------ */
@@ -110,6 +107,11 @@ Result task_memory_alloc(Task *task, size_t size, uintptr_t *out_address)
 
     memory_object_deref(memory_object);
 
+    if (!memory_mapping)
+    {
+        return ERR_OUT_OF_MEMORY;
+    }
+
     *out_address = memory_mapping->address;
 
     return SUCCESS;
@@ -126,10 +128,15 @@ Result task_memory_map(Task *task, uintptr_t address, size_t size, MemoryFlags f
 
     auto memory_object = memory_object_create(size);
 
-    task_memory_mapping_create_at(task, memory_object, address);
+    auto memory_mapping = task_memory_mapping_create_at(task, memory_object, address);
 
     memory_object_deref(memory_object);
 
+    if (!memory_mapping)
+    {
+        return ERR_OUT_OF_MEMORY;
+    }
+
     if (flags & MEMORY_CLEAR)
     {
         memset((void *)address, 0, size);
@@ -171,6 +178,11 @@ Result task_memory_include(Task *task, int handle, uintptr_t *out_address, size_
 
     memory_object_deref(memory_object);
 
+    if (!memory_mapping)
+    {
+        return ERR_OUT_OF_MEMORY;
+    }
+
     *out_address = memory_mapping->address;
     *out_size = memory_mapping->size;
 
@@ -203,12 +215,5 @@ void *task_switch_address_space(Task *task, void *address_space)
 
 size_t task_memory_usage(Task *task)
 {
-    size_t total = 0;
-
-    list_foreach(MemoryMapping, memory_mapping, task->memory_mapping)
-    {
-        total += memory_mapping->size;
-    }
-
-    return total;
+    return task->memory_mappings.size();
 }
@@ -3,16 +3,6 @@
 #include "kernel/memory/MemoryObject.h"
 #include "kernel/tasking/Task.h"
 
-struct MemoryMapping
-{
-    MemoryObject *object;
-
-    uintptr_t address;
-    size_t size;
-
-    MemoryRange range() { return {address, size}; }
-};
-
 MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object);
 
 void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping);
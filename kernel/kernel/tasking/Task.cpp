@@ -118,6 +118,7 @@ Task *task_create(Task *parent, const char *name, TaskFlags flags)
     strlcpy(task->name, name, PROCESS_NAME_SIZE);
     task->_state = TASK_STATE_NONE;
     task->_flags = flags;
+    task->usage_clock = arch_get_clock();
 
     if (task->_flags & TASK_USER)
     {
@@ -131,9 +132,6 @@ Task *task_create(Task *parent, const char *name, TaskFlags flags)
     if (parent)
         task->_domain = parent->_domain;
 
-    // Setup shms
-    task->memory_mapping = list_create();
-
     memory_alloc(task->address_space, PROCESS_STACK_SIZE, MEMORY_CLEAR, (uintptr_t *)&task->kernel_stack);
     task->kernel_stack_pointer = ((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
 
@@ -171,9 +169,6 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
 
     task->address_space = arch_address_space_create();
 
-    // Setup shms
-    task->memory_mapping = list_create();
-
     if (parent)
     {
         task->_domain = parent->_domain;
@@ -188,8 +183,7 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
     memory_alloc(task->address_space, PROCESS_STACK_SIZE, MEMORY_CLEAR, (uintptr_t *)&task->kernel_stack);
     task->kernel_stack_pointer = ((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
 
-    list_foreach(MemoryMapping, mapping, parent->memory_mapping)
-    {
+    parent->memory_mappings.foreach([&](MemoryMapping *mapping) {
         auto virtual_range = mapping->range();
 
         auto physical_range = mapping->object->range();
@@ -207,7 +201,9 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip, TaskFlags flags)
         task_switch_address_space(scheduler_running(), parent_address_space);
 
         free(buffer);
-    }
+
+        return Iteration::CONTINUE;
+    });
 
     task->user_stack_pointer = sp;
     task->entry_point = (TaskEntryPoint)ip;
@@ -225,17 +221,17 @@ void task_destroy(Task *task)
 
     task->state(TASK_STATE_NONE);
 
+    arch_task_destroy(task);
+
     interrupts_release();
 
     MemoryMapping *mapping = nullptr;
 
-    while ((mapping = (MemoryMapping *)list_peek(task->memory_mapping)))
+    while ((mapping = task->memory_mappings.first()))
     {
         task_memory_mapping_destroy(task, mapping);
     }
 
-    list_destroy(task->memory_mapping);
-
     memory_free(task->address_space, MemoryRange{(uintptr_t)task->kernel_stack, PROCESS_STACK_SIZE});
 
     if (task->address_space != arch_kernel_address_space())
@@ -250,7 +246,7 @@ void task_clear_userspace(Task *task)
 {
     MemoryMapping *mapping = nullptr;
 
-    while ((mapping = (MemoryMapping *)list_peek(task->memory_mapping)))
+    while ((mapping = task->memory_mappings.first()))
     {
         task_memory_mapping_destroy(task, mapping);
     }
@@ -421,11 +417,12 @@ void task_dump(Task *task)
     stream_format(out_stream, "\n\t   State: %s", task_state_string(task->state()));
     stream_format(out_stream, "\n\t   Memory: ");
 
-    list_foreach(MemoryMapping, mapping, task->memory_mapping)
-    {
+    task->memory_mappings.foreach([](MemoryMapping *mapping) {
         auto virtual_range = mapping->range();
         stream_format(out_stream, "\n\t   - %08x - %08x (%08x)", virtual_range.base(), virtual_range.end(), virtual_range.size());
-    }
+
+        return Iteration::CONTINUE;
+    });
 
     if (task->address_space == arch_kernel_address_space())
     {
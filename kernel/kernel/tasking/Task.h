@@ -8,9 +8,11 @@
 
 #include "kernel/memory/Memory.h"
 #include "kernel/scheduling/Blocker.h"
+#include "kernel/scheduling/Cpu.h"
 
 #include "kernel/tasking/Domain.h"
 #include "kernel/tasking/Handles.h"
+#include "kernel/tasking/MemoryMappings.h"
 
 typedef void (*TaskEntryPoint)();
 
@@ -28,6 +30,20 @@ struct Task
     TaskState _state;
     Blocker *_blocker;
 
+    // The processor whose queue the task is in, while it is runnable.
+    Cpu *cpu = nullptr;
+
+    // While a processor is running it or is still on its kernel stack, no
+    // other processor can pick it up and it can't be destroyed.
+    bool on_cpu = false;
+
+    // Time spent running, in ticks of the clock, and where it was at when
+    // the usage was last computed.
+    uint64_t cpu_time = 0;
+    uint64_t usage_clock = 0;
+    uint64_t usage_cpu_time = 0;
+    int usage = 0;
+
     uintptr_t user_stack_pointer;
     void *user_stack;
 
@@ -35,9 +51,10 @@ struct Task
     void *kernel_stack;
 
     TaskEntryPoint entry_point;
-    char fpu_registers[512];
+    // x87, SSE and AVX registers, with room to align them for XSAVE.
+    char fpu_registers[1024 + 64];
 
-    List *memory_mapping;
+    MemoryMappings memory_mappings;
     void *address_space;
 
     int exit_value = 0;
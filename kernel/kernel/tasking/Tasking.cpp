@@ -1,19 +1,30 @@
 #include <libsystem/Logger.h>
 
+#include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Finalizer.h"
 #include "kernel/tasking/Task.h"
+#include "kernel/tasking/Tasking.h"
 
-void tasking_initialize()
+void tasking_create_idle_task(Cpu *cpu)
 {
-    logger_info("Initializing tasking...");
-
     Task *idle_task = task_spawn(nullptr, "idle", system_hang, nullptr, TASK_NONE);
+
+    // The other processors would pick it up while it is runnable.
+    InterruptsRetainer retainer;
+
     task_go(idle_task);
     idle_task->state(TASK_STATE_HANG);
 
-    scheduler_did_create_idle_task(idle_task);
+    scheduler_did_create_idle_task(cpu, idle_task);
+}
+
+void tasking_initialize()
+{
+    logger_info("Initializing tasking...");
+
+    tasking_create_idle_task(cpu_current());
 
     Task *kernel_task = task_spawn(nullptr, "system", nullptr, nullptr, TASK_NONE);
     task_go(kernel_task);
@@ -1,3 +1,8 @@
 #pragma once
 
+#include "kernel/scheduling/Cpu.h"
+
 void tasking_initialize();
+
+// What the processor runs when it has nothing else to do.
+void tasking_create_idle_task(Cpu *cpu);
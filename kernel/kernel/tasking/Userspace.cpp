@@ -4,6 +4,7 @@
 #include <libsystem/process/Process.h>
 
 #include "kernel/graphics/EarlyConsole.h"
+#include "kernel/system/Trace.h"
 #include "kernel/tasking/Userspace.h"
 
 #define DEFAULT_ENVIRONMENT "{}"
@@ -27,7 +28,12 @@ void userspace_initialize()
     early_console_disable(); // We disable the early console to prevent artifact.
 
     int init_process = -1;
-    Result result = launchpad_launch(init_lauchpad, &init_process);
+    Result result = SUCCESS;
+
+    {
+        TraceSpan span{"launch init"};
+        result = launchpad_launch(init_lauchpad, &init_process);
+    }
 
     stream_close(serial_device);
 
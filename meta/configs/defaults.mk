@@ -18,6 +18,8 @@ CONFIGS = \
 	CONFIG_MEMORY \
 	CONFIG_NAME \
 	CONFIG_OPTIMISATIONS \
+	CONFIG_SMP \
+	CONFIG_CPUS \
 	CONFIG_VERSION \
 	CONFIG_IS_TEST \
 	CONFIG_IS_RELEASE
@@ -27,6 +29,7 @@ CONFIGS_PASS_TO_COMPILER = \
 	CONFIG_ARCH \
 	CONFIG_KEYBOARD_LAYOUT \
 	CONFIG_NAME \
+	CONFIG_SMP \
 	CONFIG_VERSION \
 	CONFIG_IS_TEST \
 	CONFIG_IS_RELEASE
@@ -77,6 +80,12 @@ CONFIG_STRIP		  ?=true
 # How many megabyte of memory is allocated to the virtual machine.
 CONFIG_MEMORY         ?=256
 
+# Start the other processors at boot, and run tasks on them.
+CONFIG_SMP            ?=true
+
+# How many processors the virtual machine has.
+CONFIG_CPUS           ?=2
+
 # Set the name of the distribution.
 CONFIG_NAME           ?=skift
 
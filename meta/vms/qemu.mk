@@ -4,6 +4,7 @@ QEMU_DISK?=-cdrom $(BOOTDISK)
 
 QEMU_FLAGS= \
 	-m $(CONFIG_MEMORY)M \
+	-smp $(CONFIG_CPUS) \
 	-serial mon:stdio \
 	-rtc base=localtime \
 	$(QEMU_DISK)
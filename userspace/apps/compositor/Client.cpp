@@ -136,34 +136,10 @@ void Client::handle_goodbye()
     send_message(message);
 }
 
-void Client::handle_request()
+void Client::handle_message(const CompositorMessage &message)
 {
     Assert::is_false(_disconnected);
 
-    CompositorMessage message = {};
-    auto read_result = _connection.read(&message, sizeof(CompositorMessage));
-
-    if (!read_result.success())
-    {
-        logger_error("Client handle has error: %s!", read_result.description());
-
-        _disconnected = true;
-        client_destroy_disconnected();
-        return;
-    }
-
-    size_t message_size = read_result.unwrap();
-
-    if (message_size != sizeof(CompositorMessage))
-    {
-        logger_error("Got a message with an invalid size from client %u != %u!", sizeof(CompositorMessage), message_size);
-        hexdump(&message, message_size);
-
-        _disconnected = true;
-        client_destroy_disconnected();
-        return;
-    }
-
     switch (message.type)
     {
     case COMPOSITOR_MESSAGE_CREATE_WINDOW:
@@ -200,7 +176,7 @@ void Client::handle_request()
 
     default:
         logger_error("Invalid message for client %08x", this);
-        hexdump(&message, message_size);
+        hexdump(&message, sizeof(CompositorMessage));
 
         _disconnected = true;
         client_destroy_disconnected();
@@ -218,18 +194,39 @@ Client::Client(IO::Connection connection)
 {
     _connection = connection;
 
-    _notifier = own<Async::Notifier>(connection, POLL_READ, [this]() {
-        this->handle_request();
-    });
+    auto channel_or_result = IPC::SharedChannel<CompositorProtocol>::create(connection);
+
+    if (!channel_or_result.success())
+    {
+        logger_error("Failed to create the channel of client %08x: %s", this, get_result_description(channel_or_result.result()));
+        _disconnected = true;
+        return;
+    }
+
+    _channel = channel_or_result.unwrap();
+
+    _channel->on_message = [this](const CompositorMessage &message) {
+        handle_message(message);
+    };
+
+    _channel->on_close = [this]() {
+        logger_error("Client %08x closed its connection", this);
+
+        _disconnected = true;
+        client_destroy_disconnected();
+    };
 
     logger_info("Client %08x connected", this);
 
-    this->send_message((CompositorMessage){
+    CompositorMessage greetings = {
         .type = COMPOSITOR_MESSAGE_GREETINGS,
         .greetings = {
             .screen_bound = renderer_bound(),
+            .channel = _channel->handle(),
         },
-    });
+    };
+
+    _connection.write(&greetings, sizeof(CompositorMessage));
 }
 
 Iteration destroy_window_if_client_match(Client *client, Window *window)
@@ -269,13 +266,13 @@ Result Client::send_message(CompositorMessage message)
         return ERR_STREAM_CLOSED;
     }
 
-    auto write_result = _connection.write(&message, sizeof(CompositorMessage));
+    auto result = _channel->send(message);
 
-    if (!write_result.success())
+    if (result != SUCCESS)
     {
-        logger_error("Failed to send message to %08x: %s", this, write_result.description());
+        logger_error("Failed to send message to %08x: %s", this, get_result_description(result));
         _disconnected = true;
-        return write_result.result();
+        return result;
     }
 
     return SUCCESS;
@@ -1,14 +1,14 @@
 #pragma once
 
-#include <libasync/Notifier.h>
 #include <libio/Connection.h>
+#include <libipc/SharedChannel.h>
 
 #include "compositor/Protocol.h"
 
 struct Client
 {
-    OwnPtr<Async::Notifier> _notifier = nullptr;
     IO::Connection _connection;
+    OwnPtr<IPC::SharedChannel<CompositorProtocol>> _channel = nullptr;
     bool _disconnected = false;
 
     static void connect(IO::Connection connection);
@@ -35,7 +35,7 @@ struct Client
 
     void handle_goodbye();
 
-    void handle_request();
+    void handle_message(const CompositorMessage &message);
 };
 
 void client_broadcast(CompositorMessage message);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <libio/Reader.h>
+#include <libio/Writer.h>
 #include <libmath/Rect.h>
 #include <libwidget/Cursor.h>
 #include <libwidget/Event.h>
@@ -45,9 +47,12 @@ enum WindowType
     WINDOW_TYPE_DESKTOP,
 };
 
+// The only message sent through the connection, every later one goes
+// through the shared memory channel it gives the handle of.
 struct CompositorGreetings
 {
     Math::Recti screen_bound;
+    int channel;
 };
 
 struct CompositorEvent
@@ -144,3 +149,34 @@ struct CompositorMessage
         CompositorMousePosition mouse_position;
     };
 };
+
+// Messages are sent as they are, they all have the same size.
+struct CompositorProtocol
+{
+    using Message = CompositorMessage;
+
+    static Result encode_message(IO::Writer &writer, const Message &message)
+    {
+        size_t written = TRY(writer.write(&message, sizeof(Message)));
+
+        if (written != sizeof(Message))
+        {
+            return ERR_STREAM_CLOSED;
+        }
+
+        return SUCCESS;
+    }
+
+    static ResultOr<Message> decode_message(IO::Reader &reader)
+    {
+        Message message{};
+        size_t read = TRY(reader.read(&message, sizeof(Message)));
+
+        if (read != sizeof(Message))
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        return message;
+    }
+};
@@ -10,6 +10,7 @@
 #include <libsystem/Logger.h>
 #include <libsystem/process/Launchpad.h>
 #include <libsystem/process/Process.h>
+#include <libsystem/system/Trace.h>
 #include <libsystem/unicode/UTF8Decoder.h>
 
 #include "compositor/Client.h"
@@ -133,9 +134,15 @@ int main(int argc, char const *argv[])
 
     repaint_timer->start();
 
-    manager_initialize();
-    cursor_initialize();
-    renderer_initialize();
+    {
+        auto span = Trace::span("compositor initialize");
+
+        manager_initialize();
+        cursor_initialize();
+        renderer_initialize();
+    }
+
+    Trace::mark("compositor ready");
 
     return Async::Loop::run();
 }
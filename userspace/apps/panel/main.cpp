@@ -1,3 +1,4 @@
+#include <libsystem/system/Trace.h>
 #include <libwidget/Application.h>
 
 #include "panel/windows/PanelWindow.h"
@@ -6,10 +7,19 @@ static constexpr int PANEL_HEIGHT = 38;
 
 int main(int argc, char **argv)
 {
-    Widget::Application::initialize(argc, argv);
+    OwnPtr<panel::PanelWindow> window;
 
-    auto window = own<panel::PanelWindow>();
-    window->show();
+    {
+        auto span = Trace::span("panel initialize");
+
+        Widget::Application::initialize(argc, argv);
+
+        window = own<panel::PanelWindow>();
+        window->show();
+    }
+
+    // The first thing on the screen which is not the splash screen.
+    Trace::mark("desktop ready");
 
     return Widget::Application::run();
 }
@@ -8,7 +8,7 @@
 namespace panel
 {
 
-MenuEntry::MenuEntry(String id, const Json::Value &value)
+MenuEntry::MenuEntry(String id, const Json::Node &value)
 {
     value.with("name", [this](auto &v) {
         name = v.as_string();
@@ -65,7 +65,8 @@ Vector<MenuEntry> MenuEntry::load()
 
         if (manifest_file.exist())
         {
-            entries.emplace_back(entry.name, Json::parse(manifest_file));
+            Json::Document manifest{manifest_file};
+            entries.emplace_back(entry.name, manifest.root());
         }
     }
 
@@ -13,8 +13,6 @@ struct Bundle
 
     static Optional<Bundle> Load(const String &path)
     {
-        Bundle bundle;
-
         IO::File file{path, OPEN_READ};
 
         if (!file.exist())
@@ -29,14 +27,34 @@ struct Bundle
             return {};
         }
 
-        auto obj = value.as_object();
+        return from_value(value);
+    }
+
+    static Bundle from_value(const Json::Value &value)
+    {
+        Bundle bundle;
+
+        if (value.is(Json::OBJECT))
+        {
+            value.as_object().foreach ([&](auto &key, auto &value) {
+                bundle.keys[key] = value;
+                return Iteration::CONTINUE;
+            });
+        }
+
+        return bundle;
+    }
+
+    Json::Value to_value()
+    {
+        Json::Value::Object obj;
 
-        obj.foreach ([&](auto &key, auto &value) {
-            bundle.keys[key] = value;
+        keys.foreach ([&](auto &key, auto &value) {
+            obj[key] = value;
             return Iteration::CONTINUE;
         });
 
-        return bundle;
+        return obj;
     }
 
     void write(const Path &path, const Json::Value &value)
@@ -48,15 +66,7 @@ struct Bundle
     {
         if (path.key == "*")
         {
-            Json::Value::Object obj;
-
-            keys.foreach ([&](auto &key, auto &value) {
-                obj[key] = value;
-
-                return Iteration::CONTINUE;
-            });
-
-            return obj;
+            return to_value();
         }
         else if (keys.has_key(path.key))
         {
@@ -11,6 +11,7 @@ class Client : public IPC::Peer<Protocol>
 {
 private:
     Vector<Path> _subscriptions;
+    Vector<Path> _pending_notifications;
 
 public:
     Callback<void(Client &, const Message &message)> on_message;
@@ -52,6 +53,28 @@ public:
 
         return false;
     }
+
+    // Changes are sent together once the server is done with the messages
+    // it received, a key written many times is sent once.
+    void should_notify(const Settings::Path &path)
+    {
+        if (!_pending_notifications.contains(path))
+        {
+            _pending_notifications.push_back(path);
+        }
+    }
+
+    bool has_pending_notifications()
+    {
+        return _pending_notifications.any();
+    }
+
+    Vector<Path> take_pending_notifications()
+    {
+        Vector<Path> pending = move(_pending_notifications);
+        _pending_notifications = {};
+        return pending;
+    }
 };
 
 } // namespace Settings
@@ -1,56 +1,276 @@
 #pragma once
 
+#include <libio/Copy.h>
 #include <libio/Format.h>
+#include <libsystem/io/Filesystem.h>
+#include <libutils/json/Binary.h>
 
 #include "settings-service/Bundle.h"
 
 namespace Settings
 {
 
+// A domain is a directory of /Configs. The bundles shipped with the system
+// are JSON files, changes are appended to a journal which is compacted from
+// time to time in a binary snapshot of the whole domain:
+//
+//     /Configs/<domain>/*.json     bundles shipped with the system
+//     /Configs/<domain>/.snapshot  every bundle, replaces the json files
+//     /Configs/<domain>/.journal   writes done since the snapshot
+//
+// Domains are only loaded the first time they are accessed.
 struct Domain
 {
+    static constexpr const char *SNAPSHOT_MAGIC = "SETTINGS";
+    static constexpr size_t SNAPSHOT_MAGIC_SIZE = 8;
+
+    // Past this size the journal is folded into a new snapshot.
+    static constexpr size_t JOURNAL_COMPACTION_SIZE = 16 * 1024;
+
+    String directory;
+    bool loaded = false;
+
     HashMap<String, Bundle> bundles;
 
-    static Domain load(const String &path)
+    // Keys written since the last flush, a key written many times is
+    // journaled once, with its last value.
+    Vector<Path> dirty;
+    size_t journal_size = 0;
+
+    String snapshot_path() { return IO::format("{}/.snapshot", directory); }
+
+    String journal_path() { return IO::format("{}/.journal", directory); }
+
+    static ResultOr<Slice> read_file(const String &path)
     {
-        Domain domain;
-        IO::Directory directory{path};
+        IO::File file{path, OPEN_READ};
 
-        for (auto entry : directory.entries())
+        if (!file.exist())
         {
-            if (entry.stat.type != FILE_TYPE_REGULAR)
+            return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+        }
+
+        return IO::read_all(file);
+    }
+
+    static Result write_file(const String &path, const void *buffer, size_t size, OpenFlag flags)
+    {
+        IO::File file{path, OPEN_WRITE | OPEN_CREATE | flags};
+        TRY(file.result());
+
+        size_t written = 0;
+
+        while (written < size)
+        {
+            written += TRY(file.write(static_cast<const uint8_t *>(buffer) + written, size - written));
+        }
+
+        return SUCCESS;
+    }
+
+    void load_bundles()
+    {
+        IO::Directory entries{directory};
+
+        for (auto &entry : entries.entries())
+        {
+            auto bundle_path = ::Path::parse(IO::format("{}/{}", directory, entry.name));
+
+            if (entry.stat.type != FILE_TYPE_REGULAR ||
+                bundle_path.extension() != ".json")
             {
                 continue;
             }
 
-            auto bundle_path = IO::format("{}/{}", path, entry.name);
-
-            auto bundle = Bundle::Load(bundle_path);
+            auto bundle = Bundle::Load(bundle_path.string());
 
             if (bundle.present())
             {
-                auto path = ::Path::parse(bundle_path);
+                bundles[bundle_path.basename_without_extension()] = bundle.unwrap();
+            }
+        }
+    }
+
+    bool load_snapshot(const String &path)
+    {
+        auto content = read_file(path);
+
+        if (!content.success() ||
+            content.unwrap().size() < SNAPSHOT_MAGIC_SIZE ||
+            memcmp(content.unwrap().start(), SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0)
+        {
+            return false;
+        }
+
+        auto data = reinterpret_cast<const uint8_t *>(content.unwrap().start());
+        Json::BinaryReader reader{data + SNAPSHOT_MAGIC_SIZE, content.unwrap().size() - SNAPSHOT_MAGIC_SIZE};
+
+        auto value = reader.value();
+
+        if (reader.error() || !value.is(Json::OBJECT))
+        {
+            return false;
+        }
+
+        value.as_object().foreach ([&](auto &name, auto &keys) {
+            bundles[name] = Bundle::from_value(keys);
+            return Iteration::CONTINUE;
+        });
+
+        return true;
+    }
+
+    // Each record is a varint size followed by the bundle, the key and the
+    // value. A record cut short by a crash ends the replay.
+    void replay_journal()
+    {
+        auto content = read_file(journal_path());
+
+        if (!content.success())
+        {
+            return;
+        }
+
+        journal_size = content.unwrap().size();
+
+        Json::BinaryReader journal{content.unwrap().start(), journal_size};
+
+        while (!journal.ended())
+        {
+            size_t size = journal.varint();
+            auto record = journal.slice(size);
+
+            if (journal.error())
+            {
+                break;
+            }
+
+            Path path;
+            path.bundle = record.string();
+            path.key = record.string();
+            auto value = record.value();
 
-                domain.bundles[path.basename_without_extension()] = bundle.unwrap();
+            if (record.error())
+            {
+                break;
             }
+
+            bundles[path.bundle].write(path, value);
+        }
+    }
+
+    void load()
+    {
+        if (loaded)
+        {
+            return;
+        }
+
+        loaded = true;
+
+        // A snapshot being replaced is only valid once it has been renamed.
+        if (!load_snapshot(snapshot_path()) &&
+            !load_snapshot(IO::format("{}.new", snapshot_path())))
+        {
+            load_bundles();
+        }
+
+        replay_journal();
+    }
+
+    Result compact()
+    {
+        IO::MemoryWriter memory;
+        memory.write(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+
+        Json::Value::Object object;
+
+        bundles.foreach ([&](auto &name, auto &bundle) {
+            object[name] = bundle.to_value();
+            return Iteration::CONTINUE;
+        });
+
+        Json::BinaryWriter{memory}.value(object);
+
+        auto new_snapshot = IO::format("{}.new", snapshot_path());
+
+        TRY(write_file(new_snapshot, memory.buffer(), memory.length().unwrap(), OPEN_TRUNC));
+
+        filesystem_unlink(snapshot_path().cstring());
+        TRY(filesystem_rename(new_snapshot.cstring(), snapshot_path().cstring()));
+
+        TRY(write_file(journal_path(), nullptr, 0, OPEN_TRUNC));
+        journal_size = 0;
+
+        return SUCCESS;
+    }
+
+    Result flush()
+    {
+        if (dirty.empty())
+        {
+            return SUCCESS;
         }
 
-        return domain;
+        if (!filesystem_exist(directory.cstring(), FILE_TYPE_DIRECTORY))
+        {
+            TRY(filesystem_mkdir(directory.cstring()));
+        }
+
+        IO::MemoryWriter memory;
+        Json::BinaryWriter writer{memory};
+
+        for (size_t i = 0; i < dirty.count(); i++)
+        {
+            IO::MemoryWriter record;
+            Json::BinaryWriter record_writer{record};
+
+            record_writer.string(dirty[i].bundle);
+            record_writer.string(dirty[i].key);
+            record_writer.value(read(dirty[i]));
+
+            size_t size = record.length().unwrap();
+            writer.varint(size);
+            memory.write(record.buffer(), size);
+        }
+
+        dirty.clear();
+
+        size_t size = memory.length().unwrap();
+
+        TRY(write_file(journal_path(), memory.buffer(), size, OPEN_APPEND));
+        journal_size += size;
+
+        if (journal_size > JOURNAL_COMPACTION_SIZE)
+        {
+            return compact();
+        }
+
+        return SUCCESS;
     }
 
     void write(const Path &path, const Json::Value &value)
     {
+        load();
+
         if (!bundles.has_key(path.bundle))
         {
             bundles[path.bundle] = {};
         }
 
         bundles[path.bundle].write(path, value);
+
+        if (!dirty.contains(path))
+        {
+            dirty.push_back(path);
+        }
     }
 
     Json::Value read(const Path &path)
     {
-        if (path.domain == "*")
+        load();
+
+        if (path.bundle == "*")
         {
             Json::Value::Object obj;
 
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <libasync/Timer.h>
 #include <libio/Directory.h>
 #include <libsettings/Path.h>
+#include <libsystem/Logger.h>
+#include <libsystem/system/System.h>
 #include <libutils/Path.h>
 
 #include "settings-service/Domain.h"
@@ -11,7 +14,11 @@ namespace Settings
 
 struct Repository
 {
+    // Writes are gathered during this delay and journaled together.
+    static constexpr Timeout FLUSH_DELAY = 500;
+
     HashMap<String, Domain> domains;
+    OwnPtr<Async::Timer> flush_timer;
 
     static Repository load()
     {
@@ -25,25 +32,54 @@ struct Repository
                 continue;
             }
 
-            auto domain_path = IO::format("/Configs/{}", entry.name);
-            IO::Directory dir_domain{domain_path};
+            repository.domains[entry.name].directory = IO::format("/Configs/{}", entry.name);
+        }
+
+        return repository;
+    }
+
+    void flush()
+    {
+        flush_timer->stop();
+
+        domains.foreach ([&](auto &name, auto &domain) {
+            auto result = domain.flush();
 
-            auto domain = Domain::load(domain_path);
+            if (result != SUCCESS)
+            {
+                logger_error("Failed to save the settings of '%s': %s", name.cstring(), get_result_description(result));
+            }
 
-            repository.domains[entry.name] = domain;
+            return Iteration::CONTINUE;
+        });
+    }
+
+    void should_flush()
+    {
+        if (!flush_timer)
+        {
+            flush_timer = own<Async::Timer>(FLUSH_DELAY, [this]() {
+                flush();
+            });
         }
 
-        return repository;
+        if (!flush_timer->running())
+        {
+            flush_timer->schedule(system_get_ticks() + FLUSH_DELAY);
+            flush_timer->start();
+        }
     }
 
     void write(const Path &path, const Json::Value &value)
     {
         if (!domains.has_key(path.domain))
         {
-            domains[path.domain] = {};
+            domains[path.domain].directory = IO::format("/Configs/{}", path.domain);
         }
 
         domains[path.domain].write(path, value);
+
+        should_flush();
     }
 
     Json::Value read(const Path &path)
@@ -16,6 +16,7 @@ private:
     IO::Socket _socket;
     OwnPtr<Async::Notifier> _notifier;
     OwnPtr<Async::Invoker> _invoker;
+    OwnPtr<Async::Invoker> _notify_invoker;
 
     Vector<OwnPtr<Client>> _clients{};
     Repository &_repository;
@@ -51,6 +52,49 @@ public:
                 return !client->connected();
             });
         });
+
+        _notify_invoker = own<Async::Invoker>([this]() {
+            flush_notifications();
+        });
+    }
+
+    void write(Client &client, const Path &path, const Json::Value &value)
+    {
+        _repository.write(path, value);
+
+        for (size_t i = 0; i < _clients.count(); i++)
+        {
+            if (_clients[i] != &client &&
+                _clients[i]->is_subscribe(path))
+            {
+                _clients[i]->should_notify(path);
+                _notify_invoker->invoke_later();
+            }
+        }
+    }
+
+    void flush_notifications()
+    {
+        for (size_t i = 0; i < _clients.count(); i++)
+        {
+            auto &client = *_clients[i];
+
+            if (!client.connected() || !client.has_pending_notifications())
+            {
+                continue;
+            }
+
+            Message notification;
+            notification.type = Message::SERVER_NOTIFY;
+            notification.paths = client.take_pending_notifications();
+
+            for (size_t j = 0; j < notification.paths.count(); j++)
+            {
+                notification.values.push_back(_repository.read(notification.paths[j]));
+            }
+
+            client.send(notification);
+        }
     }
 
     void handle_client_message(Client &client, const Message &message)
@@ -64,22 +108,33 @@ public:
 
             client.send(response);
         }
+        else if (message.type == Message::CLIENT_READ_MANY)
+        {
+            Message response;
+            response.type = Message::SERVER_VALUES;
+            response.paths = message.paths;
+
+            for (size_t i = 0; i < message.paths.count(); i++)
+            {
+                response.values.push_back(_repository.read(message.paths[i]));
+            }
+
+            client.send(response);
+        }
         else if (message.type == Message::CLIENT_WRITE)
         {
-            _repository.write(message.path.unwrap(), message.payload.unwrap());
+            write(client, message.path.unwrap(), message.payload.unwrap());
 
-            for (size_t i = 0; i < _clients.count(); i++)
+            Message response;
+            response.type = Message::SERVER_ACK;
+
+            client.send(response);
+        }
+        else if (message.type == Message::CLIENT_WRITE_MANY)
+        {
+            for (size_t i = 0; i < MIN(message.paths.count(), message.values.count()); i++)
             {
-                if (_clients[i] != &client &&
-                    _clients[i]->is_subscribe(message.path.unwrap()))
-                {
-                    Message notification;
-                    notification.type = Message::SERVER_NOTIFY;
-                    notification.path = message.path;
-                    notification.payload = _repository.read(message.path.unwrap());
-
-                    _clients[i]->send(notification);
-                }
+                write(client, message.paths[i], message.values[i]);
             }
 
             Message response;
@@ -1,8 +1,16 @@
 #include <libasync/Loop.h>
 #include <libsystem/Logger.h>
+#include <libsystem/system/Trace.h>
 
 #include "settings-service/Server.h"
 
+static Settings::Repository load_repository()
+{
+    auto span = Trace::span("load settings");
+
+    return Settings::Repository::load();
+}
+
 int main(int argc, const char **argv)
 {
     UNUSED(argc);
@@ -14,7 +22,7 @@ int main(int argc, const char **argv)
 
     logger_info("Loading settings...");
 
-    auto repository = Settings::Repository::load();
+    auto repository = load_repository();
 
     logger_info("Starting server...");
 
@@ -22,5 +30,7 @@ int main(int argc, const char **argv)
 
     logger_info("Ready!");
 
+    Trace::mark("settings ready");
+
     return Async::Loop::run();
 }
@@ -1,6 +1,7 @@
 #include <libwidget/Theme.h>
 
 #include "terminal/Common.h"
+#include "terminal/GlyphCache.h"
 
 RefPtr<Graphic::Font> font()
 {
@@ -76,35 +77,13 @@ void render_cell(
         painter.clear(bound, color(background));
     }
 
-    if (attributes.underline)
-    {
-        painter.draw_line(
-            bound.position() + Math::Vec2i(0, 14),
-            bound.position() + Math::Vec2i(bound.width(), 14),
-            color(foreground));
-    }
-
-    if (codepoint == U' ')
+    if (codepoint == U' ' && !attributes.underline)
     {
         return;
     }
 
-    auto &glyph = font()->glyph(codepoint);
-
-    painter.draw_glyph(
-        *font(),
-        glyph,
-        bound.position() + Math::Vec2i(0, 13),
-        color(foreground));
-
-    if (attributes.bold)
-    {
-        painter.draw_glyph(
-            *font(),
-            glyph,
-            bound.position() + Math::Vec2i(1, 13),
-            color(foreground));
-    }
+    auto &cache = glyph_cache();
+    painter.blit(cache.atlas(), cache.lookup(codepoint, foreground, attributes), bound);
 }
 
 void render_cell(Graphic::Painter &painter, int x, int y, Terminal::Cell cell)
@@ -5,6 +5,8 @@
 
 RefPtr<Graphic::Font> font();
 
+Graphic::Color color(Terminal::Color terminal_color);
+
 Math::Recti cell_bound(int x, int y);
 
 Math::Vec2i cell_size();
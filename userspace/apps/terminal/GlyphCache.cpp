@@ -0,0 +1,82 @@
+#include "terminal/GlyphCache.h"
+#include "terminal/Common.h"
+
+GlyphCache &glyph_cache()
+{
+    static GlyphCache *cache = nullptr;
+
+    if (cache == nullptr)
+    {
+        cache = new GlyphCache();
+    }
+
+    return *cache;
+}
+
+GlyphCache::GlyphCache()
+{
+    _atlas = Graphic::Bitmap::create_shared(COLUMNS * cell_size().x(), ROWS * cell_size().y()).unwrap();
+    _painter = own<Graphic::Painter>(_atlas);
+}
+
+Math::Recti GlyphCache::slot_bound(int slot)
+{
+    return cell_bound(slot % COLUMNS, slot / COLUMNS);
+}
+
+void GlyphCache::render(int slot, Codepoint codepoint, Terminal::Color foreground, Terminal::Attributes attributes)
+{
+    Math::Recti bound = slot_bound(slot);
+
+    _painter->push();
+    _painter->clip(bound);
+    _painter->clear(bound, Graphic::Colors::TRANSPARENT);
+
+    if (attributes.underline)
+    {
+        _painter->draw_line(
+            bound.position() + Math::Vec2i(0, 14),
+            bound.position() + Math::Vec2i(bound.width(), 14),
+            color(foreground));
+    }
+
+    if (codepoint != U' ')
+    {
+        auto &glyph = font()->glyph(codepoint);
+
+        _painter->draw_glyph(*font(), glyph, bound.position() + Math::Vec2i(0, 13), color(foreground));
+
+        if (attributes.bold)
+        {
+            _painter->draw_glyph(*font(), glyph, bound.position() + Math::Vec2i(1, 13), color(foreground));
+        }
+    }
+
+    _painter->pop();
+}
+
+Math::Recti GlyphCache::lookup(Codepoint codepoint, Terminal::Color foreground, Terminal::Attributes attributes)
+{
+    uint32_t key = (codepoint & 0x1fffff) |
+                   (foreground << 21) |
+                   (attributes.bold << 26) |
+                   (attributes.underline << 27);
+
+    if (_slots.has_key(key))
+    {
+        return slot_bound(_slots[key]);
+    }
+
+    if (_used == COLUMNS * ROWS)
+    {
+        // The atlas is full, start over, the working set will quickly fill it back.
+        _slots.clear();
+        _used = 0;
+    }
+
+    int slot = _used++;
+    render(slot, codepoint, foreground, attributes);
+    _slots[key] = slot;
+
+    return slot_bound(slot);
+}
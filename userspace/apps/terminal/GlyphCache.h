@@ -0,0 +1,34 @@
+#pragma once
+
+#include <libgraphic/Painter.h>
+#include <libterminal/Cell.h>
+#include <libutils/HashMap.h>
+#include <libutils/OwnPtr.h>
+
+// Prerendered cells (glyph, bold and underline) packed in an atlas,
+// so drawing a character is a single blit instead of sampling the font.
+class GlyphCache
+{
+private:
+    static constexpr int COLUMNS = 64;
+    static constexpr int ROWS = 32;
+
+    RefPtr<Graphic::Bitmap> _atlas;
+    OwnPtr<Graphic::Painter> _painter;
+
+    HashMap<uint32_t, int> _slots;
+    int _used = 0;
+
+    Math::Recti slot_bound(int slot);
+
+    void render(int slot, Codepoint codepoint, Terminal::Color foreground, Terminal::Attributes attributes);
+
+public:
+    Graphic::Bitmap &atlas() { return *_atlas; }
+
+    GlyphCache();
+
+    Math::Recti lookup(Codepoint codepoint, Terminal::Color foreground, Terminal::Attributes attributes);
+};
+
+GlyphCache &glyph_cache();
@@ -41,25 +41,26 @@ TerminalWidget::TerminalWidget(Component *parent) : Component(parent)
 
 void TerminalWidget::paint(Graphic::Painter &painter, const Math::Recti &dirty)
 {
-    painter.push();
-    painter.transform({0, -_scroll_offset});
+    int first_line = _scroll_offset / cell_size().y();
 
-    for (int y = 0; y < _terminal->height(); y++)
+    int from = clamp(dirty.top() / cell_size().y(), 0, _terminal->height());
+    int to = clamp((dirty.bottom() + cell_size().y() - 1) / cell_size().y(), 0, _terminal->height());
+
+    for (int y = from; y < to; y++)
     {
         for (int x = 0; x < _terminal->width(); x++)
         {
-            Terminal::Cell cell = _terminal->surface().at(x, y + _scroll_offset / cell_size().y());
-            render_cell(painter, x, y + _scroll_offset / cell_size().y(), cell);
-            _terminal->surface().undirty(x, y);
+            Terminal::Cell cell = _terminal->surface().at(x, y + first_line);
+            render_cell(painter, x, y, cell);
         }
     }
 
     int cx = _terminal->cursor().x;
-    int cy = _terminal->cursor().y - _scroll_offset / cell_size().y();
+    int cy = _terminal->cursor().y - first_line;
 
     if (cell_bound(cx, cy).colide_with(dirty))
     {
-        Terminal::Cell cell = _terminal->surface().at(cx, cy);
+        Terminal::Cell cell = _terminal->surface().at(cx, cy + first_line);
 
         if (window()->focused())
         {
@@ -68,7 +69,7 @@ void TerminalWidget::paint(Graphic::Painter &painter, const Math::Recti &dirty)
                 render_cell(
                     painter,
                     cx,
-                    cy + _scroll_offset / cell_size().y(),
+                    cy,
                     cell.codepoint,
                     Terminal::BACKGROUND,
                     Terminal::FOREGROUND,
@@ -76,7 +77,7 @@ void TerminalWidget::paint(Graphic::Painter &painter, const Math::Recti &dirty)
             }
             else
             {
-                render_cell(painter, cx, cy + _scroll_offset / cell_size().y(), cell);
+                render_cell(painter, cx, cy, cell);
             }
         }
         else
@@ -85,8 +86,6 @@ void TerminalWidget::paint(Graphic::Painter &painter, const Math::Recti &dirty)
             painter.draw_rectangle(cell_bound(cx, cy), color(Widget::THEME_ANSI_CURSOR));
         }
     }
-
-    painter.pop();
 }
 
 void TerminalWidget::event(Widget::Event *event)
@@ -236,5 +235,67 @@ void TerminalWidget::handle_read()
     }
 
     _terminal->write(buffer, read_result.unwrap());
-    should_repaint();
-}
\ No newline at end of file
+
+    repaint_dirty_lines();
+}
+
+void TerminalWidget::repaint_dirty_lines()
+{
+    auto &surface = _terminal->surface();
+
+    if (_scroll_offset != 0)
+    {
+        // The view is somewhere in the history, lines are not where they
+        // were on the last paint so repaint everything.
+        for (int y = 0; y < _terminal->height(); y++)
+        {
+            surface.undirty(y);
+        }
+
+        should_repaint();
+    }
+    else
+    {
+        // Coalesce runs of dirty lines into a single repaint rectangle.
+        int y = 0;
+
+        while (y < _terminal->height())
+        {
+            if (!surface.dirty(y))
+            {
+                y++;
+                continue;
+            }
+
+            int first = y;
+
+            while (y < _terminal->height() && surface.dirty(y))
+            {
+                surface.undirty(y);
+                y++;
+            }
+
+            should_repaint(line_bound(first, y - first).offset(bound().position()));
+        }
+    }
+
+    auto cursor = _terminal->cursor();
+
+    if (cursor.x != _painted_cursor.x || cursor.y != _painted_cursor.y)
+    {
+        should_repaint(cell_bound(_painted_cursor.x, _painted_cursor.y).offset(bound().position()));
+        should_repaint(cell_bound(cursor.x, cursor.y).offset(bound().position()));
+
+        _painted_cursor = cursor;
+    }
+}
+
+Math::Recti TerminalWidget::line_bound(int y, int count)
+{
+    return {
+        0,
+        y * cell_size().y(),
+        _terminal->width() * cell_size().x(),
+        count * cell_size().y(),
+    };
+}
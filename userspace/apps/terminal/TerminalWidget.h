@@ -13,6 +13,7 @@ private:
     OwnPtr<Terminal::Terminal> _terminal;
     bool _cursor_blink;
     int _scroll_offset = 0;
+    Terminal::Cursor _painted_cursor = {};
 
     IO::Terminal _terminal_device;
 
@@ -26,6 +27,10 @@ public:
 
     void handle_read();
 
+    void repaint_dirty_lines();
+
+    Math::Recti line_bound(int y, int count);
+
     void paint(Graphic::Painter &, const Math::Recti &) override;
 
     void event(Widget::Event *event) override;
@@ -0,0 +1,86 @@
+#include <string.h>
+
+#include <abi/Syscalls.h>
+#include <libio/Streams.h>
+#include <libutils/Assert.h>
+#include <libutils/Vector.h>
+
+#include "benchmarks/Driver.h"
+
+namespace Benchmark
+{
+
+static Vector<Benchmark> *_benchmarks;
+
+static size_t _processed = 0;
+static size_t _iterations = 0;
+
+void __register_benchmark(Benchmark &benchmark)
+{
+    if (!_benchmarks)
+    {
+        _benchmarks = new Vector<Benchmark>();
+    }
+
+    _benchmarks->push_back(benchmark);
+}
+
+void processed(size_t bytes)
+{
+    _processed += bytes;
+}
+
+void iterations(size_t count)
+{
+    _iterations += count;
+}
+
+int run_all_benchmarks(const char *filter)
+{
+    Assert::not_null(_benchmarks);
+
+    IO::errln("benchmark: Running {} benchmarks\n", _benchmarks->count());
+
+    for (auto &benchmark : *_benchmarks)
+    {
+        if (filter && !strstr(benchmark.name, filter))
+        {
+            continue;
+        }
+
+        IO::err("benchmark: {}: \e[1m{}\e[m... ", benchmark.location.file(), benchmark.name);
+
+        _processed = 0;
+        _iterations = 0;
+
+        uint64_t start = 0;
+        hj_system_clock(&start);
+
+        benchmark.function();
+
+        uint64_t end = 0;
+        hj_system_clock(&end);
+
+        // Avoid dividing by zero on very fast runs.
+        uint64_t elapsed = MAX(end - start, (uint64_t)1);
+
+        IO::err("\e[1m{}us\e[m", elapsed / 1000);
+
+        if (_processed)
+        {
+            IO::err(" \e[1;32m{}KiB/s\e[m", (uint64_t)_processed * 1000000000 / 1024 / elapsed);
+        }
+
+        if (_iterations)
+        {
+            IO::err(" \e[1;32m{}op/s\e[m", (uint64_t)_iterations * 1000000000 / elapsed);
+            IO::err(" \e[1m{}ns/op\e[m", elapsed / _iterations);
+        }
+
+        IO::errln("");
+    }
+
+    return 0;
+}
+
+} // namespace Benchmark
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <libutils/SourceLocation.h>
+
+namespace Benchmark
+{
+
+typedef void (*BenchmarkFunction)();
+
+struct Benchmark;
+
+void __register_benchmark(Benchmark &benchmark);
+
+struct Benchmark
+{
+    const char *name;
+    BenchmarkFunction function;
+    Utils::SourceLocation location;
+
+    Benchmark(const char *name, BenchmarkFunction function, Utils::SourceLocation location = Utils::SourceLocation::current())
+    {
+        this->name = name;
+        this->function = function;
+        this->location = location;
+
+        __register_benchmark(*this);
+    }
+};
+
+// Report the amount of data processed by the running benchmark,
+// the driver uses it to compute a throughput.
+void processed(size_t bytes);
+
+// Report the number of operations done by the running benchmark,
+// the driver uses it to compute a rate and the time per operation.
+void iterations(size_t count);
+
+#define BENCHMARK(__benchmark_function)                                   \
+    void __benchmark_##__benchmark_function##_function();                 \
+    ::Benchmark::Benchmark __benchmark_##__benchmark_function##_object{   \
+        #__benchmark_function,                                            \
+        __benchmark_##__benchmark_function##_function,                    \
+    };                                                                    \
+    void __benchmark_##__benchmark_function##_function()
+
+int run_all_benchmarks(const char *filter);
+
+} // namespace Benchmark
@@ -0,0 +1,104 @@
+#include <libasync/Loop.h>
+#include <libasync/Notifier.h>
+#include <libasync/Timer.h>
+#include <libio/Connection.h>
+#include <libio/Format.h>
+#include <libio/Pipe.h>
+#include <libio/Socket.h>
+#include <libsystem/io/Filesystem.h>
+#include <libsystem/system/System.h>
+#include <libutils/Assert.h>
+#include <libutils/OwnPtr.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int IDLE_CONNECTIONS = 1000;
+static constexpr int IDLE_TIMERS = 1000;
+static constexpr int LOOP_ROUNDS = 4096;
+
+// Sockets nobody connects to, they never become ready.
+BENCHMARK(loop_one_active_among_idle_connections)
+{
+    Async::Loop::initialize();
+
+    Vector<OwnPtr<IO::Socket>> sockets;
+    Vector<OwnPtr<Async::Notifier>> idle;
+
+    for (int i = 0; i < IDLE_CONNECTIONS; i++)
+    {
+        auto socket = own<IO::Socket>(IO::format("/Temp/loop-benchmark-{}.ipc", i), OPEN_CREATE);
+        idle.push_back(own<Async::Notifier>(*socket, POLL_ACCEPT, []() {}));
+        sockets.push_back(move(socket));
+    }
+
+    auto pipe = IO::Pipe::create().unwrap();
+    IO::Connection reader{pipe.reader};
+
+    int received = 0;
+
+    Async::Notifier active{reader, POLL_READ, [&]() {
+                               char c;
+                               reader.read(&c, 1);
+                               received++;
+                           }};
+
+    for (int i = 0; i < LOOP_ROUNDS; i++)
+    {
+        char c = 'x';
+        pipe.writer->write(&c, 1);
+
+        Async::Loop::pump(false);
+    }
+
+    Assert::equal(received, LOOP_ROUNDS);
+
+    Benchmark::iterations(LOOP_ROUNDS);
+
+    idle.clear();
+    sockets.clear();
+
+    for (int i = 0; i < IDLE_CONNECTIONS; i++)
+    {
+        filesystem_unlink(IO::format("/Temp/loop-benchmark-{}.ipc", i).cstring());
+    }
+
+    Async::Loop::uninitialize();
+}
+
+// Timers far in the future, only the heap's top is looked at on each pump.
+BENCHMARK(loop_pump_with_idle_timers)
+{
+    Async::Loop::initialize();
+
+    Vector<OwnPtr<Async::Timer>> timers;
+
+    for (int i = 0; i < IDLE_TIMERS; i++)
+    {
+        auto timer = own<Async::Timer>(1000 * 1000, []() {});
+        timer->schedule(system_get_ticks() + 1000 * 1000 + i);
+        timer->start();
+        timers.push_back(move(timer));
+    }
+
+    int fired = 0;
+
+    Async::Timer active{0, [&]() {
+        fired++;
+    }};
+
+    active.start();
+
+    for (int i = 0; i < LOOP_ROUNDS; i++)
+    {
+        active.schedule(0);
+        Async::Loop::pump(true);
+    }
+
+    Assert::equal(fired, LOOP_ROUNDS);
+
+    Benchmark::iterations(LOOP_ROUNDS);
+
+    timers.clear();
+
+    Async::Loop::uninitialize();
+}
@@ -0,0 +1,61 @@
+#include <libgraphic/Painter.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int BLIT_ROUNDS = 16;
+
+// Narrow enough for each row to be on another page, like the dirty
+// rectangles of a window edge.
+static constexpr int BLIT_COLUMN_WIDTH = 16;
+
+// Full HD screens, shared like the windows and the back buffer of the
+// compositor. Big enough to be mapped with large pages.
+static RefPtr<Graphic::Bitmap> make_screen()
+{
+    auto bitmap = Graphic::Bitmap::create_shared(1920, 1080).unwrap();
+
+    for (int i = 0; i < bitmap->width() * bitmap->height(); i++)
+    {
+        bitmap->pixels()[i] = Graphic::Color::from_rgb_byte(i * 7, i * 13, i >> 3);
+    }
+
+    return bitmap;
+}
+
+BENCHMARK(blit_1080p)
+{
+    auto source = make_screen();
+    auto destination = make_screen();
+
+    Graphic::Painter painter{*destination};
+
+    for (int i = 0; i < BLIT_ROUNDS; i++)
+    {
+        painter.blit(*source, source->bound(), destination->bound());
+    }
+
+    Benchmark::processed(BLIT_ROUNDS * source->width() * source->height() * sizeof(Graphic::Color));
+    Benchmark::iterations(BLIT_ROUNDS);
+}
+
+// Every row of a column is on another page, with small pages this misses
+// the TLB on each of them.
+BENCHMARK(blit_1080p_by_columns)
+{
+    auto source = make_screen();
+    auto destination = make_screen();
+
+    Graphic::Painter painter{*destination};
+
+    for (int i = 0; i < BLIT_ROUNDS; i++)
+    {
+        for (int x = 0; x < source->width(); x += BLIT_COLUMN_WIDTH)
+        {
+            Math::Recti column{x, 0, BLIT_COLUMN_WIDTH, source->height()};
+            painter.blit(*source, column, column);
+        }
+    }
+
+    Benchmark::processed(BLIT_ROUNDS * source->width() * source->height() * sizeof(Graphic::Color));
+    Benchmark::iterations(BLIT_ROUNDS);
+}
@@ -0,0 +1,71 @@
+#include <libgraphic/Blur.h>
+#include <libgraphic/Painter.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int BLUR_ROUNDS = 8;
+
+// A full HD screen, like the wallpaper of the compositor.
+static RefPtr<Graphic::Bitmap> make_screen()
+{
+    auto bitmap = Graphic::Bitmap::create_shared(1920, 1080).unwrap();
+
+    for (int i = 0; i < bitmap->width() * bitmap->height(); i++)
+    {
+        bitmap->pixels()[i] = Graphic::Color::from_rgb_byte(i * 7, i * 13, i >> 3);
+    }
+
+    return bitmap;
+}
+
+static void blur_repeatedly(int radius)
+{
+    auto bitmap = make_screen();
+
+    for (int i = 0; i < BLUR_ROUNDS; i++)
+    {
+        Graphic::Blur blur{*bitmap, bitmap->bound(), radius};
+        blur.run();
+    }
+
+    Benchmark::processed(BLUR_ROUNDS * bitmap->width() * bitmap->height() * sizeof(Graphic::Color));
+    Benchmark::iterations(BLUR_ROUNDS);
+}
+
+BENCHMARK(blur_1080p_radius_4)
+{
+    blur_repeatedly(4);
+}
+
+BENCHMARK(blur_1080p_radius_8)
+{
+    blur_repeatedly(8);
+}
+
+BENCHMARK(blur_1080p_radius_16)
+{
+    blur_repeatedly(16);
+}
+
+BENCHMARK(blur_1080p_radius_32)
+{
+    blur_repeatedly(32);
+}
+
+BENCHMARK(blur_1080p_radius_64)
+{
+    blur_repeatedly(64);
+}
+
+BENCHMARK(painter_acrylic_1080p)
+{
+    auto bitmap = make_screen();
+    Graphic::Painter painter{*bitmap};
+
+    for (int i = 0; i < BLUR_ROUNDS; i++)
+    {
+        painter.acrylic(bitmap->bound());
+    }
+
+    Benchmark::iterations(BLUR_ROUNDS);
+}
@@ -0,0 +1,43 @@
+#include <libgraphic/png/PngReader.h>
+#include <libio/Copy.h>
+#include <libio/File.h>
+#include <libio/MemoryReader.h>
+#include <libio/MemoryWriter.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int PNG_DECODE_ROUNDS = 4;
+
+// The file is loaded in memory first so only the decoder is measured.
+static void decode_repeatedly(const char *path)
+{
+    IO::File file{path, OPEN_READ};
+    IO::MemoryWriter memory;
+    Assert::is_true(IO::copy(file, memory) == Result::SUCCESS);
+
+    Slice data{memory.slice()};
+    size_t decoded = 0;
+
+    for (int i = 0; i < PNG_DECODE_ROUNDS; i++)
+    {
+        IO::MemoryReader reader{data};
+        Graphic::PngReader png{reader};
+        Assert::is_true(png.valid());
+
+        decoded += png.width() * png.height() * sizeof(Graphic::Color);
+    }
+
+    Benchmark::processed(decoded);
+    Benchmark::iterations(PNG_DECODE_ROUNDS);
+}
+
+BENCHMARK(png_decode_wallpaper)
+{
+    decode_repeatedly("/Files/Wallpapers/rose.png");
+}
+
+BENCHMARK(png_decode_logo)
+{
+    decode_repeatedly("/Files/logo.png");
+}
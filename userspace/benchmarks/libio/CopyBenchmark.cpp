@@ -0,0 +1,91 @@
+#include <libio/Copy.h>
+#include <libio/File.h>
+#include <libsystem/io/Filesystem.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr size_t COPY_FILE_SIZE = 8 * 1024 * 1024;
+
+static constexpr const char *COPY_SOURCE = "/Temp/copy-benchmark-source";
+static constexpr const char *COPY_DESTINATION = "/Temp/copy-benchmark-destination";
+
+static void create_source()
+{
+    IO::File file{COPY_SOURCE, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    Array<uint8_t, IO::COPY_CHUNK_SIZE> chunk;
+
+    for (size_t i = 0; i < chunk.count(); i++)
+    {
+        chunk[i] = i * 7;
+    }
+
+    for (size_t written = 0; written < COPY_FILE_SIZE; written += chunk.count())
+    {
+        Assert::is_true(file.write(chunk.raw_storage(), chunk.count()).success());
+    }
+}
+
+static void cleanup()
+{
+    filesystem_unlink(COPY_SOURCE);
+    filesystem_unlink(COPY_DESTINATION);
+}
+
+// What cp did before: a read and a write syscall for every 4 KiB.
+BENCHMARK(copy_by_chunks)
+{
+    create_source();
+
+    IO::File source{COPY_SOURCE, OPEN_READ};
+    IO::File destination{COPY_DESTINATION, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    Assert::is_true(IO::copy(static_cast<IO::Reader &>(source), static_cast<IO::Writer &>(destination)) == SUCCESS);
+    Assert::equal(destination.length().unwrap(), COPY_FILE_SIZE);
+
+    Benchmark::processed(COPY_FILE_SIZE);
+
+    cleanup();
+}
+
+BENCHMARK(copy_spliced)
+{
+    create_source();
+
+    IO::File source{COPY_SOURCE, OPEN_READ};
+    IO::File destination{COPY_DESTINATION, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    Assert::is_true(IO::copy(source, destination) == SUCCESS);
+    Assert::equal(destination.length().unwrap(), COPY_FILE_SIZE);
+
+    Benchmark::processed(COPY_FILE_SIZE);
+
+    cleanup();
+}
+
+// A header and a body, as sent by most protocols.
+BENCHMARK(copy_writev)
+{
+    IO::File file{COPY_DESTINATION, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    static constexpr int MESSAGES = 4096;
+
+    uint32_t header = 64;
+    Array<uint8_t, 64> body{};
+
+    IOVec vectors[] = {
+        {&header, sizeof(header)},
+        {body.raw_storage(), body.count()},
+    };
+
+    for (int i = 0; i < MESSAGES; i++)
+    {
+        Assert::equal(file.writev(vectors, 2).unwrap(), sizeof(header) + body.count());
+    }
+
+    Benchmark::processed(MESSAGES * (sizeof(header) + body.count()));
+    Benchmark::iterations(MESSAGES);
+
+    cleanup();
+}
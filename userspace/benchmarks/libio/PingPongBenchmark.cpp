@@ -0,0 +1,124 @@
+#include <abi/Syscalls.h>
+
+#include <libio/Connection.h>
+#include <libio/Pipe.h>
+#include <libio/Socket.h>
+#include <libsystem/io/Filesystem.h>
+#include <libsystem/process/Process.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int PING_PONG_ROUNDS = 10000;
+
+// The size of a small request, like the ones of the compositor.
+static constexpr size_t PING_PONG_MESSAGE_SIZE = 64;
+
+static constexpr const char *PING_PONG_SOCKET = "/Temp/ping-pong-benchmark.ipc";
+
+template <typename TStream>
+static void read_message(TStream &stream, char *message)
+{
+    size_t received = 0;
+
+    while (received < PING_PONG_MESSAGE_SIZE)
+    {
+        auto result = stream.read(message + received, PING_PONG_MESSAGE_SIZE - received);
+        Assert::is_true(result.success());
+        Assert::greater_than(result.unwrap(), 0);
+
+        received += result.unwrap();
+    }
+}
+
+template <typename TStream>
+static void write_message(TStream &stream, const char *message)
+{
+    auto result = stream.write(message, PING_PONG_MESSAGE_SIZE);
+    Assert::is_true(result.success());
+    Assert::equal(result.unwrap(), PING_PONG_MESSAGE_SIZE);
+}
+
+template <typename TStream>
+static void echo(TStream &requests, TStream &responses)
+{
+    char message[PING_PONG_MESSAGE_SIZE];
+
+    for (int i = 0; i < PING_PONG_ROUNDS; i++)
+    {
+        read_message(requests, message);
+        write_message(responses, message);
+    }
+}
+
+// Each round trip is two blocked reads woken by a write from the other
+// process.
+template <typename TStream>
+static void ping(TStream &requests, TStream &responses)
+{
+    char request[PING_PONG_MESSAGE_SIZE];
+    char response[PING_PONG_MESSAGE_SIZE];
+
+    for (int i = 0; i < PING_PONG_ROUNDS; i++)
+    {
+        for (size_t j = 0; j < PING_PONG_MESSAGE_SIZE; j++)
+        {
+            request[j] = i + j;
+        }
+
+        write_message(requests, request);
+        read_message(responses, response);
+
+        Assert::equal(response[PING_PONG_MESSAGE_SIZE - 1], request[PING_PONG_MESSAGE_SIZE - 1]);
+    }
+
+    Benchmark::iterations(PING_PONG_ROUNDS);
+}
+
+static void wait_for_echo(int pid)
+{
+    int exit_value = PROCESS_FAILURE;
+    process_wait(pid, &exit_value);
+    Assert::equal(exit_value, PROCESS_SUCCESS);
+}
+
+BENCHMARK(ping_pong_over_pipes)
+{
+    auto requests = IO::Pipe::create().unwrap();
+    auto responses = IO::Pipe::create().unwrap();
+
+    int pid = -1;
+    hj_process_clone(&pid, TASK_WAITABLE);
+
+    if (pid == 0)
+    {
+        echo(*requests.reader, *responses.writer);
+        hj_process_exit(PROCESS_SUCCESS);
+    }
+
+    ping(*requests.writer, *responses.reader);
+
+    wait_for_echo(pid);
+}
+
+BENCHMARK(ping_pong_over_a_connection)
+{
+    IO::Socket socket{PING_PONG_SOCKET, OPEN_CREATE};
+
+    int pid = -1;
+    hj_process_clone(&pid, TASK_WAITABLE);
+
+    if (pid == 0)
+    {
+        auto connection = IO::Socket::connect(PING_PONG_SOCKET).unwrap();
+        echo(connection, connection);
+        hj_process_exit(PROCESS_SUCCESS);
+    }
+
+    auto connection = socket.accept().unwrap();
+    ping(connection, connection);
+
+    wait_for_echo(pid);
+
+    filesystem_unlink(PING_PONG_SOCKET);
+}
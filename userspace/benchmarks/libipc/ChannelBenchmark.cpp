@@ -0,0 +1,196 @@
+#include <abi/Syscalls.h>
+
+#include <libasync/Loop.h>
+#include <libio/Reader.h>
+#include <libio/Socket.h>
+#include <libio/Writer.h>
+#include <libipc/SharedChannel.h>
+#include <libsystem/io/Filesystem.h>
+#include <libsystem/process/Process.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int CHANNEL_ROUNDS = 10000;
+static constexpr int CHANNEL_MESSAGES = 100000;
+
+static constexpr const char *CHANNEL_SOCKET = "/Temp/channel-benchmark.ipc";
+
+// The size of a small request, like the ones of the compositor.
+struct BenchmarkMessage
+{
+    int sequence;
+    char payload[60];
+};
+
+struct BenchmarkProtocol
+{
+    using Message = BenchmarkMessage;
+
+    static Result encode_message(IO::Writer &writer, const BenchmarkMessage &message)
+    {
+        return writer.write(&message, sizeof(BenchmarkMessage)).result();
+    }
+
+    static ResultOr<BenchmarkMessage> decode_message(IO::Reader &reader)
+    {
+        BenchmarkMessage message;
+
+        if (TRY(reader.read(&message, sizeof(BenchmarkMessage))) != sizeof(BenchmarkMessage))
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        return message;
+    }
+};
+
+using BenchmarkChannel = IPC::SharedChannel<BenchmarkProtocol>;
+
+// The child attaches to the channel the parent created, its handle is the
+// first thing going through the connection.
+template <typename TCallback>
+static int spawn_peer(TCallback callback)
+{
+    int pid = -1;
+    hj_process_clone(&pid, TASK_WAITABLE);
+
+    if (pid == 0)
+    {
+        Async::Loop::initialize();
+
+        auto connection = IO::Socket::connect(CHANNEL_SOCKET).unwrap();
+
+        int handle = HANDLE_INVALID_ID;
+        Assert::equal(connection.read(&handle, sizeof(handle)).unwrap(), sizeof(handle));
+
+        auto channel = BenchmarkChannel::attach(connection, handle).unwrap();
+        callback(*channel);
+
+        hj_process_exit(PROCESS_SUCCESS);
+    }
+
+    return pid;
+}
+
+static OwnPtr<BenchmarkChannel> accept_peer(IO::Socket &socket)
+{
+    Async::Loop::initialize();
+
+    auto connection = socket.accept().unwrap();
+    auto channel = BenchmarkChannel::create(connection).unwrap();
+
+    int handle = channel->handle();
+    connection.write(&handle, sizeof(handle));
+
+    return channel;
+}
+
+static void wait_for_peer(int pid)
+{
+    int exit_value = PROCESS_FAILURE;
+    process_wait(pid, &exit_value);
+    Assert::equal(exit_value, PROCESS_SUCCESS);
+
+    filesystem_unlink(CHANNEL_SOCKET);
+}
+
+// Compare with ping_pong_over_a_connection, both sides block on each round.
+BENCHMARK(ping_pong_over_a_shared_channel)
+{
+    IO::Socket socket{CHANNEL_SOCKET, OPEN_CREATE};
+
+    int pid = spawn_peer([](BenchmarkChannel &channel) {
+        for (int i = 0; i < CHANNEL_ROUNDS; i++)
+        {
+            auto message = channel.receive().unwrap();
+            Assert::is_true(channel.send(message) == SUCCESS);
+        }
+    });
+
+    auto channel = accept_peer(socket);
+
+    for (int i = 0; i < CHANNEL_ROUNDS; i++)
+    {
+        BenchmarkMessage request{};
+        request.sequence = i;
+
+        Assert::is_true(channel->send(request) == SUCCESS);
+        Assert::equal(channel->receive().unwrap().sequence, i);
+    }
+
+    Benchmark::iterations(CHANNEL_ROUNDS);
+
+    channel = nullptr;
+    Async::Loop::uninitialize();
+
+    wait_for_peer(pid);
+}
+
+// Messages sent without waiting for a response, the consumer is only woken
+// when it sleeps on an empty ring.
+BENCHMARK(stream_over_a_shared_channel)
+{
+    IO::Socket socket{CHANNEL_SOCKET, OPEN_CREATE};
+
+    int pid = spawn_peer([](BenchmarkChannel &channel) {
+        for (int i = 0; i < CHANNEL_MESSAGES; i++)
+        {
+            Assert::equal(channel.receive().unwrap().sequence, i);
+        }
+    });
+
+    auto channel = accept_peer(socket);
+
+    for (int i = 0; i < CHANNEL_MESSAGES; i++)
+    {
+        BenchmarkMessage message{};
+        message.sequence = i;
+
+        Assert::is_true(channel->send(message) == SUCCESS);
+    }
+
+    Benchmark::iterations(CHANNEL_MESSAGES);
+
+    channel = nullptr;
+    Async::Loop::uninitialize();
+
+    wait_for_peer(pid);
+}
+
+// The same stream, each message with its own write on the connection.
+BENCHMARK(stream_over_a_connection)
+{
+    IO::Socket socket{CHANNEL_SOCKET, OPEN_CREATE};
+
+    int pid = -1;
+    hj_process_clone(&pid, TASK_WAITABLE);
+
+    if (pid == 0)
+    {
+        auto connection = IO::Socket::connect(CHANNEL_SOCKET).unwrap();
+
+        for (int i = 0; i < CHANNEL_MESSAGES; i++)
+        {
+            BenchmarkMessage message;
+            Assert::equal(connection.read(&message, sizeof(message)).unwrap(), sizeof(message));
+            Assert::equal(message.sequence, i);
+        }
+
+        hj_process_exit(PROCESS_SUCCESS);
+    }
+
+    auto connection = socket.accept().unwrap();
+
+    for (int i = 0; i < CHANNEL_MESSAGES; i++)
+    {
+        BenchmarkMessage message{};
+        message.sequence = i;
+
+        Assert::equal(connection.write(&message, sizeof(message)).unwrap(), sizeof(message));
+    }
+
+    Benchmark::iterations(CHANNEL_MESSAGES);
+
+    wait_for_peer(pid);
+}
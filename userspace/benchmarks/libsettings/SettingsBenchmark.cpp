@@ -0,0 +1,76 @@
+#include <libsettings/Service.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int SETTINGS_ROUNDS = 256;
+
+// The keys an application reads while starting.
+static Vector<Settings::Path> startup_keys()
+{
+    static const char *KEYS[] = {
+        "appearance:widgets.theme",
+        "appearance:widgets.wireframe",
+        "appearance:wallpaper.image",
+        "appearance:wallpaper.color",
+        "appearance:wallpaper.scaling",
+        "appearance:night-light.enable",
+        "appearance:night-light.stenght",
+        "appearance:acrylic.enabled",
+        "appearance:acrylic.blur",
+        "appearance:acrylic.noise",
+        "appearance:acrylic.saturation",
+        "devices:display.resolution",
+    };
+
+    Vector<Settings::Path> keys;
+
+    for (size_t i = 0; i < sizeof(KEYS) / sizeof(*KEYS); i++)
+    {
+        keys.push_back(Settings::Path::parse(KEYS[i]));
+    }
+
+    return keys;
+}
+
+BENCHMARK(settings_read)
+{
+    auto service = Settings::Service::the();
+    auto keys = startup_keys();
+
+    for (int i = 0; i < SETTINGS_ROUNDS; i++)
+    {
+        for (size_t j = 0; j < keys.count(); j++)
+        {
+            Assert::is_true(service->read(keys[j]).present());
+        }
+    }
+
+    Benchmark::iterations(SETTINGS_ROUNDS * keys.count());
+}
+
+BENCHMARK(settings_read_many)
+{
+    auto service = Settings::Service::the();
+    auto keys = startup_keys();
+
+    for (int i = 0; i < SETTINGS_ROUNDS; i++)
+    {
+        Assert::is_true(service->read_many(keys).present());
+    }
+
+    Benchmark::iterations(SETTINGS_ROUNDS * keys.count());
+}
+
+BENCHMARK(settings_write)
+{
+    auto service = Settings::Service::the();
+    auto path = Settings::Path::parse("benchmarks:settings.counter");
+
+    for (int i = 0; i < SETTINGS_ROUNDS; i++)
+    {
+        Assert::is_true(service->write(path, (int64_t)i));
+    }
+
+    Benchmark::iterations(SETTINGS_ROUNDS);
+}
@@ -0,0 +1,102 @@
+#include <abi/Syscalls.h>
+
+#include <libio/Pipe.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/system/Memory.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr size_t TLB_PAGE_SIZE = 4096;
+
+// A working set spread over more pages than the TLB covers cheaply, each
+// walk touching one byte per page. Flushing the TLB makes the next walk
+// miss on every page of it.
+static constexpr size_t TLB_WORKING_SET_PAGES = 256;
+static constexpr int TLB_ROUNDS = 1000;
+
+static uintptr_t working_set_create()
+{
+    uintptr_t working_set = 0;
+    Assert::is_true(memory_alloc(TLB_WORKING_SET_PAGES * TLB_PAGE_SIZE, &working_set) == SUCCESS);
+
+    return working_set;
+}
+
+static void working_set_walk(uintptr_t working_set)
+{
+    auto pages = reinterpret_cast<volatile char *>(working_set);
+
+    for (size_t i = 0; i < TLB_WORKING_SET_PAGES; i++)
+    {
+        pages[i * TLB_PAGE_SIZE] = pages[i * TLB_PAGE_SIZE] + 1;
+    }
+}
+
+// Unmapping a page used to flush the whole TLB.
+BENCHMARK(walk_a_working_set_between_unmaps)
+{
+    uintptr_t working_set = working_set_create();
+
+    for (int i = 0; i < TLB_ROUNDS; i++)
+    {
+        uintptr_t scratch = 0;
+        Assert::is_true(memory_alloc(TLB_PAGE_SIZE, &scratch) == SUCCESS);
+
+        *reinterpret_cast<volatile char *>(scratch) = i;
+
+        Assert::is_true(memory_free(scratch) == SUCCESS);
+
+        working_set_walk(working_set);
+    }
+
+    memory_free(working_set);
+
+    Benchmark::iterations(TLB_ROUNDS);
+}
+
+// Two processes taking turns, each walking its own working set. Switching
+// address spaces used to flush the whole TLB.
+BENCHMARK(walk_a_working_set_between_context_switches)
+{
+    auto pings = IO::Pipe::create().unwrap();
+    auto pongs = IO::Pipe::create().unwrap();
+
+    int pid = -1;
+    hj_process_clone(&pid, TASK_WAITABLE);
+
+    bool child = pid == 0;
+
+    auto &from = child ? *pings.reader : *pongs.reader;
+    auto &to = child ? *pongs.writer : *pings.writer;
+
+    uintptr_t working_set = working_set_create();
+    char token = 0;
+
+    for (int i = 0; i < TLB_ROUNDS; i++)
+    {
+        if (child || i > 0)
+        {
+            Assert::is_true(from.read(&token, 1).success());
+        }
+
+        working_set_walk(working_set);
+
+        Assert::is_true(to.write(&token, 1).success());
+    }
+
+    memory_free(working_set);
+
+    if (child)
+    {
+        hj_process_exit(PROCESS_SUCCESS);
+    }
+
+    Assert::is_true(from.read(&token, 1).success());
+
+    int exit_value = PROCESS_FAILURE;
+    process_wait(pid, &exit_value);
+    Assert::equal(exit_value, PROCESS_SUCCESS);
+
+    Benchmark::iterations(TLB_ROUNDS * 2);
+}
@@ -0,0 +1,144 @@
+#include <abi/Syscalls.h>
+
+#include <libio/Pipe.h>
+#include <libsystem/process/Process.h>
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+// Like the jobs of a parallel build: as many processes as there are jobs,
+// each of them only using the processor. With one job per processor, the
+// parallel run should take the time of a single job.
+static constexpr int SCHEDULER_JOBS = 4;
+static constexpr int SCHEDULER_ROUNDS_PER_JOB = 64;
+
+static constexpr size_t SCHEDULER_ROUND_SIZE = 64 * 1024;
+
+static volatile uint32_t _sink = 0;
+
+static void cpu_bound_round(int seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+
+    for (size_t i = 0; i < SCHEDULER_ROUND_SIZE; i++)
+    {
+        hash = (hash ^ (i & 0xff)) * 16777619u;
+    }
+
+    _sink = _sink + hash;
+}
+
+static void cpu_bound_job(int job)
+{
+    for (int i = 0; i < SCHEDULER_ROUNDS_PER_JOB; i++)
+    {
+        cpu_bound_round(job * SCHEDULER_ROUNDS_PER_JOB + i);
+    }
+}
+
+BENCHMARK(cpu_bound_jobs_one_after_the_other)
+{
+    for (int job = 0; job < SCHEDULER_JOBS; job++)
+    {
+        cpu_bound_job(job);
+    }
+
+    Benchmark::iterations(SCHEDULER_JOBS * SCHEDULER_ROUNDS_PER_JOB);
+}
+
+BENCHMARK(cpu_bound_jobs_in_parallel)
+{
+    int pids[SCHEDULER_JOBS];
+
+    for (int job = 0; job < SCHEDULER_JOBS; job++)
+    {
+        hj_process_clone(&pids[job], TASK_WAITABLE);
+
+        if (pids[job] == 0)
+        {
+            cpu_bound_job(job);
+            hj_process_exit(PROCESS_SUCCESS);
+        }
+    }
+
+    for (int job = 0; job < SCHEDULER_JOBS; job++)
+    {
+        int exit_value = PROCESS_FAILURE;
+        process_wait(pids[job], &exit_value);
+        Assert::equal(exit_value, PROCESS_SUCCESS);
+    }
+
+    Benchmark::iterations(SCHEDULER_JOBS * SCHEDULER_ROUNDS_PER_JOB);
+}
+
+// Two processes handing a byte back and forth, so each round is two
+// context switches. Tasks which don't use the FPU shouldn't pay for
+// switching it, the ones which do pay once per switch.
+static constexpr int SWITCH_ROUNDS = 10000;
+
+static volatile double _fpu_sink = 0;
+
+static void use_the_fpu(int round)
+{
+    _fpu_sink = _fpu_sink * 0.5 + round;
+}
+
+static void hand_off(IO::Handle &from, IO::Handle &to, bool first, bool with_fpu)
+{
+    char token = 0;
+
+    for (int i = 0; i < SWITCH_ROUNDS; i++)
+    {
+        if (!first || i > 0)
+        {
+            auto result = from.read(&token, 1);
+            Assert::is_true(result.success());
+            Assert::equal(result.unwrap(), (size_t)1);
+        }
+
+        if (with_fpu)
+        {
+            use_the_fpu(i);
+        }
+
+        Assert::is_true(to.write(&token, 1).success());
+    }
+
+    if (first)
+    {
+        Assert::is_true(from.read(&token, 1).success());
+    }
+}
+
+static void context_switches(bool with_fpu)
+{
+    auto pings = IO::Pipe::create().unwrap();
+    auto pongs = IO::Pipe::create().unwrap();
+
+    int pid = -1;
+    hj_process_clone(&pid, TASK_WAITABLE);
+
+    if (pid == 0)
+    {
+        hand_off(*pings.reader, *pongs.writer, false, with_fpu);
+        hj_process_exit(PROCESS_SUCCESS);
+    }
+
+    hand_off(*pongs.reader, *pings.writer, true, with_fpu);
+
+    int exit_value = PROCESS_FAILURE;
+    process_wait(pid, &exit_value);
+    Assert::equal(exit_value, PROCESS_SUCCESS);
+
+    Benchmark::iterations(SWITCH_ROUNDS * 2);
+}
+
+BENCHMARK(context_switch_without_the_fpu)
+{
+    context_switches(false);
+}
+
+BENCHMARK(context_switch_with_the_fpu)
+{
+    context_switches(true);
+}
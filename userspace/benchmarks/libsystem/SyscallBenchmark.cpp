@@ -0,0 +1,34 @@
+#include <abi/Syscalls.h>
+
+#include <libutils/Assert.h>
+
+#include "benchmarks/Driver.h"
+
+// One of the cheapest syscalls, most of the time is entering and leaving
+// the kernel.
+static constexpr int SYSCALL_ROUNDS = 100000;
+
+BENCHMARK(syscall_through_the_interrupt_gate)
+{
+    uint32_t ticks = 0;
+
+    for (int i = 0; i < SYSCALL_ROUNDS; i++)
+    {
+        Assert::is_true(__syscall_interrupt(HJ_SYSTEM_TICKS, (uintptr_t)&ticks, 0, 0, 0, 0) == SUCCESS);
+    }
+
+    Benchmark::iterations(SYSCALL_ROUNDS);
+}
+
+// SYSCALL on x86_64 and SYSENTER on x86_32, when the processor has it.
+BENCHMARK(syscall_through_the_fast_entry)
+{
+    uint32_t ticks = 0;
+
+    for (int i = 0; i < SYSCALL_ROUNDS; i++)
+    {
+        Assert::is_true(__syscall(HJ_SYSTEM_TICKS, (uintptr_t)&ticks) == SUCCESS);
+    }
+
+    Benchmark::iterations(SYSCALL_ROUNDS);
+}
@@ -0,0 +1,42 @@
+#include <string.h>
+
+#include <libterminal/Terminal.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr size_t TERMINAL_WRITE_SIZE = 16 * 1024 * 1024;
+
+static void write_repeatedly(Terminal::Terminal &terminal, const char *text)
+{
+    size_t length = strlen(text);
+    size_t written = 0;
+
+    while (written < TERMINAL_WRITE_SIZE)
+    {
+        terminal.write(text, length);
+        written += length;
+    }
+
+    Benchmark::processed(written);
+}
+
+BENCHMARK(terminal_write_plain_text)
+{
+    Terminal::Terminal terminal{80, 24};
+
+    write_repeatedly(terminal, "[ 0.000000] kernel: the quick brown fox jumps over the lazy dog.\n");
+}
+
+BENCHMARK(terminal_write_long_lines)
+{
+    Terminal::Terminal terminal{80, 24};
+
+    write_repeatedly(terminal, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789\n");
+}
+
+BENCHMARK(terminal_write_colored_text)
+{
+    Terminal::Terminal terminal{80, 24};
+
+    write_repeatedly(terminal, "\e[1;32mok\e[m \e[34m/System/Utilities\e[m \e[90m// based\e[m\n");
+}
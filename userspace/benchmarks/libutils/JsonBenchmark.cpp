@@ -0,0 +1,101 @@
+#include <libio/Copy.h>
+#include <libio/Directory.h>
+#include <libio/File.h>
+#include <libio/Format.h>
+#include <libutils/Assert.h>
+#include <libutils/json/Json.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr int JSON_PARSE_ROUNDS = 64;
+
+// Settings, application manifests and the biggest document of the sysroot.
+static Vector<Slice> load_documents()
+{
+    Vector<Slice> documents;
+
+    auto load = [&](String path) {
+        IO::File file{path, OPEN_READ};
+
+        if (file.exist())
+        {
+            documents.push_back(IO::read_all(file).unwrap());
+        }
+    };
+
+    load("/Configs/environment.json");
+    load("/Configs/appearance/widgets.json");
+    load("/Configs/open/file-extensions.json");
+    load("/Configs/open/file-types.json");
+    load("/Files/Fonts/sans.json");
+
+    IO::Directory directory{"/Applications"};
+
+    for (auto &entry : directory.entries())
+    {
+        load(IO::format("/Applications/{}/manifest.json", entry.name));
+    }
+
+    Assert::greater_than(documents.count(), 0);
+
+    return documents;
+}
+
+template <typename TCallback>
+static void parse_repeatedly(TCallback callback)
+{
+    auto documents = load_documents();
+    size_t parsed = 0;
+
+    for (int i = 0; i < JSON_PARSE_ROUNDS; i++)
+    {
+        for (size_t j = 0; j < documents.count(); j++)
+        {
+            callback(documents[j]);
+            parsed += documents[j].size();
+        }
+    }
+
+    Benchmark::processed(parsed);
+    Benchmark::iterations(JSON_PARSE_ROUNDS * documents.count());
+}
+
+BENCHMARK(json_parse_value)
+{
+    parse_repeatedly([](Slice &document) {
+        auto value = Json::parse(reinterpret_cast<const char *>(document.start()), document.size());
+        Assert::is_false(value.is(Json::NIL));
+    });
+}
+
+BENCHMARK(json_parse_document)
+{
+    parse_repeatedly([](Slice &document) {
+        Json::Document parsed{document};
+        Assert::is_true(parsed.valid());
+    });
+}
+
+BENCHMARK(json_parse_sax)
+{
+    struct Counter
+    {
+        size_t events = 0;
+
+        void on_null() { events++; }
+        void on_bool(bool) { events++; }
+        void on_integer(int64_t) { events++; }
+        void on_double(double) { events++; }
+        void on_string(StringView) { events++; }
+        void on_key(StringView) { events++; }
+        void on_begin_object() { events++; }
+        void on_end_object(size_t) { events++; }
+        void on_begin_array() { events++; }
+        void on_end_array(size_t) { events++; }
+    };
+
+    parse_repeatedly([](Slice &document) {
+        Counter counter;
+        Assert::is_true(Json::sax(reinterpret_cast<const char *>(document.start()), document.size(), counter) == SUCCESS);
+    });
+}
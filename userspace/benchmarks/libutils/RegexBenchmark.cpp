@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libutils/Assert.h>
+#include <libutils/Vector.h>
+#include <libutils/regex/Regex.h>
+
+#include "benchmarks/Driver.h"
+
+// About 1MiB of log.
+static constexpr size_t LOG_LINES = 20000;
+
+// 100 scans of the log, the size of a big system log.
+static constexpr int REGEX_SCAN_ROUNDS = 100;
+
+static bool is_error(size_t line) { return line % 64 == 63; }
+
+// Lines looking like a system log, one in 64 reports an error.
+static Vector<char> generate_log()
+{
+    static const char *levels[] = {"INFO", "DEBUG", "WARNING"};
+    static const char *messages[] = {
+        "window manager: damage flushed",
+        "settings: domain appearance loaded",
+        "net: packet received from 10.0.2.2",
+        "task: process spawned",
+    };
+
+    Vector<char> log;
+
+    for (size_t line = 0; line < LOG_LINES; line++)
+    {
+        char buffer[128];
+
+        if (is_error(line))
+        {
+            snprintf(buffer, 128, "[%08d] ERROR disk: read failed after %dms\n", (int)line, (int)(line % 997));
+        }
+        else
+        {
+            snprintf(buffer, 128, "[%08d] %s %s in %dms\n", (int)line, levels[line % 3], messages[line % 4], (int)(line % 97));
+        }
+
+        for (size_t i = 0; buffer[i]; i++)
+        {
+            log.push_back(buffer[i]);
+        }
+    }
+
+    return log;
+}
+
+// The same scanning as grep: jump to the required literal, then match the
+// line around it.
+static size_t count_matching_lines(Regex::Regex &regex, const char *begin, const char *end)
+{
+    size_t matching = 0;
+    const char *current = begin;
+
+    while (current < end)
+    {
+        const char *found = regex.find_literal(current, end);
+
+        if (found == end)
+        {
+            break;
+        }
+
+        auto line_begin = reinterpret_cast<const char *>(memrchr(current, '\n', found - current));
+        line_begin = line_begin ? line_begin + 1 : current;
+
+        auto line_end = reinterpret_cast<const char *>(memchr(found, '\n', end - found));
+
+        if (regex.match(line_begin, line_end - line_begin))
+        {
+            matching++;
+        }
+
+        current = line_end + 1;
+    }
+
+    return matching;
+}
+
+template <typename TCallback>
+static void scan_repeatedly(const char *pattern, TCallback line_matches)
+{
+    auto log = generate_log();
+
+    size_t expected = 0;
+
+    for (size_t line = 0; line < LOG_LINES; line++)
+    {
+        if (line_matches(line))
+        {
+            expected++;
+        }
+    }
+
+    Regex::Regex regex{pattern};
+    Assert::is_true(regex.valid());
+
+    for (int i = 0; i < REGEX_SCAN_ROUNDS; i++)
+    {
+        size_t matching = count_matching_lines(regex, log.raw_storage(), log.raw_storage() + log.count());
+        Assert::equal(matching, expected);
+    }
+
+    Benchmark::processed(log.count() * REGEX_SCAN_ROUNDS);
+}
+
+// Most lines are skipped by the memchr on "ERROR disk: ".
+BENCHMARK(regex_scan_with_literal_prefilter)
+{
+    scan_repeatedly("ERROR disk: .* [0-9]+ms$", is_error);
+}
+
+// No required literal, every line goes through the DFA. The window manager
+// lines have two words before the colon.
+BENCHMARK(regex_scan_without_literal)
+{
+    scan_repeatedly("(INFO|DEBUG|WARNING|ERROR) [a-z]+: .*[0-9]+ms$", [](size_t line) {
+        return is_error(line) || line % 4 != 0;
+    });
+}
+
+// Exponential with a backtracking matcher, linear with the DFA.
+BENCHMARK(regex_scan_pathological_pattern)
+{
+    scan_repeatedly("(a|e)*(a|e)*(a|e)*(a|e)*(a|e)*(a|e)*[qz]", [](size_t) {
+        return false;
+    });
+}
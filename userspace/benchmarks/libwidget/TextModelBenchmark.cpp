@@ -0,0 +1,122 @@
+#include <libwidget/model/TextModel.h>
+
+#include "benchmarks/Driver.h"
+
+static constexpr size_t DOCUMENT_SIZE = 50 * 1024 * 1024;
+static constexpr size_t SCREEN_LINES = 48;
+static constexpr size_t SCROLL_STEPS = 4096;
+
+// A 50MB source file, lines of various lengths with some UTF-8 in them.
+static void generate(uint8_t *buffer, size_t size)
+{
+    static const char *LINES[] = {
+        "#include <libwidget/model/TextModel.h>\n",
+        "\n",
+        "namespace Widget\n",
+        "{\n",
+        "    // Décodé à la volée, ligne par ligne.\n",
+        "    size_t first_visible_line = MAX(0, _vscroll_offset / metrics.fulllineheight() - 1);\n",
+        "    for (size_t i = first_visible_line; i < last_visible_line; i++)\n",
+        "        painter.draw_glyph(*font(), glyph, {advance, baseline}, color(span.foreground()));\n",
+        "    }\n",
+        "} // namespace Widget — ✓\n",
+    };
+
+    size_t offset = 0;
+
+    for (size_t i = 0; offset < size; i++)
+    {
+        const char *line = LINES[i % (sizeof(LINES) / sizeof(*LINES))];
+        size_t length = MIN(strlen(line), size - offset);
+
+        memcpy(buffer + offset, line, length);
+        offset += length;
+    }
+}
+
+static Slice document()
+{
+    static uint8_t *buffer = nullptr;
+
+    if (!buffer)
+    {
+        buffer = new uint8_t[DOCUMENT_SIZE];
+        generate(buffer, DOCUMENT_SIZE);
+    }
+
+    return Slice{buffer, DOCUMENT_SIZE};
+}
+
+// What the editor does to paint a screen of text.
+static size_t paint_screen(Widget::TextModel &model, size_t first_line)
+{
+    size_t codepoints = 0;
+
+    for (size_t i = first_line; i < MIN(first_line + SCREEN_LINES, model.line_count()); i++)
+    {
+        auto line = model.line(i);
+
+        for (size_t j = 0; j < line.length(); j++)
+        {
+            auto span = model.span_at(i, j);
+            codepoints += line[j] != 0 && span.end() > j;
+        }
+    }
+
+    return codepoints;
+}
+
+BENCHMARK(text_model_open)
+{
+    // Generating the content stands for reading the file.
+    auto buffer = new uint8_t[DOCUMENT_SIZE];
+    generate(buffer, DOCUMENT_SIZE);
+
+    {
+        auto model = make<Widget::TextModel>(Slice{buffer, DOCUMENT_SIZE});
+        paint_screen(*model, model->line_count() - SCREEN_LINES);
+    }
+
+    delete[] buffer;
+
+    Benchmark::processed(DOCUMENT_SIZE);
+    Benchmark::iterations(1);
+}
+
+BENCHMARK(text_model_scroll)
+{
+    auto model = make<Widget::TextModel>(document());
+    size_t lines = model->line_count();
+
+    for (size_t i = 0; i < SCROLL_STEPS; i++)
+    {
+        paint_screen(*model, lines * i / SCROLL_STEPS);
+    }
+
+    Benchmark::iterations(SCROLL_STEPS);
+}
+
+BENCHMARK(text_model_type)
+{
+    auto model = make<Widget::TextModel>(document());
+    size_t lines = model->line_count();
+
+    Widget::TextCursor cursor;
+    cursor.move_to_within(*model, lines / 2);
+
+    for (size_t i = 0; i < SCROLL_STEPS; i++)
+    {
+        if (i % 16 == 15)
+        {
+            model->newline_at(cursor);
+        }
+        else
+        {
+            model->append_at(cursor, U'a');
+        }
+
+        paint_screen(*model, cursor.line());
+    }
+
+    Benchmark::iterations(SCROLL_STEPS);
+}
@@ -0,0 +1,6 @@
+#include "benchmarks/Driver.h"
+
+int main(int argc, char const *argv[])
+{
+    return Benchmark::run_all_benchmarks(argc > 1 ? argv[1] : nullptr);
+}
@@ -25,6 +25,15 @@ struct HandlePoll
     PollEvent result;
 };
 
+struct IOVec
+{
+    void *buffer;
+    size_t size;
+};
+
+// Upper bound on the number of buffers of a single readv/writev.
+#define IOVEC_MAX_COUNT 64
+
 #define HANDLE_INVALID_ID (-1)
 
 #define HANDLE(__subclass) ((Handle *)(__subclass))
@@ -45,6 +45,12 @@ struct IOCallNetworkSateAgs
     MacAddress mac_address;
 };
 
+// Disks which can do both move their data with DMA, unless told not to.
+struct IOCallDiskTransferModeArgs
+{
+    bool dma;
+};
+
 enum IOCall
 {
     IOCALL_TERMINAL_GET_SIZE,
@@ -62,5 +68,8 @@ enum IOCall
 
     IOCALL_NETWORK_GET_STATE,
 
+    IOCALL_DISK_GET_TRANSFER_MODE,
+    IOCALL_DISK_SET_TRANSFER_MODE,
+
     __IOCALL_COUNT,
 };
@@ -4,6 +4,10 @@
 #include <abi/Process.h>
 #include <abi/Task.h>
 
+// Only the first handles of a child can be set up by its parent, the launchpad
+// is copied on the kernel stack.
+#define LAUNCHPAD_HANDLE_COUNT 128
+
 struct LaunchpadArgument
 {
     char *buffer;
@@ -23,5 +27,5 @@ struct Launchpad
     char *env;
     size_t env_size;
 
-    int handles[PROCESS_HANDLE_COUNT];
+    int handles[LAUNCHPAD_HANDLE_COUNT];
 };
@@ -3,6 +3,6 @@
 #define PROCESS_NAME_SIZE 128
 #define PROCESS_STACK_SIZE 65536
 #define PROCESS_ARG_COUNT 128
-#define PROCESS_HANDLE_COUNT 128
+#define PROCESS_HANDLE_COUNT 1024
 #define PROCESS_SUCCESS (0)
 #define PROCESS_FAILURE (1)
@@ -1,5 +1,29 @@
 #include <abi/Syscalls.h>
 
+#if defined(__i386__)
+
+static int _has_sysenter = -1;
+
+int __syscall_has_sysenter()
+{
+    if (_has_sysenter == -1)
+    {
+        uint32_t eax = 1;
+        uint32_t ebx;
+        uint32_t ecx;
+        uint32_t edx;
+
+        asm volatile("cpuid"
+                     : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+
+        _has_sysenter = (edx >> 11) & 1;
+    }
+
+    return _has_sysenter;
+}
+
+#endif
+
 static int _pid_cache = -1;
 
 Result hj_process_this(int *pid)
@@ -139,6 +163,11 @@ Result hj_system_tick(uint32_t *tick)
     return __syscall(HJ_SYSTEM_TICKS, (uintptr_t)tick);
 }
 
+Result hj_system_clock(uint64_t *nanoseconds)
+{
+    return __syscall(HJ_SYSTEM_CLOCK, (uintptr_t)nanoseconds);
+}
+
 Result hj_system_reboot()
 {
     return __syscall(HJ_SYSTEM_REBOOT);
@@ -149,6 +178,11 @@ Result hj_system_shutdown()
     return __syscall(HJ_SYSTEM_SHUTDOWN);
 }
 
+Result hj_system_trace(const char *name, size_t size, TracePhase phase)
+{
+    return __syscall(HJ_SYSTEM_TRACE, (uintptr_t)name, size, phase);
+}
+
 Result hj_create_pipe(int *reader_handle, int *writer_handle)
 {
     return __syscall(HJ_CREATE_PIPE, (uintptr_t)reader_handle, (uintptr_t)writer_handle);
@@ -159,6 +193,21 @@ Result hj_create_term(int *server_handle, int *client_handle)
     return __syscall(HJ_CREATE_TERM, (uintptr_t)server_handle, (uintptr_t)client_handle);
 }
 
+Result hj_create_event_queue(int *queue_handle)
+{
+    return __syscall(HJ_CREATE_EVENT_QUEUE, (uintptr_t)queue_handle);
+}
+
+Result hj_event_queue_watch(int queue_handle, int handle, PollEvent events)
+{
+    return __syscall(HJ_EVENT_QUEUE_WATCH, (uintptr_t)queue_handle, (uintptr_t)handle, (uintptr_t)events);
+}
+
+Result hj_event_queue_wait(int queue_handle, HandlePoll *ready, size_t count, Timeout timeout, size_t *ready_count)
+{
+    return __syscall(HJ_EVENT_QUEUE_WAIT, (uintptr_t)queue_handle, (uintptr_t)ready, (uintptr_t)count, (uintptr_t)timeout, (uintptr_t)ready_count);
+}
+
 Result hj_handle_open(int *handle, const char *raw_path, size_t size, OpenFlag flags)
 {
     return __syscall(HJ_HANDLE_OPEN, (uintptr_t)handle, (uintptr_t)raw_path, (uintptr_t)size, flags);
@@ -221,3 +270,18 @@ Result hj_handle_accept(int handle, int *connection_handle)
         (uintptr_t)handle,
         (uintptr_t)connection_handle);
 }
+
+Result hj_handle_readv(int handle, const IOVec *vectors, size_t count, size_t *read)
+{
+    return __syscall(HJ_HANDLE_READV, (uintptr_t)handle, (uintptr_t)vectors, (uintptr_t)count, (uintptr_t)read);
+}
+
+Result hj_handle_writev(int handle, const IOVec *vectors, size_t count, size_t *written)
+{
+    return __syscall(HJ_HANDLE_WRITEV, (uintptr_t)handle, (uintptr_t)vectors, (uintptr_t)count, (uintptr_t)written);
+}
+
+Result hj_handle_splice(int source, int destination, size_t size, size_t *spliced)
+{
+    return __syscall(HJ_HANDLE_SPLICE, (uintptr_t)source, (uintptr_t)destination, (uintptr_t)size, (uintptr_t)spliced);
+}
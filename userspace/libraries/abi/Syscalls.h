@@ -10,46 +10,54 @@
 #include <abi/Launchpad.h>
 #include <abi/System.h>
 
-#define SYSCALL_LIST(__ENTRY)     \
-    __ENTRY(HJ_PROCESS_THIS)      \
-    __ENTRY(HJ_PROCESS_NAME)      \
-    __ENTRY(HJ_PROCESS_LAUNCH)    \
-    __ENTRY(HJ_PROCESS_CLONE)     \
-    __ENTRY(HJ_PROCESS_EXEC)      \
-    __ENTRY(HJ_PROCESS_EXIT)      \
-    __ENTRY(HJ_PROCESS_CANCEL)    \
-    __ENTRY(HJ_PROCESS_SLEEP)     \
-    __ENTRY(HJ_PROCESS_WAIT)      \
-    __ENTRY(HJ_MEMORY_ALLOC)      \
-    __ENTRY(HJ_MEMORY_MAP)        \
-    __ENTRY(HJ_MEMORY_FREE)       \
-    __ENTRY(HJ_MEMORY_INCLUDE)    \
-    __ENTRY(HJ_MEMORY_GET_HANDLE) \
-    __ENTRY(HJ_FILESYSTEM_LINK)   \
-    __ENTRY(HJ_FILESYSTEM_UNLINK) \
-    __ENTRY(HJ_FILESYSTEM_RENAME) \
-    __ENTRY(HJ_FILESYSTEM_MKPIPE) \
-    __ENTRY(HJ_FILESYSTEM_MKDIR)  \
-    __ENTRY(HJ_SYSTEM_INFO)       \
-    __ENTRY(HJ_SYSTEM_STATUS)     \
-    __ENTRY(HJ_SYSTEM_TIME)       \
-    __ENTRY(HJ_SYSTEM_TICKS)      \
-    __ENTRY(HJ_SYSTEM_REBOOT)     \
-    __ENTRY(HJ_SYSTEM_SHUTDOWN)   \
-    __ENTRY(HJ_HANDLE_OPEN)       \
-    __ENTRY(HJ_HANDLE_CLOSE)      \
-    __ENTRY(HJ_HANDLE_REOPEN)     \
-    __ENTRY(HJ_HANDLE_COPY)       \
-    __ENTRY(HJ_HANDLE_POLL)       \
-    __ENTRY(HJ_HANDLE_READ)       \
-    __ENTRY(HJ_HANDLE_WRITE)      \
-    __ENTRY(HJ_HANDLE_CALL)       \
-    __ENTRY(HJ_HANDLE_SEEK)       \
-    __ENTRY(HJ_HANDLE_STAT)       \
-    __ENTRY(HJ_HANDLE_CONNECT)    \
-    __ENTRY(HJ_HANDLE_ACCEPT)     \
-    __ENTRY(HJ_CREATE_PIPE)       \
-    __ENTRY(HJ_CREATE_TERM)
+#define SYSCALL_LIST(__ENTRY)      \
+    __ENTRY(HJ_PROCESS_THIS)       \
+    __ENTRY(HJ_PROCESS_NAME)       \
+    __ENTRY(HJ_PROCESS_LAUNCH)     \
+    __ENTRY(HJ_PROCESS_CLONE)      \
+    __ENTRY(HJ_PROCESS_EXEC)       \
+    __ENTRY(HJ_PROCESS_EXIT)       \
+    __ENTRY(HJ_PROCESS_CANCEL)     \
+    __ENTRY(HJ_PROCESS_SLEEP)      \
+    __ENTRY(HJ_PROCESS_WAIT)       \
+    __ENTRY(HJ_MEMORY_ALLOC)       \
+    __ENTRY(HJ_MEMORY_MAP)         \
+    __ENTRY(HJ_MEMORY_FREE)        \
+    __ENTRY(HJ_MEMORY_INCLUDE)     \
+    __ENTRY(HJ_MEMORY_GET_HANDLE)  \
+    __ENTRY(HJ_FILESYSTEM_LINK)    \
+    __ENTRY(HJ_FILESYSTEM_UNLINK)  \
+    __ENTRY(HJ_FILESYSTEM_RENAME)  \
+    __ENTRY(HJ_FILESYSTEM_MKPIPE)  \
+    __ENTRY(HJ_FILESYSTEM_MKDIR)   \
+    __ENTRY(HJ_SYSTEM_INFO)        \
+    __ENTRY(HJ_SYSTEM_STATUS)      \
+    __ENTRY(HJ_SYSTEM_TIME)        \
+    __ENTRY(HJ_SYSTEM_TICKS)       \
+    __ENTRY(HJ_SYSTEM_CLOCK)       \
+    __ENTRY(HJ_SYSTEM_REBOOT)      \
+    __ENTRY(HJ_SYSTEM_SHUTDOWN)    \
+    __ENTRY(HJ_SYSTEM_TRACE)       \
+    __ENTRY(HJ_HANDLE_OPEN)        \
+    __ENTRY(HJ_HANDLE_CLOSE)       \
+    __ENTRY(HJ_HANDLE_REOPEN)      \
+    __ENTRY(HJ_HANDLE_COPY)        \
+    __ENTRY(HJ_HANDLE_POLL)        \
+    __ENTRY(HJ_HANDLE_READ)        \
+    __ENTRY(HJ_HANDLE_WRITE)       \
+    __ENTRY(HJ_HANDLE_CALL)        \
+    __ENTRY(HJ_HANDLE_SEEK)        \
+    __ENTRY(HJ_HANDLE_STAT)        \
+    __ENTRY(HJ_HANDLE_CONNECT)     \
+    __ENTRY(HJ_HANDLE_ACCEPT)      \
+    __ENTRY(HJ_HANDLE_READV)       \
+    __ENTRY(HJ_HANDLE_WRITEV)      \
+    __ENTRY(HJ_HANDLE_SPLICE)      \
+    __ENTRY(HJ_CREATE_PIPE)        \
+    __ENTRY(HJ_CREATE_TERM)        \
+    __ENTRY(HJ_CREATE_EVENT_QUEUE) \
+    __ENTRY(HJ_EVENT_QUEUE_WATCH)  \
+    __ENTRY(HJ_EVENT_QUEUE_WAIT)
 
 #define SYSCALL_ENUM_ENTRY(__entry) __entry,
 
@@ -58,7 +66,8 @@ enum Syscall
     SYSCALL_LIST(SYSCALL_ENUM_ENTRY) __SYSCALL_COUNT
 };
 
-static Result __syscall(Syscall syscall, uintptr_t p1, uintptr_t p2, uintptr_t p3, uintptr_t p4, uintptr_t p5)
+// Through the interrupt gate, which every processor has.
+static inline Result __syscall_interrupt(Syscall syscall, uintptr_t p1, uintptr_t p2, uintptr_t p3, uintptr_t p4, uintptr_t p5)
 {
     Result __ret = ERR_NOT_IMPLEMENTED;
 
@@ -80,6 +89,50 @@ static Result __syscall(Syscall syscall, uintptr_t p1, uintptr_t p2, uintptr_t p
     return __ret;
 }
 
+#if defined(__i386__)
+
+__BEGIN_HEADER
+
+// Whether the processor has SYSENTER, the kernel uses it when it does.
+int __syscall_has_sysenter(void);
+
+__END_HEADER
+
+#endif
+
+static Result __syscall(Syscall syscall, uintptr_t p1, uintptr_t p2, uintptr_t p3, uintptr_t p4, uintptr_t p5)
+{
+    Result __ret = ERR_NOT_IMPLEMENTED;
+
+#if defined(__x86_64__)
+
+    // The kernel returns to RCX with the flags in R11, the second argument
+    // goes in R10 instead.
+    register uintptr_t __p2 asm("r10") = p2;
+
+    asm volatile("syscall"
+                 : "=a"(__ret)
+                 : "a"(syscall), "b"(p1), "r"(__p2), "d"(p3), "S"(p4), "D"(p5)
+                 : "rcx", "r11", "memory");
+
+#elif defined(__i386__)
+
+    if (!__syscall_has_sysenter())
+    {
+        return __syscall_interrupt(syscall, p1, p2, p3, p4, p5);
+    }
+
+    // SYSEXIT returns to the stack in ECX and the address in EDX, so the
+    // second argument goes in EBP and the third one on the stack.
+    asm volatile("push %%ebp; push %%edx; movl %%ecx, %%ebp; movl %%esp, %%ecx; movl $1f, %%edx; sysenter; 1: addl $4, %%esp; pop %%ebp"
+                 : "=a"(__ret), "+c"(p2), "+d"(p3)
+                 : "a"(syscall), "b"(p1), "S"(p4), "D"(p5)
+                 : "memory");
+#endif
+
+    return __ret;
+}
+
 #ifdef __cplusplus
 
 static inline Result __syscall(Syscall syscall, uintptr_t p1, uintptr_t p2, uintptr_t p3, uintptr_t p4)
@@ -137,11 +190,18 @@ Result hj_system_info(SystemInfo *info);
 Result hj_system_status(SystemStatus *status);
 Result hj_system_time(TimeStamp *timestamp);
 Result hj_system_tick(uint32_t *tick);
+// Nanoseconds since the machine started, for measuring durations.
+Result hj_system_clock(uint64_t *nanoseconds);
 Result hj_system_reboot();
 Result hj_system_shutdown();
+Result hj_system_trace(const char *name, size_t size, TracePhase phase);
 
 Result hj_create_pipe(int *reader_handle, int *writer_handle);
 Result hj_create_term(int *server_handle, int *client_handle);
+Result hj_create_event_queue(int *queue_handle);
+
+Result hj_event_queue_watch(int queue_handle, int handle, PollEvent events);
+Result hj_event_queue_wait(int queue_handle, HandlePoll *ready, size_t count, Timeout timeout, size_t *ready_count);
 
 Result hj_handle_open(int *handle, const char *raw_path, size_t size, OpenFlag flags);
 Result hj_handle_close(int handle);
@@ -155,5 +215,8 @@ Result hj_handle_seek(int handle, ssize64_t *offset, HjWhence whence, ssize64_t
 Result hj_handle_stat(int handle, FileState *state);
 Result hj_handle_connect(int *handle, const char *raw_path, size_t size);
 Result hj_handle_accept(int handle, int *connection_handle);
+Result hj_handle_readv(int handle, const IOVec *vectors, size_t count, size_t *read);
+Result hj_handle_writev(int handle, const IOVec *vectors, size_t count, size_t *written);
+Result hj_handle_splice(int source, int destination, size_t size, size_t *spliced);
 
 __END_HEADER
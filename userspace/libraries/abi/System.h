@@ -22,3 +22,13 @@ struct SystemStatus
     int running_tasks;
     int cpu_usage;
 };
+
+// Longer names of trace events are cut.
+#define TRACE_NAME_SIZE 48
+
+enum TracePhase
+{
+    TRACE_BEGIN,
+    TRACE_END,
+    TRACE_INSTANT,
+};
@@ -2,8 +2,11 @@
 #include <libasync/Loop.h>
 #include <libasync/Notifier.h>
 #include <libasync/Timer.h>
+#include <libmath/MinMax.h>
 #include <libsystem/system/System.h>
+#include <libutils/Array.h>
 #include <libutils/Assert.h>
+#include <libutils/HashMap.h>
 #include <libutils/Vector.h>
 
 namespace Async
@@ -14,79 +17,196 @@ namespace Loop
 
 /* --- Notifiers ------------------------------------------------------------ */
 
-static Vector<Notifier *> _notifiers;
-static Vector<HandlePoll> _polls;
+// The handles are watched by an event queue in the kernel, a wait only
+// returns the ones which are ready.
+static int _queue = HANDLE_INVALID_ID;
+static HashMap<int, Vector<Notifier *>> _notifiers;
 
-void update_notifier()
+static constexpr size_t READY_COUNT = 64;
+static Array<HandlePoll, READY_COUNT> _ready;
+
+static int queue()
 {
-    _polls.clear();
+    if (_queue == HANDLE_INVALID_ID)
+    {
+        Assert::is_true(hj_create_event_queue(&_queue) == SUCCESS);
+    }
 
-    for (Notifier *notifier : _notifiers)
+    return _queue;
+}
+
+// Many notifiers can watch the same handle, the queue waits for any of
+// their events.
+static void update_watch(int id)
+{
+    PollEvent events = 0;
+
+    if (_notifiers.has_key(id))
     {
-        _polls.push_back({
-            notifier->handle()->id(),
-            notifier->events(),
-            0,
-        });
+        for (Notifier *notifier : _notifiers[id])
+        {
+            events |= notifier->events();
+        }
     }
+
+    hj_event_queue_watch(queue(), id, events);
 }
 
 void register_notifier(Notifier *notifier)
 {
+    int id = notifier->handle()->id();
 
-    _notifiers.push_back(notifier);
+    _notifiers[id].push_back(notifier);
 
-    update_notifier();
+    update_watch(id);
 }
 
 void unregister_notifier(Notifier *notifier)
 {
-    _notifiers.remove_all_value(notifier);
+    int id = notifier->handle()->id();
+
+    if (!_notifiers.has_key(id))
+    {
+        return;
+    }
+
+    _notifiers[id].remove_all_value(notifier);
+
+    if (_notifiers[id].empty())
+    {
+        _notifiers.remove_key(id);
+    }
 
-    update_notifier();
+    update_watch(id);
+}
+
+static bool is_registered(int id, Notifier *notifier)
+{
+    return _notifiers.has_key(id) && _notifiers[id].contains(notifier);
 }
 
 void update_notifier(int id, PollEvent event)
 {
-    for (size_t i = 0; i < _notifiers.count(); i++)
+    if (!_notifiers.has_key(id))
     {
-        if (_notifiers[i]->handle()->id() == id &&
-            _notifiers[i]->events() & event)
+        return;
+    }
+
+    // A callback may unregister any notifier, including itself.
+    auto notifiers = _notifiers[id];
+
+    for (Notifier *notifier : notifiers)
+    {
+        if (is_registered(id, notifier) && (notifier->events() & event))
         {
-            _notifiers[i]->invoke();
+            notifier->invoke();
         }
     }
 }
 
 /* --- Timers --------------------------------------------------------------- */
 
+// Running timers, as a binary min-heap ordered by when they fire next. Each
+// timer knows its position so it can be moved or removed without a search.
 static Vector<Timer *> _timers;
 
+static bool fires_before(size_t a, size_t b)
+{
+    return _timers[a]->scheduled() < _timers[b]->scheduled();
+}
+
+static void swap_timers(size_t a, size_t b)
+{
+    swap(_timers[a], _timers[b]);
+
+    _timers[a]->heap_index(a);
+    _timers[b]->heap_index(b);
+}
+
+static void sift_up(size_t index)
+{
+    while (index > 0 && fires_before(index, (index - 1) / 2))
+    {
+        swap_timers(index, (index - 1) / 2);
+        index = (index - 1) / 2;
+    }
+}
+
+static void sift_down(size_t index)
+{
+    while (true)
+    {
+        size_t first = index;
+        size_t left = index * 2 + 1;
+        size_t right = index * 2 + 2;
+
+        if (left < _timers.count() && fires_before(left, first))
+        {
+            first = left;
+        }
+
+        if (right < _timers.count() && fires_before(right, first))
+        {
+            first = right;
+        }
+
+        if (first == index)
+        {
+            return;
+        }
+
+        swap_timers(index, first);
+        index = first;
+    }
+}
+
 void register_timer(Timer *timer)
 {
+    timer->heap_index(_timers.count());
     _timers.push_back(timer);
+
+    sift_up(timer->heap_index());
 }
 
 void unregister_timer(Timer *timer)
 {
-    _timers.remove_value(timer);
+    size_t index = timer->heap_index();
+    size_t last = _timers.count() - 1;
+
+    if (index != last)
+    {
+        swap_timers(index, last);
+    }
+
+    _timers.pop_back();
+
+    if (index < _timers.count())
+    {
+        sift_up(index);
+        sift_down(index);
+    }
+}
+
+void update_timer(Timer *timer)
+{
+    sift_up(timer->heap_index());
+    sift_down(timer->heap_index());
 }
 
 void update_timers()
 {
     TimeStamp current_fire = system_get_ticks();
 
-    auto timers_list_copy = _timers;
-
-    timers_list_copy.foreach ([&](auto timer) {
-        if (timer->running() && timer->scheduled() <= current_fire)
-        {
-            timer->trigger();
-            timer->schedule(current_fire + timer->interval());
-        }
+    // A timer is rescheduled before its callback runs so the callback is free
+    // to stop, restart or delete it. Timers without an interval are pushed to
+    // the next tick, they would be due forever otherwise.
+    while (!_timers.empty() && _timers[0]->scheduled() <= current_fire)
+    {
+        Timer *timer = _timers[0];
 
-        return Iteration::CONTINUE;
-    });
+        timer->schedule(current_fire + MAX(timer->interval(), (Timeout)1));
+        timer->trigger();
+    }
 }
 
 /* --- Invokers ------------------------------------------------------------- */
@@ -149,33 +269,29 @@ void uninitialize()
 
 static Timeout get_timeout()
 {
-    Timeout timeout = UINT32_MAX;
-
-    TimeStamp current_tick = system_get_ticks();
-
-    _timers.foreach ([&](auto timer) {
-        if (!timer->running() || timer->interval() == 0)
-        {
-            return Iteration::CONTINUE;
-        }
-
-        if (timer->scheduled() < current_tick)
+    // Invokers run after the wait, don't let it block.
+    for (size_t i = 0; i < _invoker.count(); i++)
+    {
+        if (_invoker[i]->should_be_invoke_later())
         {
-            timeout = 0;
-            return Iteration::CONTINUE;
+            return 0;
         }
+    }
 
-        Timeout remaining = timer->scheduled() - current_tick;
+    if (_timers.empty())
+    {
+        return UINT32_MAX;
+    }
 
-        if (remaining <= timeout)
-        {
-            timeout = remaining;
-        }
+    TimeStamp current_tick = system_get_ticks();
+    TimeStamp next_fire = _timers[0]->scheduled();
 
-        return Iteration::CONTINUE;
-    });
+    if (next_fire <= current_tick)
+    {
+        return 0;
+    }
 
-    return timeout;
+    return next_fire - current_tick;
 }
 
 void atexit(AtExitHook hook)
@@ -194,16 +310,17 @@ void pump(bool pool)
         timeout = get_timeout();
     }
 
-    Result result = hj_handle_poll(_polls.raw_storage(), _polls.count(), timeout);
+    size_t ready = 0;
+    Result result = hj_event_queue_wait(queue(), _ready.raw_storage(), _ready.count(), timeout, &ready);
 
     if (result_is_error(result))
     {
         exit(PROCESS_FAILURE);
     }
 
-    for (const HandlePoll &poll : _polls)
+    for (size_t i = 0; i < ready; i++)
     {
-        update_notifier(poll.handle, poll.result);
+        update_notifier(_ready[i].handle, _ready[i].result);
     }
 
     update_timers();
@@ -26,6 +26,8 @@ void register_timer(Timer *timer);
 
 void unregister_timer(Timer *timer);
 
+void update_timer(Timer *timer);
+
 /* --- Invokers ------------------------------------------------------------- */
 
 void register_invoker(Invoker *timer);
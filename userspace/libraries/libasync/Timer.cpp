@@ -15,6 +15,16 @@ Timer::~Timer()
     stop();
 }
 
+void Timer::schedule(TimeStamp when)
+{
+    _scheduled = when;
+
+    if (_running)
+    {
+        Loop::update_timer(this);
+    }
+}
+
 void Timer::start()
 {
     if (!_running)
@@ -14,6 +14,7 @@ private:
     bool _running = false;
     TimeStamp _scheduled = 0;
     Timeout _interval = 0;
+    size_t _heap_index = 0;
     Callback<void()> _callback;
 
 public:
@@ -25,7 +26,11 @@ public:
 
     auto scheduled() { return _scheduled; }
 
-    void schedule(TimeStamp when) { _scheduled = when; }
+    void schedule(TimeStamp when);
+
+    auto heap_index() { return _heap_index; }
+
+    void heap_index(size_t index) { _heap_index = index; }
 
     void trigger()
     {
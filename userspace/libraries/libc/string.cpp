@@ -22,6 +22,21 @@ void *memchr(const void *str, int c, size_t n)
     return nullptr;
 }
 
+void *memrchr(const void *str, int c, size_t n)
+{
+    unsigned char *s = (unsigned char *)str;
+
+    for (size_t i = n; i > 0; i--)
+    {
+        if (*(s + i - 1) == (unsigned char)c)
+        {
+            return (s + i - 1);
+        }
+    }
+
+    return nullptr;
+}
+
 int memcmp(const void *str1, const void *str2, size_t n)
 {
     const unsigned char *s1 = (const unsigned char *)str1;
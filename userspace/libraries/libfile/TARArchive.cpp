@@ -1,5 +1,6 @@
 #include <libfile/TARArchive.h>
 #include <libio/File.h>
+#include <libmath/MinMax.h>
 #include <libsystem/Logger.h>
 
 struct PACKED TARRawBlock
@@ -38,37 +39,38 @@ struct PACKED TARRawBlock
     }
 };
 
-bool tar_read(void *tarfile, TARBlock *block, size_t index)
+bool TARIterator::next(TARBlock *block)
 {
-    TARRawBlock *header = (TARRawBlock *)tarfile;
+    size_t left = _end - _current;
 
-    for (size_t i = 0; i < index; i++)
+    if (left < sizeof(TARRawBlock))
     {
-        if (header->name[0] == '\0')
-        {
-            return false;
-        }
-
-        size_t size = header->file_size();
+        return false;
+    }
 
-        header = (TARRawBlock *)((char *)header + ((size / 512) + 1) * 512);
+    TARRawBlock *header = (TARRawBlock *)_current;
 
-        if (size % 512)
-        {
-            header = (TARRawBlock *)((char *)header + 512);
-        }
+    if (header->name[0] == '\0')
+    {
+        return false;
     }
 
-    if (header->name[0] == '\0')
+    size_t size = header->file_size();
+
+    // A truncated archive ends at the last whole file.
+    if (left - sizeof(TARRawBlock) < size)
     {
         return false;
     }
 
     memcpy(block->name, header->name, 100);
-    block->size = header->file_size();
+    block->name[99] = '\0';
+    block->size = size;
     block->typeflag = header->typeflag;
     memcpy(block->linkname, header->linkname, 100);
-    block->data = (char *)header + 512;
+    block->data = (char *)header + sizeof(TARRawBlock);
+
+    _current += sizeof(TARRawBlock) + MIN(left - sizeof(TARRawBlock), ALIGN_UP(size, 512));
 
     return true;
 }
@@ -11,7 +11,23 @@ struct TARBlock
     char *data;
 };
 
-bool tar_read(void *tarfile, TARBlock *block, size_t index);
+// Walks the blocks of an archive in memory, each one is only visited once.
+class TARIterator
+{
+private:
+    const char *_current;
+    const char *_end;
+
+public:
+    TARIterator(const void *archive, size_t size)
+        : _current{static_cast<const char *>(archive)},
+          _end{static_cast<const char *>(archive) + size}
+    {
+    }
+
+    // The data of the block points into the archive, nothing is copied.
+    bool next(TARBlock *block);
+};
 
 class TARArchive final : public Archive
 {
@@ -19,16 +19,13 @@ static auto get_icon_for_node(String current_directory, IO::Directory::Entry &en
 
         if (manifest_file.exist())
         {
-            auto root = Json::parse(manifest_file);
+            Json::Document manifest{manifest_file};
 
-            if (root.is(Json::OBJECT))
-            {
-                auto icon_name = root.get("icon");
+            auto &icon_name = manifest.root().get("icon");
 
-                if (icon_name.is(Json::STRING))
-                {
-                    return Graphic::Icon::get(icon_name.as_string());
-                }
+            if (icon_name.is(Json::STRING))
+            {
+                return Graphic::Icon::get(icon_name.as_string());
             }
         }
 
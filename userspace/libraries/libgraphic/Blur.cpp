@@ -0,0 +1,684 @@
+#include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+#include <libgraphic/Blur.h>
+#include <libmath/MinMax.h>
+
+namespace Graphic
+{
+
+static_assert(sizeof(Color) == sizeof(uint32_t), "Pixels are blurred as packed 32bits values");
+
+// Pixels blurred side by side by the box kernel.
+static constexpr int STRIP = 8;
+
+static inline uint32_t pack(Color color)
+{
+    uint32_t packed;
+    memcpy(&packed, &color, sizeof(packed));
+    return packed;
+}
+
+static inline Color unpack(uint32_t packed)
+{
+    Color color;
+    memcpy(&color, &packed, sizeof(color));
+    return color;
+}
+
+/* --- Box kernel ----------------------------------------------------------- */
+
+// Running sums of a line of the strip. The scale is rounded up so a
+// uniform area keeps its exact color after averaging.
+class StripAccumulator
+{
+private:
+#ifdef __SSE2__
+    __m128i _sum[STRIP / 2];
+    __m128i _scale;
+#else
+    uint32_t _sum[STRIP * 4];
+    uint32_t _scale;
+#endif
+
+public:
+    StripAccumulator(int count)
+    {
+#ifdef __SSE2__
+        _scale = _mm_set1_epi16((65536 + count - 1) / count);
+
+        for (int i = 0; i < STRIP / 2; i++)
+        {
+            _sum[i] = _mm_setzero_si128();
+        }
+#else
+        _scale = (65536 + count - 1) / count;
+
+        for (int i = 0; i < STRIP * 4; i++)
+        {
+            _sum[i] = 0;
+        }
+#endif
+    }
+
+    void add(const Color *line)
+    {
+#ifdef __SSE2__
+        __m128i zero = _mm_setzero_si128();
+
+        for (int i = 0; i < STRIP / 4; i++)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(line + i * 4));
+            _sum[i * 2] = _mm_add_epi16(_sum[i * 2], _mm_unpacklo_epi8(pixels, zero));
+            _sum[i * 2 + 1] = _mm_add_epi16(_sum[i * 2 + 1], _mm_unpackhi_epi8(pixels, zero));
+        }
+#else
+        auto bytes = reinterpret_cast<const uint8_t *>(line);
+
+        for (int i = 0; i < STRIP * 4; i++)
+        {
+            _sum[i] += bytes[i];
+        }
+#endif
+    }
+
+    void sub(const Color *line)
+    {
+#ifdef __SSE2__
+        __m128i zero = _mm_setzero_si128();
+
+        for (int i = 0; i < STRIP / 4; i++)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(line + i * 4));
+            _sum[i * 2] = _mm_sub_epi16(_sum[i * 2], _mm_unpacklo_epi8(pixels, zero));
+            _sum[i * 2 + 1] = _mm_sub_epi16(_sum[i * 2 + 1], _mm_unpackhi_epi8(pixels, zero));
+        }
+#else
+        auto bytes = reinterpret_cast<const uint8_t *>(line);
+
+        for (int i = 0; i < STRIP * 4; i++)
+        {
+            _sum[i] -= bytes[i];
+        }
+#endif
+    }
+
+    void average(Color *line)
+    {
+#ifdef __SSE2__
+        for (int i = 0; i < STRIP / 4; i++)
+        {
+            __m128i low = _mm_mulhi_epu16(_sum[i * 2], _scale);
+            __m128i high = _mm_mulhi_epu16(_sum[i * 2 + 1], _scale);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(line + i * 4), _mm_packus_epi16(low, high));
+        }
+#else
+        auto bytes = reinterpret_cast<uint8_t *>(line);
+
+        for (int i = 0; i < STRIP * 4; i++)
+        {
+            bytes[i] = MIN((_sum[i] * _scale) >> 16, 255u);
+        }
+#endif
+    }
+};
+
+// Box blur along a strip with a window of 2 * radius + 1 lines, the edges
+// are repeated.
+static void box_strip(const Color *in, Color *out, int length, int radius)
+{
+    StripAccumulator accumulator{2 * radius + 1};
+
+    int last = length - 1;
+
+    auto line = [](auto *strip, int index) { return strip + index * STRIP; };
+
+    for (int i = 0; i <= radius; i++)
+    {
+        accumulator.add(line(in, 0));
+    }
+
+    for (int i = 1; i <= radius; i++)
+    {
+        accumulator.add(line(in, MIN(i, last)));
+    }
+
+    int x = 0;
+
+    // The window starts before the strip.
+    for (int end = MIN(radius, length); x < end; x++)
+    {
+        accumulator.average(line(out, x));
+        accumulator.add(line(in, MIN(x + radius + 1, last)));
+        accumulator.sub(line(in, 0));
+    }
+
+    // The window is within the strip.
+    for (int end = last - radius; x < end; x++)
+    {
+        accumulator.average(line(out, x));
+        accumulator.add(line(in, x + radius + 1));
+        accumulator.sub(line(in, x - radius));
+    }
+
+    // The window ends after the strip.
+    for (; x < length; x++)
+    {
+        accumulator.average(line(out, x));
+        accumulator.add(line(in, last));
+        accumulator.sub(line(in, MAX(x - radius, 0)));
+    }
+}
+
+// Sizes of the boxes approximating a gaussian of the given standard deviation.
+// From "Fast Almost-Gaussian Filtering", Peter Kovesi.
+static void boxes_for_gaussian(double sigma, int *radii, int count)
+{
+    double ideal = sqrt(12 * sigma * sigma / count + 1);
+
+    int lower = floor(ideal);
+
+    if (lower % 2 == 0)
+    {
+        lower--;
+    }
+
+    int upper = lower + 2;
+
+    double ideal_lower_count = (12 * sigma * sigma - count * lower * lower - 4 * count * lower - 3 * count) / (-4 * lower - 4);
+    int lower_count = round(ideal_lower_count);
+
+    for (int i = 0; i < count; i++)
+    {
+        radii[i] = ((i < lower_count ? lower : upper) - 1) / 2;
+    }
+}
+
+/* --- Strips --------------------------------------------------------------- */
+
+#ifdef __SSE2__
+
+static inline void transpose(__m128i &a, __m128i &b, __m128i &c, __m128i &d)
+{
+    __m128i ab_low = _mm_unpacklo_epi32(a, b);
+    __m128i cd_low = _mm_unpacklo_epi32(c, d);
+    __m128i ab_high = _mm_unpackhi_epi32(a, b);
+    __m128i cd_high = _mm_unpackhi_epi32(c, d);
+
+    a = _mm_unpacklo_epi64(ab_low, cd_low);
+    b = _mm_unpackhi_epi64(ab_low, cd_low);
+    c = _mm_unpacklo_epi64(ab_high, cd_high);
+    d = _mm_unpackhi_epi64(ab_high, cd_high);
+}
+
+#endif
+
+// Rows become the lines of the strip, missing rows repeat the last one.
+static void gather_rows(const Color *image, int stride, int rows, int width, Color *strip)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    if (rows == STRIP)
+    {
+        for (; x + 4 <= width; x += 4)
+        {
+            for (int half = 0; half < STRIP; half += 4)
+            {
+                const Color *in = image + half * stride + x;
+
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + stride));
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + stride * 2));
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + stride * 3));
+
+                transpose(a, b, c, d);
+
+                Color *out = strip + x * STRIP + half;
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), a);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + STRIP), b);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + STRIP * 2), c);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + STRIP * 3), d);
+            }
+        }
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        for (int i = 0; i < STRIP; i++)
+        {
+            strip[x * STRIP + i] = image[MIN(i, rows - 1) * stride + x];
+        }
+    }
+}
+
+static void scatter_rows(const Color *strip, Color *image, int stride, int rows, int width)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    if (rows == STRIP)
+    {
+        for (; x + 4 <= width; x += 4)
+        {
+            for (int half = 0; half < STRIP; half += 4)
+            {
+                const Color *in = strip + x * STRIP + half;
+
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + STRIP));
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + STRIP * 2));
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + STRIP * 3));
+
+                transpose(a, b, c, d);
+
+                Color *out = image + half * stride + x;
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), a);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + stride), b);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + stride * 2), c);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + stride * 3), d);
+            }
+        }
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        for (int i = 0; i < rows; i++)
+        {
+            image[i * stride + x] = strip[x * STRIP + i];
+        }
+    }
+}
+
+// Columns are already laid out as the lines of a strip, missing columns
+// repeat the last one.
+static void gather_columns(const Color *image, int stride, int columns, int height, Color *strip)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const Color *in = image + y * stride;
+        Color *out = strip + y * STRIP;
+
+        memcpy(out, in, columns * sizeof(Color));
+
+        for (int i = columns; i < STRIP; i++)
+        {
+            out[i] = in[columns - 1];
+        }
+    }
+}
+
+static void scatter_columns(const Color *strip, Color *image, int stride, int columns, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        memcpy(image + y * stride, strip + y * STRIP, columns * sizeof(Color));
+    }
+}
+
+/* --- Resampling --------------------------------------------------------- */
+
+// Adds a row to 16bits sums of its channels.
+static void accumulate_row(const Color *row, uint16_t *sums, int width)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+        __m128i *low = reinterpret_cast<__m128i *>(sums + x * 4);
+        __m128i *high = reinterpret_cast<__m128i *>(sums + x * 4 + 8);
+
+        _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(pixels, zero)));
+        _mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(pixels, zero)));
+    }
+#endif
+
+    auto bytes = reinterpret_cast<const uint8_t *>(row);
+
+    for (; x < width; x++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            sums[x * 4 + i] += bytes[x * 4 + i];
+        }
+    }
+}
+
+// Average of the sums of a block of pixels, the count is a power of two.
+static inline Color block_average(const uint16_t *sums, const int *indexes, int count, int shift)
+{
+#ifdef __SSE2__
+    __m128i total = _mm_set1_epi16(1 << (shift - 1));
+
+    for (int i = 0; i < count; i++)
+    {
+        total = _mm_add_epi16(total, _mm_loadl_epi64(reinterpret_cast<const __m128i *>(sums + indexes[i] * 4)));
+    }
+
+    total = _mm_srli_epi16(total, shift);
+    return unpack(_mm_cvtsi128_si32(_mm_packus_epi16(total, total)));
+#else
+    uint32_t total[4] = {};
+
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            total[j] += sums[indexes[i] * 4 + j];
+        }
+    }
+
+    int round = 1 << (shift - 1);
+
+    return Color::from_rgba_byte(
+        (total[0] + round) >> shift,
+        (total[1] + round) >> shift,
+        (total[2] + round) >> shift,
+        (total[3] + round) >> shift);
+#endif
+}
+
+// Linear interpolation of a row of pixels, the weight goes from 0 to 256.
+static void lerp_row(const Color *from, const Color *to, Color *out, int width, int weight)
+{
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i from_weight = _mm_set1_epi16(256 - weight);
+    __m128i to_weight = _mm_set1_epi16(weight);
+
+    // 255 * 256 still fits in an unsigned 16bits lane.
+    auto lerp = [&](__m128i a, __m128i b) {
+        return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, from_weight), _mm_mullo_epi16(b, to_weight)), 8);
+    };
+
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(from + x));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(to + x));
+
+        __m128i low = lerp(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i high = lerp(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        out[x] = Color::from_rgba_byte(
+            (from[x].red() * (256 - weight) + to[x].red() * weight) >> 8,
+            (from[x].green() * (256 - weight) + to[x].green() * weight) >> 8,
+            (from[x].blue() * (256 - weight) + to[x].blue() * weight) >> 8,
+            (from[x].alpha() * (256 - weight) + to[x].alpha() * weight) >> 8);
+    }
+}
+
+// Stretches a row by an even factor, pixel centers of the input are at
+// (x + 0.5) * factor - 0.5 in the output which is width * factor long.
+static void expand_row(const Color *in, Color *out, int width, int factor)
+{
+    int half = factor / 2;
+
+    for (int x = 0; x < half; x++)
+    {
+        out[x] = in[0];
+        out[width * factor - half + x] = in[width - 1];
+    }
+
+    out += half;
+
+    for (int x = 0; x + 1 < width; x++)
+    {
+        Color *run = out + x * factor;
+
+#ifdef __SSE2__
+        // Both pixels are repeated so two outputs are interpolated at once.
+        __m128i zero = _mm_setzero_si128();
+        __m128i a = _mm_unpacklo_epi8(_mm_set1_epi32(pack(in[x])), zero);
+        __m128i b = _mm_unpacklo_epi8(_mm_set1_epi32(pack(in[x + 1])), zero);
+
+        for (int i = 0; i < factor; i += 2)
+        {
+            int first = (i * 2 + 1) * 128 / factor;
+            int second = (i * 2 + 3) * 128 / factor;
+
+            __m128i to_weight = _mm_set_epi16(second, second, second, second, first, first, first, first);
+            __m128i from_weight = _mm_sub_epi16(_mm_set1_epi16(256), to_weight);
+
+            __m128i result = _mm_add_epi16(_mm_mullo_epi16(a, from_weight), _mm_mullo_epi16(b, to_weight));
+            result = _mm_srli_epi16(result, 8);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(run + i), _mm_packus_epi16(result, result));
+        }
+#else
+        for (int i = 0; i < factor; i++)
+        {
+            lerp_row(in + x, in + x + 1, run + i, 1, (i * 2 + 1) * 128 / factor);
+        }
+#endif
+    }
+}
+
+/* --- Blur ----------------------------------------------------------------- */
+
+Blur::Blur(Bitmap &bitmap, Math::Recti rectangle, int radius, int bands)
+    : _pixels{bitmap.pixels()},
+      _stride{bitmap.width()},
+      _rectangle{rectangle.clipped_with(bitmap.bound())},
+      _bands{MAX(bands, 1)}
+{
+    while (radius / _factor > MAX_DIRECT_RADIUS && _factor < MAX_FACTOR)
+    {
+        _factor *= 2;
+    }
+
+    radius = MIN(radius, MAX_DIRECT_RADIUS * _factor);
+
+    _width = (_rectangle.width() + _factor - 1) / _factor;
+    _height = (_rectangle.height() + _factor - 1) / _factor;
+
+    if (_width == 0 || _height == 0)
+    {
+        _bands = 0;
+        return;
+    }
+
+    boxes_for_gaussian(radius / 2.0 / _factor, _radii, PASSES);
+
+    if (_factor > 1)
+    {
+        _downsampled = new Color[_width * _height];
+        _image = _downsampled;
+        _image_stride = _width;
+    }
+    else
+    {
+        _image = source_row(0);
+        _image_stride = _stride;
+    }
+
+    // Resampling also needs a row of 16bits sums or a stretched row.
+    _strip_size = MAX(MAX(_width, _height) * STRIP, _width * _factor * 2);
+    _strips = new Color[_bands * 2 * _strip_size];
+}
+
+Blur::~Blur()
+{
+    delete[] _downsampled;
+    delete[] _strips;
+}
+
+Color *Blur::box_passes(int band, int length)
+{
+    Color *buffers[2] = {strip(band, 0), strip(band, 1)};
+    int current = 0;
+
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        if (_radii[pass] > 0)
+        {
+            box_strip(buffers[current], buffers[!current], length, _radii[pass]);
+            current = !current;
+        }
+    }
+
+    return buffers[current];
+}
+
+// Average blocks of factor * factor pixels, pixels past the rectangle
+// repeat its edges.
+void Blur::downsample(int band)
+{
+    int begin = _height * band / _bands;
+    int end = _height * (band + 1) / _bands;
+
+    int width = _rectangle.width();
+    int last_y = _rectangle.height() - 1;
+
+    auto sums = reinterpret_cast<uint16_t *>(strip(band, 0));
+    int *indexes = reinterpret_cast<int *>(strip(band, 1));
+
+    int shift = 0;
+
+    while ((1 << shift) < _factor * _factor)
+    {
+        shift++;
+    }
+
+    for (int y = begin; y < end; y++)
+    {
+        memset(sums, 0, width * 4 * sizeof(uint16_t));
+
+        for (int j = 0; j < _factor; j++)
+        {
+            accumulate_row(source_row(MIN(y * _factor + j, last_y)), sums, width);
+        }
+
+        for (int x = 0; x < _width; x++)
+        {
+            for (int i = 0; i < _factor; i++)
+            {
+                indexes[i] = MIN(x * _factor + i, width - 1);
+            }
+
+            _downsampled[y * _width + x] = block_average(sums, indexes, _factor, shift);
+        }
+    }
+}
+
+void Blur::horizontal(int band)
+{
+    int strips = (_height + STRIP - 1) / STRIP;
+    int begin = strips * band / _bands;
+    int end = strips * (band + 1) / _bands;
+
+    for (int i = begin; i < end; i++)
+    {
+        Color *rows = _image + i * STRIP * _image_stride;
+        int count = MIN(STRIP, _height - i * STRIP);
+
+        gather_rows(rows, _image_stride, count, _width, strip(band, 0));
+        scatter_rows(box_passes(band, _width), rows, _image_stride, count, _width);
+    }
+}
+
+void Blur::vertical(int band)
+{
+    int strips = (_width + STRIP - 1) / STRIP;
+    int begin = strips * band / _bands;
+    int end = strips * (band + 1) / _bands;
+
+    for (int i = begin; i < end; i++)
+    {
+        Color *columns = _image + i * STRIP;
+        int count = MIN(STRIP, _width - i * STRIP);
+
+        gather_columns(columns, _image_stride, count, _height, strip(band, 0));
+        scatter_columns(box_passes(band, _height), columns, _image_stride, count, _height);
+    }
+}
+
+// Bilinear upsampling, pixel centers of the downsampled image are at
+// (y + 0.5) * factor - 0.5 in the rectangle.
+void Blur::upsample(int band)
+{
+    int begin = _rectangle.height() * band / _bands;
+    int end = _rectangle.height() * (band + 1) / _bands;
+
+    Color *row = strip(band, 0);
+    Color *stretched = strip(band, 1);
+
+    for (int y = begin; y < end; y++)
+    {
+        int fixed = MAX(((2 * y + 1) * 128) / _factor - 128, 0);
+
+        int top = MIN(fixed >> 8, _height - 1);
+        int bottom = MIN(top + 1, _height - 1);
+
+        lerp_row(_downsampled + top * _width, _downsampled + bottom * _width, row, _width, fixed & 0xff);
+        expand_row(row, stretched, _width, _factor);
+
+        memcpy(source_row(y), stretched, _rectangle.width() * sizeof(Color));
+    }
+}
+
+void Blur::run(int stage, int band)
+{
+    if (band >= _bands)
+    {
+        return;
+    }
+
+    if (_factor == 1)
+    {
+        // Blurred in place, there is nothing to resample.
+        stage++;
+    }
+
+    switch (stage)
+    {
+    case 0:
+        downsample(band);
+        break;
+
+    case 1:
+        horizontal(band);
+        break;
+
+    case 2:
+        vertical(band);
+        break;
+
+    case 3:
+        upsample(band);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Blur::run()
+{
+    for (int stage = 0; stage < stages(); stage++)
+    {
+        for (int band = 0; band < _bands; band++)
+        {
+            run(stage, band);
+        }
+    }
+}
+
+} // namespace Graphic
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <libgraphic/Bitmap.h>
+#include <libmath/Rect.h>
+#include <libsystem/Macros.h>
+
+namespace Graphic
+{
+
+// Gaussian blur approximated by three successive box blurs, the radius
+// covers about two standard deviations. Both directions are blurred by the
+// same kernel sliding along strips of 8 pixels: rows are transposed into
+// strips, columns are copied. Large radii are blurred on a downsampled copy
+// which is then upsampled bilinearly.
+//
+// The work is split in stages made of independent bands. Every band of a
+// stage must be done before the next stage starts, but the bands of a
+// stage can run concurrently:
+//
+//     Blur blur{bitmap, rectangle, radius, workers};
+//
+//     for (int stage = 0; stage < blur.stages(); stage++)
+//     {
+//         // for each band in parallel:
+//         blur.run(stage, band);
+//     }
+//
+class Blur
+{
+private:
+    static constexpr int PASSES = 3;
+
+    // Above this radius the image is blurred at a lower resolution, this
+    // also keeps the sums of a box within 16bits.
+    static constexpr int MAX_DIRECT_RADIUS = 16;
+
+    // Keeps the sums of a downsampled block within 16bits, larger radii
+    // are clamped.
+    static constexpr int MAX_FACTOR = 16;
+
+    Color *_pixels;
+    int _stride;
+    Math::Recti _rectangle;
+
+    int _bands;
+    int _factor = 1;
+    int _radii[PASSES] = {};
+
+    // Image being blurred, the rectangle of the bitmap or its downsampled copy.
+    Color *_image;
+    int _image_stride;
+    int _width;
+    int _height;
+
+    Color *_downsampled = nullptr;
+    Color *_strips = nullptr;
+    int _strip_size = 0;
+
+    Color *strip(int band, int index) { return _strips + (band * 2 + index) * _strip_size; }
+
+    Color *source_row(int y) { return _pixels + (_rectangle.y() + y) * _stride + _rectangle.x(); }
+
+    // Blurs the gathered strip in place, returns the buffer holding the result.
+    Color *box_passes(int band, int length);
+
+    void downsample(int band);
+
+    void horizontal(int band);
+
+    void vertical(int band);
+
+    void upsample(int band);
+
+public:
+    NONCOPYABLE(Blur);
+    NONMOVABLE(Blur);
+
+    Blur(Bitmap &bitmap, Math::Recti rectangle, int radius, int bands = 1);
+
+    ~Blur();
+
+    int bands() const { return _bands; }
+
+    int stages() const { return _factor > 1 ? 4 : 2; }
+
+    void run(int stage, int band);
+
+    // Run every stage and band on the calling thread.
+    void run();
+};
+
+} // namespace Graphic
@@ -1,9 +1,9 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <libgraphic/Blur.h>
 #include <libgraphic/Font.h>
 #include <libgraphic/Painter.h>
-#include <libgraphic/StackBlur.h>
 #include <libutils/Assert.h>
 #include <libutils/Random.h>
 
@@ -621,12 +621,13 @@ FLATTEN void Painter::blur(Math::Recti rectangle, int radius)
 {
     rectangle = apply(rectangle);
 
-    stackblur((unsigned char *)_bitmap->pixels(),
-              _bitmap->width(),
-              _bitmap->height(),
-              radius,
-              rectangle.x(), rectangle.x() + rectangle.width(),
-              rectangle.y(), rectangle.y() + rectangle.height());
+    if (rectangle.is_empty() || radius <= 0)
+    {
+        return;
+    }
+
+    Blur blur{*_bitmap, rectangle, radius};
+    blur.run();
 }
 
 FLATTEN void Painter::saturation(Math::Recti rectangle, float value)
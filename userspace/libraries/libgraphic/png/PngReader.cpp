@@ -1,3 +1,10 @@
+#include <string.h>
+
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+#include <libcompression/CRC.h>
 #include <libcompression/Inflate.h>
 #include <libgraphic/png/PngReader.h>
 #include <libio/CRCReader.h>
@@ -17,6 +24,237 @@ PngReader::PngReader(IO::Reader &reader) : _reader(reader)
     _valid = read() == Result::SUCCESS;
 }
 
+// Adam7 passes, see https://www.w3.org/TR/2003/REC-PNG-20031110/#8Interlace
+// A non interlaced image is decoded as a single pass covering every pixel.
+struct Pass
+{
+    size_t start_x;
+    size_t start_y;
+    size_t step_x;
+    size_t step_y;
+};
+
+static constexpr Pass NON_INTERLACED_PASS = {0, 0, 1, 1};
+
+static constexpr Pass ADAM7_PASSES[] = {
+    {0, 0, 8, 8},
+    {4, 0, 8, 8},
+    {0, 4, 4, 8},
+    {2, 0, 4, 4},
+    {0, 2, 2, 4},
+    {1, 0, 2, 2},
+    {0, 1, 1, 2},
+};
+
+// Reads the zlib stream spread over consecutive IDAT chunks straight from the
+// underlying reader, validating the checksum of each chunk along the way.
+class PngReader::ImageDataReader :
+    public IO::Reader
+{
+private:
+    IO::Reader &_reader;
+    size_t _remaining;
+    Compression::CRC _crc;
+    bool _end = false;
+
+    be_uint32_t _next_length;
+    be_uint32_t _next_signature;
+
+    Result next_chunk()
+    {
+        auto crc = TRY(IO::read<be_uint32_t>(_reader));
+
+        if (crc() != _crc.checksum())
+        {
+            logger_error("Chunk checksum validation failed");
+            return Result::ERR_INVALID_DATA;
+        }
+
+        _next_length = TRY(IO::read<be_uint32_t>(_reader));
+        _next_signature = TRY(IO::read<be_uint32_t>(_reader));
+
+        if (_next_signature() != Png::ImageData::SIG)
+        {
+            _end = true;
+            return Result::SUCCESS;
+        }
+
+        _remaining = _next_length();
+        _crc = {};
+        _crc.add(reinterpret_cast<const uint8_t *>(&_next_signature), sizeof(_next_signature));
+
+        return Result::SUCCESS;
+    }
+
+public:
+    be_uint32_t next_length() { return _next_length; }
+
+    be_uint32_t next_signature() { return _next_signature; }
+
+    ImageDataReader(IO::Reader &reader, size_t length, uint32_t crc)
+        : _reader{reader}, _remaining{length}, _crc{crc}
+    {
+    }
+
+    ResultOr<size_t> read(void *buffer, size_t size) override
+    {
+        while (_remaining == 0 && !_end)
+        {
+            TRY(next_chunk());
+        }
+
+        if (_end)
+        {
+            return 0;
+        }
+
+        size_t result = TRY(_reader.read(buffer, MIN(size, _remaining)));
+
+        if (result == 0)
+        {
+            return Result::ERR_INVALID_DATA;
+        }
+
+        _crc.add(reinterpret_cast<const uint8_t *>(buffer), result);
+        _remaining -= result;
+
+        return result;
+    }
+
+    // Skip what is left of the image data (usually the adler32 checksum)
+    // and position the reader at the start of the next chunk.
+    Result finish()
+    {
+        uint8_t discard[64];
+
+        while (!_end)
+        {
+            TRY(read(discard, sizeof(discard)));
+        }
+
+        return Result::SUCCESS;
+    }
+};
+
+// Receives the decompressed image data and unfilters it one scanline at a
+// time, converted pixels are written directly at their place in the image.
+class PngReader::ScanlineWriter :
+    public IO::Writer
+{
+private:
+    PngReader &_png;
+
+    size_t _bytewidth;
+    size_t _pass_index = 0;
+    size_t _pass_count;
+
+    size_t _width = 0;
+    size_t _height = 0;
+    size_t _linebytes = 0;
+    size_t _y = 0;
+
+    Vector<uint8_t> _scanline;
+    Vector<uint8_t> _previous;
+    size_t _filled = 0;
+
+    Result _result = Result::SUCCESS;
+
+    const Pass &pass()
+    {
+        return _png._interlaced ? ADAM7_PASSES[_pass_index] : NON_INTERLACED_PASS;
+    }
+
+    void begin_pass()
+    {
+        // Empty passes (small images) don't have any scanline, not even a filter byte.
+        while (_pass_index < _pass_count)
+        {
+            auto &p = pass();
+
+            _width = _png._width > p.start_x ? (_png._width - p.start_x + p.step_x - 1) / p.step_x : 0;
+            _height = _png._height > p.start_y ? (_png._height - p.start_y + p.step_y - 1) / p.step_y : 0;
+
+            if (_width > 0 && _height > 0)
+            {
+                break;
+            }
+
+            _pass_index++;
+        }
+
+        _linebytes = (_width * _png.bits_per_pixel() + 7u) / 8u;
+        _y = 0;
+        _filled = 0;
+
+        // The first scanline of each pass is unfiltered against a line of zeros.
+        memset(_previous.raw_storage(), 0, _previous.count());
+    }
+
+    Result flush_scanline()
+    {
+        auto &p = pass();
+
+        uint8_t *scanline = _scanline.raw_storage();
+        uint8_t *previous = _previous.raw_storage();
+
+        TRY(_png.unfilter_scanline(scanline + 1, scanline + 1, previous, _bytewidth, (Png::FilterType)scanline[0], _linebytes));
+
+        Color *out = &_png._pixels[(p.start_y + _y * p.step_y) * _png._width + p.start_x];
+        TRY(_png.convert(scanline + 1, _width, out, p.step_x));
+
+        memcpy(previous, scanline + 1, _linebytes);
+        _y++;
+
+        if (_y == _height)
+        {
+            _pass_index++;
+            begin_pass();
+        }
+
+        return Result::SUCCESS;
+    }
+
+public:
+    bool done() { return _pass_index >= _pass_count; }
+
+    ScanlineWriter(PngReader &png)
+        : _png{png},
+          _bytewidth{(png.bits_per_pixel() + 7u) / 8u},
+          _pass_count{png._interlaced ? AERAY_LENGTH(ADAM7_PASSES) : 1}
+    {
+        size_t max_linebytes = (_png._width * _png.bits_per_pixel() + 7u) / 8u;
+
+        _scanline.resize(max_linebytes + 1);
+        _previous.resize(max_linebytes);
+
+        begin_pass();
+    }
+
+    ResultOr<size_t> write(const void *buffer, size_t size) override
+    {
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(buffer);
+        size_t written = 0;
+
+        while (written < size && !done())
+        {
+            size_t to_copy = MIN(size - written, _linebytes + 1 - _filled);
+            memcpy(_scanline.raw_storage() + _filled, data + written, to_copy);
+
+            _filled += to_copy;
+            written += to_copy;
+
+            if (_filled == _linebytes + 1)
+            {
+                _filled = 0;
+                TRY(flush_scanline());
+            }
+        }
+
+        // Trailing data after the last scanline is ignored.
+        return size;
+    }
+};
+
 Result PngReader::read()
 {
     Array<uint8_t, 8> signature;
@@ -29,36 +267,62 @@ Result PngReader::read()
         return Result::ERR_INVALID_DATA;
     }
 
-    TRY(read_chunks());
-
-    IO::MemoryWriter uncompressed_writer;
-    TRY(uncompress(uncompressed_writer));
-    uint8_t *scanlines = uncompressed_writer.buffer();
-
-    // Unfilter the scanlines
-    size_t out_size = _width * _height * num_channels() * bytes_per_pixel();
-    uint8_t *raw_buffer = new uint8_t[out_size];
-    memset(raw_buffer, 0, out_size);
-    TRY(unfilter(raw_buffer, scanlines));
-
-    TRY(convert(raw_buffer));
-    delete[] raw_buffer;
-
-    return Result::SUCCESS;
+    return read_chunks();
 }
 
 Result PngReader::read_chunks()
 {
-    size_t idat_counter = 0;
+    bool image_decoded = false;
     bool end = false;
-    uint32_t prev_signature = 0;
+
+    auto chunk_length = TRY(IO::read<be_uint32_t>(_reader));
+    auto chunk_signature = TRY(IO::read<be_uint32_t>(_reader));
+
     while (!end)
     {
-        auto chunk_length = TRY(IO::read<be_uint32_t>(_reader));
         // CRC checksum includes the chunk signature and chunk data
         // See https://www.w3.org/TR/2003/REC-PNG-20031110/#5Introduction
-        IO::CRCReader crc_reader(_reader);
-        auto chunk_signature = TRY(IO::read<be_uint32_t>(crc_reader));
+        Compression::CRC signature_crc;
+        signature_crc.add(reinterpret_cast<const uint8_t *>(&chunk_signature), sizeof(chunk_signature));
+
+        if (chunk_signature() == Png::ImageData::SIG)
+        {
+            // All the IDAT chunks are consumed at once, streamed through inflate and unfiltered.
+            if (image_decoded)
+            {
+                logger_error("Multiple iDat chunks must be subsequent");
+                return Result::ERR_INVALID_DATA;
+            }
+
+            if (_width == 0 || _height == 0)
+            {
+                logger_error("Image data before the image header");
+                return Result::ERR_INVALID_DATA;
+            }
+
+            _pixels.resize(_width * _height);
+
+            ImageDataReader image_data_reader{_reader, chunk_length(), signature_crc.checksum()};
+            ScanlineWriter scanline_writer{*this};
+
+            TRY(uncompress(image_data_reader, scanline_writer));
+            TRY(image_data_reader.finish());
+
+            if (!scanline_writer.done())
+            {
+                logger_error("Image data is truncated");
+                return Result::ERR_INVALID_DATA;
+            }
+
+            image_decoded = true;
+
+            chunk_length = image_data_reader.next_length();
+            chunk_signature = image_data_reader.next_signature();
+
+            continue;
+        }
+
+        IO::CRCReader crc_reader(_reader, signature_crc.checksum());
         IO::ScopedReader scoped_reader(crc_reader, chunk_length());
 
         switch (chunk_signature())
@@ -69,13 +333,14 @@ Result PngReader::read_chunks()
             _width = image_header.width();
             _height = image_header.height();
 
-            // We don't support ADAM7 yet
-            if (image_header.interlace_method() != 0)
+            if (image_header.interlace_method() > 1)
             {
                 logger_error("Unsupported interlace method: %u", image_header.interlace_method());
                 return Result::ERR_NOT_IMPLEMENTED;
             }
 
+            _interlaced = image_header.interlace_method() == 1;
+
             // Same for bit depth
             if (image_header.bit_depth() != 8)
             {
@@ -171,21 +436,6 @@ Result PngReader::read_chunks()
         }
         break;
 
-        case Png::ImageData::SIG:
-        {
-            // The first chunk begins with the compression method
-            if (idat_counter > 0 && prev_signature != Png::ImageData::SIG)
-            {
-                logger_error("Multiple iDat chunks must be subsequent");
-                return Result::ERR_INVALID_DATA;
-            }
-
-            // Read the data for this chunk into our concatenated compressed data
-            TRY(IO::copy(scoped_reader, _idat_writer));
-            idat_counter++;
-        }
-        break;
-
         case Png::TextualData::SIG:
         {
             Vector<uint8_t> data;
@@ -218,35 +468,18 @@ Result PngReader::read_chunks()
             logger_error("Chunk checksum validation failed");
             return Result::ERR_INVALID_DATA;
         }
-        prev_signature = chunk_signature();
-    }
-
-    return Result::SUCCESS;
-}
-
-// Copyright (c) 2005-2020 Lode Vandevenne
-Result PngReader::unfilter(uint8_t *out, uint8_t *in)
-{
-    // For PNG filter method 0
-    // this function unfilters a single image (e.g. without interlacing this is called once, with Adam7 seven times)
-    // out must have enough bytes allocated already, in must have the scanlines + 1 filter_type byte per scanline
-    // w and h are image dimensions or dimensions of reduced image, bpp is bits per pixel
-    // in and out are allowed to be the same memory address (but aren't the same size since in has the extra filter bytes)
-    uint8_t *prevline = 0;
 
-    // bytewidth is used for filtering, is 1 when bpp < 8, number of bytes per pixel otherwise
-    size_t bytewidth = (bits_per_pixel() + 7u) / 8u;
-    size_t linebytes = (_width * bits_per_pixel() + 7u) / 8u;
+        if (!end)
+        {
+            chunk_length = TRY(IO::read<be_uint32_t>(_reader));
+            chunk_signature = TRY(IO::read<be_uint32_t>(_reader));
+        }
+    }
 
-    for (uint32_t y = 0; y < _height; ++y)
+    if (!image_decoded)
     {
-        size_t outindex = linebytes * y;
-        size_t inindex = (1 + linebytes) * y; /*the extra filterbyte added to each row*/
-        Png::FilterType filter_type = (Png::FilterType)in[inindex];
-
-        TRY(unfilter_scanline(&out[outindex], &in[inindex + 1], prevline, bytewidth, filter_type, linebytes));
-
-        prevline = &out[outindex];
+        logger_error("Missing image data");
+        return Result::ERR_INVALID_DATA;
     }
 
     return Result::SUCCESS;
@@ -271,6 +504,148 @@ static uint8_t paeth_predictor(int16_t a, int16_t b, int16_t c)
     return (pc < pa) ? c : a;
 }
 
+#ifdef __SSE2__
+
+// SSE2 unfiltering for 3 and 4 bytes pixels (RGB and RGBA), each pixel depends
+// on the one before it, so we work on one pixel at a time but on all its
+// channels at once.
+
+template <size_t BYTEWIDTH>
+static inline __m128i load_pixel(const uint8_t *p)
+{
+    int value = 0;
+    memcpy(&value, p, BYTEWIDTH);
+    return _mm_cvtsi32_si128(value);
+}
+
+template <size_t BYTEWIDTH>
+static inline void store_pixel(uint8_t *p, __m128i pixel)
+{
+    int value = _mm_cvtsi128_si32(pixel);
+    memcpy(p, &value, BYTEWIDTH);
+}
+
+template <size_t BYTEWIDTH>
+static void unfilter_sub_sse2(uint8_t *recon, const uint8_t *scanline, size_t length)
+{
+    __m128i a = _mm_setzero_si128();
+
+    for (size_t i = 0; i + BYTEWIDTH <= length; i += BYTEWIDTH)
+    {
+        a = _mm_add_epi8(a, load_pixel<BYTEWIDTH>(scanline + i));
+        store_pixel<BYTEWIDTH>(recon + i, a);
+    }
+}
+
+static void unfilter_up_sse2(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, size_t length)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(scanline + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(precon + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(recon + i), _mm_add_epi8(x, b));
+    }
+
+    for (; i < length; i++)
+    {
+        recon[i] = scanline[i] + precon[i];
+    }
+}
+
+template <size_t BYTEWIDTH>
+static void unfilter_average_sse2(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, size_t length)
+{
+    const __m128i ones = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+
+    for (size_t i = 0; i + BYTEWIDTH <= length; i += BYTEWIDTH)
+    {
+        __m128i b = load_pixel<BYTEWIDTH>(precon + i);
+        __m128i x = load_pixel<BYTEWIDTH>(scanline + i);
+
+        // _mm_avg_epu8 rounds up, the filter rounds down.
+        __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), ones));
+
+        a = _mm_add_epi8(x, average);
+        store_pixel<BYTEWIDTH>(recon + i, a);
+    }
+}
+
+static inline __m128i abs_epi16(__m128i x)
+{
+    return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+static inline __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+template <size_t BYTEWIDTH>
+static void unfilter_paeth_sse2(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, size_t length)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    // Channels are widened to 16 bits to compute the predictor without overflow.
+    __m128i a = zero;
+    __m128i c = zero;
+
+    for (size_t i = 0; i + BYTEWIDTH <= length; i += BYTEWIDTH)
+    {
+        __m128i b = _mm_unpacklo_epi8(load_pixel<BYTEWIDTH>(precon + i), zero);
+        __m128i x = _mm_unpacklo_epi8(load_pixel<BYTEWIDTH>(scanline + i), zero);
+
+        __m128i pa = _mm_sub_epi16(b, c);
+        __m128i pb = _mm_sub_epi16(a, c);
+        __m128i pc = _mm_add_epi16(pa, pb);
+
+        pa = abs_epi16(pa);
+        pb = abs_epi16(pb);
+        pc = abs_epi16(pc);
+
+        // Ties are broken in favor of a, then b, then c.
+        __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        __m128i predictor = select(_mm_cmpeq_epi16(smallest, pa), a, select(_mm_cmpeq_epi16(smallest, pb), b, c));
+
+        // The high bytes are zero, adding bytes wraps the low ones like the scalar filter.
+        x = _mm_add_epi8(x, predictor);
+        store_pixel<BYTEWIDTH>(recon + i, _mm_packus_epi16(x, x));
+
+        a = x;
+        c = b;
+    }
+}
+
+template <size_t BYTEWIDTH>
+static bool unfilter_scanline_sse2(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon, Png::FilterType filter_type, size_t length)
+{
+    switch (filter_type)
+    {
+    case Png::FT_SUB:
+        unfilter_sub_sse2<BYTEWIDTH>(recon, scanline, length);
+        return true;
+
+    case Png::FT_UP:
+        unfilter_up_sse2(recon, scanline, precon, length);
+        return true;
+
+    case Png::FT_AVERAGE:
+        unfilter_average_sse2<BYTEWIDTH>(recon, scanline, precon, length);
+        return true;
+
+    case Png::FT_PAETH:
+        unfilter_paeth_sse2<BYTEWIDTH>(recon, scanline, precon, length);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+#endif
+
 // Copyright (c) 2005-2020 Lode Vandevenne
 Result PngReader::unfilter_scanline(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
                                     size_t bytewidth, Png::FilterType filter_type, size_t length)
@@ -283,6 +658,21 @@ Result PngReader::unfilter_scanline(uint8_t *recon, const uint8_t *scanline, con
     // recon and scanline MAY be the same memory address! precon must be disjoint.
     size_t i;
 
+#ifdef __SSE2__
+    if (precon && length % bytewidth == 0)
+    {
+        if (bytewidth == 3 && unfilter_scanline_sse2<3>(recon, scanline, precon, filter_type, length))
+        {
+            return Result::SUCCESS;
+        }
+
+        if (bytewidth == 4 && unfilter_scanline_sse2<4>(recon, scanline, precon, filter_type, length))
+        {
+            return Result::SUCCESS;
+        }
+    }
+#endif
+
     switch (filter_type)
     {
     case Png::FT_NONE:
@@ -398,10 +788,8 @@ Result PngReader::unfilter_scanline(uint8_t *recon, const uint8_t *scanline, con
     return Result::SUCCESS;
 }
 
-Result PngReader::uncompress(IO::MemoryWriter &uncompressed_writer)
+Result PngReader::uncompress(IO::Reader &compressed_reader, IO::Writer &uncompressed_writer)
 {
-    IO::MemoryReader compressed_reader(Slice(_idat_writer.slice()));
-
     // Two bytes before the actual deflate data
     // See https://www.w3.org/TR/2003/REC-PNG-20031110/#10Compression
     auto cm_cinfo = TRY(IO::read<uint8_t>(compressed_reader));
@@ -428,41 +816,39 @@ Result PngReader::uncompress(IO::MemoryWriter &uncompressed_writer)
     return inflate.perform(compressed_reader, uncompressed_writer).result();
 }
 
-Result PngReader::convert(uint8_t *buffer)
+Result PngReader::convert(const uint8_t *buffer, size_t count, Color *out, size_t stride)
 {
-    _pixels.resize(_width * _height);
-
     switch (_colour_type)
     {
     case Png::CT_RGBA:
-        for (size_t i = 0; i < _width * _height; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            _pixels[i] = Color::from_rgba_byte(buffer[i * 4],
-                                               buffer[i * 4 + 1],
-                                               buffer[i * 4 + 2],
-                                               buffer[i * 4 + 3]);
+            out[i * stride] = Color::from_rgba_byte(buffer[i * 4],
+                                                    buffer[i * 4 + 1],
+                                                    buffer[i * 4 + 2],
+                                                    buffer[i * 4 + 3]);
         }
         break;
     case Png::CT_RGB:
-        for (size_t i = 0; i < _width * _height; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            _pixels[i] = Color::from_rgb_byte(buffer[i * 3],
-                                              buffer[i * 3 + 1],
-                                              buffer[i * 3 + 2]);
+            out[i * stride] = Color::from_rgb_byte(buffer[i * 3],
+                                                   buffer[i * 3 + 1],
+                                                   buffer[i * 3 + 2]);
         }
         break;
 
     case Png::CT_GREY:
-        for (size_t i = 0; i < _width * _height; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            _pixels[i] = Color::from_monochrome_byte(buffer[i]);
+            out[i * stride] = Color::from_monochrome_byte(buffer[i]);
         }
         break;
     case Png::CT_GREY_ALPHA:
-        for (size_t i = 0; i < _width * _height; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            _pixels[i] = Color::from_monochrome_alpha_byte(buffer[i * 2],
-                                                           buffer[i * 2 + 1]);
+            out[i * stride] = Color::from_monochrome_alpha_byte(buffer[i * 2],
+                                                                buffer[i * 2 + 1]);
         }
         break;
     case Png::CT_PALETTE:
@@ -472,9 +858,15 @@ Result PngReader::convert(uint8_t *buffer)
             return Result::ERR_INVALID_DATA;
         }
 
-        for (size_t i = 0; i < _width * _height; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            _pixels[i] = _palette[buffer[i]];
+            if (buffer[i] >= _palette.count())
+            {
+                logger_error("Palette index out of range");
+                return Result::ERR_INVALID_DATA;
+            }
+
+            out[i * stride] = _palette[buffer[i]];
         }
         break;
     default:
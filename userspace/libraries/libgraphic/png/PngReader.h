@@ -4,8 +4,8 @@
 
 #include <libgraphic/Color.h>
 #include <libgraphic/png/PngCommon.h>
-#include <libio/MemoryWriter.h>
 #include <libio/Reader.h>
+#include <libio/Writer.h>
 #include <libutils/Vector.h>
 
 namespace Graphic
@@ -21,14 +21,16 @@ private:
     Vector<Color> _palette;
     DateTime _modified;
     Png::ColourType _colour_type;
+    bool _interlaced = false;
     IO::Reader &_reader;
-    IO::MemoryWriter _idat_writer;
 
-    Result uncompress(IO::MemoryWriter &uncompressed_writer);
-    Result unfilter(uint8_t *in, uint8_t *out);
+    class ImageDataReader;
+    class ScanlineWriter;
+
+    Result uncompress(IO::Reader &compressed_reader, IO::Writer &uncompressed_writer);
     Result unfilter_scanline(uint8_t *recon, const uint8_t *scanline, const uint8_t *precon,
                              size_t bytewidth, Png::FilterType filterType, size_t length);
-    Result convert(uint8_t *data);
+    Result convert(const uint8_t *data, size_t count, Color *out, size_t stride);
     Result read_chunks();
 
     Result read();
@@ -38,6 +38,22 @@ public:
         return _handle->write(buffer, size);
     }
 
+    ResultOr<size_t> readv(const IOVec *vectors, size_t count) override
+    {
+        if (!_handle)
+            return ERR_STREAM_CLOSED;
+
+        return _handle->readv(vectors, count);
+    }
+
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count) override
+    {
+        if (!_handle)
+            return ERR_STREAM_CLOSED;
+
+        return _handle->writev(vectors, count);
+    }
+
     bool closed()
     {
         return _handle == nullptr;
@@ -4,8 +4,11 @@
 #include <libutils/Slice.h>
 #include <libutils/Vector.h>
 
+#include <libio/Handle.h>
 #include <libio/MemoryReader.h>
 #include <libio/MemoryWriter.h>
+#include <libio/Scanner.h>
+#include <libio/Write.h>
 
 namespace IO
 {
@@ -64,6 +67,60 @@ static inline Result copy(Reader &from, Writer &to)
     } while (1);
 }
 
+// Bytes moved by a single splice syscall, bounds the time both handles stay
+// locked in the kernel.
+constexpr size_t SPLICE_CHUNK_SIZE = 1024 * 1024;
+
+template <typename T>
+concept HandleReader = IsBaseOf<Reader, T>::value &&IsBaseOf<RawHandle, T>::value;
+
+template <typename T>
+concept HandleWriter = IsBaseOf<Writer, T>::value &&IsBaseOf<RawHandle, T>::value;
+
+// Between two handles the data is moved by the kernel, whatever it refuses to
+// move is copied by chunks instead.
+template <HandleReader TReader, HandleWriter TWriter>
+static inline Result copy(TReader &from, TWriter &to, size_t n)
+{
+    auto from_handle = from.handle();
+    auto to_handle = to.handle();
+
+    size_t spliced = 0;
+
+    while (from_handle && to_handle && spliced < n)
+    {
+        auto result_or_chunk = from_handle->splice(*to_handle, MIN(SPLICE_CHUNK_SIZE, n - spliced));
+
+        if (!result_or_chunk.success())
+        {
+            break;
+        }
+
+        size_t chunk = result_or_chunk.unwrap();
+
+        if (chunk == 0)
+        {
+            return to.flush();
+        }
+
+        spliced += chunk;
+    }
+
+    if (spliced < n)
+    {
+        // Only what is left, the rest was already moved.
+        return copy(static_cast<Reader &>(from), static_cast<Writer &>(to), n - spliced);
+    }
+
+    return to.flush();
+}
+
+template <HandleReader TReader, HandleWriter TWriter>
+static inline Result copy(TReader &from, TWriter &to)
+{
+    return copy(from, to, (size_t)-1);
+}
+
 static inline ResultOr<Slice> read_all(Reader &reader)
 {
     MemoryWriter memory;
@@ -36,6 +36,16 @@ ResultOr<size_t> File::write(const void *buffer, size_t size)
     return _handle->write(buffer, size);
 }
 
+ResultOr<size_t> File::readv(const IOVec *vectors, size_t count)
+{
+    return _handle->readv(vectors, count);
+}
+
+ResultOr<size_t> File::writev(const IOVec *vectors, size_t count)
+{
+    return _handle->writev(vectors, count);
+}
+
 ResultOr<size_t> File::seek(SeekFrom from)
 {
     auto seek_result = _handle->seek(from);
@@ -36,6 +36,10 @@ public:
 
     ResultOr<size_t> write(const void *buffer, size_t size) override;
 
+    ResultOr<size_t> readv(const IOVec *vectors, size_t count) override;
+
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count) override;
+
     ResultOr<size_t> seek(SeekFrom from) override;
 
     ResultOr<size_t> tell() override;
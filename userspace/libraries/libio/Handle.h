@@ -67,6 +67,29 @@ public:
         return data_written;
     }
 
+    ResultOr<size_t> readv(const IOVec *vectors, size_t count)
+    {
+        size_t data_read = 0;
+        _result = TRY(hj_handle_readv(_handle, vectors, count, &data_read));
+        return data_read;
+    }
+
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count)
+    {
+        size_t data_written = 0;
+        _result = TRY(hj_handle_writev(_handle, vectors, count, &data_written));
+        return data_written;
+    }
+
+    // Moves up to size bytes to the destination without them going through
+    // userspace, returns 0 once the end of the source is reached.
+    ResultOr<size_t> splice(Handle &destination, size_t size)
+    {
+        size_t data_spliced = 0;
+        _result = TRY(hj_handle_splice(_handle, destination.id(), size, &data_spliced));
+        return data_spliced;
+    }
+
     Result call(IOCall request, void *args)
     {
         _result = hj_handle_call(_handle, request, args);
@@ -111,25 +111,7 @@ public:
 
     ResultOr<size_t> write(uint8_t v)
     {
-        if (_size == 0)
-        {
-            _buffer = new uint8_t[16];
-            _buffer[0] = '\0';
-            _size = 16;
-            _used = 0;
-            _position = 0;
-        }
-
-        if (_used == _size)
-        {
-            auto new_size = _size + _size / 4;
-            auto new_buffer = new uint8_t[new_size];
-            memcpy(new_buffer, _buffer, _size);
-            delete[] _buffer;
-
-            _size = new_size;
-            _buffer = new_buffer;
-        }
+        reserve(_position + 1);
 
         _buffer[_position] = v;
         _position++;
@@ -144,13 +126,41 @@ public:
 
     ResultOr<size_t> write(const void *buffer, size_t size) override
     {
-        for (size_t i = 0; i < size; i++)
+        reserve(_position + size);
+
+        memcpy(_buffer + _position, buffer, size);
+        _position += size;
+
+        if (_position > _used)
         {
-            write(((uint8_t *)buffer)[i]);
+            _used = _position;
         }
 
         return size;
     }
+
+    void reserve(size_t size)
+    {
+        if (_size == 0)
+        {
+            _buffer = new uint8_t[MAX(size, 16)];
+            _buffer[0] = '\0';
+            _size = MAX(size, 16);
+            _used = 0;
+            _position = 0;
+        }
+
+        if (size > _size)
+        {
+            auto new_size = MAX(_size + _size / 4, size);
+            auto new_buffer = new uint8_t[new_size];
+            memcpy(new_buffer, _buffer, _used);
+            delete[] _buffer;
+
+            _size = new_size;
+            _buffer = new_buffer;
+        }
+    }
 };
 
 } // namespace IO
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <abi/Handle.h>
 #include <libio/Seek.h>
 
 namespace IO
@@ -10,6 +11,27 @@ struct Reader
     virtual ~Reader() {}
 
     virtual ResultOr<size_t> read(void *buffer, size_t size) = 0;
+
+    // Fills the buffers one after the other and stops at the first short
+    // read, readers backed by a handle do it in a single syscall.
+    virtual ResultOr<size_t> readv(const IOVec *vectors, size_t count)
+    {
+        size_t read = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t vector_read = TRY(this->read(vectors[i].buffer, vectors[i].size));
+
+            read += vector_read;
+
+            if (vector_read < vectors[i].size)
+            {
+                break;
+            }
+        }
+
+        return read;
+    }
 };
 
 template <typename T>
@@ -19,6 +19,7 @@ public:
     InStream() : _handle{make<Handle>(0)} {}
 
     ResultOr<size_t> read(void *buffer, size_t size) override { return _handle->read(buffer, size); }
+    ResultOr<size_t> readv(const IOVec *vectors, size_t count) override { return _handle->readv(vectors, count); }
     RefPtr<Handle> handle() override { return _handle; }
 };
 
@@ -35,6 +36,7 @@ public:
     OutStream() : _handle{make<Handle>(1)} {}
 
     ResultOr<size_t> write(const void *buffer, size_t size) override { return _handle->write(buffer, size); }
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count) override { return _handle->writev(vectors, count); }
     RefPtr<Handle> handle() override { return _handle; }
 };
 
@@ -52,6 +54,7 @@ public:
     ErrStream() : _handle{make<Handle>(2)} {}
 
     ResultOr<size_t> write(const void *buffer, size_t size) override { return _handle->write(buffer, size); }
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count) override { return _handle->writev(vectors, count); }
     RefPtr<Handle> handle() override { return _handle; }
 };
 
@@ -68,6 +71,7 @@ public:
     LogStream() : _handle{make<Handle>(3)} {}
 
     ResultOr<size_t> write(const void *buffer, size_t size) override { return _handle->write(buffer, size); }
+    ResultOr<size_t> writev(const IOVec *vectors, size_t count) override { return _handle->writev(vectors, count); }
     RefPtr<Handle> handle() override { return _handle; }
 };
 
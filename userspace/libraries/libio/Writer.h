@@ -1,5 +1,6 @@
 #pragma once
 
+#include <abi/Handle.h>
 #include <libio/Seek.h>
 
 namespace IO
@@ -11,6 +12,27 @@ struct Writer
 
     virtual ResultOr<size_t> write(const void *buffer, size_t size) = 0;
 
+    // Writes the buffers as if they were a single one, writers backed by a
+    // handle do it in a single syscall.
+    virtual ResultOr<size_t> writev(const IOVec *vectors, size_t count)
+    {
+        size_t written = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t vector_written = TRY(write(vectors[i].buffer, vectors[i].size));
+
+            written += vector_written;
+
+            if (vector_written < vectors[i].size)
+            {
+                break;
+            }
+        }
+
+        return written;
+    }
+
     virtual Result flush() { return SUCCESS; }
 };
 
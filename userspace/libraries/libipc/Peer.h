@@ -73,7 +73,7 @@ public:
 
         while (!predicate(response))
         {
-            handle_message(message);
+            handle_message(response);
             response = TRY(receive());
         }
 
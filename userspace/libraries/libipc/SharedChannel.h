@@ -0,0 +1,305 @@
+#pragma once
+
+#include <libasync/Invoker.h>
+#include <libasync/Notifier.h>
+#include <libio/Connection.h>
+#include <libipc/SharedRing.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/system/Memory.h>
+#include <libutils/Callback.h>
+#include <libutils/OwnPtr.h>
+#include <libutils/ResultOr.h>
+
+namespace IPC
+{
+
+// Messages of a protocol going through a ring in shared memory for each
+// direction, so sending or receiving one is not a syscall. The connection
+// is only a doorbell: a byte is written to it when the other side sleeps.
+//
+// One side creates the channel and sends handle() to the other through
+// the connection, which attaches to it. Protocol::encode_message() and
+// Protocol::decode_message() work on an IO::Writer and an IO::Reader.
+template <typename Protocol>
+class SharedChannel
+{
+public:
+    using Message = typename Protocol::Message;
+
+    // For each direction, this is also the maximum size of a message.
+    static constexpr size_t RING_CAPACITY = 32 * 1024;
+
+    static constexpr size_t MEMORY_SIZE = 2 * SharedRing::memory_size(RING_CAPACITY);
+
+private:
+    IO::Connection _doorbell;
+    uintptr_t _memory;
+    int _handle = HANDLE_INVALID_ID;
+
+    SharedRing _outbound;
+    SharedRing _inbound;
+
+    OwnPtr<Async::Notifier> _notifier;
+    OwnPtr<Async::Invoker> _invoker;
+
+    bool _closed = false;
+
+    // Set while dispatching, the callbacks are allowed to destroy us.
+    bool *_destroyed = nullptr;
+
+    ResultOr<Message> read_message()
+    {
+        SharedRing::MessageReader reader{_inbound};
+        auto result_or_message = Protocol::decode_message(reader);
+        reader.commit();
+
+        return result_or_message;
+    }
+
+    void doorbell_rang()
+    {
+        char bells[16];
+        auto result = _doorbell.read(bells, sizeof(bells));
+
+        if (!result.success() || result.unwrap() == 0)
+        {
+            close();
+            return;
+        }
+
+        dispatch();
+    }
+
+    void dispatch()
+    {
+        bool destroyed = false;
+        _destroyed = &destroyed;
+
+        while (!_closed)
+        {
+            _inbound.awake();
+
+            while (!_inbound.empty())
+            {
+                auto result_or_message = read_message();
+
+                if (!result_or_message.success())
+                {
+                    close();
+                    break;
+                }
+
+                if (on_message)
+                {
+                    on_message(result_or_message.unwrap());
+                }
+
+                if (destroyed || _closed)
+                {
+                    break;
+                }
+            }
+
+            if (destroyed || _closed)
+            {
+                break;
+            }
+
+            _inbound.sleep();
+
+            if (_inbound.empty())
+            {
+                break;
+            }
+        }
+
+        if (!destroyed)
+        {
+            _destroyed = nullptr;
+        }
+    }
+
+public:
+    Callback<void(const Message &)> on_message;
+    Callback<void()> on_close;
+
+    int handle() { return _handle; }
+
+    bool closed() { return _closed; }
+
+    static ResultOr<OwnPtr<SharedChannel>> create(IO::Connection doorbell)
+    {
+        uintptr_t memory = 0;
+        TRY(memory_alloc(MEMORY_SIZE, &memory));
+
+        memset(reinterpret_cast<void *>(memory), 0, MEMORY_SIZE);
+
+        return own<SharedChannel>(doorbell, memory, true);
+    }
+
+    static ResultOr<OwnPtr<SharedChannel>> attach(IO::Connection doorbell, int handle)
+    {
+        uintptr_t memory = 0;
+        size_t size = 0;
+        TRY(memory_include(handle, &memory, &size));
+
+        if (size < MEMORY_SIZE)
+        {
+            memory_free(memory);
+            return ERR_INVALID_DATA;
+        }
+
+        return own<SharedChannel>(doorbell, memory, false);
+    }
+
+    SharedChannel(IO::Connection doorbell, uintptr_t memory, bool created)
+        : _doorbell{doorbell}, _memory{memory}
+    {
+        SharedRing first{reinterpret_cast<void *>(memory), RING_CAPACITY};
+        SharedRing second{reinterpret_cast<void *>(memory + SharedRing::memory_size(RING_CAPACITY)), RING_CAPACITY};
+
+        _outbound = created ? first : second;
+        _inbound = created ? second : first;
+
+        memory_get_handle(memory, &_handle);
+
+        _notifier = own<Async::Notifier>(_doorbell, POLL_READ, [this]() {
+            doorbell_rang();
+        });
+
+        // Messages may have been sent before we attached, without a bell.
+        _invoker = own<Async::Invoker>([this]() {
+            dispatch();
+        });
+
+        _invoker->invoke_later();
+    }
+
+    ~SharedChannel()
+    {
+        if (_destroyed)
+        {
+            *_destroyed = true;
+        }
+
+        _invoker = nullptr;
+        _notifier = nullptr;
+
+        memory_free(_memory);
+    }
+
+    Result send(const Message &message)
+    {
+        while (true)
+        {
+            if (_closed)
+            {
+                return ERR_STREAM_CLOSED;
+            }
+
+            SharedRing::MessageWriter writer{_outbound};
+            Result result = Protocol::encode_message(writer, message);
+
+            if (result == SUCCESS)
+            {
+                writer.commit();
+                break;
+            }
+
+            if (!writer.overflow() || writer.too_big())
+            {
+                return writer.too_big() ? ERR_OUT_OF_MEMORY : result;
+            }
+
+            // The ring is full, make sure the other side is draining it.
+            if (_outbound.wake_consumer())
+            {
+                char bell = 0;
+                _doorbell.write(&bell, 1);
+            }
+
+            process_sleep(1);
+        }
+
+        if (_outbound.wake_consumer())
+        {
+            char bell = 0;
+            auto result = _doorbell.write(&bell, 1);
+
+            if (!result.success())
+            {
+                close();
+                return result.result();
+            }
+        }
+
+        return SUCCESS;
+    }
+
+    // Waits for the next message, for request and response exchanges.
+    ResultOr<Message> receive()
+    {
+        while (!_closed)
+        {
+            if (!_inbound.empty())
+            {
+                auto result_or_message = read_message();
+
+                if (!result_or_message.success())
+                {
+                    close();
+                    return result_or_message;
+                }
+
+                // The messages after this one won't ring the doorbell.
+                _inbound.sleep();
+
+                if (!_inbound.empty())
+                {
+                    _invoker->invoke_later();
+                }
+
+                return result_or_message;
+            }
+
+            _inbound.sleep();
+
+            if (!_inbound.empty())
+            {
+                continue;
+            }
+
+            char bell;
+            auto result = _doorbell.read(&bell, 1);
+
+            // Closing may destroy us, through on_close.
+            if (!result.success() || result.unwrap() == 0)
+            {
+                close();
+                return ERR_STREAM_CLOSED;
+            }
+        }
+
+        return ERR_STREAM_CLOSED;
+    }
+
+    void close()
+    {
+        if (_closed)
+        {
+            return;
+        }
+
+        _closed = true;
+        _invoker->cancel();
+        _notifier = nullptr;
+        _doorbell.close();
+
+        if (on_close)
+        {
+            on_close();
+        }
+    }
+};
+
+} // namespace IPC
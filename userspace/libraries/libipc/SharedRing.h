@@ -0,0 +1,220 @@
+#pragma once
+
+#include <string.h>
+
+#include <libio/Reader.h>
+#include <libio/Writer.h>
+#include <libmath/MinMax.h>
+
+namespace IPC
+{
+
+// A single producer, single consumer queue of messages in memory shared by
+// two processes. Each side only moves its own index, so there is no lock: a
+// message is published by moving the head past it once it is whole, and
+// freed by moving the tail past it once it is read.
+class SharedRing
+{
+public:
+    struct Header
+    {
+        uint32_t head;
+        uint32_t tail;
+
+        // Set by the consumer when it may wait for the doorbell.
+        uint32_t sleeping;
+    };
+
+    static constexpr size_t memory_size(size_t capacity)
+    {
+        return sizeof(Header) + capacity;
+    }
+
+private:
+    Header *_header = nullptr;
+    uint8_t *_data = nullptr;
+    uint32_t _capacity = 0;
+
+    void copy_in(uint32_t position, const void *buffer, size_t size)
+    {
+        uint32_t offset = position & (_capacity - 1);
+        size_t first = MIN(size, _capacity - offset);
+
+        memcpy(_data + offset, buffer, first);
+        memcpy(_data, static_cast<const uint8_t *>(buffer) + first, size - first);
+    }
+
+    void copy_out(uint32_t position, void *buffer, size_t size)
+    {
+        uint32_t offset = position & (_capacity - 1);
+        size_t first = MIN(size, _capacity - offset);
+
+        memcpy(buffer, _data + offset, first);
+        memcpy(static_cast<uint8_t *>(buffer) + first, _data, size - first);
+    }
+
+public:
+    SharedRing() {}
+
+    // The capacity has to be a power of two.
+    SharedRing(void *memory, size_t capacity)
+        : _header{static_cast<Header *>(memory)},
+          _data{static_cast<uint8_t *>(memory) + sizeof(Header)},
+          _capacity{(uint32_t)capacity}
+    {
+    }
+
+    size_t capacity() { return _capacity; }
+
+    bool empty()
+    {
+        return __atomic_load_n(&_header->head, __ATOMIC_SEQ_CST) ==
+               __atomic_load_n(&_header->tail, __ATOMIC_RELAXED);
+    }
+
+    /* --- Doorbell --------------------------------------------------------- */
+
+    // The consumer is about to wait, it has to check the ring is still empty
+    // afterward since the producer may have missed the flag.
+    void sleep() { __atomic_store_n(&_header->sleeping, 1, __ATOMIC_SEQ_CST); }
+
+    void awake() { __atomic_store_n(&_header->sleeping, 0, __ATOMIC_SEQ_CST); }
+
+    // Whether the producer has to ring the doorbell after a publish.
+    bool wake_consumer() { return __atomic_exchange_n(&_header->sleeping, 0, __ATOMIC_SEQ_CST); }
+
+    /* --- Producer --------------------------------------------------------- */
+
+    // Writes a message after the head, in place. Writes fail once the free
+    // space is exhausted, nothing is published until commit().
+    class MessageWriter : public IO::Writer
+    {
+    private:
+        SharedRing &_ring;
+        uint32_t _start;
+        uint32_t _available;
+        uint32_t _size = 0;
+        bool _overflow = false;
+        bool _corrupted = false;
+
+    public:
+        bool overflow() { return _overflow; }
+
+        bool corrupted() { return _corrupted; }
+
+        // Whether the message wouldn't fit even in an empty ring.
+        bool too_big() { return _overflow && _available == _ring._capacity; }
+
+        MessageWriter(SharedRing &ring) : _ring{ring}
+        {
+            _start = __atomic_load_n(&ring._header->head, __ATOMIC_RELAXED);
+            uint32_t tail = __atomic_load_n(&ring._header->tail, __ATOMIC_ACQUIRE);
+
+            uint32_t used = _start - tail;
+
+            // The other side doesn't get to make us write outside the ring.
+            if (used > ring._capacity)
+            {
+                _corrupted = true;
+                _available = 0;
+                return;
+            }
+
+            _available = ring._capacity - used;
+        }
+
+        ResultOr<size_t> write(const void *buffer, size_t size) override
+        {
+            if (_corrupted)
+            {
+                return ERR_INVALID_DATA;
+            }
+
+            if (sizeof(uint32_t) + _size > _available ||
+                size > _available - sizeof(uint32_t) - _size)
+            {
+                _overflow = true;
+                return ERR_OUT_OF_MEMORY;
+            }
+
+            _ring.copy_in(_start + sizeof(uint32_t) + _size, buffer, size);
+            _size += size;
+
+            return size;
+        }
+
+        void commit()
+        {
+            if (_corrupted)
+            {
+                return;
+            }
+
+            _ring.copy_in(_start, &_size, sizeof(_size));
+            __atomic_store_n(&_ring._header->head, _start + sizeof(uint32_t) + _size, __ATOMIC_SEQ_CST);
+        }
+    };
+
+    /* --- Consumer --------------------------------------------------------- */
+
+    // Reads the message at the tail, in place. The message stays in the
+    // ring until commit().
+    class MessageReader : public IO::Reader
+    {
+    private:
+        SharedRing &_ring;
+        uint32_t _start;
+        uint32_t _end;
+        uint32_t _size = 0;
+        uint32_t _position = 0;
+        bool _corrupted = false;
+
+    public:
+        MessageReader(SharedRing &ring) : _ring{ring}
+        {
+            _start = __atomic_load_n(&ring._header->tail, __ATOMIC_RELAXED);
+            _end = __atomic_load_n(&ring._header->head, __ATOMIC_ACQUIRE);
+
+            uint32_t used = _end - _start;
+
+            if (used < sizeof(uint32_t))
+            {
+                _corrupted = used > 0;
+                return;
+            }
+
+            ring.copy_out(_start, &_size, sizeof(_size));
+
+            // The other side doesn't get to make us read outside the ring.
+            if (used > ring._capacity || _size > used - sizeof(uint32_t))
+            {
+                _corrupted = true;
+                _size = 0;
+            }
+        }
+
+        ResultOr<size_t> read(void *buffer, size_t size) override
+        {
+            if (_corrupted)
+            {
+                return ERR_INVALID_DATA;
+            }
+
+            size = MIN(size, _size - _position);
+
+            _ring.copy_out(_start + sizeof(uint32_t) + _position, buffer, size);
+            _position += size;
+
+            return size;
+        }
+
+        // A corrupted ring is dropped whole.
+        void commit()
+        {
+            uint32_t tail = _corrupted ? _end : _start + sizeof(uint32_t) + _size;
+            __atomic_store_n(&_ring._header->tail, tail, __ATOMIC_RELEASE);
+        }
+    };
+};
+
+} // namespace IPC
@@ -68,10 +68,10 @@ bool Path::match(const Path &other) const
            (other.key == "*" || other.key == key);
 }
 
-bool Path::operator==(const Path &other)
+bool Path::operator==(const Path &other) const
 {
     return domain == other.domain &&
-           bundle == other.domain &&
+           bundle == other.bundle &&
            key == other.key;
 }
 
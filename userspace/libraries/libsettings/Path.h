@@ -20,7 +20,7 @@ struct Path
 
     bool match(const Path &other) const;
 
-    bool operator==(const Path &other);
+    bool operator==(const Path &other) const;
 };
 
 } // namespace Settings
@@ -1,80 +1,165 @@
-#include <libio/Copy.h>
 #include <libio/MemoryWriter.h>
 #include <libsettings/Protocol.h>
+#include <libutils/json/Binary.h>
 
 namespace Settings
 {
 
-struct MessageHeader
+struct PACKED MessageHeader
 {
     Message::Type type;
-    size_t path_length;
-    size_t payload_length;
+    uint8_t flags;
+    uint32_t size;
 };
 
-Result Protocol::encode_message(IO::Connection &connection, const Message &message)
+static constexpr uint8_t MESSAGE_HAS_PATH = 1 << 0;
+static constexpr uint8_t MESSAGE_HAS_PAYLOAD = 1 << 1;
+
+// Keeps a broken peer from making us allocate without bound.
+static constexpr size_t MESSAGE_MAX_SIZE = 16 * 1024 * 1024;
+
+static void write_path(Json::BinaryWriter &writer, const Path &path)
 {
-    String path_buffer = "";
+    writer.string(path.domain);
+    writer.string(path.bundle);
+    writer.string(path.key);
+}
 
-    if (message.path.present())
+static Path read_path(Json::BinaryReader &reader)
+{
+    Path path;
+
+    path.domain = reader.string();
+    path.bundle = reader.string();
+    path.key = reader.string();
+
+    return path;
+}
+
+static Result read_exactly(IO::Reader &reader, void *buffer, size_t size)
+{
+    size_t received = 0;
+
+    while (received < size)
     {
-        Prettifier pretty;
-        message.path.unwrap().prettify(pretty);
-        path_buffer = pretty.finalize();
+        size_t read = TRY(reader.read(static_cast<uint8_t *>(buffer) + received, size - received));
+
+        if (read == 0)
+        {
+            return ERR_STREAM_CLOSED;
+        }
+
+        received += read;
     }
 
-    String payload_buffer = "";
+    return SUCCESS;
+}
+
+Result Protocol::encode_message(IO::Writer &stream, const Message &message)
+{
+    IO::MemoryWriter memory{256};
+    Json::BinaryWriter writer{memory};
+
+    MessageHeader header{};
+    header.type = message.type;
+    memory.write(&header, sizeof(header));
+
+    if (message.path.present())
+    {
+        header.flags |= MESSAGE_HAS_PATH;
+        write_path(writer, message.path.unwrap());
+    }
 
     if (message.payload.present())
     {
-        Prettifier pretty;
-        Json::prettify(pretty, message.payload.unwrap());
-        payload_buffer = pretty.finalize();
+        header.flags |= MESSAGE_HAS_PAYLOAD;
+        writer.value(message.payload.unwrap());
     }
 
-    MessageHeader header;
-    header.type = message.type;
-    header.path_length = path_buffer.length();
-    header.payload_length = payload_buffer.length();
+    writer.varint(message.paths.count());
 
-    TRY(connection.write(&header, sizeof(MessageHeader)));
+    for (size_t i = 0; i < message.paths.count(); i++)
+    {
+        write_path(writer, message.paths[i]);
+    }
 
-    if (path_buffer.length())
+    writer.varint(message.values.count());
+
+    for (size_t i = 0; i < message.values.count(); i++)
     {
-        TRY(connection.write(path_buffer.cstring(), path_buffer.length()));
+        writer.value(message.values[i]);
     }
 
-    if (payload_buffer.length())
+    size_t size = memory.length().unwrap();
+
+    header.size = size - sizeof(header);
+    memcpy(memory.buffer(), &header, sizeof(header));
+
+    size_t written = 0;
+
+    while (written < size)
     {
-        TRY(connection.write(payload_buffer.cstring(), payload_buffer.length()));
+        size_t sent = TRY(stream.write(memory.buffer() + written, size - written));
+
+        if (sent == 0)
+        {
+            return ERR_STREAM_CLOSED;
+        }
+
+        written += sent;
     }
 
     return SUCCESS;
 }
 
-ResultOr<Message> Protocol::decode_message(IO::Connection &connection)
+ResultOr<Message> Protocol::decode_message(IO::Reader &stream)
 {
     MessageHeader header;
 
-    TRY(connection.read(&header, sizeof(header)));
+    TRY(read_exactly(stream, &header, sizeof(header)));
+
+    if (header.size > MESSAGE_MAX_SIZE)
+    {
+        return ERR_INVALID_DATA;
+    }
+
+    Vector<uint8_t> body{};
+    body.resize(header.size);
+
+    TRY(read_exactly(stream, body.raw_storage(), header.size));
+
+    Json::BinaryReader reader{body.raw_storage(), header.size};
 
     Message message;
     message.type = header.type;
 
-    if (header.path_length > 0)
+    if (header.flags & MESSAGE_HAS_PATH)
+    {
+        message.path = read_path(reader);
+    }
+
+    if (header.flags & MESSAGE_HAS_PAYLOAD)
+    {
+        message.payload = reader.value();
+    }
+
+    uint64_t paths = reader.varint();
+
+    for (uint64_t i = 0; i < paths && !reader.error(); i++)
+    {
+        message.paths.push_back(read_path(reader));
+    }
+
+    uint64_t values = reader.varint();
+
+    for (uint64_t i = 0; i < values && !reader.error(); i++)
     {
-        IO::MemoryWriter memory;
-        TRY(IO::copy(connection, memory, header.path_length));
-        String str = memory.string();
-        message.path = Path::parse(str);
+        message.values.push_back(reader.value());
     }
 
-    if (header.payload_length > 0)
+    if (reader.error() || !reader.ended())
     {
-        IO::MemoryWriter memory;
-        TRY(IO::copy(connection, memory, header.payload_length));
-        String str = memory.string();
-        message.payload = Json::parse(str);
+        return ERR_INVALID_DATA;
     }
 
     return message;
@@ -16,24 +16,33 @@ struct Message
         CLIENT_WRITE,
         CLIENT_WATCH,
         CLIENT_UNWATCH,
+        CLIENT_READ_MANY,
+        CLIENT_WRITE_MANY,
 
         SERVER_ACK,
         SERVER_VALUE,
+        SERVER_VALUES,
         SERVER_NOTIFY,
     };
 
     Type type;
     Optional<Path> path;
     Optional<Json::Value> payload;
+
+    // Batched requests, replies and notifications, the values match the paths.
+    Vector<Path> paths{};
+    Vector<Json::Value> values{};
 };
 
+// Messages are sent in a single write: a header with the size of the body,
+// then the body encoded as Json binary values.
 struct Protocol
 {
     using Message = Settings::Message;
 
-    static Result encode_message(IO::Connection &connection, const Message &message);
+    static Result encode_message(IO::Writer &stream, const Message &message);
 
-    static ResultOr<Message> decode_message(IO::Connection &connection);
+    static ResultOr<Message> decode_message(IO::Reader &stream);
 };
 
 } // namespace Settings
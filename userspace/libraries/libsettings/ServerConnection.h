@@ -32,7 +32,10 @@ public:
     {
         if (message.type == Message::SERVER_NOTIFY)
         {
-            on_notify(message.path.unwrap(), message.payload.unwrap());
+            for (size_t i = 0; i < MIN(message.paths.count(), message.values.count()); i++)
+            {
+                on_notify(message.paths[i], message.values[i]);
+            }
         }
     }
 };
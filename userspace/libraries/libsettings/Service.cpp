@@ -121,4 +121,43 @@ bool Service::write(const Path path, Json::Value value)
     return result.success();
 }
 
+Optional<Vector<Json::Value>> Service::read_many(const Vector<Path> &paths)
+{
+    Message message;
+
+    message.type = Message::CLIENT_READ_MANY;
+    message.paths = paths;
+
+    auto result_or_response = server().request(message, Message::SERVER_VALUES);
+
+    if (!result_or_response.success() ||
+        result_or_response.unwrap().values.count() != paths.count())
+    {
+        return {};
+    }
+
+    return result_or_response.unwrap().values;
+}
+
+bool Service::write_many(const Vector<Path> &paths, const Vector<Json::Value> &values)
+{
+    Message message;
+
+    message.type = Message::CLIENT_WRITE_MANY;
+    message.paths = paths;
+    message.values = values;
+
+    auto result = server().request(message, Message::SERVER_ACK);
+
+    if (result.success())
+    {
+        for (size_t i = 0; i < MIN(paths.count(), values.count()); i++)
+        {
+            notify_watchers(paths[i], values[i]);
+        }
+    }
+
+    return result.success();
+}
+
 } // namespace Settings
\ No newline at end of file
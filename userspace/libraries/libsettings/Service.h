@@ -37,6 +37,12 @@ public:
     Optional<Json::Value> read(const Path path);
 
     bool write(const Path path, Json::Value value);
+
+    // Reads all the paths in a single request.
+    Optional<Vector<Json::Value>> read_many(const Vector<Path> &paths);
+
+    // Writes all the paths in a single request, values match the paths.
+    bool write_many(const Vector<Path> &paths, const Vector<Json::Value> &values);
 };
 
 } // namespace Settings
@@ -37,6 +37,7 @@
     __ENTRY(ERR_DIRECTORY_NOT_EMPTY, "Directory not empty")                       \
     __ENTRY(ERR_EXTENSION, "Unrecognized file extension")                         \
     __ENTRY(ERR_ACCESS_DENIED, "Access denied")                                   \
+    __ENTRY(ERR_INPUT_OUTPUT, "Input/output error")                               \
     __ENTRY(ERR_UNKNOWN, "Unknown failure")
 
 enum Result
@@ -86,21 +86,21 @@ void launchpad_arguments(Launchpad *launchpad, const Vector<String> &arguments)
 
 void launchpad_handle(Launchpad *launchpad, IO::RawHandle &handle_to_pass, int destination)
 {
-    assert(destination >= 0 && destination < PROCESS_ARG_COUNT);
+    assert(destination >= 0 && destination < LAUNCHPAD_HANDLE_COUNT);
 
     launchpad->handles[destination] = handle_to_pass.handle()->id();
 }
 
 void launchpad_handle(Launchpad *launchpad, IO::Handle &handle, int destination)
 {
-    assert(destination >= 0 && destination < PROCESS_ARG_COUNT);
+    assert(destination >= 0 && destination < LAUNCHPAD_HANDLE_COUNT);
 
     launchpad->handles[destination] = handle.id();
 }
 
 void launchpad_handle(Launchpad *launchpad, Handle *handle_to_pass, int destination)
 {
-    assert(destination >= 0 && destination < PROCESS_ARG_COUNT);
+    assert(destination >= 0 && destination < LAUNCHPAD_HANDLE_COUNT);
 
     launchpad->handles[destination] = handle_to_pass->id;
 }
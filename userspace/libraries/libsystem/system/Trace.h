@@ -0,0 +1,42 @@
+#pragma once
+
+#include <abi/Syscalls.h>
+#include <string.h>
+
+// Markers going to the boot trace of the kernel, next to its own, see the
+// trace utility. They are dropped once its buffer is full.
+namespace Trace
+{
+
+class Span
+{
+private:
+    const char *_name;
+
+    NONCOPYABLE(Span);
+    NONMOVABLE(Span);
+
+public:
+    Span(const char *name) : _name{name}
+    {
+        hj_system_trace(_name, strlen(_name), TRACE_BEGIN);
+    }
+
+    ~Span()
+    {
+        hj_system_trace(_name, strlen(_name), TRACE_END);
+    }
+};
+
+// Until the end of the scope: auto span = Trace::span("...");
+inline Span span(const char *name)
+{
+    return {name};
+}
+
+inline void mark(const char *name)
+{
+    hj_system_trace(name, strlen(name), TRACE_INSTANT);
+}
+
+} // namespace Trace
@@ -1,3 +1,5 @@
 LIBS += TERMINAL
 
 TERMINAL_NAME = terminal
+
+TERMINAL_CXXFLAGS=-O3 -mmmx -msse -msse2
@@ -1,144 +1,99 @@
 #pragma once
 
-#include <libterminal/Cell.h>
+#include <libterminal/Line.h>
 #include <libutils/Assert.h>
 #include <libutils/Vector.h>
 
 namespace Terminal
 {
 
+// A fixed capacity ring of lines, index 0 is the oldest line.
+// Appending to a full buffer recycles the oldest line, so scrolling
+// never moves the cells of the other lines around.
 class Buffer
 {
 private:
     int _width;
-    int _height;
-    Vector<Cell> _buffer;
+    int _capacity;
+
+    Vector<Line> _lines;
+    int _first = 0;
+    int _count = 0;
+
+    int index_of(int line) const
+    {
+        return (_first + line) % _capacity;
+    }
 
 public:
     int width() const { return _width; }
 
-    int height() const { return _height; }
+    int capacity() const { return _capacity; }
 
-    Buffer(int width, int height)
-        : _width{width}, _height{height}
+    int count() const { return _count; }
+
+    Buffer(int width, int capacity)
+        : _width{width},
+          _capacity{MAX(capacity, 1)},
+          _lines(_capacity)
     {
-        _buffer.resize(_width * _height);
+        _lines.resize(_capacity);
     }
 
-    const Cell at(int x, int y) const
+    Line &line(int line)
     {
-        if (x >= 0 && x < _width && y >= 0 && y < _height)
-        {
-            return _buffer[y * _width + x];
-        }
-
-        return {U' ', {}, true};
+        assert(line >= 0 && line < _count);
+        return _lines[index_of(line)];
     }
 
-    void set(int x, int y, Cell cell)
+    const Line &line(int line) const
     {
-        if (x >= 0 && x < _width &&
-            y >= 0 && y < _height)
-        {
-            Cell old_cell = _buffer[y * _width + x];
-
-            if (old_cell.codepoint != cell.codepoint ||
-                old_cell.attributes != cell.attributes)
-            {
-                _buffer[y * _width + x] = cell;
-                _buffer[y * _width + x].dirty = true;
-            }
-        }
+        assert(line >= 0 && line < _count);
+        return _lines[index_of(line)];
     }
 
-    void undirty(int x, int y)
+    Line &append(Attributes attributes)
     {
-        if (x >= 0 && x < _width && y >= 0 && y < _height)
+        if (_count < _capacity)
         {
-            _buffer[y * _width + x].dirty = false;
+            _count++;
         }
-    }
-
-    void clear(int fromx, int fromy, int tox, int toy, Attributes attributes)
-    {
-        for (int i = fromx + fromy * _width; i < tox + toy * _width; i++)
+        else
         {
-            set(i % _width, i / _width, (Cell){U' ', attributes, true});
+            _first = (_first + 1) % _capacity;
         }
-    }
 
-    void clear_all(Attributes attributes)
-    {
-        clear(0, 0, _width, _height, attributes);
-    }
+        Line &appended = line(_count - 1);
 
-    void clear_line(int line, Attributes attributes)
-    {
-        if (line >= 0 && line < _height)
+        if (appended.width() != _width)
         {
-            for (int i = 0; i < _width; i++)
-            {
-                set(i, line, (Cell){U' ', attributes, true});
-            }
+            appended = Line{_width, attributes};
         }
+        else
+        {
+            appended.clear(0, _width, attributes);
+        }
+
+        return appended;
     }
 
-    void resize(int width, int height)
+    void append(Line &&other)
     {
-        Vector<Cell> new_buffer;
-        new_buffer.resize(width * height);
+        append(Attributes{}) = move(other);
 
-        for (int i = 0; i < width * height; i++)
-        {
-            new_buffer[i] = {U' ', {}, true};
-        }
+        Line &appended = line(_count - 1);
 
-        for (int x = 0; x < MIN(width, _width); x++)
+        if (appended.width() != _width)
         {
-            for (int y = 0; y < MIN(height, _height); y++)
-            {
-                new_buffer[y * width + x] = at(x, y);
-            }
+            appended.resize(_width);
         }
 
-        _buffer = new_buffer;
-
-        _width = width;
-        _height = height;
+        appended.dirty(true);
     }
 
-    void scroll(int how_many_line, Attributes attributes)
+    void swap_lines(int a, int b)
     {
-        if (how_many_line < 0)
-        {
-            for (int line = 0; line < how_many_line; line++)
-            {
-                for (int i = (width() * height()) - 1; i >= height(); i++)
-                {
-                    int x = i % width();
-                    int y = i / width();
-
-                    set(x, y, at(x, y - 1));
-                }
-
-                clear_line(0, attributes);
-            }
-        }
-        else if (how_many_line > 0)
-        {
-            for (int line = 0; line < how_many_line; line++)
-            {
-                for (int i = 0; i < width() * (height() - 1); i++)
-                {
-                    int x = i % width();
-                    int y = i / width();
-
-                    set(x, y, at(x, y + 1));
-                }
-
-                clear_line(height() - 1, attributes);
-            }
-        }
+        swap(line(a), line(b));
     }
 };
 
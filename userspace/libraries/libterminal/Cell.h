@@ -10,7 +10,12 @@ struct Cell
 {
     Codepoint codepoint = U' ';
     Attributes attributes;
-    bool dirty;
+
+    bool operator==(const Cell &other) const
+    {
+        return codepoint == other.codepoint &&
+               attributes == other.attributes;
+    }
 };
 
 } // namespace Terminal
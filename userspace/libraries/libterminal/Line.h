@@ -0,0 +1,95 @@
+#pragma once
+
+#include <libterminal/Cell.h>
+#include <libutils/Vector.h>
+
+namespace Terminal
+{
+
+class Line
+{
+private:
+    Vector<Cell> _cells;
+    bool _dirty = true;
+
+public:
+    int width() const { return _cells.count(); }
+
+    bool dirty() const { return _dirty; }
+
+    void dirty(bool value) { _dirty = value; }
+
+    Line() {}
+
+    Line(int width, Attributes attributes)
+        : _cells(width)
+    {
+        _cells.resize(width);
+        clear(0, width, attributes);
+    }
+
+    const Cell at(int x) const
+    {
+        if (x >= 0 && x < width())
+        {
+            return _cells[x];
+        }
+
+        return {U' ', {}};
+    }
+
+    void set(int x, Cell cell)
+    {
+        if (x >= 0 && x < width() && !(_cells[x] == cell))
+        {
+            _cells[x] = cell;
+            _dirty = true;
+        }
+    }
+
+    // Write a run of ASCII characters starting at `x`, the run must fit in the line.
+    void write(int x, const char *text, int length, Attributes attributes)
+    {
+        assert(x >= 0 && x + length <= width());
+
+        Cell *cells = &_cells[x];
+
+        for (int i = 0; i < length; i++)
+        {
+            cells[i] = {(Codepoint)text[i], attributes};
+        }
+
+        _dirty = true;
+    }
+
+    void clear(int from, int to, Attributes attributes)
+    {
+        from = MAX(from, 0);
+        to = MIN(to, width());
+
+        for (int x = from; x < to; x++)
+        {
+            _cells[x] = {U' ', attributes};
+        }
+
+        _dirty = true;
+    }
+
+    void resize(int new_width)
+    {
+        int old_width = width();
+
+        Vector<Cell> new_cells(new_width);
+        new_cells.resize(new_width);
+
+        for (int x = 0; x < new_width; x++)
+        {
+            new_cells[x] = x < old_width ? _cells[x] : Cell{U' ', {}};
+        }
+
+        _cells = move(new_cells);
+        _dirty = true;
+    }
+};
+
+} // namespace Terminal
@@ -8,16 +8,27 @@ namespace Terminal
 class Surface
 {
 private:
+    static constexpr int DEFAULT_HISTORY = 1000;
+    static constexpr int HISTORY_MEMORY_LIMIT = 4 * 1024 * 1024;
+
     Buffer _buffer;
 
     int _height;
     int _width;
 
-    int _scrollback = 0;
+    int _history;
 
+    // The screen is made of the last `_height` lines of the buffer,
+    // everything above is the scrollback history.
     int convert_y(int y) const
     {
-        return _buffer.height() - _height + y;
+        return _buffer.count() - _height + y;
+    }
+
+    static int capacity_for(int width, int height, int history)
+    {
+        int line_size = MAX(width, 1) * sizeof(Cell);
+        return height + MIN(history, HISTORY_MEMORY_LIMIT / line_size);
     }
 
 public:
@@ -25,33 +36,82 @@ public:
 
     int height() { return _height; }
 
-    int scrollback() { return _scrollback; }
+    int scrollback() { return _buffer.count() - _height; }
+
+    int history() { return _history; }
 
-    Surface(int width, int height)
-        : _buffer{width, 1000}
+    Surface(int width, int height, int history = DEFAULT_HISTORY)
+        : _buffer{width, capacity_for(width, height, history)},
+          _height{height},
+          _width{width},
+          _history{history}
     {
-        _width = width;
-        _height = height;
+        for (int i = 0; i < height; i++)
+        {
+            _buffer.append(Attributes{});
+        }
+    }
+
+    bool contains(int y) const
+    {
+        return y >= -(_buffer.count() - _height) && y < _height;
+    }
+
+    // `y` can go as low as `-scrollback()` to reach into the history.
+    Line &line(int y)
+    {
+        return _buffer.line(convert_y(y));
     }
 
     const Cell at(int x, int y) const
     {
-        return _buffer.at(x, convert_y(y));
+        if (!contains(y))
+        {
+            return {U' ', {}};
+        }
+
+        return _buffer.line(convert_y(y)).at(x);
     }
 
     void set(int x, int y, Cell cell)
     {
-        _buffer.set(x, convert_y(y), cell);
+        if (y >= 0 && y < _height)
+        {
+            line(y).set(x, cell);
+        }
+    }
+
+    bool dirty(int y)
+    {
+        return contains(y) && line(y).dirty();
     }
 
-    void undirty(int x, int y)
+    void undirty(int y)
     {
-        _buffer.undirty(x, convert_y(y));
+        if (contains(y))
+        {
+            line(y).dirty(false);
+        }
     }
 
     void clear(int fromx, int fromy, int tox, int toy, Attributes attributes)
     {
-        _buffer.clear(fromx, convert_y(fromy), tox, convert_y(toy), attributes);
+        int from = fromx + fromy * _width;
+        int to = tox + toy * _width;
+
+        while (from < to)
+        {
+            int y = from / _width;
+            int x = from % _width;
+            int end = MIN(to - y * _width, _width);
+
+            if (y >= 0 && y < _height)
+            {
+                line(y).clear(x, end, attributes);
+            }
+
+            from = (y + 1) * _width;
+        }
     }
 
     void clear_all(Attributes attributes)
@@ -59,22 +119,65 @@ public:
         clear(0, 0, _width, _height, attributes);
     }
 
-    void clear_line(int line, Attributes attributes)
+    void clear_line(int y, Attributes attributes)
     {
-        _buffer.clear_line(convert_y(line), attributes);
+        if (y >= 0 && y < _height)
+        {
+            line(y).clear(0, _width, attributes);
+        }
     }
 
     void resize(int width, int height)
     {
-        _buffer.resize(MAX(_buffer.width(), width), MAX(MAX(height, _height), 1000));
+        Buffer new_buffer{width, capacity_for(width, height, _history)};
+
+        int kept = MIN(_buffer.count(), new_buffer.capacity());
+
+        for (int i = kept; i < height; i++)
+        {
+            new_buffer.append(Attributes{});
+        }
+
+        for (int i = _buffer.count() - kept; i < _buffer.count(); i++)
+        {
+            new_buffer.append(move(_buffer.line(i)));
+        }
+
+        _buffer = move(new_buffer);
         _width = width;
         _height = height;
     }
 
     void scroll(int how_many_line, Attributes attributes)
     {
-        _buffer.scroll(how_many_line, attributes);
-        _scrollback += how_many_line;
+        if (how_many_line > 0)
+        {
+            // Pushing lines at the bottom moves the top of the screen
+            // into the history without touching any other line.
+            for (int i = 0; i < how_many_line; i++)
+            {
+                _buffer.append(attributes);
+            }
+        }
+        else if (how_many_line < 0)
+        {
+            how_many_line = MIN(-how_many_line, _height);
+
+            for (int y = _height - 1; y >= how_many_line; y--)
+            {
+                _buffer.swap_lines(convert_y(y), convert_y(y - how_many_line));
+            }
+
+            for (int y = 0; y < how_many_line; y++)
+            {
+                clear_line(y, attributes);
+            }
+        }
+
+        for (int y = 0; y < _height; y++)
+        {
+            line(y).dirty(true);
+        }
     }
 };
 
@@ -1,5 +1,9 @@
 #include <assert.h>
 
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
 #include <libmath/MinMax.h>
 #include <libsystem/Logger.h>
 #include <libterminal/Terminal.h>
@@ -106,11 +110,32 @@ void Terminal::append(Codepoint codepoint)
     }
     else
     {
-        _surface.set(_cursor.x, _cursor.y, {codepoint, _attributes, true});
+        _surface.set(_cursor.x, _cursor.y, {codepoint, _attributes});
         cursor_move(1, 0);
     }
 }
 
+void Terminal::append(const char *text, size_t size)
+{
+    while (size > 0)
+    {
+        // cursor_set() lets the cursor sit right past the last column or
+        // line, it is brought back on the surface first.
+        if (_cursor.x >= width() || _cursor.y >= height())
+        {
+            cursor_move(0, 0);
+        }
+
+        int length = MIN((int)size, width() - _cursor.x);
+
+        _surface.line(_cursor.y).write(_cursor.x, text, length, _attributes);
+        cursor_move(length, 0);
+
+        text += length;
+        size -= length;
+    }
+}
+
 void Terminal::do_ansi(Codepoint codepoint)
 {
     switch (codepoint)
@@ -404,11 +429,65 @@ void Terminal::write(char c)
     _decoder.write(c);
 }
 
+// Length of the run of printable ASCII characters at the start of `buffer`.
+static size_t printable_run(const char *buffer, size_t size)
+{
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128i lower = _mm_set1_epi8(0x1f);
+    const __m128i upper = _mm_set1_epi8(0x7f);
+
+    // Bytes above 0x7f are negative when compared as signed,
+    // so they fail the lower bound check with the control characters.
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + i));
+        __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(chunk, lower), _mm_cmplt_epi8(chunk, upper));
+
+        unsigned mask = ~_mm_movemask_epi8(printable) & 0xffff;
+
+        if (mask)
+        {
+            return i + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; i < size; i++)
+    {
+        if (buffer[i] < 0x20 || buffer[i] >= 0x7f)
+        {
+            return i;
+        }
+    }
+
+    return i;
+}
+
 void Terminal::write(const char *buffer, size_t size)
 {
-    for (size_t i = 0; i < size; i++)
+    size_t i = 0;
+
+    while (i < size)
     {
+        // Plain text outside of any escape or utf8 sequence can be written
+        // as a whole without going through the decoder and the state machine.
+        if (_state == State::WAIT_ESC && !_decoder.decoding())
+        {
+            size_t run = printable_run(buffer + i, size - i);
+
+            if (run > 0)
+            {
+                append(buffer + i, run);
+                i += run;
+
+                continue;
+            }
+        }
+
         write(buffer[i]);
+        i++;
     }
 }
 
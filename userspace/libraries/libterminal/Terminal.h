@@ -62,6 +62,8 @@ public:
 
     void append(Codepoint codepoint);
 
+    void append(const char *text, size_t size);
+
     void do_ansi(Codepoint codepoint);
 
     void write(Codepoint codepoint);
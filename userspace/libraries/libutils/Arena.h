@@ -0,0 +1,132 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <libmath/MinMax.h>
+#include <libsystem/Macros.h>
+#include <libutils/Move.h>
+#include <libutils/New.h>
+
+// Bump allocator: memory is handed out from large chunks and released all
+// at once when the arena goes away. Destructors of the objects allocated
+// from an arena are never called, only put trivially destructible types in it.
+class Arena
+{
+private:
+    static constexpr size_t CHUNK_SIZE = 16 * 1024;
+    static constexpr size_t ALIGNMENT = 8;
+
+    struct ALIGNED(ALIGNMENT) Chunk
+    {
+        Chunk *next;
+        size_t size;
+        size_t used;
+
+        uint8_t *data() { return reinterpret_cast<uint8_t *>(this + 1); }
+    };
+
+    static_assert(sizeof(Chunk) % ALIGNMENT == 0);
+
+    Chunk *_chunks = nullptr;
+    size_t _allocated = 0;
+
+    Chunk *new_chunk(size_t size)
+    {
+        auto chunk = reinterpret_cast<Chunk *>(new uint8_t[sizeof(Chunk) + size]);
+
+        chunk->next = _chunks;
+        chunk->size = size;
+        chunk->used = 0;
+
+        _chunks = chunk;
+
+        return chunk;
+    }
+
+public:
+    size_t allocated() const { return _allocated; }
+
+    NONCOPYABLE(Arena);
+
+    Arena() {}
+
+    Arena(Arena &&other)
+        : _chunks{exchange_and_return_initial_value(other._chunks, nullptr)},
+          _allocated{exchange_and_return_initial_value(other._allocated, 0)}
+    {
+    }
+
+    Arena &operator=(Arena &&other)
+    {
+        swap(_chunks, other._chunks);
+        swap(_allocated, other._allocated);
+
+        return *this;
+    }
+
+    ~Arena()
+    {
+        while (_chunks)
+        {
+            auto next = _chunks->next;
+            delete[] reinterpret_cast<uint8_t *>(_chunks);
+            _chunks = next;
+        }
+    }
+
+    void *allocate(size_t size, size_t alignment = ALIGNMENT)
+    {
+        assert(alignment <= ALIGNMENT);
+
+        Chunk *chunk = _chunks;
+        size_t offset = chunk ? ALIGN_UP(chunk->used, alignment) : 0;
+
+        if (!chunk || offset + size > chunk->size)
+        {
+            // Big allocations get a chunk of their own.
+            chunk = new_chunk(MAX(size, CHUNK_SIZE));
+            offset = 0;
+        }
+
+        chunk->used = offset + size;
+        _allocated += size;
+
+        return chunk->data() + offset;
+    }
+
+    template <typename T, typename... TArgs>
+    T *make(TArgs &&...args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(forward<TArgs>(args)...);
+    }
+
+    template <typename T>
+    T *make_array(size_t count)
+    {
+        if (count == 0)
+        {
+            return nullptr;
+        }
+
+        T *result = reinterpret_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            new (&result[i]) T();
+        }
+
+        return result;
+    }
+
+    char *copy(const char *buffer, size_t size)
+    {
+        char *result = reinterpret_cast<char *>(allocate(size + 1, 1));
+
+        memcpy(result, buffer, size);
+        result[size] = '\0';
+
+        return result;
+    }
+};
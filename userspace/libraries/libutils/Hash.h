@@ -35,6 +35,12 @@ inline uint32_t hash<uint32_t>(const uint32_t &value)
 
 template <>
 inline uint32_t hash<uint64_t>(const uint64_t &value)
+{
+    return hash(&value, sizeof(value));
+}
+
+template <>
+inline uint32_t hash<int>(const int &value)
 {
     return hash(&value, sizeof(value));
 }
\ No newline at end of file
@@ -18,8 +18,15 @@ private:
 
     Vector<Vector<Item>> _buckets{};
 
+    // Buckets are only allocated on the first insertion, most maps are
+    // small or short lived (ex: json objects).
     Vector<Item> &bucket(uint32_t hash)
     {
+        if (_buckets.empty())
+        {
+            _buckets.resize(BUCKET_COUNT);
+        }
+
         return _buckets[hash % BUCKET_COUNT];
     }
 
@@ -31,6 +38,12 @@ private:
     Item *item_by_key(const TKey &key, uint32_t hash)
     {
         Item *result = nullptr;
+
+        if (_buckets.empty())
+        {
+            return nullptr;
+        }
+
         auto &b = bucket(hash);
 
         b.foreach ([&](Item &item) {
@@ -53,7 +66,7 @@ public:
     {
         size_t result = 0;
 
-        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        for (size_t i = 0; i < _buckets.count(); i++)
         {
             result += _buckets[i].count();
         }
@@ -61,13 +74,7 @@ public:
         return result;
     }
 
-    HashMap()
-    {
-        for (size_t i = 0; i < BUCKET_COUNT; i++)
-        {
-            _buckets.push_back({});
-        }
-    }
+    HashMap() {}
 
     HashMap(const HashMap &other)
         : _buckets(other._buckets)
@@ -86,6 +93,11 @@ public:
 
     void remove_key(TKey &key)
     {
+        if (_buckets.empty())
+        {
+            return;
+        }
+
         uint32_t h = hash<TKey>(key);
 
         bucket(h).remove_all_match([&](auto &item) {
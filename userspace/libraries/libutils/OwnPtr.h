@@ -2,6 +2,8 @@
 
 #include <assert.h>
 
+#include <libutils/Move.h>
+
 template <typename T>
 class OwnPtr
 {
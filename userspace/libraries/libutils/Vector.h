@@ -73,7 +73,8 @@ public:
         return _storage[index];
     }
 
-    Vector() : Vector(16) {}
+    // Storage is only allocated on the first insertion.
+    Vector() {}
 
     Vector(size_t capacity)
     {
@@ -308,15 +309,14 @@ public:
         free(_storage);
         _storage = new_storage;
         _capacity = new_capacity;
-
-        _count++;
     }
 
     void grow()
     {
         if (_count + 1 >= _capacity)
         {
-            size_t new_capacity = _capacity + _capacity / 4;
+            // Moved-from vectors have no storage left.
+            size_t new_capacity = MAX(_capacity + _capacity / 4, 16);
             T *new_storage = reinterpret_cast<T *>(calloc(new_capacity, sizeof(T)));
 
             for (size_t i = 0; i < _count; i++)
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <libio/MemoryWriter.h>
+#include <libutils/json/Value.h>
+
+namespace Json
+{
+
+// Compact binary form of values, for IPC and files that are never edited by
+// hand. Each value starts with its type as a byte, lengths and integers are
+// LEB128 varints (integers zigzag encoded):
+//
+//     STRING   length, bytes
+//     INTEGER  varint
+//     DOUBLE   8 bytes, native order
+//     OBJECT   count, then count times key length, key bytes, value
+//     ARRAY    count, then count values
+//     TRUE, FALSE and NIL have no content.
+//
+// Nothing has to be escaped or parsed back, strings are copied as is.
+
+class BinaryWriter
+{
+private:
+    IO::MemoryWriter &_memory;
+
+public:
+    BinaryWriter(IO::MemoryWriter &memory) : _memory{memory} {}
+
+    void varint(uint64_t value)
+    {
+        uint8_t buffer[10];
+        size_t size = 0;
+
+        do
+        {
+            buffer[size] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+            value >>= 7;
+            size++;
+        } while (value);
+
+        _memory.write(buffer, size);
+    }
+
+    void string(const char *buffer, size_t size)
+    {
+        varint(size);
+        _memory.write(buffer, size);
+    }
+
+    void string(const String &str)
+    {
+        string(str.cstring(), str.length());
+    }
+
+    void value(const Value &value)
+    {
+        if (value.is(STRING))
+        {
+            _memory.write((uint8_t)STRING);
+            string(value.as_string());
+        }
+        else if (value.is(INTEGER))
+        {
+            int64_t integer = value.as_integer();
+
+            _memory.write((uint8_t)INTEGER);
+            varint(((uint64_t)integer << 1) ^ (uint64_t)(integer >> 63));
+        }
+#ifndef __KERNEL__
+        else if (value.is(DOUBLE))
+        {
+            double number = value.as_double();
+
+            _memory.write((uint8_t)DOUBLE);
+            _memory.write(&number, sizeof(number));
+        }
+#endif
+        else if (value.is(OBJECT))
+        {
+            auto &object = value.as_object();
+
+            _memory.write((uint8_t)OBJECT);
+            varint(object.count());
+
+            object.foreach ([&](auto &key, auto &member) {
+                string(key);
+                this->value(member);
+
+                return Iteration::CONTINUE;
+            });
+        }
+        else if (value.is(ARRAY))
+        {
+            auto &array = value.as_array();
+
+            _memory.write((uint8_t)ARRAY);
+            varint(array.count());
+
+            for (size_t i = 0; i < array.count(); i++)
+            {
+                this->value(array[i]);
+            }
+        }
+        else if (value.is(TRUE) || value.is(FALSE))
+        {
+            _memory.write((uint8_t)(value.is(TRUE) ? TRUE : FALSE));
+        }
+        else
+        {
+            _memory.write((uint8_t)NIL);
+        }
+    }
+};
+
+// Reads what a BinaryWriter wrote, malformed or truncated input turns the
+// reader into an error state and every following read returns nothing.
+class BinaryReader
+{
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    const uint8_t *_current;
+    const uint8_t *_end;
+    bool _error = false;
+    int _depth = 0;
+
+    // Lengths are read as 64 bits, they are checked before they are
+    // narrowed to a size_t.
+    bool ensure(uint64_t size)
+    {
+        if (_error || (uint64_t)(_end - _current) < size)
+        {
+            _error = true;
+        }
+
+        return !_error;
+    }
+
+public:
+    bool error() const { return _error; }
+
+    bool ended() const { return _current == _end; }
+
+    BinaryReader(const void *buffer, size_t size)
+        : _current{reinterpret_cast<const uint8_t *>(buffer)},
+          _end{reinterpret_cast<const uint8_t *>(buffer) + size}
+    {
+    }
+
+    uint8_t byte()
+    {
+        if (!ensure(1))
+        {
+            return 0;
+        }
+
+        return *_current++;
+    }
+
+    uint64_t varint()
+    {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t current = byte();
+
+            value |= (uint64_t)(current & 0x7f) << shift;
+
+            if (!(current & 0x80))
+            {
+                return value;
+            }
+        }
+
+        _error = true;
+        return 0;
+    }
+
+    // The next bytes as a reader of their own.
+    BinaryReader slice(size_t size)
+    {
+        if (!ensure(size))
+        {
+            return {_current, 0};
+        }
+
+        BinaryReader reader{_current, size};
+        _current += size;
+
+        return reader;
+    }
+
+    String string()
+    {
+        uint64_t size = varint();
+
+        if (!ensure(size))
+        {
+            return "";
+        }
+
+        String result{reinterpret_cast<const char *>(_current), (size_t)size};
+        _current += size;
+
+        return result;
+    }
+
+    Value value()
+    {
+        if (_depth >= MAX_DEPTH)
+        {
+            _error = true;
+        }
+
+        auto type = byte();
+
+        if (_error)
+        {
+            return nullptr;
+        }
+
+        switch (type)
+        {
+        case STRING:
+            return string();
+
+        case INTEGER:
+        {
+            uint64_t zigzag = varint();
+            return (int64_t)((zigzag >> 1) ^ -(zigzag & 1));
+        }
+
+#ifndef __KERNEL__
+        case DOUBLE:
+        {
+            double number = 0;
+
+            if (ensure(sizeof(number)))
+            {
+                memcpy(&number, _current, sizeof(number));
+                _current += sizeof(number);
+            }
+
+            return number;
+        }
+#endif
+
+        case OBJECT:
+        {
+            Value::Object object;
+            uint64_t count = varint();
+
+            _depth++;
+
+            for (uint64_t i = 0; i < count && !_error; i++)
+            {
+                auto key = string();
+                object[key] = value();
+            }
+
+            _depth--;
+
+            return move(object);
+        }
+
+        case ARRAY:
+        {
+            Value::Array array;
+            uint64_t count = varint();
+
+            _depth++;
+
+            for (uint64_t i = 0; i < count && !_error; i++)
+            {
+                array.push_back(value());
+            }
+
+            _depth--;
+
+            return move(array);
+        }
+
+        case TRUE:
+            return true;
+
+        case FALSE:
+            return false;
+
+        case NIL:
+            return nullptr;
+
+        default:
+            _error = true;
+            return nullptr;
+        }
+    }
+};
+
+} // namespace Json
@@ -0,0 +1,587 @@
+#pragma once
+
+#include <libio/Copy.h>
+#include <libutils/Arena.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+#include <libutils/json/Sax.h>
+#include <libutils/json/Value.h>
+
+namespace Json
+{
+
+struct Member;
+
+// Read-only JSON value, allocated in the arena of a Document.
+class Node
+{
+private:
+    friend class DocumentBuilder;
+
+    Type _type = NIL;
+
+    union
+    {
+        int64_t _integer;
+#ifndef __KERNEL__
+        double _double;
+#endif
+        struct
+        {
+            const char *buffer;
+            size_t size;
+        } _string;
+
+        struct
+        {
+            const Member *members;
+            size_t count;
+        } _object;
+
+        struct
+        {
+            const Node *elements;
+            size_t count;
+        } _array;
+    };
+
+    static const Node &nil()
+    {
+        static const Node nil{};
+        return nil;
+    }
+
+public:
+    bool is(Type type) const { return _type == type; }
+
+    Node() : _object{nullptr, 0} {}
+
+    // Points into the source document (or the arena for decoded strings).
+    StringView as_string_view() const
+    {
+        if (_type == STRING)
+        {
+            return {_string.buffer, _string.size};
+        }
+        else if (_type == TRUE)
+        {
+            return "true";
+        }
+        else if (_type == FALSE)
+        {
+            return "false";
+        }
+        else
+        {
+            return "null";
+        }
+    }
+
+    String as_string() const
+    {
+        auto view = as_string_view();
+        return {view.buffer(), view.size()};
+    }
+
+    int64_t as_integer() const
+    {
+        if (_type == INTEGER)
+        {
+            return _integer;
+        }
+#ifndef __KERNEL__
+        else if (_type == DOUBLE)
+        {
+            return _double;
+        }
+#endif
+        else
+        {
+            return _type == TRUE;
+        }
+    }
+
+#ifndef __KERNEL__
+    double as_double() const
+    {
+        if (_type == DOUBLE)
+        {
+            return _double;
+        }
+        else
+        {
+            return as_integer();
+        }
+    }
+#endif
+
+    bool as_bool() const
+    {
+        return as_integer() != 0;
+    }
+
+    size_t length() const
+    {
+        if (_type == OBJECT)
+        {
+            return _object.count;
+        }
+        else if (_type == ARRAY)
+        {
+            return _array.count;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    inline const Member *member(const char *key, size_t size) const;
+
+    bool has(const char *key) const
+    {
+        return member(key, strlen(key)) != nullptr;
+    }
+
+    inline const Node &get(const char *key) const;
+
+    const Node &get(size_t index) const
+    {
+        if (_type != ARRAY || index >= _array.count)
+        {
+            return nil();
+        }
+
+        return _array.elements[index];
+    }
+
+    template <typename TCallback>
+    inline void with(const char *key, TCallback callback) const;
+
+    // Members are visited sorted by key.
+    template <typename TCallback>
+    inline Iteration foreach (TCallback callback) const;
+
+    // Deep copy into a Json::Value, for code that still needs one.
+    inline Value to_value() const;
+};
+
+struct Member
+{
+    const char *key;
+    size_t key_size;
+    Node value;
+
+    StringView name() const { return {key, key_size}; }
+
+    static int compare(const char *left, size_t left_size, const char *right, size_t right_size)
+    {
+        int result = memcmp(left, right, MIN(left_size, right_size));
+
+        if (result != 0)
+        {
+            return result;
+        }
+
+        return (int)(left_size > right_size) - (int)(left_size < right_size);
+    }
+};
+
+// Objects keep their members in a compact array sorted by key.
+inline const Member *Node::member(const char *key, size_t size) const
+{
+    if (_type != OBJECT)
+    {
+        return nullptr;
+    }
+
+    size_t low = 0;
+    size_t high = _object.count;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        auto &m = _object.members[middle];
+
+        int result = Member::compare(m.key, m.key_size, key, size);
+
+        if (result == 0)
+        {
+            return &m;
+        }
+        else if (result < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return nullptr;
+}
+
+inline const Node &Node::get(const char *key) const
+{
+    auto *m = member(key, strlen(key));
+
+    if (!m)
+    {
+        return nil();
+    }
+
+    return m->value;
+}
+
+template <typename TCallback>
+inline void Node::with(const char *key, TCallback callback) const
+{
+    auto *m = member(key, strlen(key));
+
+    if (m)
+    {
+        callback(m->value);
+    }
+}
+
+template <typename TCallback>
+inline Iteration Node::foreach (TCallback callback) const
+{
+    for (size_t i = 0; i < length(); i++)
+    {
+        Iteration iteration;
+
+        if (_type == OBJECT)
+        {
+            iteration = callback(_object.members[i].name(), _object.members[i].value);
+        }
+        else
+        {
+            iteration = callback(StringView{""}, _array.elements[i]);
+        }
+
+        if (iteration == Iteration::STOP)
+        {
+            return Iteration::STOP;
+        }
+    }
+
+    return Iteration::CONTINUE;
+}
+
+inline Value Node::to_value() const
+{
+    switch (_type)
+    {
+    case STRING:
+        return String{_string.buffer, _string.size};
+
+    case INTEGER:
+        return _integer;
+
+#ifndef __KERNEL__
+    case DOUBLE:
+        return _double;
+#endif
+
+    case TRUE:
+        return true;
+
+    case FALSE:
+        return false;
+
+    case OBJECT:
+    {
+        Value::Object object;
+
+        for (size_t i = 0; i < _object.count; i++)
+        {
+            auto &m = _object.members[i];
+            object[String{m.key, m.key_size}] = m.value.to_value();
+        }
+
+        return move(object);
+    }
+
+    case ARRAY:
+    {
+        Value::Array array;
+
+        for (size_t i = 0; i < _array.count; i++)
+        {
+            array.push_back(_array.elements[i].to_value());
+        }
+
+        return move(array);
+    }
+
+    default:
+        return nullptr;
+    }
+}
+
+// Builds the nodes of a document from the events of the sax parser,
+// values are kept on a stack until their container is closed.
+class DocumentBuilder
+{
+private:
+    Arena &_arena;
+
+    const char *_source;
+    size_t _source_size;
+
+    struct Container
+    {
+        const char *key;
+        size_t key_size;
+        size_t start;
+    };
+
+    Vector<Member> _stack{};
+    Vector<Container> _containers{};
+
+    const char *_key = "";
+    size_t _key_size = 0;
+
+    // Strings in the source buffer are used as is, decoded ones are copied.
+    const char *keep(const StringView &view)
+    {
+        if (view.buffer() >= _source && view.buffer() + view.size() <= _source + _source_size)
+        {
+            return view.buffer();
+        }
+
+        return _arena.copy(view.buffer(), view.size());
+    }
+
+    void push(Node node)
+    {
+        _stack.push_back({_key, _key_size, node});
+    }
+
+    void begin()
+    {
+        _containers.push_back({_key, _key_size, _stack.count()});
+    }
+
+    // Returns where the elements of the container start on the stack.
+    size_t end()
+    {
+        auto container = _containers.pop_back();
+
+        _key = container.key;
+        _key_size = container.key_size;
+
+        return container.start;
+    }
+
+    static void sort(Member *members, size_t count)
+    {
+        // Insertion sort, stable so duplicated keys stay in order.
+        for (size_t i = 1; i < count; i++)
+        {
+            Member member = members[i];
+            size_t j = i;
+
+            while (j > 0 && Member::compare(members[j - 1].key, members[j - 1].key_size, member.key, member.key_size) > 0)
+            {
+                members[j] = members[j - 1];
+                j--;
+            }
+
+            members[j] = member;
+        }
+    }
+
+public:
+    DocumentBuilder(Arena &arena, const char *source, size_t size)
+        : _arena{arena}, _source{source}, _source_size{size}
+    {
+    }
+
+    Node root()
+    {
+        if (_stack.count() != 1)
+        {
+            return {};
+        }
+
+        return _stack[0].value;
+    }
+
+    void on_null()
+    {
+        push({});
+    }
+
+    void on_bool(bool value)
+    {
+        Node node;
+        node._type = value ? TRUE : FALSE;
+        push(node);
+    }
+
+    void on_integer(int64_t value)
+    {
+        Node node;
+        node._type = INTEGER;
+        node._integer = value;
+        push(node);
+    }
+
+#ifndef __KERNEL__
+    void on_double(double value)
+    {
+        Node node;
+        node._type = DOUBLE;
+        node._double = value;
+        push(node);
+    }
+#endif
+
+    void on_string(StringView value)
+    {
+        Node node;
+        node._type = STRING;
+        node._string.buffer = keep(value);
+        node._string.size = value.size();
+        push(node);
+    }
+
+    void on_key(StringView key)
+    {
+        _key = keep(key);
+        _key_size = key.size();
+    }
+
+    void on_begin_object()
+    {
+        begin();
+    }
+
+    void on_end_object(size_t)
+    {
+        size_t start = end();
+        size_t count = _stack.count() - start;
+
+        Member *members = _arena.make_array<Member>(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            members[i] = _stack[start + i];
+        }
+
+        sort(members, count);
+
+        // Duplicated keys, the last one wins.
+        size_t unique = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (unique > 0 && Member::compare(members[unique - 1].key, members[unique - 1].key_size, members[i].key, members[i].key_size) == 0)
+            {
+                unique--;
+            }
+
+            members[unique++] = members[i];
+        }
+
+        _stack.resize(start);
+
+        Node node;
+        node._type = OBJECT;
+        node._object.members = members;
+        node._object.count = unique;
+        push(node);
+    }
+
+    void on_begin_array()
+    {
+        begin();
+    }
+
+    void on_end_array(size_t)
+    {
+        size_t start = end();
+        size_t count = _stack.count() - start;
+
+        Node *elements = _arena.make_array<Node>(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            elements[i] = _stack[start + i].value;
+        }
+
+        _stack.resize(start);
+
+        Node node;
+        node._type = ARRAY;
+        node._array.elements = elements;
+        node._array.count = count;
+        push(node);
+    }
+};
+
+// A parsed document, all its nodes live in a single arena. Strings that
+// don't need decoding point directly into the source, which is kept alive
+// by the document.
+class Document
+{
+private:
+    Slice _source;
+    Arena _arena{};
+    Node _root{};
+    Result _result = SUCCESS;
+
+    void parse(Slice source)
+    {
+        _source = source;
+
+        auto buffer = reinterpret_cast<const char *>(_source.start());
+
+        DocumentBuilder builder{_arena, buffer, _source.size()};
+        _result = sax(buffer, _source.size(), builder);
+
+        if (_result == SUCCESS)
+        {
+            _root = builder.root();
+        }
+    }
+
+public:
+    const Node &root() const { return _root; }
+
+    Result result() const { return _result; }
+
+    bool valid() const { return _result == SUCCESS; }
+
+    size_t allocated() const { return _arena.allocated(); }
+
+    NONCOPYABLE(Document);
+
+    Document(Slice source)
+    {
+        parse(source);
+    }
+
+    Document(const String &source)
+    {
+        parse(source.slice());
+    }
+
+    Document(IO::Reader &reader)
+    {
+        auto source = IO::read_all(reader);
+
+        if (!source.success())
+        {
+            _result = source.result();
+            return;
+        }
+
+        parse(source.unwrap());
+    }
+};
+
+} // namespace Json
@@ -3,6 +3,7 @@
 #include <libutils/Scanner.h>
 #include <libutils/String.h>
 
+#include <libutils/json/Document.h>
 #include <libutils/json/Parser.h>
 #include <libutils/json/Prettifier.h>
 #include <libutils/json/Value.h>
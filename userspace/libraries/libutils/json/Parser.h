@@ -1,293 +1,120 @@
 #pragma once
 
-#include <libio/MemoryReader.h>
-#include <libio/NumberScanner.h>
-#include <libio/Scanner.h>
-#include <libutils/StringBuilder.h>
-#include <libutils/Strings.h>
+#include <libio/Copy.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+#include <libutils/json/Sax.h>
 #include <libutils/json/Value.h>
-#include <libio/ScopedReader.h>
 
 namespace Json
 {
 
-Value value(IO::Scanner &scan);
-
-inline void whitespace(IO::Scanner &scan)
-{
-    scan.eat(Strings::WHITESPACE);
-}
-
-inline Value number(IO::Scanner &scan)
-{
-#ifdef __KERNEL__
-    return IO::NumberScanner::decimal().scan_int(scan).unwrap_or(0);
-#else
-    return IO::NumberScanner::decimal().scan_float(scan).unwrap_or(0);
-#endif
-}
-
-static inline const char *escape_sequence(IO::Scanner &scan)
+// Builds a Json::Value from the events of the sax parser. Containers are
+// filled in place and moved into their parent once they are closed.
+class ValueBuilder
 {
-    scan.skip('\\');
-
-    if (scan.ended())
-    {
-        return "\\";
-    }
-
-    char chr = scan.current();
-    scan.forward();
-
-    switch (chr)
+private:
+    struct Container
     {
-    case '"':
-        return "\"";
-
-    case '\\':
-        return "\\";
-
-    case '/':
-        return "/";
-
-    case 'b':
-        return "\b";
-
-    case 'f':
-        return "\f";
-
-    case 'n':
-        return "\n";
+        bool is_object;
+        String key;
+    };
 
-    case 'r':
-        return "\r";
+    Vector<Container> _containers{};
+    Vector<Value::Object> _objects{};
+    Vector<Value::Array> _arrays{};
 
-    case 't':
-        return "\t";
+    String _key{};
+    Value _root{};
 
-    case 'u':
+    void push(Value &&value)
     {
-        auto read_4hex = [&]() {
-            char buffer[5];
-            for (size_t i = 0; i < 4 && scan.current_is(Strings::LOWERCASE_XDIGITS); i++)
-            {
-                buffer[i] = scan.current();
-                scan.forward();
-            }
-
-            IO::MemoryReader memory{buffer, 5};
-            IO::Scanner bufscan{memory};
-            return IO::NumberScanner::hexadecimal().scan_uint(bufscan).unwrap_or(0);
-        };
-
-        uint32_t first_surrogate = read_4hex();
-
-        if (first_surrogate >= 0xDC00 && first_surrogate <= 0xDFFF)
+        if (_containers.empty())
         {
-            // FIXME: We should use char8_t
-            return reinterpret_cast<const char *>(u8"�");
+            _root = move(value);
         }
-
-        if (!(first_surrogate >= 0xD800 && first_surrogate <= 0xDBFF))
+        else if (_containers.peek_back().is_object)
         {
-            // Not an UTF16 surrogate pair.
-            static uint8_t utf8[5] = {};
-            codepoint_to_utf8(first_surrogate, utf8);
-            return (char *)utf8;
-        }
-
-        if (!scan.skip_word("\\u"))
-        {
-            // FIXME: We should use char8_t
-            return reinterpret_cast<const char *>(u8"�");
-        }
-
-        uint32_t second_surrogate = read_4hex();
-
-        if ((second_surrogate < 0xDC00) || (second_surrogate > 0xDFFF))
-        {
-            // Invalid second half of the surrogate pair
-            // FIXME: We should use char8_t
-            return reinterpret_cast<const char *>(u8"�");
-        }
-
-        Codepoint codepoint = 0x10000 + (((first_surrogate & 0x3FF) << 10) | (second_surrogate & 0x3FF));
-
-        static uint8_t utf8[5] = {};
-        codepoint_to_utf8(codepoint, utf8);
-        return (char *)utf8;
-    }
-
-    default:
-        break;
-    }
-
-    static char buffer[3] = "\\x";
-    buffer[1] = chr;
-
-    return buffer;
-}
-
-inline String string(IO::Scanner &scan)
-{
-    StringBuilder builder{};
-
-    scan.skip('"');
-
-    while (scan.current() != '"' && scan.do_continue())
-    {
-        if (scan.current() == '\\')
-        {
-            builder.append(escape_sequence(scan));
+            _objects.peek_back()[_key] = move(value);
         }
         else
         {
-            builder.append(scan.current());
-            scan.forward();
+            _arrays.peek_back().push_back(move(value));
         }
     }
 
-    scan.skip('"');
+public:
+    Value &root() { return _root; }
 
-    return builder.finalize();
-}
-
-inline Value array(IO::Scanner &scan)
-{
-    scan.skip('[');
+    void on_null() { push(nullptr); }
 
-    Value::Array array{};
+    void on_bool(bool value) { push(value); }
 
-    whitespace(scan);
+    void on_integer(int64_t value) { push(value); }
 
-    if (scan.skip(']'))
-    {
-        return move(array);
-    }
-
-    int index = 0;
-
-    do
-    {
-        scan.skip(',');
-        array.push_back(value(scan));
-        index++;
-    } while (scan.current() == ',');
-
-    scan.skip(']');
-
-    return move(array);
-}
-
-inline Value object(IO::Scanner &scan)
-{
-    scan.skip('{');
+#ifndef __KERNEL__
+    void on_double(double value) { push(value); }
+#endif
 
-    Value::Object object{};
+    void on_string(StringView value) { push(String{value.buffer(), value.size()}); }
 
-    whitespace(scan);
+    void on_key(StringView key) { _key = String{key.buffer(), key.size()}; }
 
-    if (scan.skip('}'))
+    void on_begin_object()
     {
-        return object;
+        _containers.push_back({true, _key});
+        _objects.push_back({});
     }
 
-    while (scan.current() != '}')
-    {
-        auto k = string(scan);
-        whitespace(scan);
-
-        scan.skip(':');
-
-        object[k] = value(scan);
-
-        scan.skip(',');
-
-        whitespace(scan);
-    }
-
-    scan.skip('}');
-
-    return object;
-}
-
-inline Value keyword(IO::Scanner &scan)
-{
-    StringBuilder builder{};
-
-    while (scan.current_is(Strings::LOWERCASE_ALPHA) &&
-           scan.do_continue())
+    void on_end_object(size_t)
     {
-        builder.append(scan.current());
-        scan.forward();
+        auto object = _objects.pop_back();
+        _key = _containers.pop_back().key;
+        push(move(object));
     }
 
-    auto keyword = builder.finalize();
-
-    if (keyword == "true")
+    void on_begin_array()
     {
-        return true;
+        _containers.push_back({false, _key});
+        _arrays.push_back({});
     }
 
-    if (keyword == "false")
+    void on_end_array(size_t)
     {
-        return false;
+        auto array = _arrays.pop_back();
+        _key = _containers.pop_back().key;
+        push(move(array));
     }
+};
 
-    return nullptr;
-}
-
-inline Value value(IO::Scanner &scan)
+// Malformed documents are parsed as null.
+inline Value parse(const char *buffer, size_t size)
 {
-    whitespace(scan);
-
-    Value value{};
+    ValueBuilder builder;
 
-    if (scan.current() == '"')
-    {
-        value = string(scan);
-    }
-    else if (scan.current_is("-") ||
-             scan.current_is("0123456789"))
-    {
-        value = number(scan);
-    }
-    else if (scan.current() == '{')
+    if (sax(buffer, size, builder) != SUCCESS)
     {
-        value = object(scan);
+        return nullptr;
     }
-    else if (scan.current() == '[')
-    {
-        value = array(scan);
-    }
-    else
-    {
-        value = keyword(scan);
-    }
-
-    whitespace(scan);
 
-    return value;
+    return move(builder.root());
 }
 
-inline Value parse(IO::Reader &reader)
+inline Value parse(String &str)
 {
-    IO::Scanner scan{reader};
-    scan.skip_utf8bom();
-    return value(scan);
+    return parse(str.cstring(), str.length());
 }
 
-inline Value parse(const char *buffer, size_t size)
+inline Value parse(IO::Reader &reader)
 {
-    IO::MemoryReader memory{buffer, size};
-    return parse(memory);
-}
+    auto source = IO::read_all(reader);
 
-inline Value parse(String&str)
-{
-    IO::MemoryReader memory{str};
-    return parse(memory);
-}
+    if (!source.success())
+    {
+        return nullptr;
+    }
 
+    return parse(reinterpret_cast<const char *>(source.unwrap().start()), source.unwrap().size());
+}
 
-} // namespace Json
\ No newline at end of file
+} // namespace Json
@@ -0,0 +1,567 @@
+#pragma once
+
+#ifndef __KERNEL__
+#    include <math.h>
+#endif
+
+#include <string.h>
+
+#include <libmath/MinMax.h>
+#include <libutils/ResultOr.h>
+#include <libutils/StringView.h>
+#include <libutils/unicode/Codepoint.h>
+
+namespace Json
+{
+
+// Event based parser working on an in-memory document, nothing is
+// allocated for the document itself. THandler must provide:
+//
+//     void on_null();
+//     void on_bool(bool value);
+//     void on_integer(int64_t value);
+//     void on_double(double value);         // Not in the kernel
+//     void on_string(StringView value);
+//     void on_key(StringView key);
+//     void on_begin_object();
+//     void on_end_object(size_t members);
+//     void on_begin_array();
+//     void on_end_array(size_t elements);
+//
+// Strings without escape sequences point directly into the source buffer,
+// the others are decoded in a scratch buffer that is only valid during the
+// callback.
+template <typename THandler>
+class Sax
+{
+private:
+    static constexpr int MAX_DEPTH = 512;
+
+    THandler &_handler;
+
+    const char *_cursor;
+    const char *_end;
+
+    int _depth = 0;
+
+    char *_scratch = nullptr;
+    size_t _scratch_used = 0;
+    size_t _scratch_capacity = 0;
+
+    bool ended() { return _cursor >= _end; }
+
+    char current() { return ended() ? '\0' : *_cursor; }
+
+    bool skip(char c)
+    {
+        if (current() == c)
+        {
+            _cursor++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool skip_word(const char *word, size_t size)
+    {
+        if ((size_t)(_end - _cursor) < size || memcmp(_cursor, word, size) != 0)
+        {
+            return false;
+        }
+
+        _cursor += size;
+        return true;
+    }
+
+    void whitespace()
+    {
+        while (_cursor < _end &&
+               (*_cursor == ' ' || *_cursor == '\n' || *_cursor == '\r' || *_cursor == '\t'))
+        {
+            _cursor++;
+        }
+    }
+
+    void scratch_append(const char *data, size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+
+        if (_scratch_used + size > _scratch_capacity)
+        {
+            size_t new_capacity = MAX(_scratch_capacity * 2, MAX(_scratch_used + size, 64));
+            char *new_scratch = new char[new_capacity];
+
+            if (_scratch)
+            {
+                memcpy(new_scratch, _scratch, _scratch_used);
+                delete[] _scratch;
+            }
+
+            _scratch = new_scratch;
+            _scratch_capacity = new_capacity;
+        }
+
+        memcpy(_scratch + _scratch_used, data, size);
+        _scratch_used += size;
+    }
+
+    bool hex4(uint32_t &result)
+    {
+        result = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            char c = current();
+
+            if (c >= '0' && c <= '9')
+            {
+                result = result * 16 + (c - '0');
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                result = result * 16 + (c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                result = result * 16 + (c - 'A' + 10);
+            }
+            else
+            {
+                return false;
+            }
+
+            _cursor++;
+        }
+
+        return true;
+    }
+
+    Result escape_sequence()
+    {
+        _cursor++; // Skip the backslash
+
+        char chr = current();
+        _cursor++;
+
+        switch (chr)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            scratch_append(&chr, 1);
+            return SUCCESS;
+
+        case 'b':
+            scratch_append("\b", 1);
+            return SUCCESS;
+
+        case 'f':
+            scratch_append("\f", 1);
+            return SUCCESS;
+
+        case 'n':
+            scratch_append("\n", 1);
+            return SUCCESS;
+
+        case 'r':
+            scratch_append("\r", 1);
+            return SUCCESS;
+
+        case 't':
+            scratch_append("\t", 1);
+            return SUCCESS;
+
+        case 'u':
+        {
+            uint32_t first_surrogate;
+
+            if (!hex4(first_surrogate))
+            {
+                return ERR_INVALID_DATA;
+            }
+
+            Codepoint codepoint = first_surrogate;
+
+            if (first_surrogate >= 0xDC00 && first_surrogate <= 0xDFFF)
+            {
+                codepoint = U'�';
+            }
+            else if (first_surrogate >= 0xD800 && first_surrogate <= 0xDBFF)
+            {
+                uint32_t second_surrogate;
+
+                if (!skip_word("\\u", 2) ||
+                    !hex4(second_surrogate) ||
+                    second_surrogate < 0xDC00 || second_surrogate > 0xDFFF)
+                {
+                    codepoint = U'�';
+                }
+                else
+                {
+                    codepoint = 0x10000 + (((first_surrogate & 0x3FF) << 10) | (second_surrogate & 0x3FF));
+                }
+            }
+
+            uint8_t utf8[5] = {};
+            int length = codepoint_to_utf8(codepoint, utf8);
+            scratch_append(reinterpret_cast<const char *>(utf8), length);
+
+            return SUCCESS;
+        }
+
+        default:
+            return ERR_INVALID_DATA;
+        }
+    }
+
+    Result string(bool is_key)
+    {
+        _cursor++; // Skip the opening quote
+
+        const char *start = _cursor;
+
+        while (_cursor < _end && *_cursor != '"' && *_cursor != '\\')
+        {
+            _cursor++;
+        }
+
+        if (ended())
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        StringView view{start, (size_t)(_cursor - start)};
+
+        if (*_cursor == '\\')
+        {
+            // Slow path, the string has to be decoded.
+            _scratch_used = 0;
+            scratch_append(start, _cursor - start);
+
+            while (!ended() && current() != '"')
+            {
+                if (current() == '\\')
+                {
+                    TRY(escape_sequence());
+                }
+                else
+                {
+                    const char *run = _cursor;
+
+                    while (_cursor < _end && *_cursor != '"' && *_cursor != '\\')
+                    {
+                        _cursor++;
+                    }
+
+                    scratch_append(run, _cursor - run);
+                }
+            }
+
+            if (ended())
+            {
+                return ERR_INVALID_DATA;
+            }
+
+            view = StringView{_scratch, _scratch_used};
+        }
+
+        _cursor++; // Skip the closing quote
+
+        if (is_key)
+        {
+            _handler.on_key(view);
+        }
+        else
+        {
+            _handler.on_string(view);
+        }
+
+        return SUCCESS;
+    }
+
+    Result number()
+    {
+        bool negative = skip('-');
+
+        if (!(current() >= '0' && current() <= '9'))
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+
+        while (current() >= '0' && current() <= '9')
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (current() - '0');
+                digits += mantissa > 0;
+            }
+            else
+            {
+                exponent++;
+            }
+
+            _cursor++;
+        }
+
+        bool is_integer = exponent == 0 && digits <= 18;
+
+        if (skip('.'))
+        {
+            is_integer = false;
+
+            while (current() >= '0' && current() <= '9')
+            {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + (current() - '0');
+                    digits += mantissa > 0;
+                    exponent--;
+                }
+
+                _cursor++;
+            }
+        }
+
+        if (current() == 'e' || current() == 'E')
+        {
+            is_integer = false;
+            _cursor++;
+
+            bool negative_exponent = skip('-');
+
+            if (!negative_exponent)
+            {
+                skip('+');
+            }
+
+            int explicit_exponent = 0;
+
+            while (current() >= '0' && current() <= '9')
+            {
+                explicit_exponent = MIN(explicit_exponent * 10 + (current() - '0'), 100000);
+                _cursor++;
+            }
+
+            exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+        }
+
+        if (is_integer)
+        {
+            int64_t value = mantissa;
+            _handler.on_integer(negative ? -value : value);
+
+            return SUCCESS;
+        }
+
+#ifdef __KERNEL__
+        // No floating point in the kernel, truncate to an integer.
+        while (exponent < 0 && mantissa > 0)
+        {
+            mantissa /= 10;
+            exponent++;
+        }
+
+        int64_t value = exponent > 0 ? 0 : mantissa;
+        _handler.on_integer(negative ? -value : value);
+#else
+        double value = mantissa;
+
+        if (exponent < 0)
+        {
+            value /= pow(10, -exponent);
+        }
+        else if (exponent > 0)
+        {
+            value *= pow(10, exponent);
+        }
+
+        _handler.on_double(negative ? -value : value);
+#endif
+
+        return SUCCESS;
+    }
+
+    Result array()
+    {
+        _cursor++; // Skip the opening bracket
+        _handler.on_begin_array();
+
+        size_t elements = 0;
+
+        whitespace();
+
+        if (!skip(']'))
+        {
+            do
+            {
+                TRY(value());
+                elements++;
+            } while (skip(','));
+
+            if (!skip(']'))
+            {
+                return ERR_INVALID_DATA;
+            }
+        }
+
+        _handler.on_end_array(elements);
+
+        return SUCCESS;
+    }
+
+    Result object()
+    {
+        _cursor++; // Skip the opening brace
+        _handler.on_begin_object();
+
+        size_t members = 0;
+
+        whitespace();
+
+        if (!skip('}'))
+        {
+            do
+            {
+                whitespace();
+
+                if (current() != '"')
+                {
+                    return ERR_INVALID_DATA;
+                }
+
+                TRY(string(true));
+
+                whitespace();
+
+                if (!skip(':'))
+                {
+                    return ERR_INVALID_DATA;
+                }
+
+                TRY(value());
+                members++;
+            } while (skip(','));
+
+            if (!skip('}'))
+            {
+                return ERR_INVALID_DATA;
+            }
+        }
+
+        _handler.on_end_object(members);
+
+        return SUCCESS;
+    }
+
+    Result keyword()
+    {
+        if (skip_word("true", 4))
+        {
+            _handler.on_bool(true);
+        }
+        else if (skip_word("false", 5))
+        {
+            _handler.on_bool(false);
+        }
+        else if (skip_word("null", 4))
+        {
+            _handler.on_null();
+        }
+        else
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        return SUCCESS;
+    }
+
+    Result value()
+    {
+        if (++_depth > MAX_DEPTH)
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        whitespace();
+
+        Result result = SUCCESS;
+
+        switch (current())
+        {
+        case '"':
+            result = string(false);
+            break;
+
+        case '{':
+            result = object();
+            break;
+
+        case '[':
+            result = array();
+            break;
+
+        case 't':
+        case 'f':
+        case 'n':
+            result = keyword();
+            break;
+
+        default:
+            result = number();
+            break;
+        }
+
+        whitespace();
+
+        _depth--;
+
+        return result;
+    }
+
+public:
+    Sax(THandler &handler, const char *buffer, size_t size)
+        : _handler{handler},
+          _cursor{buffer},
+          _end{buffer + size}
+    {
+    }
+
+    ~Sax()
+    {
+        if (_scratch)
+        {
+            delete[] _scratch;
+        }
+    }
+
+    Result parse()
+    {
+        skip_word("\xEF\xBB\xBF", 3); // UTF-8 byte order mark
+
+        TRY(value());
+
+        if (!ended())
+        {
+            return ERR_INVALID_DATA;
+        }
+
+        return SUCCESS;
+    }
+};
+
+template <typename THandler>
+Result sax(const char *buffer, size_t size, THandler &handler)
+{
+    Sax<THandler> parser{handler, buffer, size};
+    return parser.parse();
+}
+
+} // namespace Json
@@ -0,0 +1,524 @@
+#pragma once
+
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+namespace Regex
+{
+
+// A set of bytes, patterns are matched byte by byte.
+struct CharSet
+{
+    uint32_t bits[8] = {};
+
+    bool has(uint8_t c) const { return bits[c / 32] & (1u << (c % 32)); }
+
+    void add(uint8_t c) { bits[c / 32] |= 1u << (c % 32); }
+
+    void add(uint8_t from, uint8_t to)
+    {
+        for (int c = from; c <= to; c++)
+        {
+            add(c);
+        }
+    }
+
+    void add(const CharSet &other)
+    {
+        for (size_t i = 0; i < 8; i++)
+        {
+            bits[i] |= other.bits[i];
+        }
+    }
+
+    void invert()
+    {
+        for (size_t i = 0; i < 8; i++)
+        {
+            bits[i] = ~bits[i];
+        }
+    }
+
+    void fold_case()
+    {
+        for (int c = 'a'; c <= 'z'; c++)
+        {
+            if (has(c) || has(c - 'a' + 'A'))
+            {
+                add(c);
+                add(c - 'a' + 'A');
+            }
+        }
+    }
+
+    // The byte if the set has exactly one, -1 otherwise.
+    int single() const
+    {
+        int found = -1;
+
+        for (int c = 0; c < 256; c++)
+        {
+            if (has(c))
+            {
+                if (found != -1)
+                {
+                    return -1;
+                }
+
+                found = c;
+            }
+        }
+
+        return found;
+    }
+};
+
+enum NodeType
+{
+    NODE_EMPTY,
+    NODE_SET,
+    NODE_BEGIN,
+    NODE_END,
+    NODE_CONCAT,
+    NODE_ALTERNATION,
+    NODE_REPEAT,
+};
+
+// REPEAT_INFINITY as max means there is no upper bound.
+static constexpr int REPEAT_INFINITY = -1;
+
+// Counted repetitions are expanded when compiled, this keeps a{1000}{1000}
+// from exhausting the memory.
+static constexpr int REPEAT_MAX = 1000;
+
+struct Node
+{
+    NodeType type;
+    CharSet set;
+    Vector<int> children;
+    int min;
+    int max;
+};
+
+// Recursive descent parser of the syntax below, nodes are stored in a flat
+// vector and refer to their children by index:
+//
+//     alternation  concat ('|' concat)*
+//     concat       repeat*
+//     repeat       atom ('*' | '+' | '?' | '{n}' | '{n,}' | '{n,m}')*
+//     atom         '(' alternation ')' | '[' class ']' | '.' | '^' | '$'
+//                  | '\' escape | literal
+class Parser
+{
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    const char *_current;
+    const char *_end;
+    bool _ignore_case;
+
+    int _depth = 0;
+    const char *_error = nullptr;
+
+    Vector<Node> _nodes;
+
+    bool ended() { return _current >= _end; }
+
+    char peek() { return ended() ? '\0' : *_current; }
+
+    char next() { return ended() ? '\0' : *_current++; }
+
+    int fail(const char *message)
+    {
+        if (!_error)
+        {
+            _error = message;
+        }
+
+        _current = _end;
+
+        return add({NODE_EMPTY, {}, {}, 0, 0});
+    }
+
+    int add(Node &&node)
+    {
+        _nodes.push_back(move(node));
+        return _nodes.count() - 1;
+    }
+
+    int add_set(CharSet set)
+    {
+        if (_ignore_case)
+        {
+            set.fold_case();
+        }
+
+        return add({NODE_SET, set, {}, 0, 0});
+    }
+
+    static bool escape_class(char c, CharSet &set)
+    {
+        switch (c)
+        {
+        case 'd':
+        case 'D':
+            set.add('0', '9');
+            break;
+
+        case 'w':
+        case 'W':
+            set.add('a', 'z');
+            set.add('A', 'Z');
+            set.add('0', '9');
+            set.add('_');
+            break;
+
+        case 's':
+        case 'S':
+            set.add(' ');
+            set.add('\t', '\r');
+            break;
+
+        default:
+            return false;
+        }
+
+        if (c == 'D' || c == 'W' || c == 'S')
+        {
+            set.invert();
+        }
+
+        return true;
+    }
+
+    static uint8_t escape_literal(char c)
+    {
+        switch (c)
+        {
+        case 't':
+            return '\t';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        default:
+            return c;
+        }
+    }
+
+    int parse_class()
+    {
+        CharSet set{};
+        bool negated = false;
+
+        if (peek() == '^')
+        {
+            negated = true;
+            next();
+        }
+
+        bool first = true;
+
+        while (!ended() && (peek() != ']' || first))
+        {
+            first = false;
+
+            uint8_t from = next();
+
+            if (from == '\\')
+            {
+                char escaped = next();
+
+                // Expanded on its own, \D and the like are inverted without
+                // the rest of the class.
+                CharSet shorthand{};
+
+                if (escape_class(escaped, shorthand))
+                {
+                    set.add(shorthand);
+                    continue;
+                }
+
+                from = escape_literal(escaped);
+            }
+
+            if (peek() == '-' && _current + 1 < _end && _current[1] != ']')
+            {
+                next();
+
+                uint8_t to = next();
+
+                if (to == '\\')
+                {
+                    to = escape_literal(next());
+                }
+
+                if (to < from)
+                {
+                    return fail("Invalid range in character class");
+                }
+
+                set.add(from, to);
+            }
+            else
+            {
+                set.add(from);
+            }
+        }
+
+        if (next() != ']')
+        {
+            return fail("Missing ']'");
+        }
+
+        if (_ignore_case)
+        {
+            set.fold_case();
+        }
+
+        if (negated)
+        {
+            set.invert();
+        }
+
+        return add({NODE_SET, set, {}, 0, 0});
+    }
+
+    bool parse_number(int &value)
+    {
+        if (peek() < '0' || peek() > '9')
+        {
+            return false;
+        }
+
+        value = 0;
+
+        while (peek() >= '0' && peek() <= '9')
+        {
+            value = value * 10 + (next() - '0');
+
+            if (value > REPEAT_MAX)
+            {
+                fail("Repetition count too large");
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // A brace that doesn't start a valid count is a literal, like in most
+    // other engines.
+    bool parse_count(int &min, int &max)
+    {
+        const char *start = _current;
+
+        next();
+
+        if (!parse_number(min))
+        {
+            _current = _error ? _end : start;
+            return false;
+        }
+
+        max = min;
+
+        if (peek() == ',')
+        {
+            next();
+
+            if (!parse_number(max))
+            {
+                if (_error)
+                {
+                    return false;
+                }
+
+                max = REPEAT_INFINITY;
+            }
+        }
+
+        if (next() != '}' || (max != REPEAT_INFINITY && max < min))
+        {
+            _current = start;
+            return false;
+        }
+
+        return true;
+    }
+
+    int parse_atom()
+    {
+        char c = next();
+
+        switch (c)
+        {
+        case '(':
+        {
+            int node = parse_alternation();
+
+            if (next() != ')')
+            {
+                return fail("Missing ')'");
+            }
+
+            return node;
+        }
+
+        case '[':
+            return parse_class();
+
+        case '.':
+        {
+            CharSet set{};
+            set.add('\n');
+            set.invert();
+            return add({NODE_SET, set, {}, 0, 0});
+        }
+
+        case '^':
+            return add({NODE_BEGIN, {}, {}, 0, 0});
+
+        case '$':
+            return add({NODE_END, {}, {}, 0, 0});
+
+        case '\\':
+        {
+            if (ended())
+            {
+                return fail("Trailing '\\'");
+            }
+
+            char escaped = next();
+            CharSet set{};
+
+            if (!escape_class(escaped, set))
+            {
+                set.add(escape_literal(escaped));
+            }
+
+            return add_set(set);
+        }
+
+        case '*':
+        case '+':
+        case '?':
+            return fail("Nothing to repeat");
+
+        default:
+        {
+            CharSet set{};
+            set.add(c);
+            return add_set(set);
+        }
+        }
+    }
+
+    int parse_repeat()
+    {
+        int node = parse_atom();
+        int repeats = 0;
+
+        while (!ended())
+        {
+            if (repeats++ > MAX_DEPTH)
+            {
+                return fail("Too many repetitions");
+            }
+
+            int min = 0;
+            int max = REPEAT_INFINITY;
+
+            if (peek() == '*')
+            {
+                next();
+            }
+            else if (peek() == '+')
+            {
+                next();
+                min = 1;
+            }
+            else if (peek() == '?')
+            {
+                next();
+                max = 1;
+            }
+            else if (peek() != '{' || !parse_count(min, max))
+            {
+                break;
+            }
+
+            node = add({NODE_REPEAT, {}, {node}, min, max});
+        }
+
+        return node;
+    }
+
+    int parse_concat()
+    {
+        Vector<int> children;
+
+        while (!ended() && peek() != '|' && peek() != ')')
+        {
+            children.push_back(parse_repeat());
+        }
+
+        if (children.count() == 1)
+        {
+            return children[0];
+        }
+
+        return add({NODE_CONCAT, {}, move(children), 0, 0});
+    }
+
+    int parse_alternation()
+    {
+        if (++_depth > MAX_DEPTH)
+        {
+            return fail("Pattern nested too deeply");
+        }
+
+        Vector<int> children;
+        children.push_back(parse_concat());
+
+        while (peek() == '|')
+        {
+            next();
+            children.push_back(parse_concat());
+        }
+
+        _depth--;
+
+        if (children.count() == 1)
+        {
+            return children[0];
+        }
+
+        return add({NODE_ALTERNATION, {}, move(children), 0, 0});
+    }
+
+public:
+    Parser(const char *pattern, size_t size, bool ignore_case)
+        : _current{pattern}, _end{pattern + size}, _ignore_case{ignore_case}
+    {
+    }
+
+    const char *error() { return _error; }
+
+    Vector<Node> &nodes() { return _nodes; }
+
+    // Returns the index of the root node.
+    int parse()
+    {
+        int root = parse_alternation();
+
+        if (!ended())
+        {
+            return fail("Unmatched ')'");
+        }
+
+        return root;
+    }
+};
+
+} // namespace Regex
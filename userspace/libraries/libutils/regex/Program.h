@@ -0,0 +1,176 @@
+#pragma once
+
+#include <libutils/regex/Parser.h>
+
+namespace Regex
+{
+
+enum Opcode
+{
+    // Consumes a byte of the set then continues with the next instruction.
+    OP_SET,
+
+    // Continues with both next and alternative.
+    OP_SPLIT,
+
+    OP_JUMP,
+
+    // Only continue at the begining or the end of the text.
+    OP_BEGIN,
+    OP_END,
+
+    OP_MATCH,
+};
+
+struct Instruction
+{
+    Opcode opcode;
+    int set;
+    int next;
+    int alternative;
+};
+
+// A Thompson NFA, as a list of instructions. Instructions continue with
+// the one after them unless they are jumps or splits.
+class Program
+{
+private:
+    // Bounds the size of the expansion of counted repetitions.
+    static constexpr size_t MAX_INSTRUCTIONS = 64 * 1024;
+
+    Vector<Instruction> _instructions;
+    Vector<CharSet> _sets;
+    bool _too_big = false;
+
+    int emit(Opcode opcode, int next = -1, int alternative = -1, int set = -1)
+    {
+        if (_instructions.count() >= MAX_INSTRUCTIONS)
+        {
+            _too_big = true;
+        }
+
+        _instructions.push_back({opcode, set, next, alternative});
+        return _instructions.count() - 1;
+    }
+
+    int here() { return _instructions.count(); }
+
+    void compile(const Vector<Node> &nodes, int index)
+    {
+        if (_too_big)
+        {
+            return;
+        }
+
+        auto &node = nodes[index];
+
+        switch (node.type)
+        {
+        case NODE_EMPTY:
+            break;
+
+        case NODE_SET:
+            _sets.push_back(node.set);
+            emit(OP_SET, -1, -1, _sets.count() - 1);
+            break;
+
+        case NODE_BEGIN:
+            emit(OP_BEGIN);
+            break;
+
+        case NODE_END:
+            emit(OP_END);
+            break;
+
+        case NODE_CONCAT:
+            for (size_t i = 0; i < node.children.count(); i++)
+            {
+                compile(nodes, node.children[i]);
+            }
+            break;
+
+        case NODE_ALTERNATION:
+        {
+            Vector<int> jumps;
+
+            for (size_t i = 0; i + 1 < node.children.count(); i++)
+            {
+                int split = emit(OP_SPLIT);
+                _instructions[split].next = here();
+
+                compile(nodes, node.children[i]);
+                jumps.push_back(emit(OP_JUMP));
+
+                _instructions[split].alternative = here();
+            }
+
+            compile(nodes, node.children.peek_back());
+
+            for (size_t i = 0; i < jumps.count(); i++)
+            {
+                _instructions[jumps[i]].next = here();
+            }
+
+            break;
+        }
+
+        case NODE_REPEAT:
+        {
+            int child = node.children[0];
+
+            for (int i = 0; i < node.min; i++)
+            {
+                compile(nodes, child);
+            }
+
+            if (node.max == REPEAT_INFINITY)
+            {
+                int split = emit(OP_SPLIT);
+                _instructions[split].next = here();
+
+                compile(nodes, child);
+                emit(OP_JUMP, split);
+
+                _instructions[split].alternative = here();
+            }
+            else
+            {
+                Vector<int> splits;
+
+                for (int i = node.min; i < node.max; i++)
+                {
+                    int split = emit(OP_SPLIT);
+                    _instructions[split].next = here();
+                    splits.push_back(split);
+
+                    compile(nodes, child);
+                }
+
+                for (size_t i = 0; i < splits.count(); i++)
+                {
+                    _instructions[splits[i]].alternative = here();
+                }
+            }
+
+            break;
+        }
+        }
+    }
+
+public:
+    const Instruction &operator[](size_t index) const { return _instructions[index]; }
+
+    size_t count() const { return _instructions.count(); }
+
+    const CharSet &set(int index) const { return _sets[index]; }
+
+    bool too_big() const { return _too_big; }
+
+    Program(const Vector<Node> &nodes, int root)
+    {
+        compile(nodes, root);
+        emit(OP_MATCH);
+    }
+};
+
+} // namespace Regex
@@ -0,0 +1,447 @@
+#pragma once
+
+#include <string.h>
+
+#include <libutils/Hash.h>
+#include <libutils/HashMap.h>
+#include <libutils/Optional.h>
+#include <libutils/regex/Program.h>
+
+namespace Regex
+{
+
+// Finds whether a pattern matches somewhere in a text, in a single pass over
+// the text whatever the pattern.
+//
+// The pattern is compiled to a Thompson NFA, which is then run as a DFA
+// whose states are the sets of NFA instructions which are alive. DFA states
+// and their transitions are only built once the text needs them, and kept
+// for the next matches. A text is searched by adding the first instruction
+// to every state, so there is no backtracking.
+class Regex
+{
+private:
+    // Past this many DFA states the cache is thrown away and rebuilt, the
+    // transitions of a state take a kilobyte.
+    static constexpr size_t MAX_STATES = 1024;
+
+    static constexpr int UNKNOWN = -1;
+
+    struct State
+    {
+        Vector<int> instructions;
+        bool accepting;
+        bool accepting_at_end;
+    };
+
+    Optional<Program> _program;
+    const char *_error = nullptr;
+    Optional<String> _literal;
+
+    Vector<State> _states;
+    Vector<int> _transitions;
+    HashMap<uint32_t, Vector<int>> _states_by_hash;
+    int _initial = UNKNOWN;
+    size_t _flushes = 0;
+
+    // Scratch space of closure(), kept to avoid allocating on each step.
+    Vector<int> _marks;
+    int _generation = 0;
+    Vector<int> _stack;
+
+    void closure(Vector<int> &result, Vector<int> &stack, bool at_begin, bool at_end)
+    {
+        auto &program = _program.unwrap();
+
+        while (!stack.empty())
+        {
+            int pc = stack.pop_back();
+
+            if (_marks[pc] == _generation)
+            {
+                continue;
+            }
+
+            _marks[pc] = _generation;
+
+            auto &instruction = program[pc];
+
+            switch (instruction.opcode)
+            {
+            case OP_SPLIT:
+                stack.push_back(instruction.alternative);
+                stack.push_back(instruction.next);
+                break;
+
+            case OP_JUMP:
+                stack.push_back(instruction.next);
+                break;
+
+            case OP_BEGIN:
+                if (at_begin)
+                {
+                    stack.push_back(pc + 1);
+                }
+                break;
+
+            case OP_END:
+                if (at_end)
+                {
+                    stack.push_back(pc + 1);
+                }
+                else
+                {
+                    result.push_back(pc);
+                }
+                break;
+
+            default:
+                result.push_back(pc);
+                break;
+            }
+        }
+    }
+
+    static void sort(Vector<int> &instructions)
+    {
+        for (size_t i = 1; i < instructions.count(); i++)
+        {
+            int value = instructions[i];
+            size_t j = i;
+
+            while (j > 0 && instructions[j - 1] > value)
+            {
+                instructions[j] = instructions[j - 1];
+                j--;
+            }
+
+            instructions[j] = value;
+        }
+    }
+
+    bool contains_match(const Vector<int> &instructions)
+    {
+        for (size_t i = 0; i < instructions.count(); i++)
+        {
+            if (_program.unwrap()[instructions[i]].opcode == OP_MATCH)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void flush()
+    {
+        _flushes++;
+        _states.clear();
+        _transitions.clear();
+        _states_by_hash.clear();
+        _initial = UNKNOWN;
+    }
+
+    int state(Vector<int> &&instructions)
+    {
+        sort(instructions);
+
+        uint32_t key = hash(instructions.raw_storage(), instructions.count() * sizeof(int));
+
+        if (_states_by_hash.has_key(key))
+        {
+            auto &candidates = _states_by_hash[key];
+
+            for (size_t i = 0; i < candidates.count(); i++)
+            {
+                auto &other = _states[candidates[i]].instructions;
+
+                if (other.count() == instructions.count() &&
+                    (instructions.empty() ||
+                     memcmp(other.raw_storage(), instructions.raw_storage(), instructions.count() * sizeof(int)) == 0))
+                {
+                    return candidates[i];
+                }
+            }
+        }
+
+        if (_states.count() >= MAX_STATES)
+        {
+            flush();
+        }
+
+        // Where the match would be if the text ended here.
+        Vector<int> at_end;
+        _stack.clear();
+        _generation++;
+
+        for (size_t i = 0; i < instructions.count(); i++)
+        {
+            _stack.push_back(instructions[i]);
+        }
+
+        closure(at_end, _stack, false, true);
+
+        bool accepting = contains_match(instructions);
+        bool accepting_at_end = contains_match(at_end);
+
+        _states.push_back({move(instructions), accepting, accepting_at_end});
+
+        for (size_t i = 0; i < 256; i++)
+        {
+            _transitions.push_back(UNKNOWN);
+        }
+
+        int index = _states.count() - 1;
+        _states_by_hash[key].push_back(index);
+
+        return index;
+    }
+
+    int initial()
+    {
+        if (_initial == UNKNOWN)
+        {
+            Vector<int> instructions;
+
+            _stack.clear();
+            _stack.push_back(0);
+            _generation++;
+
+            closure(instructions, _stack, true, false);
+
+            _initial = state(move(instructions));
+        }
+
+        return _initial;
+    }
+
+    int step(int from, uint8_t c)
+    {
+        int cached = _transitions[from * 256 + c];
+
+        if (cached != UNKNOWN)
+        {
+            return cached;
+        }
+
+        auto &program = _program.unwrap();
+        auto &current = _states[from].instructions;
+
+        _stack.clear();
+
+        // The search could start at the next byte as well.
+        _stack.push_back(0);
+
+        for (size_t i = 0; i < current.count(); i++)
+        {
+            auto &instruction = program[current[i]];
+
+            if (instruction.opcode == OP_SET && program.set(instruction.set).has(c))
+            {
+                _stack.push_back(current[i] + 1);
+            }
+        }
+
+        Vector<int> instructions;
+        _generation++;
+        closure(instructions, _stack, false, false);
+
+        size_t flushes = _flushes;
+        int next = state(move(instructions));
+
+        // Unless the cache was flushed and "from" is gone.
+        if (flushes == _flushes)
+        {
+            _transitions[from * 256 + c] = next;
+        }
+
+        return next;
+    }
+
+    static bool is_literal(const Vector<Node> &nodes, int index, char &literal)
+    {
+        if (nodes[index].type != NODE_SET)
+        {
+            return false;
+        }
+
+        int single = nodes[index].set.single();
+
+        if (single == -1)
+        {
+            return false;
+        }
+
+        literal = single;
+        return true;
+    }
+
+    // The longest string every match has to contain, so texts without it can
+    // be skipped with a memchr.
+    static Optional<String> required_literal(const Vector<Node> &nodes, int root)
+    {
+        char literal;
+
+        if (is_literal(nodes, root, literal))
+        {
+            return String{&literal, 1};
+        }
+
+        if (nodes[root].type != NODE_CONCAT)
+        {
+            return {};
+        }
+
+        String longest = "";
+        Vector<char> current;
+
+        auto end_run = [&]() {
+            if (current.count() > longest.length())
+            {
+                longest = String{current.raw_storage(), current.count()};
+            }
+
+            current.clear();
+        };
+
+        auto &children = nodes[root].children;
+
+        for (size_t i = 0; i < children.count(); i++)
+        {
+            auto &child = nodes[children[i]];
+
+            if (is_literal(nodes, children[i], literal))
+            {
+                current.push_back(literal);
+            }
+            else if (child.type == NODE_REPEAT && child.min > 0 &&
+                     is_literal(nodes, child.children[0], literal))
+            {
+                current.push_back(literal);
+                end_run();
+            }
+            else if (child.type != NODE_BEGIN && child.type != NODE_END)
+            {
+                end_run();
+            }
+        }
+
+        end_run();
+
+        if (longest.length() == 0)
+        {
+            return {};
+        }
+
+        return longest;
+    }
+
+public:
+    bool valid() { return _error == nullptr; }
+
+    const char *error() { return _error; }
+
+    const Optional<String> &literal() { return _literal; }
+
+    Regex(const char *pattern, size_t size, bool ignore_case = false)
+    {
+        Parser parser{pattern, size, ignore_case};
+
+        int root = parser.parse();
+
+        if (parser.error())
+        {
+            _error = parser.error();
+            return;
+        }
+
+        _program = Program{parser.nodes(), root};
+
+        if (_program.unwrap().too_big())
+        {
+            _error = "Pattern too big";
+            return;
+        }
+
+        for (size_t i = 0; i < _program.unwrap().count(); i++)
+        {
+            _marks.push_back(0);
+        }
+
+        _literal = required_literal(parser.nodes(), root);
+    }
+
+    Regex(const char *pattern, bool ignore_case = false)
+        : Regex(pattern, strlen(pattern), ignore_case)
+    {
+    }
+
+    Regex(const String &pattern, bool ignore_case = false)
+        : Regex(pattern.cstring(), pattern.length(), ignore_case)
+    {
+    }
+
+    // Whether the pattern matches somewhere in the text. The text is a line,
+    // '^' and '$' match at its boundaries.
+    bool match(const char *text, size_t size)
+    {
+        if (!valid())
+        {
+            return false;
+        }
+
+        int current = initial();
+
+        for (size_t i = 0; i < size; i++)
+        {
+            if (_states[current].accepting)
+            {
+                return true;
+            }
+
+            current = step(current, text[i]);
+        }
+
+        return _states[current].accepting || _states[current].accepting_at_end;
+    }
+
+    bool match(const String &text)
+    {
+        return match(text.cstring(), text.length());
+    }
+
+    // The first occurrence of the required literal, or the end if there is
+    // none. Patterns without a required literal can be anywhere.
+    const char *find_literal(const char *begin, const char *end)
+    {
+        if (!_literal.present())
+        {
+            return begin;
+        }
+
+        auto &literal = _literal.unwrap();
+        size_t size = literal.length();
+        const char *current = begin;
+
+        while ((size_t)(end - current) >= size)
+        {
+            auto found = reinterpret_cast<const char *>(memchr(current, literal[0], end - current - size + 1));
+
+            if (!found)
+            {
+                break;
+            }
+
+            if (memcmp(found, literal.cstring(), size) == 0)
+            {
+                return found;
+            }
+
+            current = found + 1;
+        }
+
+        return end;
+    }
+};
+
+} // namespace Regex
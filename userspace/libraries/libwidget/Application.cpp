@@ -1,10 +1,10 @@
 #include <assert.h>
 
 #include <libasync/Loop.h>
-#include <libasync/Notifier.h>
 #include <libio/Connection.h>
 #include <libio/Format.h>
 #include <libio/Socket.h>
+#include <libipc/SharedChannel.h>
 #include <libsettings/Setting.h>
 #include <libsystem/Logger.h>
 #include <libsystem/process/Process.h>
@@ -32,14 +32,19 @@ enum class State
 Vector<Window *> _windows;
 State _state = State::UNINITIALIZED;
 IO::Connection _connection;
-OwnPtr<Async::Notifier> _connection_notifier;
+OwnPtr<IPC::SharedChannel<CompositorProtocol>> _channel;
 bool _wireframe = false;
 
 /* --- IPC ------------------------------------------------------------------ */
 
 void send_message(CompositorMessage message)
 {
-    _connection.write(&message, sizeof(message));
+    if (!_channel)
+    {
+        return;
+    }
+
+    _channel->send(message);
 }
 
 void do_message(const CompositorMessage &message)
@@ -80,15 +85,19 @@ void do_message(const CompositorMessage &message)
 
 ResultOr<CompositorMessage> wait_for_message(CompositorMessageType expected_message)
 {
+    if (!_channel)
+    {
+        return ERR_STREAM_CLOSED;
+    }
+
     Vector<CompositorMessage> pendings;
 
-    CompositorMessage message{};
-    TRY(_connection.read(&message, sizeof(message)));
+    CompositorMessage message = TRY(_channel->receive());
 
     while (message.type != expected_message)
     {
         pendings.push_back(move(message));
-        auto result = _connection.read(&message, sizeof(CompositorMessage));
+        auto result = _channel->receive();
 
         if (!result.success())
         {
@@ -99,6 +108,8 @@ ResultOr<CompositorMessage> wait_for_message(CompositorMessageType expected_mess
 
             return result.result();
         }
+
+        message = result.unwrap();
     }
 
     pendings.foreach ([&](auto &message) {
@@ -353,41 +364,36 @@ Result initialize(int argc, char **argv)
 
     Async::Loop::initialize();
 
-    _connection_notifier = own<Async::Notifier>(_connection, POLL_READ, []() {
-        CompositorMessage message = {};
-        auto read_result = _connection.read(&message, sizeof(CompositorMessage));
+    // The greetings are the only message going through the connection, they
+    // carry the shared memory of the channel every other message goes through.
+    CompositorMessage greetings = {};
+    size_t greetings_size = TRY(_connection.read(&greetings, sizeof(CompositorMessage)));
 
-        if (!read_result.success())
-        {
-            logger_error("Connection to the compositor closed %s!", read_result.description());
-            Application::exit(PROCESS_FAILURE);
-        }
+    if (greetings_size != sizeof(CompositorMessage) ||
+        greetings.type != COMPOSITOR_MESSAGE_GREETINGS)
+    {
+        logger_error("Got invalid greetings from compositor!");
+        hexdump(&greetings, greetings_size);
+        return ERR_INVALID_DATA;
+    }
 
-        size_t message_size = read_result.unwrap();
+    Screen::bound(greetings.greetings.screen_bound);
 
-        if (message_size != sizeof(CompositorMessage))
-        {
-            logger_error("Got a message with an invalid size from compositor %u != %u!", sizeof(CompositorMessage), message_size);
-            hexdump(&message, message_size);
-            Application::exit(PROCESS_FAILURE);
-        }
+    _channel = TRY(IPC::SharedChannel<CompositorProtocol>::attach(_connection, greetings.greetings.channel));
 
+    _channel->on_message = [](const CompositorMessage &message) {
         do_message(message);
-    });
+    };
+
+    _channel->on_close = []() {
+        logger_error("Connection to the compositor closed!");
+        Application::exit(PROCESS_FAILURE);
+    };
 
     _state = State::RUNNING;
 
     Async::Loop::atexit(uninitialized);
 
-    auto result_or_greetings = wait_for_message(COMPOSITOR_MESSAGE_GREETINGS);
-
-    if (result_or_greetings.success())
-    {
-        auto greetings = result_or_greetings.unwrap();
-
-        Screen::bound(greetings.greetings.screen_bound);
-    }
-
     return SUCCESS;
 }
 
@@ -433,7 +439,7 @@ void exit(int exit_value)
 
     goodbye();
 
-    _connection_notifier = nullptr;
+    _channel = nullptr;
     _connection.close();
 
     Async::Loop::exit(exit_value);
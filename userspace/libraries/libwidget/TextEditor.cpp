@@ -40,7 +40,7 @@ void TextEditor::paint(Graphic::Painter &painter, const Math::Recti &)
 
     for (size_t i = first_visible_line; i < last_visible_line; i++)
     {
-        auto &line = _model->line(i);
+        auto line = _model->line(i);
         int linetop = metrics.fulllineheight() * i;
         int baseline = linetop + metrics.halfleading() + metrics.baseline();
 
@@ -33,7 +33,7 @@ void TextField::paint(Graphic::Painter &painter, const Math::Recti &)
         painter.fill_rectangle(cursor_bound, color(THEME_ACCENT));
     };
 
-    auto &line = _model->line(0);
+    auto line = _model->line(0);
 
     for (size_t j = 0; j < line.length(); j++)
     {
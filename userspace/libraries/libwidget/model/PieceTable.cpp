@@ -0,0 +1,306 @@
+#include <string.h>
+
+#include <libwidget/model/PieceTable.h>
+
+namespace Widget
+{
+
+PieceTable::PieceTable(Slice original)
+    : _original{original}
+{
+    _size = _original.size();
+
+    if (_size > 0)
+    {
+        _pieces.push_back({ORIGINAL, 0, _size, 0});
+    }
+}
+
+size_t PieceTable::newlines_before(Source source, size_t offset) const
+{
+    auto &positions = newlines(source);
+
+    size_t low = 0;
+    size_t high = positions.count();
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (positions[middle] < offset)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+PieceTable::Piece PieceTable::make_piece(Source source, size_t offset, size_t size) const
+{
+    size_t newlines = newlines_before(source, offset + size) - newlines_before(source, offset);
+    return {source, offset, size, newlines};
+}
+
+void PieceTable::index()
+{
+    if (_indexed)
+    {
+        return;
+    }
+
+    auto start = reinterpret_cast<const uint8_t *>(_original.start());
+    auto end = start + _original.size();
+
+    for (auto current = start; current < end; current++)
+    {
+        current = reinterpret_cast<const uint8_t *>(memchr(current, '\n', end - current));
+
+        if (!current)
+        {
+            break;
+        }
+
+        _original_newlines.push_back(current - start);
+    }
+
+    // Until the first edit the document is the original content.
+    if (_pieces.count() > 0)
+    {
+        _pieces[0].newlines = _original_newlines.count();
+    }
+
+    _newlines = _original_newlines.count();
+    _indexed = true;
+    _cache = {0, 0, 0};
+}
+
+PieceTable::Location PieceTable::locate(size_t offset)
+{
+    auto location = _cache;
+
+    if (offset < location.offset)
+    {
+        location = {0, 0, 0};
+    }
+
+    while (location.index < _pieces.count() &&
+           offset >= location.offset + _pieces[location.index].size)
+    {
+        location.offset += _pieces[location.index].size;
+        location.lines += _pieces[location.index].newlines;
+        location.index++;
+    }
+
+    _cache = location;
+
+    return location;
+}
+
+size_t PieceTable::split(size_t offset)
+{
+    auto location = locate(offset);
+
+    if (location.index == _pieces.count() || location.offset == offset)
+    {
+        return location.index;
+    }
+
+    auto &piece = _pieces[location.index];
+    size_t left = offset - location.offset;
+
+    auto right = make_piece(piece.source, piece.offset + left, piece.size - left);
+    piece = make_piece(piece.source, piece.offset, left);
+
+    _pieces.insert(location.index + 1, right);
+
+    return location.index + 1;
+}
+
+size_t PieceTable::line_count()
+{
+    index();
+
+    return _newlines + 1;
+}
+
+size_t PieceTable::line_start(size_t line)
+{
+    index();
+
+    if (line == 0)
+    {
+        return 0;
+    }
+
+    if (line > _newlines)
+    {
+        return _size;
+    }
+
+    // Find the piece holding the newline ending the previous line.
+    auto location = _cache;
+
+    if (location.lines >= line)
+    {
+        location = {0, 0, 0};
+    }
+
+    while (location.lines + _pieces[location.index].newlines < line)
+    {
+        location.offset += _pieces[location.index].size;
+        location.lines += _pieces[location.index].newlines;
+        location.index++;
+    }
+
+    _cache = location;
+
+    auto &piece = _pieces[location.index];
+    size_t newline = newlines(piece.source)[newlines_before(piece.source, piece.offset) + (line - location.lines - 1)];
+
+    return location.offset + (newline - piece.offset) + 1;
+}
+
+size_t PieceTable::line_end(size_t line)
+{
+    index();
+
+    if (line >= _newlines)
+    {
+        return _size;
+    }
+
+    return line_start(line + 1) - 1;
+}
+
+size_t PieceTable::longest_line()
+{
+    index();
+
+    size_t line = 0;
+    size_t length = 0;
+
+    size_t longest = 0;
+    size_t longest_length = 0;
+
+    for (size_t i = 0; i < _pieces.count(); i++)
+    {
+        auto &piece = _pieces[i];
+        auto &positions = newlines(piece.source);
+
+        size_t position = piece.offset;
+        size_t first = newlines_before(piece.source, piece.offset);
+
+        for (size_t j = first; j < first + piece.newlines; j++)
+        {
+            length += positions[j] - position;
+
+            if (length > longest_length)
+            {
+                longest = line;
+                longest_length = length;
+            }
+
+            line++;
+            length = 0;
+            position = positions[j] + 1;
+        }
+
+        length += piece.offset + piece.size - position;
+    }
+
+    if (length > longest_length)
+    {
+        longest = line;
+    }
+
+    return longest;
+}
+
+void PieceTable::insert(size_t offset, const uint8_t *data, size_t size)
+{
+    if (size == 0 || offset > _size)
+    {
+        return;
+    }
+
+    index();
+
+    size_t start = _added.count();
+    size_t inserted_newlines = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (data[i] == '\n')
+        {
+            _added_newlines.push_back(start + i);
+            inserted_newlines++;
+        }
+    }
+
+    _added.push_back_many(data, size);
+
+    size_t at = split(offset);
+
+    // Typing extends the piece inserted by the previous keystroke.
+    if (at > 0 &&
+        _pieces[at - 1].source == ADDED &&
+        _pieces[at - 1].offset + _pieces[at - 1].size == start)
+    {
+        _pieces[at - 1].size += size;
+        _pieces[at - 1].newlines += inserted_newlines;
+    }
+    else
+    {
+        _pieces.insert(at, {ADDED, start, size, inserted_newlines});
+    }
+
+    _size += size;
+    _newlines += inserted_newlines;
+    _cache = {0, 0, 0};
+}
+
+void PieceTable::remove(size_t offset, size_t size)
+{
+    size = MIN(size, _size - MIN(offset, _size));
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    index();
+
+    size_t begin = split(offset);
+    size_t end = split(offset + size);
+
+    for (size_t i = begin; i < end; i++)
+    {
+        _size -= _pieces[begin].size;
+        _newlines -= _pieces[begin].newlines;
+        _pieces.remove_index(begin);
+    }
+
+    _cache = {0, 0, 0};
+}
+
+void PieceTable::clear()
+{
+    _original = {};
+    _added.clear();
+
+    _original_newlines.clear();
+    _added_newlines.clear();
+    _indexed = true;
+
+    _pieces.clear();
+    _size = 0;
+    _newlines = 0;
+    _cache = {0, 0, 0};
+}
+
+} // namespace Widget
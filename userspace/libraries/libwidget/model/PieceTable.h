@@ -0,0 +1,134 @@
+#pragma once
+
+#include <libutils/Slice.h>
+#include <libutils/Vector.h>
+
+namespace Widget
+{
+
+// Text stored as a sequence of pieces of two buffers: the original content,
+// which is never modified, and an append-only buffer holding everything
+// inserted since. The newlines of both buffers are indexed so lines can be
+// found without scanning the text, the index of the original content is
+// only built the first time lines are needed.
+class PieceTable
+{
+private:
+    enum Source
+    {
+        ORIGINAL,
+        ADDED,
+    };
+
+    struct Piece
+    {
+        Source source;
+        size_t offset;
+        size_t size;
+        size_t newlines;
+    };
+
+    // Where a piece starts in the document.
+    struct Location
+    {
+        size_t index;
+        size_t offset;
+        size_t lines;
+    };
+
+    Slice _original{};
+    Vector<uint8_t> _added{};
+
+    bool _indexed = false;
+    Vector<size_t> _original_newlines{};
+    Vector<size_t> _added_newlines{};
+
+    Vector<Piece> _pieces{};
+    size_t _size = 0;
+    size_t _newlines = 0;
+
+    // Last piece looked up, consecutive lookups tend to be close together.
+    Location _cache{0, 0, 0};
+
+    const uint8_t *buffer(Source source) const
+    {
+        if (source == ORIGINAL)
+        {
+            return reinterpret_cast<const uint8_t *>(_original.start());
+        }
+        else
+        {
+            return _added.raw_storage();
+        }
+    }
+
+    const Vector<size_t> &newlines(Source source) const
+    {
+        return source == ORIGINAL ? _original_newlines : _added_newlines;
+    }
+
+    // Index of the first newline of the buffer at or after the offset.
+    size_t newlines_before(Source source, size_t offset) const;
+
+    Piece make_piece(Source source, size_t offset, size_t size) const;
+
+    void index();
+
+    Location locate(size_t offset);
+
+    // Splits the piece containing the offset, returns the index of the
+    // piece starting at the offset.
+    size_t split(size_t offset);
+
+public:
+    size_t size() const { return _size; }
+
+    PieceTable() : _indexed{true} {}
+
+    PieceTable(Slice original);
+
+    size_t line_count();
+
+    // Offset of the first byte of the line.
+    size_t line_start(size_t line);
+
+    // Offset of the newline ending the line, or the end of the document.
+    size_t line_end(size_t line);
+
+    // The line with the most bytes, ignoring the newline.
+    size_t longest_line();
+
+    // Calls back with the chunks of the document covering the range.
+    template <typename TCallback>
+    void read(size_t offset, size_t size, TCallback callback)
+    {
+        size = MIN(size, _size - MIN(offset, _size));
+
+        if (size == 0)
+        {
+            return;
+        }
+
+        auto location = locate(offset);
+        size_t skip = offset - location.offset;
+
+        for (size_t i = location.index; i < _pieces.count() && size > 0; i++)
+        {
+            auto &piece = _pieces[i];
+            size_t chunk = MIN(piece.size - skip, size);
+
+            callback(buffer(piece.source) + piece.offset + skip, chunk);
+
+            size -= chunk;
+            skip = 0;
+        }
+    }
+
+    void insert(size_t offset, const uint8_t *data, size_t size);
+
+    void remove(size_t offset, size_t size);
+
+    void clear();
+};
+
+} // namespace Widget
@@ -1,84 +1,164 @@
-#include <libutils/Scanner.h>
-#include <libutils/StringBuilder.h>
+#include <libio/Copy.h>
+#include <libio/File.h>
 #include <libwidget/model/TextModel.h>
 
 namespace Widget
 {
 
-RefPtr<TextModel> TextModel::empty()
+// Decodes the codepoint at the start of the buffer, without reading past
+// its end when the last sequence is truncated.
+static size_t decode_codepoint(const uint8_t *buffer, size_t size, Codepoint *codepoint)
 {
-    auto model = make<TextModel>();
-    model->append_line(own<TextModelLine>());
-    return model;
+    if (size >= 4)
+    {
+        return utf8_to_codepoint(buffer, codepoint);
+    }
+
+    uint8_t padded[4] = {};
+    memcpy(padded, buffer, size);
+
+    return MIN((size_t)utf8_to_codepoint(padded, codepoint), size);
 }
 
-RefPtr<TextModel> TextModel::from_file(const char *path)
+TextModelLine::TextModelLine(const uint8_t *buffer, size_t size)
 {
-    auto model = make<TextModel>();
+    size_t offset = 0;
 
-    Stream *stream = stream_open(path, OPEN_READ | OPEN_BUFFERED);
+    while (offset < size)
+    {
+        Codepoint codepoint;
+        offset += decode_codepoint(buffer + offset, size - offset, &codepoint);
+        _codepoints.push_back(codepoint);
+    }
+}
 
-    StreamScanner scan{stream};
+RefPtr<TextModel> TextModel::empty()
+{
+    return make<TextModel>();
+}
 
-    // Skip the utf8 bom header if present.
-    scan.skip_word("\xEF\xBB\xBF");
+RefPtr<TextModel> TextModel::from_file(const char *path)
+{
+    IO::File file{path, OPEN_READ};
 
-    while (scan.do_continue())
-    {
-        auto line = own<TextModelLine>();
+    auto content = IO::read_all(file);
 
-        while (scan.do_continue() &&
-               scan.current_codepoint() != '\n')
-        {
-            line->append(scan.current_codepoint());
-            scan.foreward_codepoint();
-        }
+    if (!content.success())
+    {
+        return empty();
+    }
 
-        scan.skip('\n'); // skip the \n
+    auto text = content.unwrap();
 
-        model->append_line(line);
+    // Skip the utf8 bom header if present.
+    if (text.size() >= 3 && memcmp(text.start(), "\xEF\xBB\xBF", 3) == 0)
+    {
+        text = text.slice(3, text.size() - 3);
     }
 
-    stream_close(stream);
+    return make<TextModel>(text);
+}
 
-    if (model->line_count() == 0)
+Math::Recti TextModel::bound(const Graphic::Font &font)
+{
+    if (!_longest_line_known)
     {
-        model->append_line(own<TextModelLine>());
+        _longest_line = _text.longest_line();
+        _longest_line_size = line_size(_longest_line);
+        _longest_line_known = true;
+        _bound_font = nullptr;
     }
 
-    model->span_add(TextModelSpan(0, 0, 10, THEME_ANSI_RED, THEME_ANSI_BLUE));
-
-    if (model->line_count() == 0)
+    if (_bound_font != &font)
     {
-        model->append_line(own<TextModelLine>());
+        _bound_width = line(_longest_line).bound(font).width();
+        _bound_font = &font;
     }
 
-    return model;
+    return {_bound_width, (int)line_count() * font.metrics().fulllineheight()};
 }
 
 String TextModel::string()
 {
-    StringBuilder builder;
+    Vector<char> buffer(_text.size());
+
+    _text.read(0, _text.size(), [&](const uint8_t *data, size_t size) {
+        buffer.push_back_many(reinterpret_cast<const char *>(data), size);
+    });
+
+    return {buffer.raw_storage(), buffer.count()};
+}
+
+Vector<uint8_t> TextModel::line_bytes(size_t index)
+{
+    size_t start = _text.line_start(index);
+    size_t size = _text.line_end(index) - start;
+
+    Vector<uint8_t> bytes(size);
+
+    _text.read(start, size, [&](const uint8_t *data, size_t size) {
+        bytes.push_back_many(data, size);
+    });
+
+    return bytes;
+}
+
+TextModelLine TextModel::line(size_t index)
+{
+    auto bytes = line_bytes(index);
+    return {bytes.raw_storage(), bytes.count()};
+}
+
+size_t TextModel::offset_at(size_t line, size_t column)
+{
+    auto bytes = line_bytes(line);
 
-    for (size_t i = 0; i < _lines.count(); i++)
+    size_t offset = 0;
+
+    for (size_t i = 0; i < column && offset < bytes.count(); i++)
     {
-        for (size_t j = 0; j < _lines[i]->length(); j++)
-        {
-            builder.append_codepoint(_lines[i]->operator[](j));
-        }
+        Codepoint codepoint;
+        offset += decode_codepoint(bytes.raw_storage() + offset, bytes.count() - offset, &codepoint);
+    }
 
-        if (i + 1 < _lines.count())
-        {
-            builder.append('\n');
-        }
+    return _text.line_start(line) + offset;
+}
+
+void TextModel::did_edit_line(size_t line)
+{
+    if (!_longest_line_known)
+    {
+        return;
+    }
+
+    size_t size = line_size(line);
+
+    if (line == _longest_line && size < _longest_line_size)
+    {
+        did_edit_lines();
+    }
+    else if (line == _longest_line || size > _longest_line_size)
+    {
+        _longest_line = line;
+        _longest_line_size = size;
+        _bound_font = nullptr;
     }
+}
 
-    return builder.finalize();
+void TextModel::did_edit_lines()
+{
+    _longest_line_known = false;
+    _bound_font = nullptr;
 }
 
 void TextModel::append_at(TextCursor &cursor, Codepoint codepoint)
 {
-    line(cursor.line()).append_at(cursor.column(), codepoint);
+    uint8_t utf8[5];
+    size_t size = codepoint_to_utf8(codepoint, utf8);
+
+    _text.insert(offset_at(cursor.line(), cursor.column()), utf8, size);
+    did_edit_line(cursor.line());
+
     cursor.move_right_within(*this);
     did_update();
 }
@@ -89,18 +169,23 @@ void TextModel::backspace_at(TextCursor &cursor)
         cursor.column() == 0)
     {
         int line_length = line(cursor.line() - 1).length();
-        line(cursor.line() - 1).append(line(cursor.line()));
 
-        _lines.remove_index(cursor.line());
+        _text.remove(_text.line_start(cursor.line()) - 1, 1);
+        did_edit_lines();
 
         cursor.move_up_within(*this);
         cursor.move_to_within(line(cursor.line()), line_length);
 
         did_update();
     }
-    else if (cursor.column() > 0 && line(cursor.line()).length() > 0)
+    else if (cursor.column() > 0)
     {
-        line(cursor.line()).backspace_at(cursor.column());
+        size_t start = offset_at(cursor.line(), cursor.column() - 1);
+        size_t end = offset_at(cursor.line(), cursor.column());
+
+        _text.remove(start, end - start);
+        did_edit_line(cursor.line());
+
         cursor.move_left_within(*this);
 
         did_update();
@@ -111,15 +196,18 @@ void TextModel::delete_at(TextCursor &cursor)
 {
     if (cursor.line() < line_count() - 1 && cursor.column() == line(cursor.line()).length())
     {
-        line(cursor.line()).append(line(cursor.line() + 1));
-
-        _lines.remove_index(cursor.line() + 1);
+        _text.remove(_text.line_end(cursor.line()), 1);
+        did_edit_lines();
 
         did_update();
     }
-    else if (cursor.column() < line(cursor.line()).length() && line(cursor.line()).length() > 0)
+    else if (cursor.column() < line(cursor.line()).length())
     {
-        line(cursor.line()).delete_at(cursor.column());
+        size_t start = offset_at(cursor.line(), cursor.column());
+        size_t end = offset_at(cursor.line(), cursor.column() + 1);
+
+        _text.remove(start, end - start);
+        did_edit_line(cursor.line());
 
         did_update();
     }
@@ -127,23 +215,10 @@ void TextModel::delete_at(TextCursor &cursor)
 
 void TextModel::newline_at(TextCursor &cursor)
 {
-    auto left_side_line = own<TextModelLine>();
-    auto right_side_line = own<TextModelLine>();
-
-    for (size_t i = 0; i < cursor.column(); i++)
-    {
-        left_side_line->append(line(cursor.line())[i]);
-    }
-
-    for (size_t i = cursor.column(); i < line(cursor.line()).length(); i++)
-    {
-        right_side_line->append(line(cursor.line())[i]);
-    }
+    uint8_t newline = '\n';
 
-    _lines.remove_index(cursor.line());
-
-    _lines.insert(cursor.line(), left_side_line);
-    _lines.insert(cursor.line() + 1, right_side_line);
+    _text.insert(offset_at(cursor.line(), cursor.column()), &newline, 1);
+    did_edit_lines();
 
     cursor.move_down_within(*this);
     cursor.move_to_beginning_of_the_line();
@@ -151,11 +226,36 @@ void TextModel::newline_at(TextCursor &cursor)
     did_update();
 }
 
+// Swaps a line with the one following it.
+static void swap_lines(PieceTable &text, size_t line)
+{
+    size_t start = text.line_start(line);
+    size_t middle = text.line_end(line);
+    size_t end = text.line_end(line + 1);
+
+    Vector<uint8_t> swapped(end - start);
+
+    text.read(middle + 1, end - middle - 1, [&](const uint8_t *data, size_t size) {
+        swapped.push_back_many(data, size);
+    });
+
+    swapped.push_back('\n');
+
+    text.read(start, middle - start, [&](const uint8_t *data, size_t size) {
+        swapped.push_back_many(data, size);
+    });
+
+    text.remove(start, end - start);
+    text.insert(start, swapped.raw_storage(), swapped.count());
+}
+
 void TextModel::move_line_up_at(TextCursor &cursor)
 {
     if (cursor.line() > 0)
     {
-        _lines.insert(cursor.line() - 1, _lines.take_at(cursor.line()));
+        swap_lines(_text, cursor.line() - 1);
+        did_edit_lines();
+
         cursor.move_up_within(*this);
 
         did_update();
@@ -164,13 +264,58 @@ void TextModel::move_line_up_at(TextCursor &cursor)
 
 void TextModel::move_line_down_at(TextCursor &cursor)
 {
-    if (cursor.line() < line_count())
+    if (cursor.line() + 1 < line_count())
     {
-        _lines.insert(cursor.line() + 1, _lines.take_at(cursor.line()));
+        swap_lines(_text, cursor.line());
+        did_edit_lines();
+
         cursor.move_down_within(*this);
 
         did_update();
     }
 }
 
+size_t TextModel::span_lower_bound(size_t line, size_t column)
+{
+    size_t low = 0;
+    size_t high = _spans.count();
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        auto &span = _spans[middle];
+
+        if (span.line() < line || (span.line() == line && span.start() < column))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+TextModelSpan TextModel::span_at(size_t line, size_t column)
+{
+    for (size_t i = span_lower_bound(line, 0); i < _spans.count(); i++)
+    {
+        auto &span = _spans[i];
+
+        if (span.line() != line || span.start() > column)
+        {
+            break;
+        }
+
+        if (column < span.end())
+        {
+            return span;
+        }
+    }
+
+    return TextModelSpan(line, column, column + 1);
+}
+
 } // namespace Widget
@@ -3,17 +3,19 @@
 #include <libasync/Observable.h>
 #include <libgraphic/Font.h>
 #include <libutils/Assert.h>
-#include <libutils/OwnPtr.h>
 #include <libutils/RefCounted.h>
 #include <libutils/Vector.h>
 #include <libutils/unicode/Codepoint.h>
 #include <libwidget/Theme.h>
+#include <libwidget/model/PieceTable.h>
 
 namespace Widget
 {
 
 struct TextCursor;
 
+// A line of the model decoded to codepoints, it's a copy: edits go
+// through the model.
 class TextModelLine
 {
 private:
@@ -24,48 +26,25 @@ public:
     {
     }
 
+    TextModelLine(const uint8_t *buffer, size_t size);
+
     ~TextModelLine()
     {
     }
 
-    Codepoint operator[](size_t index)
+    Codepoint operator[](size_t index) const
     {
         Assert::lower_than(index, length());
 
         return _codepoints[index];
     }
 
-    size_t length()
+    size_t length() const
     {
         return _codepoints.count();
     }
 
-    void append(Codepoint codepoint)
-    {
-        _codepoints.push_back(codepoint);
-    }
-
-    void append(const TextModelLine &line)
-    {
-        _codepoints.push_back_many(line._codepoints);
-    }
-
-    void append_at(size_t index, Codepoint codepoint)
-    {
-        _codepoints.insert(index, codepoint);
-    }
-
-    void backspace_at(size_t index)
-    {
-        _codepoints.remove_index(index - 1);
-    }
-
-    void delete_at(size_t index)
-    {
-        _codepoints.remove_index(index);
-    }
-
-    Math::Recti bound(const Graphic::Font &font)
+    Math::Recti bound(const Graphic::Font &font) const
     {
         int width = 0;
 
@@ -117,13 +96,44 @@ public:
     }
 };
 
+// The text is kept as UTF-8 in a piece table, lines are decoded when asked
+// for, so the cost of painting depends on what's visible and not on the
+// size of the document.
 class TextModel :
     public RefCounted<TextModel>,
     public Async::Observable<TextModel>
 {
 private:
-    Vector<OwnPtr<TextModelLine>> _lines{1024};
-    Vector<TextModelSpan> _spans{1024};
+    PieceTable _text;
+
+    // Sorted by line then by start.
+    Vector<TextModelSpan> _spans{};
+
+    // The document is as wide as its longest line in bytes, which is
+    // measured again when it changes.
+    bool _longest_line_known = false;
+    size_t _longest_line = 0;
+    size_t _longest_line_size = 0;
+
+    const Graphic::Font *_bound_font = nullptr;
+    int _bound_width = 0;
+
+    size_t line_size(size_t index)
+    {
+        return _text.line_end(index) - _text.line_start(index);
+    }
+
+    Vector<uint8_t> line_bytes(size_t index);
+
+    // Offset in the document of a column of a line.
+    size_t offset_at(size_t line, size_t column);
+
+    void did_edit_line(size_t line);
+
+    void did_edit_lines();
+
+    // First span that's not before the position.
+    size_t span_lower_bound(size_t line, size_t column);
 
 public:
     static RefPtr<TextModel> empty();
@@ -132,42 +142,28 @@ public:
 
     TextModel() {}
 
-    ~TextModel() {}
+    TextModel(Slice content) : _text{content} {}
 
-    Math::Recti bound(const Graphic::Font &font)
-    {
-        int width = 0;
-        int height = 0;
-
-        for (size_t i = 0; i < _lines.count(); i++)
-        {
-            auto line_bound = _lines[i]->bound(font);
-            width = MAX(width, line_bound.width());
-            height += line_bound.height();
-        }
+    ~TextModel() {}
 
-        return {width, height};
-    }
+    Math::Recti bound(const Graphic::Font &font);
 
     String string();
 
     void clear()
     {
-        _lines.clear();
+        _text.clear();
         _spans.clear();
 
-        append_line(own<TextModelLine>());
-
+        did_edit_lines();
         did_update();
     }
 
     /* --- Editing ---------------------------------------------------------- */
 
-    TextModelLine &line(int index) { return *_lines[index]; }
+    TextModelLine line(size_t index);
 
-    size_t line_count() const { return _lines.count(); }
-
-    void append_line(OwnPtr<TextModelLine> line) { _lines.push_back(line); }
+    size_t line_count() { return _text.line_count(); }
 
     void append_at(TextCursor &cursor, Codepoint codepoint);
 
@@ -185,26 +181,10 @@ public:
 
     void span_add(TextModelSpan span)
     {
-        _spans.insert_sorted(span, [](auto &left, auto &right) {
-            return left.line() < right.line() &&
-                   left.start() < right.start();
-        });
+        _spans.insert(span_lower_bound(span.line(), span.start()), span);
     }
 
-    TextModelSpan span_at(size_t line, size_t column)
-    {
-        for (size_t i = 0; i < _spans.count(); i++)
-        {
-            auto &span = _spans[i];
-
-            if (span.line() == line && column >= span.start() && column < span.end())
-            {
-                return span;
-            }
-        }
-
-        return TextModelSpan(line, column, column + 1);
-    }
+    TextModelSpan span_at(size_t line, size_t column);
 
     void span_clear()
     {
@@ -232,7 +212,7 @@ public:
         }
     }
 
-    void move_to_within(TextModelLine &line, size_t column)
+    void move_to_within(const TextModelLine &line, size_t column)
     {
         _column = clamp(column, 0, line.length());
         _prefered_column = _column;
@@ -315,7 +295,7 @@ public:
         _prefered_column = _column;
     }
 
-    void move_home_within(TextModelLine &line)
+    void move_home_within(const TextModelLine &line)
     {
         UNUSED(line);
 
@@ -323,7 +303,7 @@ public:
         _prefered_column = _column;
     }
 
-    void move_end_within(TextModelLine &line)
+    void move_end_within(const TextModelLine &line)
     {
         _column = line.length();
         _prefered_column = _column;
@@ -6,7 +6,7 @@ TESTS_SOURCES = $(wildcard userspace/tests/*.cpp) \
 
 TESTS_OBJECTS = $(patsubst %.cpp, $(BUILDROOT)/%.o, $(TESTS_SOURCES))
 
-TESTS_LIBS = graphic compression injection io system c
+TESTS_LIBS = widget terminal graphic compression injection io system c
 
 TARGETS += $(TESTS_BINARY)
 OBJECTS += $(TESTS_OBJECTS)
@@ -0,0 +1,138 @@
+#include <libgraphic/Blur.h>
+
+#include "tests/Driver.h"
+
+static constexpr int WIDTH = 97;
+static constexpr int HEIGHT = 61;
+
+static RefPtr<Graphic::Bitmap> make_bitmap(Graphic::Color *pixels, Graphic::Color color)
+{
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+    {
+        pixels[i] = color;
+    }
+
+    return Graphic::Bitmap::create_static(WIDTH, HEIGHT, pixels);
+}
+
+static void fill(Graphic::Bitmap &bitmap, Math::Recti rectangle, Graphic::Color color)
+{
+    for (int y = rectangle.top(); y < rectangle.bottom(); y++)
+    {
+        for (int x = rectangle.left(); x < rectangle.right(); x++)
+        {
+            bitmap.set_pixel({x, y}, color);
+        }
+    }
+}
+
+static void assert_same_pixels(Graphic::Color *left, Graphic::Color *right)
+{
+    for (int i = 0; i < WIDTH * HEIGHT; i++)
+    {
+        Assert::equal(left[i].red(), right[i].red());
+        Assert::equal(left[i].green(), right[i].green());
+        Assert::equal(left[i].blue(), right[i].blue());
+        Assert::equal(left[i].alpha(), right[i].alpha());
+    }
+}
+
+TEST(blur_keeps_uniform_bitmap)
+{
+    static Graphic::Color pixels[WIDTH * HEIGHT];
+    static Graphic::Color expected[WIDTH * HEIGHT];
+
+    auto color = Graphic::Color::from_rgba_byte(12, 130, 250, 200);
+
+    // Large radii go through the downsampled path.
+    static const int RADII[] = {1, 4, 16, 40};
+
+    for (int radius : RADII)
+    {
+        auto bitmap = make_bitmap(pixels, color);
+        make_bitmap(expected, color);
+
+        Graphic::Blur blur{*bitmap, bitmap->bound(), radius};
+        blur.run();
+
+        assert_same_pixels(pixels, expected);
+    }
+}
+
+TEST(blur_spreads_a_point_symmetrically)
+{
+    static Graphic::Color pixels[WIDTH * HEIGHT];
+
+    static const int RADII[] = {3, 8};
+
+    for (int radius : RADII)
+    {
+        auto bitmap = make_bitmap(pixels, Graphic::Colors::BLACK);
+        fill(*bitmap, {48, 30, 2, 2}, Graphic::Colors::WHITE);
+
+        Graphic::Blur blur{*bitmap, bitmap->bound(), radius};
+        blur.run();
+
+        Assert::greater_than(bitmap->get_pixel({48, 30}).red(), bitmap->get_pixel({46, 30}).red());
+        Assert::greater_than(bitmap->get_pixel({46, 30}).red(), bitmap->get_pixel({40, 30}).red());
+        Assert::equal(bitmap->get_pixel({46, 30}).red(), bitmap->get_pixel({51, 30}).red());
+        Assert::equal(bitmap->get_pixel({48, 28}).red(), bitmap->get_pixel({48, 33}).red());
+    }
+}
+
+TEST(blur_downsampled_spreads_a_square)
+{
+    static Graphic::Color pixels[WIDTH * HEIGHT];
+
+    auto bitmap = make_bitmap(pixels, Graphic::Colors::BLACK);
+    fill(*bitmap, {40, 22, 16, 16}, Graphic::Colors::WHITE);
+
+    Graphic::Blur blur{*bitmap, bitmap->bound(), 40};
+    blur.run();
+
+    auto center = bitmap->get_pixel({47, 29}).red();
+    auto border = bitmap->get_pixel({40, 29}).red();
+    auto outside = bitmap->get_pixel({30, 29}).red();
+
+    Assert::lower_than(center, 255);
+    Assert::greater_than(center, border);
+    Assert::greater_than(border, outside);
+    Assert::greater_than(outside, 0);
+}
+
+TEST(blur_bands_match_a_single_band)
+{
+    static Graphic::Color serial[WIDTH * HEIGHT];
+    static Graphic::Color banded[WIDTH * HEIGHT];
+
+    static const int RADII[] = {6, 40};
+
+    for (int radius : RADII)
+    {
+        auto serial_bitmap = make_bitmap(serial, Graphic::Colors::BLACK);
+        auto banded_bitmap = make_bitmap(banded, Graphic::Colors::BLACK);
+
+        for (int i = 0; i < WIDTH * HEIGHT; i++)
+        {
+            serial[i] = banded[i] = Graphic::Color::from_rgb_byte(i * 7, i * 13, i * 31);
+        }
+
+        Math::Recti rectangle{10, 5, 70, 50};
+
+        Graphic::Blur{*serial_bitmap, rectangle, radius}.run();
+
+        Graphic::Blur blur{*banded_bitmap, rectangle, radius, 5};
+
+        for (int stage = 0; stage < blur.stages(); stage++)
+        {
+            // Bands of a stage are independent, run them out of order.
+            for (int band = blur.bands() - 1; band >= 0; band--)
+            {
+                blur.run(stage, band);
+            }
+        }
+
+        assert_same_pixels(serial, banded);
+        Assert::equal(serial_bitmap->get_pixel({0, 0}).red(), 0);
+    }
+}
@@ -1,4 +1,5 @@
 #include <libgraphic/png/PngReader.h>
+#include <libio/MemoryReader.h>
 
 #include "tests/Driver.h"
 
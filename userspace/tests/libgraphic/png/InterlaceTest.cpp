@@ -0,0 +1,178 @@
+#include <libgraphic/png/PngReader.h>
+#include <libio/MemoryReader.h>
+
+#include "tests/Driver.h"
+
+// Each pair encodes the same pixels, once progressive and once Adam7
+// interlaced, with a random filter type per scanline and the image data
+// split across several IDAT chunks.
+
+static void assert_same_pixels(const Graphic::PngReader &left, const Graphic::PngReader &right)
+{
+    Assert::equal(left.width(), right.width());
+    Assert::equal(left.height(), right.height());
+
+    for (size_t i = 0; i < left.pixels().count(); i++)
+    {
+        Assert::is_true(left.pixels()[i] == right.pixels()[i]);
+    }
+}
+
+TEST(pngreader_interlace_8bit_rgb_alpha)
+{
+    uint8_t rgba_progressive[] = {
+        0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x07,
+        0x08, 0x06, 0x00, 0x00, 0x00, 0xda, 0x9b, 0x67, 0x60, 0x00, 0x00, 0x00,
+        0x58, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0xf0, 0x95, 0x30, 0x90,
+        0x6d, 0xd0, 0x51, 0xbe, 0x69, 0xdf, 0xd0, 0xd0, 0x70, 0xba, 0xd0, 0xc5,
+        0x13, 0x48, 0x35, 0x24, 0x28, 0x34, 0x34, 0xdc, 0x6a, 0x78, 0x51, 0xdf,
+        0xd0, 0x30, 0x13, 0xc8, 0x53, 0xbd, 0xc6, 0xb0, 0xfe, 0x97, 0x3a, 0x90,
+        0xb1, 0xb9, 0xa1, 0x41, 0xbf, 0x41, 0x71, 0x1e, 0x90, 0x75, 0xb4, 0xe1,
+        0x8d, 0x75, 0x7e, 0x43, 0xdd, 0xbf, 0xa7, 0x7d, 0x40, 0xce, 0x95, 0x86,
+        0x86, 0xb2, 0xa8, 0xf2, 0x58, 0x46, 0xa6, 0xbd, 0x0d, 0x0e, 0x75, 0x87,
+        0x19, 0x1c, 0x3c, 0x3c, 0x7d, 0x17, 0xed, 0xc8, 0xf7, 0x5e, 0xbe, 0xbd,
+        0x6a, 0x00, 0x00, 0x00, 0x58, 0x49, 0x44, 0x41, 0x54, 0xd5, 0x66, 0xf0,
+        0x48, 0x93, 0x65, 0x60, 0x64, 0x10, 0xdb, 0xfd, 0x9f, 0xa1, 0x9c, 0x4f,
+        0x9f, 0x21, 0xda, 0x9c, 0xab, 0x57, 0x8f, 0x41, 0xaf, 0x61, 0x77, 0x43,
+        0x51, 0x03, 0x08, 0x35, 0x54, 0x35, 0x34, 0xfc, 0xe1, 0x6b, 0x68, 0x48,
+        0x6e, 0x68, 0xd8, 0xd4, 0x50, 0xf0, 0x21, 0x83, 0x61, 0x43, 0x83, 0x2d,
+        0x50, 0x34, 0x7a, 0xd5, 0x29, 0x96, 0xbf, 0x0c, 0x6d, 0x79, 0x7c, 0x45,
+        0xf6, 0xa1, 0x5b, 0xfa, 0x18, 0x14, 0x7c, 0x18, 0xea, 0x8b, 0xc2, 0x18,
+        0x82, 0x18, 0x56, 0x9d, 0x3b, 0x2d, 0x30, 0xe1, 0x69, 0x83, 0x21, 0x83,
+        0x33, 0x8b, 0x6a, 0xcb, 0x00, 0x00, 0x00, 0x00, 0x58, 0x49, 0x44, 0x41,
+        0x54, 0xc3, 0x8c, 0xbd, 0x0c, 0xbe, 0x0c, 0x4c, 0x9f, 0x78, 0x3f, 0x4e,
+        0x62, 0xe8, 0x63, 0x50, 0xf6, 0x29, 0x61, 0x50, 0x64, 0x60, 0xc8, 0xda,
+        0x77, 0xfa, 0xf7, 0x76, 0x06, 0x06, 0x06, 0xeb, 0x63, 0x0c, 0x8f, 0x2b,
+        0x27, 0xc6, 0x30, 0x84, 0x47, 0xd7, 0x65, 0x09, 0x89, 0x33, 0x25, 0xbf,
+        0xf0, 0x63, 0xbf, 0x73, 0x88, 0x41, 0x8a, 0xa1, 0xa7, 0xf6, 0xcf, 0x5c,
+        0x06, 0x87, 0x53, 0xf7, 0x59, 0x59, 0xf7, 0xe9, 0x32, 0x9c, 0xb3, 0xfa,
+        0x15, 0xd0, 0xfe, 0xea, 0x30, 0xc3, 0x4a, 0xc7, 0xa3, 0xc7, 0xcb, 0x5f,
+        0x02, 0x00, 0x19, 0xeb, 0x6a, 0xb3, 0xb9, 0x86, 0x94, 0x00, 0x00, 0x00,
+        0x01, 0x49, 0x44, 0x41, 0x54, 0xc8, 0xbd, 0x87, 0x37, 0x6a, 0x00, 0x00,
+        0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82};
+
+    uint8_t rgba_adam7[] = {
+        0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x07,
+        0x08, 0x06, 0x00, 0x00, 0x01, 0xad, 0x9c, 0x57, 0xf6, 0x00, 0x00, 0x00,
+        0x5c, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x01, 0x0a, 0x01, 0xf5, 0xfe,
+        0x00, 0x4d, 0x18, 0x30, 0x1d, 0x80, 0x80, 0x25, 0xd6, 0x00, 0x80, 0x80,
+        0x80, 0x80, 0x01, 0x2b, 0x80, 0x41, 0xee, 0xab, 0x00, 0x74, 0x92, 0x67,
+        0x00, 0x42, 0x00, 0x00, 0x3f, 0x80, 0x80, 0x80, 0xda, 0x80, 0xe8, 0x7f,
+        0x04, 0xf5, 0x00, 0x00, 0xe3, 0xa6, 0xcd, 0x98, 0x7e, 0x02, 0x02, 0xbd,
+        0x80, 0x40, 0xc8, 0xc9, 0xcd, 0x22, 0x80, 0x80, 0x80, 0x6a, 0x3b, 0x80,
+        0x80, 0xf7, 0x80, 0xb9, 0x0d, 0x80, 0x02, 0x7e, 0xb8, 0x00, 0x47, 0xb8,
+        0xb7, 0x30, 0x5e, 0x00, 0x00, 0xf1, 0xd4, 0x3f, 0x00, 0x00, 0x65, 0x00,
+        0xf8, 0xd8, 0x5d, 0xc4, 0x68, 0x00, 0x00, 0x00, 0x5c, 0x49, 0x44, 0x41,
+        0x54, 0x73, 0x00, 0x04, 0x80, 0x2c, 0x23, 0xd9, 0x4b, 0x45, 0x21, 0x70,
+        0x95, 0xaf, 0x3c, 0x37, 0x20, 0x60, 0x19, 0x00, 0x03, 0x40, 0x6a, 0x6f,
+        0x14, 0xdb, 0xc0, 0xb8, 0xe9, 0x10, 0x55, 0x33, 0x1a, 0xc9, 0x2f, 0xf4,
+        0xd2, 0x03, 0x40, 0xb2, 0x40, 0x03, 0x00, 0xeb, 0x2e, 0x38, 0x00, 0x00,
+        0x03, 0x00, 0x1c, 0xe9, 0x00, 0xdf, 0x03, 0x1c, 0xc9, 0x40, 0x5f, 0xaf,
+        0x1f, 0xa8, 0x88, 0x5f, 0x00, 0x37, 0x3c, 0x09, 0x00, 0xfc, 0x80, 0x04,
+        0xaf, 0xfa, 0x27, 0x80, 0xd1, 0x86, 0x8c, 0x00, 0x00, 0xaf, 0xcd, 0xa1,
+        0x1e, 0x51, 0x00, 0x5f, 0x27, 0x00, 0x6c, 0xbb, 0xaa, 0x38, 0x1f, 0xbf,
+        0x2d, 0x00, 0x00, 0x00, 0x5c, 0x49, 0x44, 0x41, 0x54, 0x00, 0x92, 0xc3,
+        0x76, 0x0e, 0x02, 0x82, 0x9b, 0x46, 0x00, 0x00, 0xf6, 0x86, 0xf7, 0xdd,
+        0x03, 0xd7, 0x03, 0xa8, 0x40, 0x1b, 0x00, 0xc9, 0xf2, 0x07, 0x29, 0x00,
+        0x31, 0xf1, 0x00, 0x7c, 0x91, 0xde, 0x00, 0x6f, 0x5c, 0x09, 0x32, 0x10,
+        0xb1, 0x3e, 0xc8, 0x80, 0x38, 0xc8, 0x9f, 0x40, 0xe8, 0x05, 0x10, 0x2f,
+        0x5c, 0x04, 0xef, 0x0d, 0x77, 0x00, 0x0e, 0xf3, 0x4e, 0xf4, 0x00, 0x74,
+        0x00, 0x12, 0x00, 0x8c, 0xe9, 0x30, 0x21, 0xfb, 0x09, 0x00, 0xdf, 0xce,
+        0x3b, 0xd6, 0x90, 0xc8, 0xf9, 0x02, 0x5c, 0x50, 0xde, 0x31, 0xdf, 0x6a,
+        0x32, 0xcd, 0x37, 0x78, 0x67, 0x08, 0xb4, 0x2b, 0x24, 0x00, 0x00, 0x00,
+        0x01, 0x49, 0x44, 0x41, 0x54, 0x92, 0x36, 0x39, 0x8f, 0x80, 0x00, 0x00,
+        0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82};
+
+    IO::MemoryReader progressive_reader(rgba_progressive, sizeof(rgba_progressive));
+    Graphic::PngReader progressive(progressive_reader);
+    Assert::is_true(progressive.valid());
+
+    IO::MemoryReader adam7_reader(rgba_adam7, sizeof(rgba_adam7));
+    Graphic::PngReader adam7(adam7_reader);
+    Assert::is_true(adam7.valid());
+
+    assert_same_pixels(progressive, adam7);
+    Assert::is_true(adam7.pixels()[0] == Graphic::Color::from_rgba_byte(77, 24, 48, 29));
+    Assert::is_true(adam7.pixels()[9 * 7 - 1] == Graphic::Color::from_rgba_byte(128, 177, 128, 128));
+}
+
+TEST(pngreader_interlace_8bit_rgb)
+{
+    uint8_t rgb_progressive[] = {
+        0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x05,
+        0x08, 0x02, 0x00, 0x00, 0x00, 0x2c, 0x48, 0x90, 0x20, 0x00, 0x00, 0x00,
+        0x5a, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x01, 0x04, 0x01, 0xfb, 0xfe,
+        0x01, 0x09, 0x80, 0x80, 0xea, 0x64, 0x5d, 0x8d, 0x9c, 0xa3, 0x00, 0xee,
+        0x00, 0xc7, 0x43, 0x00, 0x39, 0xd1, 0x9c, 0x43, 0xfe, 0x64, 0xb9, 0x00,
+        0xde, 0x68, 0x3a, 0x22, 0x9c, 0xc6, 0x1e, 0xdd, 0x43, 0xf0, 0x23, 0x3f,
+        0x9f, 0x95, 0x97, 0x4a, 0x3a, 0xe7, 0x09, 0x31, 0x26, 0x00, 0x11, 0xda,
+        0x00, 0x4a, 0x00, 0x00, 0x01, 0x08, 0x80, 0x80, 0x78, 0x00, 0x00, 0x8f,
+        0x38, 0x00, 0xd8, 0xc8, 0x00, 0x99, 0x00, 0x81, 0xa3, 0x00, 0x7f, 0x5d,
+        0x00, 0x72, 0xa6, 0x00, 0x77, 0xc5, 0x43, 0x2a, 0x95, 0xbd, 0xed, 0x7f,
+        0xdb, 0x84, 0x53, 0x00, 0x00, 0x00, 0x5a, 0x49, 0x44, 0x41, 0x54, 0xcb,
+        0x1b, 0x00, 0xab, 0xee, 0x00, 0x79, 0xf7, 0x12, 0x7f, 0x00, 0xee, 0x92,
+        0xab, 0x00, 0x6a, 0xbb, 0x00, 0x81, 0x48, 0x06, 0x04, 0x78, 0x0f, 0x00,
+        0x00, 0x69, 0xd1, 0xec, 0x88, 0xf7, 0xc5, 0x29, 0x65, 0x00, 0xbb, 0x7f,
+        0x5d, 0x5a, 0x47, 0x00, 0xc2, 0xe9, 0x5a, 0x00, 0xb1, 0x95, 0x89, 0x1f,
+        0x21, 0x73, 0x00, 0x8e, 0xc1, 0x00, 0x8a, 0x00, 0x00, 0x11, 0x52, 0xb4,
+        0x92, 0x47, 0x3a, 0x00, 0xbb, 0x18, 0x9b, 0x94, 0x31, 0xe7, 0xd0, 0xb7,
+        0x00, 0xaa, 0x80, 0x47, 0x80, 0x59, 0x2e, 0xbc, 0x67, 0x80, 0x80, 0xd3,
+        0x80, 0x8a, 0x1f, 0xb8, 0x6e, 0x15, 0xc0, 0x21, 0xb1, 0x00, 0x00, 0x00,
+        0x5a, 0x49, 0x44, 0x41, 0x54, 0x7f, 0xe4, 0x9f, 0x80, 0x80, 0x10, 0xf2,
+        0x80, 0x25, 0xef, 0x80, 0x37, 0x4d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+        0x14, 0x40, 0x13, 0x80, 0x41, 0x80, 0x80, 0x39, 0x99, 0x80, 0x80, 0x72,
+        0x80, 0x9a, 0x80, 0xa1, 0x02, 0xd6, 0x00, 0x31, 0x00, 0x79, 0x52, 0x4f,
+        0x70, 0xf4, 0x00, 0xad, 0x91, 0xf6, 0x61, 0x12, 0x27, 0x01, 0x9c, 0xc7,
+        0xe3, 0xf1, 0x87, 0x0b, 0x00, 0x5b, 0x2d, 0x00, 0x92, 0xbf, 0x00, 0x9a,
+        0x00, 0x66, 0x00, 0x00, 0x6c, 0x40, 0x6d, 0xde, 0x3f, 0x00, 0x1f, 0x47,
+        0x26, 0x00, 0xb7, 0x1d, 0x57, 0xe6, 0xea, 0xfd, 0x74, 0xf8, 0x69, 0x10,
+        0x4c, 0x24, 0x6c, 0x00, 0x00, 0x00, 0x01, 0x49, 0x44, 0x41, 0x54, 0x95,
+        0xa8, 0x5d, 0x1a, 0x23, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44,
+        0xae, 0x42, 0x60, 0x82};
+
+    uint8_t rgb_adam7[] = {
+        0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x05,
+        0x08, 0x02, 0x00, 0x00, 0x01, 0x5b, 0x4f, 0xa0, 0xb6, 0x00, 0x00, 0x00,
+        0x57, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0xe4, 0x6c, 0x68, 0xb8,
+        0x6d, 0xc5, 0xf0, 0xfd, 0x18, 0x03, 0xa3, 0xfb, 0xc6, 0x86, 0x73, 0x2f,
+        0xbe, 0xb3, 0x34, 0x34, 0x54, 0x30, 0x30, 0x04, 0x31, 0xcc, 0xd9, 0xc6,
+        0x90, 0x72, 0x8f, 0xe1, 0x95, 0x03, 0x43, 0x43, 0x43, 0xc3, 0xe1, 0x86,
+        0x86, 0xd8, 0xc3, 0x7d, 0x0d, 0xcb, 0x1a, 0x98, 0xba, 0xc3, 0xbf, 0x2c,
+        0x7e, 0xfc, 0x71, 0xef, 0xde, 0x08, 0x06, 0x49, 0x06, 0xa6, 0x86, 0xfe,
+        0x86, 0xdf, 0x0d, 0x1e, 0x0d, 0x29, 0x40, 0x15, 0xb7, 0x1b, 0x7c, 0x3a,
+        0xf8, 0x80, 0xf4, 0x25, 0xb7, 0x86, 0x2b, 0x33, 0x16, 0x2c, 0xf3, 0x40,
+        0x00, 0x00, 0x00, 0x57, 0x49, 0x44, 0x41, 0x54, 0x82, 0xfe, 0x35, 0xb0,
+        0x7c, 0x7e, 0x72, 0xb7, 0xb7, 0x6b, 0x31, 0x83, 0xc8, 0x9c, 0x3f, 0xff,
+        0x9c, 0x58, 0x18, 0x1c, 0x18, 0x9a, 0xfa, 0xcf, 0xd7, 0x05, 0x3b, 0x31,
+        0x30, 0x30, 0xf5, 0x8a, 0x94, 0x38, 0x58, 0xeb, 0x32, 0xd8, 0xac, 0x66,
+        0x61, 0xd8, 0xa3, 0x68, 0xff, 0x88, 0xa1, 0x2e, 0xd8, 0x70, 0x26, 0xc3,
+        0x97, 0x5f, 0x9e, 0x0c, 0x0d, 0x97, 0x80, 0xfa, 0x05, 0xa7, 0x36, 0x34,
+        0x4c, 0xff, 0xdb, 0x70, 0x92, 0xa7, 0x01, 0x0c, 0xe6, 0x9b, 0xf7, 0x5f,
+        0x67, 0xe2, 0x00, 0x33, 0xf9, 0x77, 0x34, 0x3c, 0x07, 0xd1, 0x8c, 0xf1,
+        0xde, 0x7a, 0xec, 0x00, 0x00, 0x00, 0x57, 0x49, 0x44, 0x41, 0x54, 0xca,
+        0x20, 0xf2, 0x93, 0x5a, 0x43, 0xe6, 0xeb, 0xc3, 0x93, 0x81, 0x2c, 0xef,
+        0xd9, 0x0d, 0xdf, 0x3a, 0x1b, 0xf2, 0x1b, 0x26, 0xbd, 0x03, 0x72, 0xb4,
+        0x1b, 0x5e, 0x3d, 0x6b, 0xc8, 0xd6, 0x6b, 0x63, 0x58, 0xd5, 0xe0, 0xde,
+        0x10, 0xa9, 0xb7, 0x27, 0xbd, 0xa1, 0xe1, 0x72, 0x43, 0x97, 0xfc, 0x8e,
+        0xbc, 0xfa, 0x27, 0xf3, 0x1b, 0x1a, 0x04, 0x3e, 0x35, 0xa8, 0xbe, 0x6f,
+        0x30, 0xf7, 0x85, 0x98, 0x2d, 0xe2, 0x20, 0xdc, 0xe0, 0xd8, 0xd0, 0x60,
+        0x39, 0xb3, 0xa1, 0xa1, 0xa8, 0x61, 0x56, 0xc3, 0x42, 0x00, 0xb9, 0x5b,
+        0x7a, 0x61, 0xc0, 0x66, 0x0c, 0x07, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45,
+        0x4e, 0x44, 0xae, 0x42, 0x60, 0x82};
+
+    IO::MemoryReader progressive_reader(rgb_progressive, sizeof(rgb_progressive));
+    Graphic::PngReader progressive(progressive_reader);
+    Assert::is_true(progressive.valid());
+
+    IO::MemoryReader adam7_reader(rgb_adam7, sizeof(rgb_adam7));
+    Graphic::PngReader adam7(adam7_reader);
+    Assert::is_true(adam7.valid());
+
+    assert_same_pixels(progressive, adam7);
+    Assert::is_true(adam7.pixels()[0] == Graphic::Color::from_rgb_byte(9, 128, 128));
+    Assert::is_true(adam7.pixels()[17 * 5 - 1] == Graphic::Color::from_rgb_byte(128, 106, 158));
+}
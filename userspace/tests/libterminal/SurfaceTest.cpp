@@ -0,0 +1,77 @@
+#include <libterminal/Surface.h>
+
+#include "tests/Driver.h"
+
+TEST(surface_scroll_moves_lines_into_history)
+{
+    Terminal::Surface surface{8, 4};
+
+    surface.set(0, 0, {U'a', {}});
+    surface.set(0, 3, {U'b', {}});
+    surface.scroll(1, {});
+
+    Assert::equal(surface.scrollback(), 1);
+    Assert::is_true(surface.at(0, -1).codepoint == U'a');
+    Assert::is_true(surface.at(0, 2).codepoint == U'b');
+    Assert::is_true(surface.at(0, 3).codepoint == U' ');
+}
+
+TEST(surface_history_is_bounded)
+{
+    Terminal::Surface surface{8, 4, 16};
+
+    for (int i = 0; i < 100; i++)
+    {
+        surface.set(0, 3, {(Codepoint)(U'0' + i % 10), {}});
+        surface.scroll(1, {});
+    }
+
+    Assert::equal(surface.scrollback(), 16);
+    Assert::is_true(surface.at(0, 2).codepoint == U'9');
+    Assert::is_true(surface.at(0, -16).codepoint == U'1');
+}
+
+TEST(surface_reverse_scroll_keeps_history)
+{
+    Terminal::Surface surface{8, 4};
+
+    surface.set(0, 0, {U'a', {}});
+    surface.scroll(1, {});
+    surface.set(0, 0, {U'b', {}});
+    surface.scroll(-1, {});
+
+    Assert::equal(surface.scrollback(), 1);
+    Assert::is_true(surface.at(0, -1).codepoint == U'a');
+    Assert::is_true(surface.at(0, 0).codepoint == U' ');
+    Assert::is_true(surface.at(0, 1).codepoint == U'b');
+}
+
+TEST(surface_only_changed_lines_are_dirty)
+{
+    Terminal::Surface surface{8, 4};
+
+    for (int y = 0; y < 4; y++)
+    {
+        surface.undirty(y);
+    }
+
+    surface.set(2, 1, {U'x', {}});
+    surface.set(0, 2, {U' ', {}});
+
+    Assert::is_false(surface.dirty(0));
+    Assert::is_true(surface.dirty(1));
+    Assert::is_false(surface.dirty(2));
+    Assert::is_false(surface.dirty(3));
+}
+
+TEST(surface_resize_keeps_bottom_lines)
+{
+    Terminal::Surface surface{8, 4};
+
+    surface.set(0, 3, {U'z', {}});
+    surface.resize(4, 2);
+
+    Assert::equal(surface.width(), 4);
+    Assert::is_true(surface.at(0, 1).codepoint == U'z');
+    Assert::equal(surface.scrollback(), 2);
+}
@@ -0,0 +1,27 @@
+#include <libterminal/Terminal.h>
+#include <string.h>
+
+#include "tests/Driver.h"
+
+TEST(terminal_text_after_the_last_line_scrolls)
+{
+    Terminal::Terminal terminal{8, 4};
+
+    const char *text = "\e[999;1Hab";
+    terminal.write(text, strlen(text));
+
+    Assert::equal(terminal.cursor().y, 3);
+    Assert::is_true(terminal.surface().at(0, 3).codepoint == U'a');
+    Assert::is_true(terminal.surface().at(1, 3).codepoint == U'b');
+}
+
+TEST(terminal_text_after_the_last_column_wraps)
+{
+    Terminal::Terminal terminal{8, 4};
+
+    const char *text = "\e[1;999Hab";
+    terminal.write(text, strlen(text));
+
+    Assert::is_true(terminal.surface().at(0, 1).codepoint == U'a');
+    Assert::is_true(terminal.surface().at(1, 1).codepoint == U'b');
+}
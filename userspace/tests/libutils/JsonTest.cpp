@@ -0,0 +1,150 @@
+#include <libutils/json/Binary.h>
+#include <libutils/json/Json.h>
+
+#include "tests/Driver.h"
+
+TEST(json_parse_value)
+{
+    String source = R"({"name": "skift", "version": 3, "ratio": 0.5, "tags": ["os", "hobby"], "stable": false})";
+    auto value = Json::parse(source);
+
+    Assert::is_true(value.is(Json::OBJECT));
+    Assert::equal(value.get("name").as_string(), "skift");
+    Assert::is_true(value.get("version").is(Json::INTEGER));
+    Assert::equal(value.get("version").as_integer(), 3);
+    Assert::is_true(value.get("ratio").as_double() == 0.5);
+    Assert::equal(value.get("tags").length(), 2);
+    Assert::equal(value.get("tags").get(1).as_string(), "hobby");
+    Assert::is_false(value.get("stable").as_bool());
+}
+
+TEST(json_parse_malformed_is_null)
+{
+    String source = R"({"name": "skift",)";
+    auto value = Json::parse(source);
+
+    Assert::is_true(value.is(Json::NIL));
+}
+
+TEST(json_document_borrows_plain_strings)
+{
+    String source = R"({"plain": "hello", "escaped": "a\"bé"})";
+    Json::Document document{source};
+
+    Assert::is_true(document.valid());
+
+    auto plain = document.root().get("plain").as_string_view();
+    Assert::is_true(plain.buffer() > source.cstring());
+    Assert::is_true(plain.buffer() < source.cstring() + source.length());
+    Assert::equal(document.root().get("plain").as_string(), "hello");
+    Assert::equal(document.root().get("escaped").as_string(), "a\"bé");
+}
+
+TEST(json_document_object_lookup)
+{
+    String source = R"({"zeta": 1, "alpha": 2, "mid": {"x": [1, 2, 3]}, "zeta": 4})";
+    Json::Document document{source};
+
+    auto &root = document.root();
+
+    Assert::equal(root.length(), 3);
+    Assert::equal(root.get("alpha").as_integer(), 2);
+    Assert::equal(root.get("zeta").as_integer(), 4);
+    Assert::equal(root.get("mid").get("x").get(2).as_integer(), 3);
+    Assert::is_true(root.get("missing").is(Json::NIL));
+    Assert::is_false(root.has("missing"));
+}
+
+TEST(json_sax_events)
+{
+    struct Counter
+    {
+        int scalars = 0;
+        int keys = 0;
+        size_t members = 0;
+        size_t elements = 0;
+
+        void on_null() { scalars++; }
+        void on_bool(bool) { scalars++; }
+        void on_integer(int64_t) { scalars++; }
+        void on_double(double) { scalars++; }
+        void on_string(StringView) { scalars++; }
+        void on_key(StringView) { keys++; }
+        void on_begin_object() {}
+        void on_end_object(size_t count) { members += count; }
+        void on_begin_array() {}
+        void on_end_array(size_t count) { elements += count; }
+    };
+
+    const char *source = R"({"a": [1, 2.5, "three", null, true], "b": {"c": false}})";
+
+    Counter counter;
+    Assert::is_true(Json::sax(source, strlen(source), counter) == SUCCESS);
+
+    Assert::equal(counter.scalars, 6);
+    Assert::equal(counter.keys, 3);
+    Assert::equal(counter.members, 3);
+    Assert::equal(counter.elements, 5);
+}
+
+TEST(json_binary_round_trip)
+{
+    String source = R"({"name": "skift", "version": -3, "big": 4294967296, "ratio": 0.5, "tags": ["os", null, true, {}], "stable": false})";
+    auto value = Json::parse(source);
+
+    IO::MemoryWriter memory;
+    Json::BinaryWriter writer{memory};
+    writer.value(value);
+    writer.value("after");
+
+    size_t size = memory.length().unwrap();
+    Json::BinaryReader reader{memory.buffer(), size};
+
+    auto decoded = reader.value();
+
+    Assert::is_false(reader.error());
+    Assert::equal(decoded.get("name").as_string(), "skift");
+    Assert::equal(decoded.get("version").as_integer(), -3);
+    Assert::equal(decoded.get("big").as_integer(), 4294967296);
+    Assert::is_true(decoded.get("ratio").as_double() == 0.5);
+    Assert::equal(decoded.get("tags").length(), 4);
+    Assert::is_true(decoded.get("tags").get(1).is(Json::NIL));
+    Assert::is_true(decoded.get("tags").get(3).is(Json::OBJECT));
+    Assert::is_false(decoded.get("stable").as_bool());
+
+    Assert::equal(reader.value().as_string(), "after");
+    Assert::is_true(reader.ended());
+}
+
+TEST(json_binary_truncated_is_an_error)
+{
+    String source = R"(["a long enough string", 1234567])";
+
+    IO::MemoryWriter memory;
+    Json::BinaryWriter writer{memory};
+    writer.value(Json::parse(source));
+
+    for (size_t size = 0; size < memory.length().unwrap(); size++)
+    {
+        Json::BinaryReader reader{memory.buffer(), size};
+        reader.value();
+
+        Assert::is_true(reader.error());
+    }
+}
+
+TEST(json_binary_length_past_the_buffer_is_an_error)
+{
+    IO::MemoryWriter memory;
+    Json::BinaryWriter writer{memory};
+
+    // 4GiB and 3 bytes, which would be 3 once narrowed to 32 bits.
+    memory.write((uint8_t)Json::STRING);
+    writer.varint(0x100000003);
+    memory.write("abc", 3);
+
+    Json::BinaryReader reader{memory.buffer(), memory.length().unwrap()};
+    reader.value();
+
+    Assert::is_true(reader.error());
+}
@@ -0,0 +1,170 @@
+#include <libutils/StringBuilder.h>
+#include <libutils/regex/Regex.h>
+
+#include "tests/Driver.h"
+
+TEST(regex_literals)
+{
+    Regex::Regex regex{"error"};
+
+    Assert::is_true(regex.valid());
+    Assert::is_true(regex.match("an error occurred"));
+    Assert::is_true(regex.match("error"));
+    Assert::is_false(regex.match("erro"));
+    Assert::is_false(regex.match(""));
+}
+
+TEST(regex_anchors)
+{
+    Regex::Regex begin{"^foo"};
+    Regex::Regex end{"foo$"};
+    Regex::Regex whole{"^foo$"};
+
+    Assert::is_true(begin.match("foobar"));
+    Assert::is_false(begin.match("barfoo"));
+
+    Assert::is_true(end.match("barfoo"));
+    Assert::is_false(end.match("foobar"));
+
+    Assert::is_true(whole.match("foo"));
+    Assert::is_false(whole.match("foo "));
+
+    Regex::Regex empty{"^$"};
+    Assert::is_true(empty.match(""));
+    Assert::is_false(empty.match("a"));
+}
+
+TEST(regex_classes)
+{
+    Regex::Regex digits{"[0-9]+ms"};
+    Regex::Regex negated{"^[^a-z]*$"};
+    Regex::Regex escapes{"\\w+\\s\\d"};
+    Regex::Regex any{"a.c"};
+
+    Assert::is_true(digits.match("took 120ms"));
+    Assert::is_false(digits.match("took ms"));
+
+    Assert::is_true(negated.match("ABC 123"));
+    Assert::is_false(negated.match("ABc"));
+
+    Assert::is_true(escapes.match("size 4"));
+    Assert::is_false(escapes.match("size  4"));
+
+    Assert::is_true(any.match("abc"));
+    Assert::is_false(any.match("a\nc"));
+}
+
+TEST(regex_negated_escapes_in_classes)
+{
+    Regex::Regex before{"^[x\\D]+$"};
+    Regex::Regex after{"^[\\Dx]+$"};
+    Regex::Regex spaces{"^[\\S ]+$"};
+
+    Assert::is_true(before.match("x"));
+    Assert::is_true(before.match("ax-"));
+    Assert::is_false(before.match("x1"));
+
+    Assert::is_true(after.match("x"));
+    Assert::is_false(after.match("1"));
+
+    Assert::is_true(spaces.match("a b"));
+    Assert::is_false(spaces.match("a\tb"));
+}
+
+TEST(regex_alternation_and_groups)
+{
+    Regex::Regex regex{"^(GET|POST) /(index|home)\\.html$"};
+
+    Assert::is_true(regex.match("GET /index.html"));
+    Assert::is_true(regex.match("POST /home.html"));
+    Assert::is_false(regex.match("PUT /index.html"));
+    Assert::is_false(regex.match("GET /indexhtml"));
+
+    Regex::Regex nested{"a(b|c(d|e))*f"};
+
+    Assert::is_true(nested.match("af"));
+    Assert::is_true(nested.match("abcdcef"));
+    Assert::is_false(nested.match("acf"));
+}
+
+TEST(regex_counted_repetition)
+{
+    Regex::Regex exact{"^a{3}$"};
+    Regex::Regex range{"^a{2,4}$"};
+    Regex::Regex at_least{"^a{2,}$"};
+
+    Assert::is_false(exact.match("aa"));
+    Assert::is_true(exact.match("aaa"));
+    Assert::is_false(exact.match("aaaa"));
+
+    Assert::is_false(range.match("a"));
+    Assert::is_true(range.match("aa"));
+    Assert::is_true(range.match("aaaa"));
+    Assert::is_false(range.match("aaaaa"));
+
+    Assert::is_false(at_least.match("a"));
+    Assert::is_true(at_least.match("aaaaaaaa"));
+
+    Regex::Regex brace{"a{"};
+    Assert::is_true(brace.valid());
+    Assert::is_true(brace.match("a{"));
+}
+
+TEST(regex_ignore_case)
+{
+    Regex::Regex regex{"warning: [a-z]+", true};
+
+    Assert::is_true(regex.match("WARNING: Disk"));
+    Assert::is_true(regex.match("Warning: disk"));
+    Assert::is_false(regex.match("Warning: 42"));
+}
+
+TEST(regex_invalid_patterns)
+{
+    Assert::is_false(Regex::Regex{"(abc"}.valid());
+    Assert::is_false(Regex::Regex{"abc)"}.valid());
+    Assert::is_false(Regex::Regex{"[abc"}.valid());
+    Assert::is_false(Regex::Regex{"*abc"}.valid());
+    Assert::is_false(Regex::Regex{"[z-a]"}.valid());
+    Assert::is_false(Regex::Regex{"abc\\"}.valid());
+    Assert::is_false(Regex::Regex{"a{1001}"}.valid());
+}
+
+TEST(regex_pathological_pattern_is_linear)
+{
+    Regex::Regex regex{"a*a*a*a*a*a*a*a*a*a*a*a*a*a*a*a*b"};
+
+    StringBuilder builder{};
+
+    for (size_t i = 0; i < 120; i++)
+    {
+        builder.append('a');
+    }
+
+    String text = builder.finalize();
+
+    Assert::is_false(regex.match(text));
+
+    builder.append(text);
+    builder.append('b');
+
+    Assert::is_true(regex.match(builder.finalize()));
+}
+
+TEST(regex_required_literal)
+{
+    Regex::Regex regex{"^[0-9]+ ERROR: disk"};
+
+    Assert::is_true(regex.literal().present());
+    Assert::equal(regex.literal().unwrap(), " ERROR: disk");
+
+    const char *text = "12 INFO: ok\n13 ERROR: disk full\n";
+    const char *end = text + strlen(text);
+
+    Assert::equal(regex.find_literal(text, end) - text, 14);
+
+    Regex::Regex no_literal{"[0-9]+"};
+
+    Assert::is_false(no_literal.literal().present());
+    Assert::is_true(no_literal.find_literal(text, end) == text);
+}
@@ -0,0 +1,125 @@
+#include <libutils/StringBuilder.h>
+#include <libwidget/model/TextModel.h>
+
+#include "tests/Driver.h"
+
+static RefPtr<Widget::TextModel> model_of(const char *text)
+{
+    return make<Widget::TextModel>(Slice{text});
+}
+
+static String line_of(Widget::TextModel &model, size_t index)
+{
+    auto line = model.line(index);
+
+    StringBuilder builder;
+
+    for (size_t i = 0; i < line.length(); i++)
+    {
+        builder.append_codepoint(line[i]);
+    }
+
+    return builder.finalize();
+}
+
+TEST(piece_table_lines)
+{
+    Widget::PieceTable text{Slice{"one\ntwo\n\nfour"}};
+
+    Assert::equal(text.line_count(), 4);
+    Assert::equal(text.line_start(1), 4);
+    Assert::equal(text.line_end(1), 7);
+    Assert::equal(text.line_start(2), 8);
+    Assert::equal(text.line_end(2), 8);
+    Assert::equal(text.line_end(3), text.size());
+    Assert::equal(text.longest_line(), 3);
+}
+
+TEST(piece_table_edits_across_pieces)
+{
+    Widget::PieceTable text{Slice{"hello world"}};
+
+    text.insert(5, (const uint8_t *)",\nbig", 5);
+    text.insert(0, (const uint8_t *)">", 1);
+    text.remove(3, 6);
+
+    StringBuilder builder;
+
+    text.read(0, text.size(), [&](const uint8_t *data, size_t size) {
+        builder.append((const char *)data, size);
+    });
+
+    Assert::equal(builder.finalize(), ">heig world");
+    Assert::equal(text.line_count(), 1);
+
+    text.insert(4, (const uint8_t *)"\n\n", 2);
+
+    Assert::equal(text.line_count(), 3);
+    Assert::equal(text.line_start(2), 6);
+}
+
+TEST(text_model_decodes_lines)
+{
+    auto model = model_of("été\n✓ ok\n");
+
+    Assert::equal(model->line_count(), 3);
+    Assert::equal(model->line(0).length(), 3);
+    Assert::equal(line_of(*model, 1), "✓ ok");
+    Assert::equal(model->line(2).length(), 0);
+}
+
+TEST(text_model_edits)
+{
+    auto model = model_of("aé\nb");
+    Widget::TextCursor cursor;
+
+    cursor.move_to_within(model->line(0), 2);
+    model->append_at(cursor, U'ç');
+    Assert::equal(model->string(), "aéç\nb");
+
+    model->backspace_at(cursor);
+    model->backspace_at(cursor);
+    Assert::equal(model->string(), "a\nb");
+
+    model->newline_at(cursor);
+    Assert::equal(model->string(), "a\n\nb");
+    Assert::equal(cursor.line(), 1);
+
+    model->delete_at(cursor);
+    Assert::equal(model->string(), "a\nb");
+
+    model->backspace_at(cursor);
+    Assert::equal(model->string(), "ab");
+    Assert::equal(cursor.column(), 1);
+}
+
+TEST(text_model_move_lines)
+{
+    auto model = model_of("one\ntwo\nthree");
+    Widget::TextCursor cursor;
+
+    model->move_line_down_at(cursor);
+    Assert::equal(model->string(), "two\none\nthree");
+    Assert::equal(cursor.line(), 1);
+
+    cursor.move_end_within(*model);
+    model->move_line_down_at(cursor);
+    Assert::equal(model->string(), "two\none\nthree");
+
+    model->move_line_up_at(cursor);
+    Assert::equal(model->string(), "two\nthree\none");
+}
+
+TEST(text_model_spans)
+{
+    auto model = model_of("abcdef\nghi");
+
+    model->span_add({1, 0, 2, Widget::THEME_ANSI_RED, Widget::THEME_BACKGROUND});
+    model->span_add({0, 4, 6, Widget::THEME_ANSI_BLUE, Widget::THEME_BACKGROUND});
+    model->span_add({0, 0, 2, Widget::THEME_ANSI_GREEN, Widget::THEME_BACKGROUND});
+
+    Assert::is_true(model->span_at(0, 1).foreground() == Widget::THEME_ANSI_GREEN);
+    Assert::is_true(model->span_at(0, 3).foreground() == Widget::THEME_FOREGROUND);
+    Assert::is_true(model->span_at(0, 5).foreground() == Widget::THEME_ANSI_BLUE);
+    Assert::is_true(model->span_at(1, 1).foreground() == Widget::THEME_ANSI_RED);
+}
@@ -5,6 +5,7 @@ UTILITIES = \
 	CP \
 	CRC32 \
 	DIRNAME \
+	DISKBENCH \
 	DISPLAYCTL \
 	DSTART \
 	ECHO \
@@ -34,6 +35,7 @@ UTILITIES = \
 	SYSFETCH \
 	TAC \
 	TOUCH \
+	TRACE \
 	TRUE \
 	UNAME \
 	UNLINK \
@@ -57,6 +59,9 @@ CP_NAME = cp
 CRC32_LIBS = system io compression
 CRC32_NAME = crc32
 
+DISKBENCH_LIBS = system io
+DISKBENCH_NAME = diskbench
+
 PLAY_LIBS = system io
 PLAY_NAME = play
 
@@ -123,6 +128,9 @@ TAC_NAME = tac
 TOUCH_LIBS = system io
 TOUCH_NAME = touch
 
+TRACE_LIBS = system io
+TRACE_NAME = trace
+
 UNLINK_LIBS = system io
 UNLINK_NAME = unlink
 
@@ -0,0 +1,154 @@
+#include <abi/IOCall.h>
+#include <abi/Syscalls.h>
+
+#include <libio/File.h>
+#include <libio/Streams.h>
+#include <libsystem/system/Memory.h>
+#include <libutils/ArgParse.h>
+#include <libutils/Random.h>
+
+static bool random_order = false;
+static bool writing = false;
+static bool pio = false;
+static size_t block_size = 64 * 1024;
+static size_t total_size = 16 * 1024 * 1024;
+
+static uint64_t now()
+{
+    uint64_t nanoseconds = 0;
+    hj_system_clock(&nanoseconds);
+    return nanoseconds;
+}
+
+Result diskbench(IO::File &disk)
+{
+    size_t disk_size = TRY(disk.length());
+    size_t blocks = MIN(total_size, disk_size) / block_size;
+
+    if (blocks == 0)
+    {
+        IO::errln("diskbench: The disk is smaller than a block");
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    // Page aligned, the driver can transfer straight to it.
+    uintptr_t buffer = 0;
+    TRY(memory_alloc(block_size, &buffer));
+
+    Random rng{};
+    uint64_t start = now();
+
+    for (size_t i = 0; i < blocks; i++)
+    {
+        size_t block = random_order ? rng.next_u32(disk_size / block_size) : i;
+        TRY(disk.seek(IO::SeekFrom::start(block * block_size)));
+
+        if (writing)
+        {
+            TRY(disk.write(reinterpret_cast<void *>(buffer), block_size));
+        }
+        else
+        {
+            TRY(disk.read(reinterpret_cast<void *>(buffer), block_size));
+        }
+    }
+
+    uint64_t elapsed = MAX(now() - start, (uint64_t)1);
+
+    memory_free(buffer);
+
+    IO::outln("{} {} of {} blocks of {}KiB in {}us",
+              random_order ? "Random" : "Sequential",
+              writing ? "writes" : "reads",
+              blocks,
+              block_size / 1024,
+              elapsed / 1000);
+
+    IO::outln("{}KiB/s {}op/s {}us/op",
+              (uint64_t)blocks * block_size * 1000000000 / 1024 / elapsed,
+              (uint64_t)blocks * 1000000000 / elapsed,
+              elapsed / 1000 / blocks);
+
+    return SUCCESS;
+}
+
+int main(int argc, char const *argv[])
+{
+    ArgParse args{};
+    args.should_abort_on_failure();
+    args.show_help_if_no_operand_given();
+
+    args.prologue("Measure how fast a disk is read or written.");
+
+    args.usage("DEVICE");
+    args.usage("[OPTION]... DEVICE");
+
+    args.option_bool('r', "random", "Go through the blocks in a random order", [&](bool value) {
+        random_order = value;
+        return PROCESS_SUCCESS;
+    });
+
+    args.option_bool('w', "write", "Write the blocks instead of reading them, this destroys what was on the disk", [&](bool value) {
+        writing = value;
+        return PROCESS_SUCCESS;
+    });
+
+    args.option_bool('p', "pio", "Move the data with PIO instead of DMA, to compare them", [&](bool value) {
+        pio = value;
+        return PROCESS_SUCCESS;
+    });
+
+    args.option_int('b', "block", "The size of each read or write, in KiB (default: 64)", [&](int value) {
+        block_size = MAX(value, 1) * 1024;
+        return PROCESS_SUCCESS;
+    });
+
+    args.option_int('s', "size", "How much to read or write, in MiB (default: 16)", [&](int value) {
+        total_size = MAX(value, 1) * 1024 * 1024;
+        return PROCESS_SUCCESS;
+    });
+
+    if (args.eval(argc, argv) != PROCESS_SUCCESS)
+    {
+        return PROCESS_FAILURE;
+    }
+
+    OpenFlag flags = writing ? OPEN_READ | OPEN_WRITE : OPEN_READ;
+    IO::File disk{args.argv()[0], flags};
+
+    if (!disk.exist())
+    {
+        IO::errln("diskbench: {}: No such device", args.argv()[0]);
+        return PROCESS_FAILURE;
+    }
+
+    // Put back as it was once done, the disk is used by everyone else.
+    IOCallDiskTransferModeArgs mode{};
+
+    if (pio)
+    {
+        IOCallDiskTransferModeArgs pio_mode{false};
+
+        if (disk.handle()->call(IOCALL_DISK_GET_TRANSFER_MODE, &mode) != SUCCESS ||
+            disk.handle()->call(IOCALL_DISK_SET_TRANSFER_MODE, &pio_mode) != SUCCESS)
+        {
+            IO::errln("diskbench: {}: The transfer mode can't be changed", args.argv()[0]);
+            return PROCESS_FAILURE;
+        }
+    }
+
+    Result result = diskbench(disk);
+
+    if (pio)
+    {
+        disk.handle()->call(IOCALL_DISK_SET_TRANSFER_MODE, &mode);
+    }
+
+    if (result != SUCCESS)
+    {
+        IO::errln("diskbench: {}: {}", args.argv()[0], get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}
@@ -1,141 +1,303 @@
 #include <string.h>
-#include <libsystem/io/Stream.h>
 
-int matchstar(int c, char *re, char *text);
+#include <libio/File.h>
+#include <libio/Streams.h>
+#include <libutils/ArgParse.h>
+#include <libutils/regex/Regex.h>
 
-// matchhere: search for re at beginning of text
-int matchhere(char *re, char *text)
+static bool option_count = false;
+static bool option_line_number = false;
+static bool option_ignore_case = false;
+static bool option_invert = false;
+
+static constexpr size_t READ_SIZE = 64 * 1024;
+static constexpr size_t OUTPUT_SIZE = 16 * 1024;
+
+// Lines are written in batches, not with a syscall each.
+struct Output
 {
-    if (re[0] == '\0')
-    {
-        return 1;
-    }
+    char buffer[OUTPUT_SIZE];
+    size_t used = 0;
 
-    if (re[1] == '*')
+    void flush()
     {
-        return matchstar(re[0], re + 2, text);
+        size_t written = 0;
+
+        while (written < used)
+        {
+            auto result = IO::out().write(buffer + written, used - written);
+
+            if (!result.success() || result.unwrap() == 0)
+            {
+                break;
+            }
+
+            written += result.unwrap();
+        }
+
+        used = 0;
     }
 
-    if (re[0] == '$' && re[1] == '\0')
+    void write(const char *data, size_t size)
     {
-        return *text == '\0';
+        if (used + size > OUTPUT_SIZE)
+        {
+            flush();
+        }
+
+        if (size > OUTPUT_SIZE)
+        {
+            IO::out().write(data, size);
+            return;
+        }
+
+        memcpy(buffer + used, data, size);
+        used += size;
     }
 
-    if (*text != '\0' && (re[0] == '.' || re[0] == *text))
+    void write(const String &string)
     {
-        return matchhere(re + 1, text + 1);
+        write(string.cstring(), string.length());
     }
+};
 
-    return 0;
-}
+static Output output;
 
-// matchstar: search for c*re at beginning of text
-int matchstar(int c, char *re, char *text)
+struct Grep
 {
-    do
+    Regex::Regex &regex;
+    String prefix;
+
+    size_t line_number = 0;
+    size_t selected = 0;
+
+    void report(const char *begin, const char *end, bool matched)
     {
-        // a * matches zero or more instances
-        if (matchhere(re, text))
+        line_number++;
+
+        if (matched == option_invert)
         {
-            return 1;
+            return;
         }
-    } while (*text != '\0' && (*text++ == c || c == '.'));
 
-    return 0;
-}
+        selected++;
 
-int match(char *re, char *text)
-{
-    if (re[0] == '^')
-    {
-        return matchhere(re + 1, text);
+        if (option_count)
+        {
+            return;
+        }
+
+        if (prefix.length() > 0)
+        {
+            output.write(prefix);
+        }
+
+        if (option_line_number)
+        {
+            output.write(IO::format("{}:", line_number));
+        }
+
+        output.write(begin, end - begin);
+        output.write("\n", 1);
     }
 
-    do
+    // Lines known not to match, only counted unless they are selected.
+    void skip(const char *begin, const char *end)
     {
-        // must look at empty string
-        if (matchhere(re, text))
+        if (!option_invert)
         {
-            return 1;
+            while (begin < end)
+            {
+                auto newline = reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
+
+                if (!newline)
+                {
+                    break;
+                }
+
+                line_number++;
+                begin = newline + 1;
+            }
+
+            return;
         }
-    } while (*text++ != '\0');
 
-    return 0;
-}
+        while (begin < end)
+        {
+            auto newline = reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
 
-void grep(char *pattern, Stream *stream)
-{
-    char *q;
+            report(begin, newline, false);
+            begin = newline + 1;
+        }
+    }
+
+    // Every line of the buffer ends with a newline.
+    void lines(const char *begin, const char *end)
+    {
+        const char *current = begin;
+
+        while (current < end)
+        {
+            // Jump to the line with the next occurrence of the literal.
+            const char *found = regex.find_literal(current, end);
+
+            if (found == end)
+            {
+                skip(current, end);
+                return;
+            }
+
+            auto line_begin = reinterpret_cast<const char *>(memrchr(current, '\n', found - current));
+            line_begin = line_begin ? line_begin + 1 : current;
+
+            skip(current, line_begin);
 
-    char buffer[1024];
-    size_t file_offset = 0;
-    size_t text_read = stream_read(stream, buffer + file_offset, sizeof(buffer) - file_offset - 1);
+            auto line_end = reinterpret_cast<const char *>(memchr(found, '\n', end - found));
 
-    while (text_read > 0)
+            report(line_begin, line_end, regex.match(line_begin, line_end - line_begin));
+
+            current = line_end + 1;
+        }
+    }
+
+    Result run(IO::Reader &reader)
     {
-        file_offset += text_read;
-        buffer[file_offset] = '\0';
-        char *p = buffer;
+        Vector<char> buffer{};
+        buffer.resize(READ_SIZE);
+
+        size_t used = 0;
 
-        while ((q = strchr(p, '\n')) != 0)
+        while (true)
         {
-            *q = 0;
+            if (used == buffer.count())
+            {
+                buffer.resize(buffer.count() * 2);
+            }
+
+            size_t read = TRY(reader.read(buffer.raw_storage() + used, buffer.count() - used));
+
+            if (read == 0)
+            {
+                break;
+            }
+
+            used += read;
 
-            if (match(pattern, p))
+            auto last_newline = reinterpret_cast<const char *>(memrchr(buffer.raw_storage(), '\n', used));
+
+            if (!last_newline)
             {
-                *q = '\n';
-                stream_write(out_stream, p, q + 1 - p);
+                continue;
             }
 
-            p = q + 1;
+            size_t complete = last_newline - buffer.raw_storage() + 1;
+
+            lines(buffer.raw_storage(), buffer.raw_storage() + complete);
+
+            memmove(buffer.raw_storage(), buffer.raw_storage() + complete, used - complete);
+            used -= complete;
         }
 
-        if (p == buffer)
+        // The last line has no newline.
+        if (used > 0)
         {
-            file_offset = 0;
+            report(buffer.raw_storage(), buffer.raw_storage() + used, regex.match(buffer.raw_storage(), used));
         }
 
-        if (file_offset > 0)
+        if (option_count)
         {
-            file_offset -= p - buffer;
-            memmove(buffer, p, file_offset);
+            output.write(IO::format("{}{}\n", prefix, selected));
         }
 
-        text_read = stream_read(stream, buffer + file_offset, sizeof(buffer) - file_offset - 1);
+        return SUCCESS;
     }
-}
+};
 
-int main(int argc, char *argv[])
+int main(int argc, const char *argv[])
 {
-    if (argc <= 1)
+    ArgParse args;
+
+    args.should_abort_on_failure();
+
+    args.usage("PATTERN");
+    args.usage("[OPTION]... PATTERN FILENAME...");
+
+    args.prologue("Print the lines of each FILE which match PATTERN.");
+
+    args.option(option_count, 'c', "count", "Print the number of selected lines instead of the lines.");
+    args.option(option_line_number, 'n', "line-number", "Prefix each line with its line number.");
+    args.option(option_ignore_case, 'i', "ignore-case", "Ignore case distinctions.");
+    args.option(option_invert, 'v', "invert-match", "Select the lines which don't match.");
+
+    args.epiloge("PATTERN supports . [] [^] ^ $ | () * + ? {n,m} and the \\d \\w \\s classes.\nIf no filename provided read from standard input.");
+
+    if (args.eval(argc, argv) != PROCESS_SUCCESS)
+    {
+        return PROCESS_FAILURE;
+    }
+
+    if (args.argc() == 0)
     {
-        stream_format(err_stream, "usage: grep pattern [file ...]\n");
-        return 0;
+        IO::errln("grep: Missing pattern");
+        return PROCESS_FAILURE;
     }
 
-    char *pattern = argv[1];
+    Regex::Regex regex{args.argv()[0], option_ignore_case};
 
-    if (argc <= 2)
+    if (!regex.valid())
     {
-        grep(pattern, in_stream);
-        return 0;
+        IO::errln("grep: {}: {}", args.argv()[0], regex.error());
+        return PROCESS_FAILURE;
     }
 
-    for (int i = 2; i < argc; i++)
+    size_t selected = 0;
+    int exit_code = PROCESS_SUCCESS;
+
+    if (args.argc() == 1)
     {
-        Stream *stream = stream_open(argv[i], OPEN_READ);
+        Grep grep{regex, ""};
+        Result result = grep.run(IO::in());
 
-        if (handle_has_error(stream))
+        if (result != SUCCESS)
         {
-            handle_printf_error(stream, "grep: cannot open %s", argv[i]);
-            stream_close(stream);
+            output.flush();
+            IO::errln("grep: -: {}", get_result_description(result));
+            exit_code = PROCESS_FAILURE;
+        }
 
-            return -1;
+        selected += grep.selected;
+    }
+
+    for (size_t i = 1; i < args.argc(); i++)
+    {
+        auto &filename = args.argv()[i];
+
+        IO::File file{filename, OPEN_READ};
+        Grep grep{regex, args.argc() > 2 ? IO::format("{}:", filename) : ""};
+
+        Result result = file.result();
+
+        if (result == SUCCESS)
+        {
+            result = grep.run(file);
         }
 
-        grep(pattern, stream);
-        stream_close(stream);
+        if (result != SUCCESS)
+        {
+            output.flush();
+            IO::errln("grep: {}: {}", filename, get_result_description(result));
+            exit_code = PROCESS_FAILURE;
+        }
+
+        selected += grep.selected;
+    }
+
+    output.flush();
+
+    if (selected == 0)
+    {
+        exit_code = PROCESS_FAILURE;
     }
 
-    return 0;
+    return exit_code;
 }
@@ -5,10 +5,14 @@
 #include <libsystem/Logger.h>
 #include <libsystem/io/Filesystem.h>
 #include <libsystem/process/Process.h>
+#include <libsystem/system/Trace.h>
 
 void start_service(const char *command, const char *socket)
 {
     logger_info("Starting '%s'...", command);
+
+    auto span = Trace::span(command);
+
     int compositor_pid = -1;
     process_run(command, &compositor_pid, TASK_WAITABLE);
 
@@ -62,15 +66,20 @@ int main(int, const char *[])
     logger_level(LOGGER_TRACE);
 
     logger_info("Loading environement variables...");
-    IO::File file{"/Configs/environment.json", OPEN_READ};
 
-    if (file.exist())
-    {
-        environment() = Json::parse(file);
-    }
-    else
     {
-        logger_error("Environment file not found!");
+        auto span = Trace::span("environment");
+
+        IO::File file{"/Configs/environment.json", OPEN_READ};
+
+        if (file.exist())
+        {
+            environment() = Json::parse(file);
+        }
+        else
+        {
+            logger_error("Environment file not found!");
+        }
     }
 
     if constexpr (__CONFIG_IS_TEST__)
@@ -0,0 +1,134 @@
+#include <libio/File.h>
+#include <libio/Streams.h>
+#include <libutils/ArgParse.h>
+#include <libutils/HashMap.h>
+#include <libutils/json/Json.h>
+
+constexpr auto PROLOGUE = "Write the trace of the boot in the Chrome trace format, for chrome://tracing or Perfetto.";
+
+constexpr auto EPILOGUE = "If no filename provided write to standard output.";
+
+static const char *chrome_phase(const String &phase)
+{
+    if (phase == "begin")
+    {
+        return "B";
+    }
+
+    if (phase == "end")
+    {
+        return "E";
+    }
+
+    return "i";
+}
+
+static Json::Value to_chrome_trace(const Json::Value &events)
+{
+    Json::Value::Array trace_events{};
+    HashMap<int, String> processes{};
+
+    for (size_t i = 0; i < events.length(); i++)
+    {
+        auto &event = events.get(i);
+
+        int pid = event.get("pid").as_integer();
+        processes[pid] = event.get("process").as_string();
+
+        Json::Value::Object trace_event{};
+
+        trace_event["name"] = event.get("name").as_string();
+        trace_event["cat"] = pid == 0 ? "kernel" : "userspace";
+        trace_event["ph"] = chrome_phase(event.get("phase").as_string());
+        trace_event["ts"] = event.get("timestamp").as_integer() / 1000.0;
+        trace_event["pid"] = (int64_t)pid;
+        trace_event["tid"] = (int64_t)pid;
+
+        if (event.get("phase").as_string() == "instant")
+        {
+            trace_event["s"] = "g";
+        }
+
+        trace_events.push_back(move(trace_event));
+    }
+
+    // Names the tracks of each process.
+    processes.foreach ([&](auto &pid, auto &name) {
+        Json::Value::Object args{};
+        args["name"] = name;
+
+        Json::Value::Object metadata{};
+
+        metadata["name"] = "process_name";
+        metadata["ph"] = "M";
+        metadata["pid"] = (int64_t)pid;
+        metadata["args"] = move(args);
+
+        trace_events.push_back(move(metadata));
+
+        return Iteration::CONTINUE;
+    });
+
+    Json::Value::Object root{};
+
+    root["traceEvents"] = move(trace_events);
+    root["displayTimeUnit"] = "ms";
+
+    return root;
+}
+
+int main(int argc, char const *argv[])
+{
+    ArgParse args{};
+
+    args.should_abort_on_failure();
+
+    args.prologue(PROLOGUE);
+
+    args.usage("");
+    args.usage("FILE");
+
+    args.epiloge(EPILOGUE);
+
+    if (args.eval(argc, argv) != PROCESS_SUCCESS)
+    {
+        return PROCESS_FAILURE;
+    }
+
+    IO::File trace_file{"/System/trace", OPEN_READ};
+
+    if (!trace_file.exist())
+    {
+        IO::errln("trace: The kernel has no boot trace");
+        return PROCESS_FAILURE;
+    }
+
+    auto events = Json::parse(trace_file);
+
+    if (!events.is(Json::ARRAY))
+    {
+        IO::errln("trace: Invalid boot trace");
+        return PROCESS_FAILURE;
+    }
+
+    Prettifier pretty{};
+    Json::prettify(pretty, to_chrome_trace(events));
+
+    if (args.argc() == 0)
+    {
+        IO::write(IO::out(), pretty.finalize());
+        return PROCESS_SUCCESS;
+    }
+
+    IO::File output{args.argv()[0], OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC};
+
+    auto result = IO::write(output, pretty.finalize());
+
+    if (!result.success())
+    {
+        IO::errln("trace: {}: {}", args.argv()[0], result.description());
+        return PROCESS_FAILURE;
+    }
+
+    return PROCESS_SUCCESS;
+}